@@ -0,0 +1,110 @@
+#include "common/Literals.hpp"
+#include "lib/RecentMessages.hpp"
+#include "providers/twitch/IrcMessageHandler.hpp"
+#include "providers/twitch/TwitchChannel.hpp"
+#include "providers/twitch/TwitchIrcLine.hpp"
+#include "util/VectorMessageSink.hpp"
+
+#include <benchmark/benchmark.h>
+#include <IrcMessage>
+#include <QJsonArray>
+
+#include <memory>
+#include <vector>
+
+using namespace chatterino;
+using namespace literals;
+
+namespace {
+
+/// Builds the recorded PRIVMSGs of nymn through the IRC message handler, from
+/// the received line to the built message
+class BuildPrivMessage : public bench::RecentMessages
+{
+public:
+    BuildPrivMessage()
+        : bench::RecentMessages(u"nymn"_s)
+        , channel_(std::make_shared<TwitchChannel>(this->name))
+    {
+        this->channel_->setSeventvEmotes(this->chan.seventvEmotes());
+        this->channel_->setBttvEmotes(this->chan.bttvEmotes());
+        this->channel_->setFfzEmotes(this->chan.ffzEmotes());
+
+        for (const auto &line :
+             this->messages.object()["messages"_L1].toArray())
+        {
+            auto data = line.toString().toUtf8();
+            auto parsed = TwitchIrcLine::parse(data);
+            // replies and redemptions depend on previous messages, so they
+            // can't be built in a pool
+            if (parsed && parsed->command() == "PRIVMSG" &&
+                !parsed->hasTag(TwitchTag::ReplyThreadParentMsgId) &&
+                !parsed->hasTag(TwitchTag::CustomRewardId))
+            {
+                this->data_.emplace_back(std::move(data));
+            }
+        }
+    }
+
+    /// The path of pooled messages (IrcMessageHandler::buildPrivMessage)
+    void runPooled(benchmark::State &state)
+    {
+        for (auto _ : state)
+        {
+            for (const auto &data : this->data_)
+            {
+                auto add =
+                    IrcMessageHandler::buildPrivMessage(data, this->channel_);
+                benchmark::DoNotOptimize(add);
+            }
+        }
+        this->setItemsProcessed(state);
+    }
+
+    /// The path of messages built in the GUI thread
+    /// (IrcMessageHandler::parseMessageInto)
+    void runHandler(benchmark::State &state)
+    {
+        for (auto _ : state)
+        {
+            VectorMessageSink sink;
+            for (const auto &data : this->data_)
+            {
+                std::unique_ptr<Communi::IrcMessage> message(
+                    Communi::IrcMessage::fromData(data, nullptr));
+                IrcMessageHandler::parseMessageInto(message.get(), sink,
+                                                    this->channel_.get());
+            }
+            auto messages = std::move(sink).takeMessages();
+            benchmark::DoNotOptimize(messages);
+        }
+        this->setItemsProcessed(state);
+    }
+
+private:
+    void setItemsProcessed(benchmark::State &state) const
+    {
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                                static_cast<int64_t>(this->data_.size()));
+    }
+
+    std::shared_ptr<TwitchChannel> channel_;
+    std::vector<QByteArray> data_;
+};
+
+void BM_BuildPrivMessagePooled(benchmark::State &state)
+{
+    BuildPrivMessage bench;
+    bench.runPooled(state);
+}
+
+void BM_BuildPrivMessageHandler(benchmark::State &state)
+{
+    BuildPrivMessage bench;
+    bench.runHandler(state);
+}
+
+}  // namespace
+
+BENCHMARK(BM_BuildPrivMessagePooled)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BuildPrivMessageHandler)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,96 @@
+#include "common/ChatterSet.hpp"
+
+#include "common/Literals.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+using namespace chatterino;
+using namespace literals;
+
+namespace {
+
+constexpr size_t CHATTER_COUNT = 100000;
+
+/// A set of 100k chatters with random names
+ChatterSet makeChatters()
+{
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> letter(0, 25);
+    std::uniform_int_distribution<int> length(4, 16);
+
+    ChatterSet set(CHATTER_COUNT);
+    for (size_t i = 0; i < CHATTER_COUNT; i++)
+    {
+        QString name;
+        auto n = length(rng);
+        for (int c = 0; c < n; c++)
+        {
+            name.append(QChar(u'a' + letter(rng)));
+        }
+        // some names have mixed case
+        if (i % 3 == 0)
+        {
+            name[0] = name[0].toUpper();
+        }
+        set.addRecentChatter(name);
+    }
+    return set;
+}
+
+/// Completes the queries someone gets when typing "@nym"
+const std::vector<QString> QUERIES{u"n"_s, u"ny"_s, u"nym"_s};
+
+/// What the user completion did before: go through all chatters
+void BM_ChatterSet_ScanAll(benchmark::State &state)
+{
+    auto set = makeChatters();
+    for (auto _ : state)
+    {
+        auto all = set.all();
+        for (const auto &query : QUERIES)
+        {
+            std::vector<std::pair<QString, QString>> result;
+            for (const auto &item : all)
+            {
+                if (item.first.startsWith(query))
+                {
+                    result.push_back(item);
+                }
+            }
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+void BM_ChatterSet_FilterByPrefix(benchmark::State &state)
+{
+    auto set = makeChatters();
+    for (auto _ : state)
+    {
+        for (const auto &query : QUERIES)
+        {
+            auto result = set.filterByPrefix(query);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+void BM_ChatterSet_AddRecentChatter(benchmark::State &state)
+{
+    auto set = makeChatters();
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        // every chatter is new, so one is evicted each time
+        set.addRecentChatter(u"chatter"_s + QString::number(i++));
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_ChatterSet_ScanAll);
+BENCHMARK(BM_ChatterSet_FilterByPrefix);
+BENCHMARK(BM_ChatterSet_AddRecentChatter);
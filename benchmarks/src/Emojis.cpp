@@ -180,3 +180,13 @@ BENCHMARK_CAPTURE(
     "😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 "
     "😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 ",
     61);
+BENCHMARK_CAPTURE(BM_EmojiParsing2, ascii_only,
+                  "forsen LULW that was so close 4Head I can't believe he "
+                  "missed the jump again #1 streamer OMEGALUL 1234567890",
+                  0);
+BENCHMARK_CAPTURE(BM_EmojiParsing2, non_ascii,
+                  "Привет чат, как дела? Сегодня стрим будет долгим", 0);
+BENCHMARK_CAPTURE(BM_EmojiParsing2, mixed,
+                  "forsen LULW 🐧 that was so close 4Head 😂😂 I can't "
+                  "believe it ❤️ #1 streamer",
+                  4);
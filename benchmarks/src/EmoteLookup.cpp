@@ -0,0 +1,167 @@
+#include "Application.hpp"
+#include "common/Literals.hpp"
+#include "lib/RecentMessages.hpp"
+#include "messages/Emote.hpp"
+#include "messages/MergedEmoteMap.hpp"
+#include "providers/bttv/BttvEmotes.hpp"
+#include "providers/ffz/FfzEmotes.hpp"
+#include "providers/seventv/SeventvEmotes.hpp"
+#include "providers/twitch/TwitchChannel.hpp"
+
+#include <benchmark/benchmark.h>
+#include <IrcMessage>
+#include <QJsonArray>
+#include <QString>
+
+#include <memory>
+#include <vector>
+
+using namespace chatterino;
+using namespace literals;
+
+namespace {
+
+/// Resolves every word of the recorded messages of nymn to an emote, with
+/// 2000 channel emotes loaded.
+class EmoteLookup : public bench::RecentMessages
+{
+public:
+    static constexpr size_t CHANNEL_EMOTES = 2000;
+
+    EmoteLookup()
+        : bench::RecentMessages(u"nymn"_s)
+    {
+        auto channelEmotes = this->chan.ffzEmotes()->size() +
+                             this->chan.bttvEmotes()->size() +
+                             this->chan.seventvEmotes()->size();
+        if (channelEmotes < CHANNEL_EMOTES)
+        {
+            auto bttv = std::make_shared<EmoteMap>(*this->chan.bttvEmotes());
+            for (size_t i = 0; channelEmotes < CHANNEL_EMOTES; i++)
+            {
+                EmoteName name{u"benchEmote"_s + QString::number(i)};
+                auto [_, inserted] = bttv->emplace(
+                    name, std::make_shared<const Emote>(Emote{.name = name}));
+                channelEmotes += inserted ? 1 : 0;
+            }
+            this->chan.setBttvEmotes(std::move(bttv));
+        }
+
+        for (const auto &line :
+             this->messages.object()["messages"_L1].toArray())
+        {
+            std::unique_ptr<Communi::IrcMessage> message(
+                Communi::IrcMessage::fromData(line.toString().toUtf8(),
+                                              nullptr));
+            if (message->type() != Communi::IrcMessage::Private)
+            {
+                continue;
+            }
+            auto *privmsg =
+                static_cast<Communi::IrcPrivateMessage *>(message.get());
+            this->words_.emplace_back(
+                privmsg->content().split(u' ', Qt::SkipEmptyParts));
+        }
+    }
+
+    /// Looks up every word in all channel and global maps, one after another
+    void runSeparate(benchmark::State &state)
+    {
+        auto *app = getApp();
+        for (auto _ : state)
+        {
+            for (const auto &words : this->words_)
+            {
+                // the global maps were loaded once per message
+                auto ffzGlobal = app->getFfzEmotes()->emotes();
+                auto bttvGlobal = app->getBttvEmotes()->emotes();
+                auto seventvGlobal = app->getSeventvEmotes()->globalEmotes();
+                for (const auto &word : words)
+                {
+                    EmoteName name{word};
+                    auto emote = this->findSeparate(
+                        name, *ffzGlobal, *bttvGlobal, *seventvGlobal);
+                    benchmark::DoNotOptimize(emote);
+                }
+            }
+        }
+        this->setItemsProcessed(state);
+    }
+
+    /// Looks up every word in the merged map of the channel
+    void runMerged(benchmark::State &state)
+    {
+        for (auto _ : state)
+        {
+            for (const auto &words : this->words_)
+            {
+                // the merged map is fetched once per message
+                auto merged = this->chan.mergedEmotes();
+                for (const auto &word : words)
+                {
+                    const auto *entry = merged->find(word);
+                    benchmark::DoNotOptimize(entry);
+                }
+            }
+        }
+        this->setItemsProcessed(state);
+    }
+
+private:
+    EmotePtr findSeparate(const EmoteName &name, const EmoteMap &ffzGlobal,
+                          const EmoteMap &bttvGlobal,
+                          const EmoteMap &seventvGlobal) const
+    {
+        if (auto emote = this->chan.ffzEmote(name))
+        {
+            return *emote;
+        }
+        if (auto emote = this->chan.bttvEmote(name))
+        {
+            return *emote;
+        }
+        if (auto emote = this->chan.seventvEmote(name))
+        {
+            return *emote;
+        }
+        for (const auto *map : {&ffzGlobal, &bttvGlobal, &seventvGlobal})
+        {
+            auto it = map->find(name);
+            if (it != map->end())
+            {
+                return it->second;
+            }
+        }
+        return nullptr;
+    }
+
+    void setItemsProcessed(benchmark::State &state) const
+    {
+        int64_t words = 0;
+        for (const auto &message : this->words_)
+        {
+            words += message.size();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                                words);
+    }
+
+    std::vector<QStringList> words_;
+};
+
+void BM_EmoteLookup_Separate(benchmark::State &state)
+{
+    EmoteLookup bench;
+    bench.runSeparate(state);
+}
+
+void BM_EmoteLookup_Merged(benchmark::State &state)
+{
+    EmoteLookup bench;
+    bench.runMerged(state);
+}
+
+}  // namespace
+
+BENCHMARK(BM_EmoteLookup_Separate);
+BENCHMARK(BM_EmoteLookup_Merged);
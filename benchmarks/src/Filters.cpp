@@ -0,0 +1,96 @@
+#include "common/Literals.hpp"
+#include "controllers/filters/lang/Filter.hpp"
+#include "controllers/filters/lang/FilterContext.hpp"
+#include "lib/RecentMessages.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QString>
+
+using namespace chatterino;
+using namespace chatterino::filters;
+using namespace literals;
+
+namespace {
+
+// clang-format off
+const QString SIMPLE_FILTER = u"!flags.system_message && author.subbed"_s;
+const QString COMPLEX_FILTER = uR".(
+    (author.badges contains "moderator" || author.badges contains "vip" ||
+     author.sub_length >= 12) &&
+    !(message.content match ri"^!\w+") &&
+    message.length > 5 &&
+    channel.name == "nymn" &&
+    !(author.name startswith "nightbot")
+)."_s.trimmed();
+// clang-format on
+
+Filter makeFilter(const QString &text)
+{
+    auto result = Filter::fromString(text);
+    auto *filter = std::get_if<Filter>(&result);
+    if (!filter)
+    {
+        _exit(1);
+    }
+    return std::move(*filter);
+}
+
+class FilterEvaluation : public bench::RecentMessages
+{
+public:
+    FilterEvaluation(const QString &filterText)
+        : bench::RecentMessages(u"nymn"_s)
+        , filter(makeFilter(filterText))
+        , builtMessages(this->buildMessages())
+    {
+    }
+
+    void runTree(benchmark::State &state)
+    {
+        for (auto _ : state)
+        {
+            for (const auto &msg : this->builtMessages)
+            {
+                auto context = buildContextMap(msg, &this->chan);
+                auto result = this->filter.execute(context);
+                benchmark::DoNotOptimize(result);
+            }
+        }
+    }
+
+    void runCompiled(benchmark::State &state)
+    {
+        for (auto _ : state)
+        {
+            for (const auto &msg : this->builtMessages)
+            {
+                FilterContext context(msg, &this->chan);
+                auto result = this->filter.execute(context);
+                benchmark::DoNotOptimize(result);
+            }
+        }
+    }
+
+private:
+    Filter filter;
+    std::vector<MessagePtr> builtMessages;
+};
+
+void BM_FilterTree(benchmark::State &state, const QString &filterText)
+{
+    FilterEvaluation bench(filterText);
+    bench.runTree(state);
+}
+
+void BM_FilterCompiled(benchmark::State &state, const QString &filterText)
+{
+    FilterEvaluation bench(filterText);
+    bench.runCompiled(state);
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_FilterTree, simple, SIMPLE_FILTER);
+BENCHMARK_CAPTURE(BM_FilterCompiled, simple, SIMPLE_FILTER);
+BENCHMARK_CAPTURE(BM_FilterTree, complex, COMPLEX_FILTER);
+BENCHMARK_CAPTURE(BM_FilterCompiled, complex, COMPLEX_FILTER);
@@ -0,0 +1,106 @@
+#include "common/Literals.hpp"
+#include "controllers/highlights/HighlightPhrase.hpp"
+#include "controllers/highlights/HighlightPhraseMatcher.hpp"
+#include "lib/RecentMessages.hpp"
+#include "messages/Message.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QColor>
+#include <QRegularExpression>
+#include <QString>
+#include <QStringList>
+
+#include <random>
+#include <vector>
+
+using namespace chatterino;
+using namespace literals;
+
+namespace {
+
+/// Highlight phrases checked against the recorded chat of nymn.
+///
+/// Most phrases are words from the chat itself (so some of them match), every
+/// fourth phrase is a regex.
+class Highlights : public bench::RecentMessages
+{
+public:
+    explicit Highlights(size_t nPhrases)
+        : bench::RecentMessages(u"nymn"_s)
+    {
+        QStringList words;
+        for (const auto &message : this->buildMessages())
+        {
+            this->texts_.push_back(message->messageText);
+            words.append(message->messageText.split(u' ', Qt::SkipEmptyParts));
+        }
+
+        std::mt19937 rng(42);
+        for (size_t i = 0; i < nPhrases; i++)
+        {
+            const auto &word =
+                words[static_cast<qsizetype>(rng() % words.size())];
+            auto isRegex = i % 4 == 3;
+            auto pattern =
+                isRegex ? u"^%1|%1\\d+"_s.arg(QRegularExpression::escape(word))
+                        : word;
+            this->phrases_.emplace_back(pattern, false, false, false, isRegex,
+                                        i % 2 == 0, QString(), QColor());
+        }
+    }
+
+    void runMatcher(benchmark::State &state)
+    {
+        HighlightPhraseMatcher matcher(this->phrases_);
+        for (auto _ : state)
+        {
+            for (const auto &text : this->texts_)
+            {
+                benchmark::DoNotOptimize(matcher.findMatches(text));
+            }
+        }
+        this->setProcessed(state);
+    }
+
+    void runPhrases(benchmark::State &state)
+    {
+        for (auto _ : state)
+        {
+            for (const auto &text : this->texts_)
+            {
+                for (const auto &phrase : this->phrases_)
+                {
+                    benchmark::DoNotOptimize(phrase.isMatch(text));
+                }
+            }
+        }
+        this->setProcessed(state);
+    }
+
+private:
+    void setProcessed(benchmark::State &state) const
+    {
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                                static_cast<int64_t>(this->texts_.size()));
+    }
+
+    std::vector<QString> texts_;
+    std::vector<HighlightPhrase> phrases_;
+};
+
+void BM_HighlightPhrases_Matcher(benchmark::State &state)
+{
+    Highlights bench(static_cast<size_t>(state.range(0)));
+    bench.runMatcher(state);
+}
+
+void BM_HighlightPhrases_Individual(benchmark::State &state)
+{
+    Highlights bench(static_cast<size_t>(state.range(0)));
+    bench.runPhrases(state);
+}
+
+}  // namespace
+
+BENCHMARK(BM_HighlightPhrases_Matcher)->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK(BM_HighlightPhrases_Individual)->Arg(10)->Arg(100)->Arg(1000);
@@ -0,0 +1,116 @@
+#include "common/Literals.hpp"
+#include "controllers/ignores/IgnoreController.hpp"
+#include "controllers/ignores/IgnorePhrase.hpp"
+#include "lib/RecentMessages.hpp"
+#include "messages/Message.hpp"
+#include "providers/twitch/TwitchIrc.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QRegularExpression>
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace chatterino;
+using namespace literals;
+
+namespace {
+
+/// Replacement ignore phrases applied to the recorded chat of nymn.
+///
+/// Phrases are words from the chat with a suffix, so only a few of them
+/// actually replace something. Every fourth phrase is a regex.
+class IgnorePhrases : public bench::RecentMessages
+{
+public:
+    explicit IgnorePhrases(size_t nPhrases)
+        : bench::RecentMessages(u"nymn"_s)
+    {
+        QStringList words;
+        for (const auto &message : this->buildMessages())
+        {
+            this->texts_.push_back(message->messageText);
+            words.append(message->messageText.split(u' ', Qt::SkipEmptyParts));
+        }
+
+        std::mt19937 rng(42);
+        std::vector<IgnorePhrase> phrases;
+        for (size_t i = 0; i < nPhrases; i++)
+        {
+            auto word = words[static_cast<qsizetype>(rng() % words.size())];
+            if (rng() % 8 != 0)
+            {
+                word += u"xd"_s;
+            }
+            auto isRegex = i % 4 == 3;
+            auto pattern =
+                isRegex ? u"\\b%1\\b"_s.arg(QRegularExpression::escape(word))
+                        : word;
+            phrases.emplace_back(pattern, isRegex, false, u"***"_s,
+                                 i % 2 == 0);
+        }
+        this->phrases_ = std::make_shared<const std::vector<IgnorePhrase>>(
+            std::move(phrases));
+    }
+
+    void runReplacer(benchmark::State &state)
+    {
+        IgnorePhraseReplacer replacer(this->phrases_);
+        for (auto _ : state)
+        {
+            for (const auto &text : this->texts_)
+            {
+                auto content = text;
+                std::vector<TwitchEmoteOccurrence> emotes;
+                replacer.process(content, emotes);
+                benchmark::DoNotOptimize(content);
+            }
+        }
+        this->setProcessed(state);
+    }
+
+    void runPhrases(benchmark::State &state)
+    {
+        for (auto _ : state)
+        {
+            for (const auto &text : this->texts_)
+            {
+                auto content = text;
+                std::vector<TwitchEmoteOccurrence> emotes;
+                processIgnorePhrases(*this->phrases_, content, emotes);
+                benchmark::DoNotOptimize(content);
+            }
+        }
+        this->setProcessed(state);
+    }
+
+private:
+    void setProcessed(benchmark::State &state) const
+    {
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                                static_cast<int64_t>(this->texts_.size()));
+    }
+
+    std::vector<QString> texts_;
+    std::shared_ptr<const std::vector<IgnorePhrase>> phrases_;
+};
+
+void BM_IgnorePhrases_Replacer(benchmark::State &state)
+{
+    IgnorePhrases bench(static_cast<size_t>(state.range(0)));
+    bench.runReplacer(state);
+}
+
+void BM_IgnorePhrases_Individual(benchmark::State &state)
+{
+    IgnorePhrases bench(static_cast<size_t>(state.range(0)));
+    bench.runPhrases(state);
+}
+
+}  // namespace
+
+BENCHMARK(BM_IgnorePhrases_Replacer)->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK(BM_IgnorePhrases_Individual)->Arg(10)->Arg(100)->Arg(1000);
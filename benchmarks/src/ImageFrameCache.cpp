@@ -0,0 +1,76 @@
+#include "messages/Image.hpp"
+#include "messages/ImageFrameCache.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QBuffer>
+#include <QFile>
+#include <QImageReader>
+#include <QTemporaryDir>
+
+using namespace chatterino;
+
+namespace {
+
+QByteArray readResource(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly))
+    {
+        return {};
+    }
+    return file.readAll();
+}
+
+/// Loading an image that was never shown before: the downloaded data has to be
+/// decoded
+void BM_ImageLoad_Cold(benchmark::State &state, const QString &path)
+{
+    auto data = readResource(path);
+    auto image = Image::fromUrl({path});
+    int64_t frameCount = 0;
+    for (auto _ : state)
+    {
+        QBuffer buffer;
+        buffer.setData(data);
+        QImageReader reader(&buffer);
+        auto frames = detail::readFrames(reader, image->url(), image);
+        frameCount += frames.size();
+        benchmark::DoNotOptimize(frames);
+    }
+    state.SetItemsProcessed(frameCount);
+}
+
+/// Loading an image that was decoded before from the disk cache
+void BM_ImageLoad_Warm(benchmark::State &state, const QString &path)
+{
+    QTemporaryDir dir;
+    ImageFrameCache cache(dir.path(), 1024 * 1024 * 1024);
+
+    auto data = readResource(path);
+    auto image = Image::fromUrl({path});
+    QBuffer buffer;
+    buffer.setData(data);
+    QImageReader reader(&buffer);
+    cache.write(path, 1, detail::readFrames(reader, image->url(), image));
+
+    int64_t frameCount = 0;
+    for (auto _ : state)
+    {
+        auto frames = cache.read(path, 1);
+        if (!frames)
+        {
+            state.SkipWithError("image isn't cached");
+            break;
+        }
+        frameCount += frames->size();
+        benchmark::DoNotOptimize(frames);
+    }
+    state.SetItemsProcessed(frameCount);
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_ImageLoad_Cold, static_png, ":/buttons/mod.png");
+BENCHMARK_CAPTURE(BM_ImageLoad_Warm, static_png, ":/buttons/mod.png");
+BENCHMARK_CAPTURE(BM_ImageLoad_Cold, animated_gif, ":/examples/moving.gif");
+BENCHMARK_CAPTURE(BM_ImageLoad_Warm, animated_gif, ":/examples/moving.gif");
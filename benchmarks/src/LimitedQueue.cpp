@@ -1,5 +1,7 @@
 #include "messages/LimitedQueue.hpp"
 
+#include "messages/ChunkedLimitedQueue.hpp"
+
 #include <benchmark/benchmark.h>
 
 #include <memory>
@@ -107,6 +109,109 @@ void BM_LimitedQueue_Find(benchmark::State &state)
     }
 }
 
+// Comparisons between LimitedQueue and ChunkedLimitedQueue at different
+// limits. The queues are full of shared pointers, like the message queues in
+// channels.
+
+template <typename Queue>
+std::unique_ptr<Queue> makeFullQueue(size_t limit)
+{
+    auto queue = std::make_unique<Queue>(limit);
+    for (size_t i = 0; i < limit; ++i)
+    {
+        queue->pushBack(std::make_shared<int>(static_cast<int>(i)));
+    }
+    return queue;
+}
+
+template <typename Queue>
+void BM_Queue_PushBack(benchmark::State &state)
+{
+    auto queue = makeFullQueue<Queue>(static_cast<size_t>(state.range(0)));
+    auto item = std::make_shared<int>(1);
+
+    for (auto _ : state)
+    {
+        queue->pushBack(item);
+    }
+}
+
+template <typename Queue>
+void BM_Queue_Snapshot(benchmark::State &state)
+{
+    auto queue = makeFullQueue<Queue>(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        auto snapshot = queue->getSnapshot();
+        benchmark::DoNotOptimize(snapshot);
+    }
+}
+
+/// The first thread pushes messages while all others take snapshots and look
+/// at the last message, like a ChannelView painting a busy channel.
+template <typename Queue>
+void BM_Queue_Contention(benchmark::State &state)
+{
+    static std::unique_ptr<Queue> queue;
+    const bool isWriter = state.thread_index() == 0;
+    if (isWriter)
+    {
+        queue = makeFullQueue<Queue>(static_cast<size_t>(state.range(0)));
+    }
+    auto item = std::make_shared<int>(1);
+
+    for (auto _ : state)
+    {
+        if (isWriter)
+        {
+            queue->pushBack(item);
+        }
+        else
+        {
+            auto snapshot = queue->getSnapshot();
+            benchmark::DoNotOptimize(snapshot[snapshot.size() - 1]);
+        }
+    }
+
+    if (isWriter)
+    {
+        queue.reset();
+    }
+}
+
+using SharedQueue = LimitedQueue<std::shared_ptr<int>>;
+using SharedChunkedQueue = ChunkedLimitedQueue<std::shared_ptr<int>>;
+
+BENCHMARK_TEMPLATE(BM_Queue_PushBack, SharedQueue)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000);
+BENCHMARK_TEMPLATE(BM_Queue_PushBack, SharedChunkedQueue)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000);
+BENCHMARK_TEMPLATE(BM_Queue_Snapshot, SharedQueue)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000);
+BENCHMARK_TEMPLATE(BM_Queue_Snapshot, SharedChunkedQueue)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000);
+BENCHMARK_TEMPLATE(BM_Queue_Contention, SharedQueue)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Threads(2)
+    ->Threads(4);
+BENCHMARK_TEMPLATE(BM_Queue_Contention, SharedChunkedQueue)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Threads(2)
+    ->Threads(4);
+
 BENCHMARK(BM_LimitedQueue_PushBack);
 BENCHMARK(BM_LimitedQueue_PushFront_One);
 BENCHMARK(BM_LimitedQueue_PushFront_Many);
@@ -0,0 +1,116 @@
+#include "messages/MergedSnapshots.hpp"
+
+#include "common/Literals.hpp"
+#include "messages/LimitedQueue.hpp"
+#include "messages/Message.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QDateTime>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace chatterino;
+using namespace literals;
+
+namespace {
+
+constexpr size_t MESSAGES_PER_CHANNEL = 10000;
+
+/// Snapshots of `state.range(0)` channels whose messages are interleaved
+std::vector<LimitedQueueSnapshot<MessagePtr>> makeChannels(
+    const benchmark::State &state)
+{
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<qint64> gap(1, 2000);
+
+    std::vector<LimitedQueueSnapshot<MessagePtr>> channels;
+    for (int64_t channel = 0; channel < state.range(0); channel++)
+    {
+        LimitedQueue<MessagePtr> queue(MESSAGES_PER_CHANNEL);
+        qint64 time = 1700000000000;
+        for (size_t i = 0; i < MESSAGES_PER_CHANNEL; i++)
+        {
+            time += gap(rng);
+            auto message = std::make_shared<Message>();
+            message->id = u"%1-%2"_s.arg(channel).arg(i);
+            message->serverReceivedTime = QDateTime::fromMSecsSinceEpoch(time);
+            queue.pushBack(message);
+        }
+        channels.push_back(queue.getSnapshot());
+    }
+    return channels;
+}
+
+/// What SearchPopup did before: sort by ID to remove duplicates, then sort by
+/// time
+void BM_SortSnapshots(benchmark::State &state)
+{
+    auto channels = makeChannels(state);
+    for (auto _ : state)
+    {
+        std::vector<MessagePtr> combined;
+        for (const auto &snapshot : channels)
+        {
+            combined.insert(combined.end(), snapshot.begin(), snapshot.end());
+        }
+        std::ranges::sort(combined, [](const auto &a, const auto &b) {
+            return a->id > b->id;
+        });
+        auto [first, last] =
+            std::ranges::unique(combined, [](const auto &a, const auto &b) {
+                return !a->id.isNull() && a->id == b->id;
+            });
+        combined.erase(first, last);
+        std::ranges::sort(combined, [](const auto &a, const auto &b) {
+            return a->serverReceivedTime < b->serverReceivedTime;
+        });
+        benchmark::DoNotOptimize(combined);
+    }
+}
+
+void BM_MergeSnapshots(benchmark::State &state)
+{
+    auto channels = makeChannels(state);
+    for (auto _ : state)
+    {
+        MergedSnapshots merged;
+        for (const auto &snapshot : channels)
+        {
+            merged.add(snapshot);
+        }
+        auto combined = merged.collect();
+        benchmark::DoNotOptimize(combined);
+    }
+}
+
+/// Only takes the first 100 messages (e.g. to fill one screen)
+void BM_MergeSnapshots_First100(benchmark::State &state)
+{
+    auto channels = makeChannels(state);
+    for (auto _ : state)
+    {
+        MergedSnapshots merged;
+        for (const auto &snapshot : channels)
+        {
+            merged.add(snapshot);
+        }
+        size_t n = 0;
+        for (const auto &message : merged)
+        {
+            benchmark::DoNotOptimize(message);
+            if (++n == 100)
+            {
+                break;
+            }
+        }
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_SortSnapshots)->Arg(2)->Arg(20);
+BENCHMARK(BM_MergeSnapshots)->Arg(2)->Arg(20);
+BENCHMARK(BM_MergeSnapshots_First100)->Arg(2)->Arg(20);
@@ -0,0 +1,94 @@
+#include "common/Literals.hpp"
+#include "lib/RecentMessages.hpp"
+#include "providers/twitch/IrcMessageHandler.hpp"
+#include "providers/twitch/TwitchChannel.hpp"
+#include "util/KeyedThreadPool.hpp"
+
+#include <benchmark/benchmark.h>
+#include <IrcMessage>
+#include <QJsonArray>
+#include <QString>
+
+#include <memory>
+#include <vector>
+
+using namespace chatterino;
+using namespace literals;
+
+namespace {
+
+/// Replays the recorded PRIVMSGs of nymn into a few channels, building the
+/// messages on a KeyedThreadPool like TwitchIrcServer does.
+class MessageBuilderThreads : public bench::RecentMessages
+{
+public:
+    static constexpr size_t CHANNEL_COUNT = 8;
+
+    MessageBuilderThreads()
+        : bench::RecentMessages(u"nymn"_s)
+    {
+        for (size_t i = 0; i < CHANNEL_COUNT; i++)
+        {
+            auto channel = std::make_shared<TwitchChannel>(this->name);
+            channel->setSeventvEmotes(this->chan.seventvEmotes());
+            channel->setBttvEmotes(this->chan.bttvEmotes());
+            channel->setFfzEmotes(this->chan.ffzEmotes());
+            this->channels_.emplace_back(std::move(channel));
+        }
+
+        for (const auto &line :
+             this->messages.object()["messages"_L1].toArray())
+        {
+            auto data = line.toString().toUtf8();
+            std::unique_ptr<Communi::IrcMessage> message(
+                Communi::IrcMessage::fromData(data, nullptr));
+            // replies depend on previous messages and are built in the GUI
+            // thread
+            if (message->type() == Communi::IrcMessage::Private &&
+                !message->tags().contains(u"reply-thread-parent-msg-id"_s))
+            {
+                this->data_.emplace_back(std::move(data));
+            }
+        }
+    }
+
+    void run(benchmark::State &state)
+    {
+        KeyedThreadPool pool(static_cast<size_t>(state.range(0)), "Bench");
+        for (auto _ : state)
+        {
+            for (size_t i = 0; i < this->data_.size(); i++)
+            {
+                const auto &channel = this->channels_[i % CHANNEL_COUNT];
+                pool.submit(channel.get(), [&data = this->data_[i], channel] {
+                    auto add =
+                        IrcMessageHandler::buildPrivMessage(data, channel);
+                    benchmark::DoNotOptimize(add);
+                });
+            }
+            pool.waitForIdle();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                                static_cast<int64_t>(this->data_.size()));
+    }
+
+private:
+    std::vector<std::shared_ptr<TwitchChannel>> channels_;
+    std::vector<QByteArray> data_;
+};
+
+void BM_MessageBuilderThreads(benchmark::State &state)
+{
+    MessageBuilderThreads bench;
+    bench.run(state);
+}
+
+}  // namespace
+
+BENCHMARK(BM_MessageBuilderThreads)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,58 @@
+#include "messages/layouts/MessageLayout.hpp"
+
+#include "common/Literals.hpp"
+#include "lib/RecentMessages.hpp"
+#include "messages/layouts/MessageLayoutContext.hpp"
+#include "messages/MessageElement.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QString>
+
+#include <memory>
+#include <vector>
+
+using namespace chatterino;
+using namespace literals;
+
+namespace {
+
+/// Lays out the recent messages of a channel again, like resizing a split
+/// does
+void BM_RelayoutMessages(benchmark::State &state, const QString &name)
+{
+    bench::RecentMessages recent(name);
+
+    std::vector<std::unique_ptr<MessageLayout>> layouts;
+    for (auto &message : recent.buildMessages())
+    {
+        layouts.emplace_back(std::make_unique<MessageLayout>(message));
+    }
+
+    MessageColors colors;
+    MessageLayoutContext ctx{
+        .messageColors = colors,
+        .flags = MessageElementFlag::Default,
+        .width = static_cast<int>(state.range(0)),
+        .scale = 1,
+        .imageScale = 1,
+    };
+
+    for (auto _ : state)
+    {
+        for (auto &layout : layouts)
+        {
+            layout->flags.set(MessageLayoutFlag::RequiresLayout);
+            benchmark::DoNotOptimize(layout->layout(ctx, false));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(layouts.size()));
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_RelayoutMessages, nymn, u"nymn"_s)
+    ->Arg(200)
+    ->Arg(400)
+    ->Arg(800)
+    ->Arg(1600);
@@ -0,0 +1,108 @@
+#include "messages/MessageSimilarity.hpp"
+
+#include "common/Literals.hpp"
+#include "lib/RecentMessages.hpp"
+#include "messages/ChunkedLimitedQueue.hpp"
+#include "messages/Message.hpp"
+#include "singletons/Settings.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QString>
+#include <QStringList>
+#include <QTime>
+
+#include <random>
+#include <vector>
+
+using namespace chatterino;
+using namespace literals;
+
+namespace {
+
+// clang-format off
+const QStringList COPYPASTAS = {
+    u"THIS IS A RAID FROM THE FORSEN COMMUNITY forsenE forsenE forsenE WE COME IN PEACE forsenE forsenE forsenE"_s,
+    u"RAID RAID RAID RAID RAID RAID RAID RAID RAID RAID RAID RAID RAID RAID RAID"_s,
+    u"Clap Clap Clap Clap Clap Clap Clap Clap Clap Clap Clap Clap Clap Clap Clap Clap Clap Clap"_s,
+    u"The raid train has arrived, please remain seated until it comes to a complete stop. Thank you for travelling with us today."_s,
+    u"NymN raid NymN raid NymN raid NymN raid NymN raid"_s,
+};
+// clang-format on
+
+/// Recorded chat of nymn interleaved with a raid.
+///
+/// Raiders post one of a few copypastas with small changes, three out of four
+/// messages are part of the raid.
+class SimilarityRaid : public bench::RecentMessages
+{
+public:
+    SimilarityRaid()
+        : bench::RecentMessages(u"nymn"_s)
+    {
+        std::mt19937 rng(42);
+        size_t raiderID = 0;
+
+        for (const auto &recorded : this->buildMessages())
+        {
+            this->messages_.push_back(
+                makeMessage(recorded->loginName, recorded->messageText));
+
+            for (int i = 0; i < 3; i++)
+            {
+                auto text = COPYPASTAS[rng() % COPYPASTAS.size()];
+                // cut off some words or add some at the end
+                auto cut = static_cast<qsizetype>(rng() % 20);
+                text.chop(cut);
+                text += u" forsenE"_s.repeated(rng() % 3);
+
+                this->messages_.push_back(makeMessage(
+                    u"raider%1"_s.arg(raiderID++), std::move(text)));
+            }
+        }
+    }
+
+    void run(benchmark::State &state)
+    {
+        auto *settings = getSettings();
+        settings->similarityEnabled.setValue(true);
+        settings->hideSimilarBySameUser.setValue(false);
+        settings->hideSimilarMaxDelay.setValue(24 * 60 * 60);
+        settings->hideSimilarMaxMessagesToCheck.setValue(
+            static_cast<int>(state.range(0)));
+
+        for (auto _ : state)
+        {
+            ChunkedLimitedQueue<MessagePtr> queue;
+            for (const auto &message : this->messages_)
+            {
+                setSimilarityFlags(message, queue.getSnapshot());
+                queue.pushBack(message);
+            }
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                                static_cast<int64_t>(this->messages_.size()));
+    }
+
+private:
+    static MessagePtr makeMessage(const QString &loginName, QString text)
+    {
+        auto message = std::make_shared<Message>();
+        message->loginName = loginName;
+        message->messageText = std::move(text);
+        message->parseTime = QTime::currentTime();
+        return message;
+    }
+
+    std::vector<MessagePtr> messages_;
+};
+
+void BM_SimilarityRaid(benchmark::State &state)
+{
+    SimilarityRaid bench;
+    bench.run(state);
+}
+
+}  // namespace
+
+BENCHMARK(BM_SimilarityRaid)->Arg(3)->Arg(10)->Arg(50);
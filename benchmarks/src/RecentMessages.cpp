@@ -1,219 +1,30 @@
 #include "common/Literals.hpp"
-#include "controllers/accounts/AccountController.hpp"
-#include "controllers/highlights/HighlightController.hpp"
-#include "messages/Emote.hpp"
-#include "mocks/BaseApplication.hpp"
-#include "mocks/DisabledStreamerMode.hpp"
-#include "mocks/Emotes.hpp"
-#include "mocks/LinkResolver.hpp"
-#include "mocks/Logging.hpp"
-#include "mocks/TwitchIrcServer.hpp"
-#include "mocks/UserData.hpp"
-#include "providers/bttv/BttvEmotes.hpp"
-#include "providers/chatterino/ChatterinoBadges.hpp"
-#include "providers/ffz/FfzBadges.hpp"
-#include "providers/ffz/FfzEmotes.hpp"
+#include "lib/RecentMessages.hpp"
 #include "providers/recentmessages/Impl.hpp"
-#include "providers/seventv/SeventvBadges.hpp"
-#include "providers/seventv/SeventvEmotes.hpp"
-#include "providers/twitch/TwitchBadges.hpp"
 #include "providers/twitch/TwitchChannel.hpp"
-#include "singletons/Resources.hpp"
+#include "util/VectorMessageSink.hpp"
 
 #include <benchmark/benchmark.h>
-#include <QFile>
-#include <QJsonArray>
-#include <QJsonDocument>
 #include <QString>
+#include <QtConcurrent>
+#include <QThreadPool>
 
-#include <optional>
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
 
 using namespace chatterino;
 using namespace literals;
 
 namespace {
 
-class MockApplication : public mock::BaseApplication
+class RecentMessages : public bench::RecentMessages
 {
 public:
-    MockApplication()
-        : highlights(this->settings, &this->accounts)
-    {
-    }
-
-    IEmotes *getEmotes() override
-    {
-        return &this->emotes;
-    }
-
-    IUserDataController *getUserData() override
-    {
-        return &this->userData;
-    }
-
-    AccountController *getAccounts() override
-    {
-        return &this->accounts;
-    }
-
-    ITwitchIrcServer *getTwitch() override
-    {
-        return &this->twitch;
-    }
-
-    ChatterinoBadges *getChatterinoBadges() override
-    {
-        return &this->chatterinoBadges;
-    }
-
-    FfzBadges *getFfzBadges() override
-    {
-        return &this->ffzBadges;
-    }
-
-    SeventvBadges *getSeventvBadges() override
-    {
-        return &this->seventvBadges;
-    }
-
-    HighlightController *getHighlights() override
-    {
-        return &this->highlights;
-    }
-
-    TwitchBadges *getTwitchBadges() override
-    {
-        return &this->twitchBadges;
-    }
-
-    BttvEmotes *getBttvEmotes() override
-    {
-        return &this->bttvEmotes;
-    }
-
-    FfzEmotes *getFfzEmotes() override
-    {
-        return &this->ffzEmotes;
-    }
-
-    SeventvEmotes *getSeventvEmotes() override
-    {
-        return &this->seventvEmotes;
-    }
-
-    IStreamerMode *getStreamerMode() override
-    {
-        return &this->streamerMode;
-    }
-
-    ILinkResolver *getLinkResolver() override
-    {
-        return &this->linkResolver;
-    }
-
-    ILogging *getChatLogger() override
-    {
-        return &this->logging;
-    }
-
-    mock::EmptyLogging logging;
-    AccountController accounts;
-    mock::Emotes emotes;
-    mock::UserDataController userData;
-    mock::MockTwitchIrcServer twitch;
-    mock::EmptyLinkResolver linkResolver;
-    ChatterinoBadges chatterinoBadges;
-    FfzBadges ffzBadges;
-    SeventvBadges seventvBadges;
-    HighlightController highlights;
-    TwitchBadges twitchBadges;
-    BttvEmotes bttvEmotes;
-    FfzEmotes ffzEmotes;
-    SeventvEmotes seventvEmotes;
-    DisabledStreamerMode streamerMode;
-};
-
-std::optional<QJsonDocument> tryReadJsonFile(const QString &path)
-{
-    QFile file(path);
-    if (!file.open(QFile::ReadOnly))
-    {
-        return std::nullopt;
-    }
-
-    QJsonParseError e;
-    auto doc = QJsonDocument::fromJson(file.readAll(), &e);
-    if (e.error != QJsonParseError::NoError)
-    {
-        return std::nullopt;
-    }
-
-    return doc;
-}
-
-QJsonDocument readJsonFile(const QString &path)
-{
-    auto opt = tryReadJsonFile(path);
-    if (!opt)
-    {
-        _exit(1);
-    }
-    return *opt;
-}
-
-class RecentMessages
-{
-public:
-    explicit RecentMessages(const QString &name_)
-        : name(name_)
-        , chan(this->name)
-    {
-        const auto seventvEmotes =
-            tryReadJsonFile(u":/bench/seventvemotes-%1.json"_s.arg(this->name));
-        const auto bttvEmotes =
-            tryReadJsonFile(u":/bench/bttvemotes-%1.json"_s.arg(this->name));
-        const auto ffzEmotes =
-            tryReadJsonFile(u":/bench/ffzemotes-%1.json"_s.arg(this->name));
-
-        if (seventvEmotes)
-        {
-            this->chan.setSeventvEmotes(
-                std::make_shared<const EmoteMap>(seventv::detail::parseEmotes(
-                    seventvEmotes->object()["emote_set"_L1]
-                        .toObject()["emotes"_L1]
-                        .toArray(),
-                    false)));
-        }
-
-        if (bttvEmotes)
-        {
-            this->chan.setBttvEmotes(std::make_shared<const EmoteMap>(
-                bttv::detail::parseChannelEmotes(bttvEmotes->object(),
-                                                 this->name)));
-        }
-
-        if (ffzEmotes)
-        {
-            this->chan.setFfzEmotes(std::make_shared<const EmoteMap>(
-                ffz::detail::parseChannelEmotes(ffzEmotes->object())));
-        }
-
-        this->messages =
-            readJsonFile(u":/bench/recentmessages-%1.json"_s.arg(this->name));
-    }
-
-    ~RecentMessages()
-    {
-        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
-    }
+    using bench::RecentMessages::RecentMessages;
 
     virtual void run(benchmark::State &state) = 0;
-
-protected:
-    QString name;
-    MockApplication app;
-    TwitchChannel chan;
-    QJsonDocument messages;
 };
 
 class ParseRecentMessages : public RecentMessages
@@ -256,6 +67,93 @@ public:
     }
 };
 
+/// Loads the recent messages of `state.range(0)` channels at once, like
+/// opening a layout. With `state.range(1)` threads, the chunks of all
+/// channels are prepared in parallel and finished in order per channel. With
+/// no threads, every channel is parsed and built serially.
+class BackfillChannels : public RecentMessages
+{
+public:
+    explicit BackfillChannels(const QString &name_)
+        : RecentMessages(name_)
+    {
+    }
+
+    void run(benchmark::State &state)
+    {
+        auto channelCount = static_cast<size_t>(state.range(0));
+        auto threadCount = static_cast<int>(state.range(1));
+
+        std::vector<std::shared_ptr<TwitchChannel>> channels;
+        for (size_t i = 0; i < channelCount; i++)
+        {
+            auto channel = std::make_shared<TwitchChannel>(this->name);
+            channel->setSeventvEmotes(this->chan.seventvEmotes());
+            channel->setBttvEmotes(this->chan.bttvEmotes());
+            channel->setFfzEmotes(this->chan.ffzEmotes());
+            channels.emplace_back(std::move(channel));
+        }
+
+        QThreadPool pool;
+        pool.setMaxThreadCount(std::max(threadCount, 1));
+
+        for (auto _ : state)
+        {
+            if (threadCount == 0)
+            {
+                for (const auto &channel : channels)
+                {
+                    auto parsed = recentmessages::detail::parseRecentMessages(
+                        this->messages.object());
+                    auto built = recentmessages::detail::buildRecentMessages(
+                        parsed, channel.get());
+                    benchmark::DoNotOptimize(built);
+                }
+                continue;
+            }
+
+            // (channel, chunk) pairs
+            std::vector<std::pair<TwitchChannel *, std::vector<QByteArray>>>
+                jobs;
+            for (const auto &channel : channels)
+            {
+                for (auto &chunk : recentmessages::detail::splitRecentMessages(
+                         this->messages.object()))
+                {
+                    jobs.emplace_back(channel.get(), std::move(chunk));
+                }
+            }
+
+            auto prepared = QtConcurrent::blockingMapped<
+                std::vector<recentmessages::detail::PreparedRecentMessages>>(
+                &pool, jobs, [](const auto &job) {
+                    return recentmessages::detail::prepareRecentMessages(
+                        job.second, job.first);
+                });
+
+            // the jobs of a channel are next to each other
+            size_t job = 0;
+            for (const auto &channel : channels)
+            {
+                VectorMessageSink sink({}, MessageFlag::RecentMessage);
+                for (; job < jobs.size() && jobs[job].first == channel.get();
+                     job++)
+                {
+                    recentmessages::detail::finishRecentMessages(
+                        prepared[job], sink, channel.get());
+                }
+                auto built = std::move(sink).takeMessages();
+                benchmark::DoNotOptimize(built);
+            }
+        }
+
+        state.SetItemsProcessed(
+            static_cast<int64_t>(state.iterations()) *
+            static_cast<int64_t>(channelCount) *
+            this->messages.object()["messages"_L1].toArray().size());
+    }
+};
+
 void BM_ParseRecentMessages(benchmark::State &state, const QString &name)
 {
     ParseRecentMessages bench(name);
@@ -268,7 +166,17 @@ void BM_BuildRecentMessages(benchmark::State &state, const QString &name)
     bench.run(state);
 }
 
+void BM_BackfillChannels(benchmark::State &state, const QString &name)
+{
+    BackfillChannels bench(name);
+    bench.run(state);
+}
+
 }  // namespace
 
 BENCHMARK_CAPTURE(BM_ParseRecentMessages, nymn, u"nymn"_s);
 BENCHMARK_CAPTURE(BM_BuildRecentMessages, nymn, u"nymn"_s);
+BENCHMARK_CAPTURE(BM_BackfillChannels, nymn, u"nymn"_s)
+    ->ArgsProduct({{1, 10, 100}, {0, 1, 4, 8}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
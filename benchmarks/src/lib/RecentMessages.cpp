@@ -0,0 +1,93 @@
+#include "lib/RecentMessages.hpp"
+
+#include "common/Literals.hpp"
+#include "messages/Emote.hpp"
+#include "providers/recentmessages/Impl.hpp"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+
+namespace chatterino::bench {
+
+using namespace literals;
+
+std::optional<QJsonDocument> tryReadJsonFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly))
+    {
+        return std::nullopt;
+    }
+
+    QJsonParseError e;
+    auto doc = QJsonDocument::fromJson(file.readAll(), &e);
+    if (e.error != QJsonParseError::NoError)
+    {
+        return std::nullopt;
+    }
+
+    return doc;
+}
+
+QJsonDocument readJsonFile(const QString &path)
+{
+    auto opt = tryReadJsonFile(path);
+    if (!opt)
+    {
+        _exit(1);
+    }
+    return *opt;
+}
+
+RecentMessages::RecentMessages(const QString &name_)
+    : name(name_)
+    , chan(this->name)
+{
+    const auto seventvEmotes =
+        tryReadJsonFile(u":/bench/seventvemotes-%1.json"_s.arg(this->name));
+    const auto bttvEmotes =
+        tryReadJsonFile(u":/bench/bttvemotes-%1.json"_s.arg(this->name));
+    const auto ffzEmotes =
+        tryReadJsonFile(u":/bench/ffzemotes-%1.json"_s.arg(this->name));
+
+    if (seventvEmotes)
+    {
+        this->chan.setSeventvEmotes(
+            std::make_shared<const EmoteMap>(seventv::detail::parseEmotes(
+                seventvEmotes->object()["emote_set"_L1]
+                    .toObject()["emotes"_L1]
+                    .toArray(),
+                false)));
+    }
+
+    if (bttvEmotes)
+    {
+        this->chan.setBttvEmotes(std::make_shared<const EmoteMap>(
+            bttv::detail::parseChannelEmotes(bttvEmotes->object(),
+                                             this->name)));
+    }
+
+    if (ffzEmotes)
+    {
+        this->chan.setFfzEmotes(std::make_shared<const EmoteMap>(
+            ffz::detail::parseChannelEmotes(ffzEmotes->object())));
+    }
+
+    this->messages =
+        readJsonFile(u":/bench/recentmessages-%1.json"_s.arg(this->name));
+}
+
+RecentMessages::~RecentMessages()
+{
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+}
+
+std::vector<MessagePtr> RecentMessages::buildMessages()
+{
+    auto parsed =
+        recentmessages::detail::parseRecentMessages(this->messages.object());
+    return recentmessages::detail::buildRecentMessages(parsed, &this->chan);
+}
+
+}  // namespace chatterino::bench
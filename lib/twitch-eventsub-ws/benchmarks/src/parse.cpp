@@ -1,15 +1,51 @@
 #include "twitch-eventsub-ws/listener.hpp"
+#include "twitch-eventsub-ws/messages/metadata.hpp"
 #include "twitch-eventsub-ws/session.hpp"
 
 #include <benchmark/benchmark.h>
+#include <boost/beast/core/buffers_to_string.hpp>
 #include <boost/beast/core/flat_buffer.hpp>
 #include <QFile>
 
+#include <array>
+#include <atomic>
+#include <cstdlib>
 #include <memory>
+#include <new>
+
+namespace {
+
+// Counts the allocations made through the global operator new, so the
+// benchmarks can report how many allocations each message needs.
+std::atomic<size_t> allocationCount{0};
+
+}  // namespace
+
+void *operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size == 0 ? 1 : size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t /* size */) noexcept
+{
+    std::free(ptr);
+}
 
 namespace {
 
 using namespace chatterino::eventsub::lib;
+// `messages` is used for the benchmark input below
+using Metadata = messages::Metadata;
 
 std::vector<boost::beast::flat_buffer> readMessages()
 {
@@ -166,6 +202,86 @@ public:
     // NOLINTEND(cppcoreguidelines-pro-type-const-cast)
 };
 
+size_t totalSize(const std::vector<boost::beast::flat_buffer> &messages)
+{
+    size_t size = 0;
+    for (const auto &msg : messages)
+    {
+        size += msg.size();
+    }
+    return size;
+}
+
+/// Reports the throughput and the allocations per message
+void setCounters(benchmark::State &state,
+                 const std::vector<boost::beast::flat_buffer> &messages,
+                 size_t allocations)
+{
+    auto processed = static_cast<int64_t>(state.iterations()) *
+                     static_cast<int64_t>(messages.size());
+    state.SetItemsProcessed(processed);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(totalSize(messages)));
+    state.counters["allocs/msg"] = benchmark::Counter(
+        static_cast<double>(allocations) / static_cast<double>(processed));
+}
+
+/// Copies every message into a string and parses it into a new value
+/// (like the session did before it reused its parser)
+void BM_ParseCopy(benchmark::State &state)
+{
+    auto messages = readMessages();
+
+    size_t before = allocationCount.load(std::memory_order_relaxed);
+    for (auto _ : state)
+    {
+        for (const auto &msg : messages)
+        {
+            boost::system::error_code ec;
+            auto jv = boost::json::parse(
+                boost::beast::buffers_to_string(msg.data()), ec);
+            assert(!ec);
+            auto metadata = boost::json::try_value_to<Metadata>(
+                jv.at("metadata"));
+            benchmark::DoNotOptimize(metadata);
+        }
+    }
+    setCounters(state, messages,
+                allocationCount.load(std::memory_order_relaxed) - before);
+}
+
+/// Parses every message directly from its buffer with one parser, reusing
+/// the memory of the previous message
+void BM_ParseReuse(benchmark::State &state)
+{
+    auto messages = readMessages();
+    std::array<unsigned char, 16384> buffer{};
+    boost::json::monotonic_resource resource(buffer.data(), buffer.size());
+    boost::json::parser parser;
+
+    size_t before = allocationCount.load(std::memory_order_relaxed);
+    for (auto _ : state)
+    {
+        for (const auto &msg : messages)
+        {
+            resource.release();
+            parser.reset(boost::json::storage_ptr(&resource));
+
+            boost::system::error_code ec;
+            auto data = msg.cdata();
+            parser.write(static_cast<const char *>(data.data()), data.size(),
+                         ec);
+            assert(!ec);
+            auto jv = parser.release();
+            auto metadata = boost::json::try_value_to<Metadata>(
+                jv.at("metadata"));
+            benchmark::DoNotOptimize(metadata);
+        }
+    }
+    setCounters(state, messages,
+                allocationCount.load(std::memory_order_relaxed) - before);
+}
+
 void BM_ParseAndHandleMessages(benchmark::State &state)
 {
     auto messages = readMessages();
@@ -176,6 +292,7 @@ void BM_ParseAndHandleMessages(benchmark::State &state)
         boost::asio::ssl::context::method::tls_client);
     auto sess = std::make_shared<Session>(ioc, ssl, std::move(listener));
 
+    size_t before = allocationCount.load(std::memory_order_relaxed);
     for (auto _ : state)
     {
         for (const auto &msg : messages)
@@ -184,8 +301,12 @@ void BM_ParseAndHandleMessages(benchmark::State &state)
             assert(!ec);
         }
     }
+    setCounters(state, messages,
+                allocationCount.load(std::memory_order_relaxed) - before);
 }
 
 }  // namespace
 
+BENCHMARK(BM_ParseCopy);
+BENCHMARK(BM_ParseReuse);
 BENCHMARK(BM_ParseAndHandleMessages);
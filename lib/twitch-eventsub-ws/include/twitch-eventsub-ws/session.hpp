@@ -7,6 +7,8 @@
 #include <boost/beast/websocket/ssl.hpp>
 #include <boost/json.hpp>
 
+#include <array>
+
 namespace chatterino::eventsub::lib::messages {
 
 struct Metadata;
@@ -34,6 +36,8 @@ public:
     Listener *getListener();
 
     // public for testing
+    // The JSON values passed to the listener are only valid during the call,
+    // their memory is reused for the next message.
     boost::system::error_code handleMessage(
         const boost::beast::flat_buffer &buffer);
 
@@ -68,6 +72,14 @@ private:
         boost::beast::ssl_stream<boost::beast::tcp_stream>>
         ws;
     boost::beast::flat_buffer buffer;
+
+    // Received messages are parsed into jsonBuffer, so most messages are
+    // parsed without any allocations. Larger messages allocate blocks that
+    // are freed when the next message is parsed.
+    std::array<unsigned char, 16384> jsonBuffer{};
+    boost::json::monotonic_resource jsonResource;
+    boost::json::parser jsonParser;
+
     std::string host;
     std::string port;
     std::string path;
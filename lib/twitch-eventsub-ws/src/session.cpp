@@ -233,6 +233,7 @@ Session::Session(boost::asio::io_context &ioc, boost::asio::ssl::context &ctx,
                  std::unique_ptr<Listener> listener)
     : resolver(boost::asio::make_strand(ioc))
     , ws(boost::asio::make_strand(ioc), ctx)
+    , jsonResource(this->jsonBuffer.data(), this->jsonBuffer.size())
     , listener(std::move(listener))
 {
 }
@@ -433,14 +434,21 @@ void Session::fail(beast::error_code ec, std::string_view op)
 boost::system::error_code Session::handleMessage(
     const beast::flat_buffer &buffer)
 {
+    // The value of the previous message was destroyed, so its memory can be
+    // reused. The message is parsed directly from the buffer without copying.
+    this->jsonResource.release();
+    this->jsonParser.reset(boost::json::storage_ptr(&this->jsonResource));
+
     boost::system::error_code parseError;
-    auto jv =
-        boost::json::parse(beast::buffers_to_string(buffer.data()), parseError);
+    auto data = buffer.cdata();
+    this->jsonParser.write(static_cast<const char *>(data.data()), data.size(),
+                           parseError);
     if (parseError)
     {
         // TODO: wrap error?
         return parseError;
     }
+    auto jv = this->jsonParser.release();
 
     const auto *jvObject = jv.if_object();
     if (jvObject == nullptr)
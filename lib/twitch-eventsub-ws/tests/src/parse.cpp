@@ -165,3 +165,39 @@ TEST_P(TestHandleMessageP, Run)
 
 INSTANTIATE_TEST_SUITE_P(HandleMessage, TestHandleMessageP,
                          testing::ValuesIn(discover()));
+
+TEST(HandleMessage, ReuseSession)
+{
+    std::unique_ptr<Listener> listener = std::make_unique<NoOpListener>();
+    boost::asio::io_context ioc;
+    boost::asio::ssl::context ssl(
+        boost::asio::ssl::context::method::tls_client);
+    auto sess = std::make_shared<Session>(ioc, ssl, std::move(listener));
+
+    // the memory of a message is reused for the next one
+    for (int i = 0; i < 2; i++)
+    {
+        for (const auto &name : discover())
+        {
+            if (name == "session-welcome")
+            {
+                // starts the keepalive timer, which can only happen once
+                continue;
+            }
+            auto buf = readToFlatBuffer(filePath(name + ".json"));
+            auto ec = sess->handleMessage(buf);
+            ASSERT_FALSE(ec.failed()) << name << ": " << ec.message();
+        }
+    }
+
+    // a malformed message doesn't affect the following messages
+    std::string_view truncated = R"({"metadata": {"message_id")";
+    boost::beast::flat_buffer malformed;
+    auto inner = malformed.prepare(truncated.size());
+    std::memcpy(inner.data(), truncated.data(), inner.size());
+    malformed.commit(inner.size());
+    ASSERT_TRUE(sess->handleMessage(malformed).failed());
+
+    auto buf = readToFlatBuffer(filePath("channel.chat.message.json"));
+    ASSERT_FALSE(sess->handleMessage(buf).failed());
+}
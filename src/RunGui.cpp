@@ -3,8 +3,11 @@
 #include "Application.hpp"
 #include "common/Args.hpp"
 #include "common/Modes.hpp"
+#include "common/network/NetworkCache.hpp"
 #include "common/network/NetworkManager.hpp"
 #include "common/QLogging.hpp"
+#include "messages/ImageFrameCache.hpp"
+#include "messages/ScrollbackArchive.hpp"
 #include "singletons/CrashHandler.hpp"
 #include "singletons/Paths.hpp"
 #include "singletons/Resources.hpp"
@@ -275,9 +278,26 @@ void runGui(QApplication &a, const Paths &paths, Settings &settings,
         std::ignore = QtConcurrent::run([crashDirectory] {
             clearCrashes(crashDirectory);
         });
+        std::ignore = QtConcurrent::run([cachePath] {
+            ScrollbackArchive::removeStale(
+                combinePath(cachePath, "Scrollback"));
+        });
+        if (auto *frameCache = ImageFrameCache::instance())
+        {
+            std::ignore = QtConcurrent::run([frameCache] {
+                frameCache->evict();
+            });
+        }
+        if (auto *networkCache = NetworkCache::instance())
+        {
+            std::ignore = QtConcurrent::run([networkCache] {
+                networkCache->evict();
+            });
+        }
     });
 
     chatterino::NetworkManager::init();
+    NetworkCache::init(paths.cacheDirectory());
     updates.checkForUpdates();
 
     Application app(settings, paths, args, updates);
@@ -289,6 +309,8 @@ void runGui(QApplication &a, const Paths &paths, Settings &settings,
 
     chatterino::NetworkManager::deinit();
 
+    NetworkCache::deinit();
+
 #ifdef USEWINSDK
     // flushing windows clipboard to keep copied messages
     flushClipboard();
@@ -2,7 +2,7 @@
 
 #include "common/enums/MessageContext.hpp"
 #include "controllers/completion/TabCompletionModel.hpp"
-#include "messages/LimitedQueue.hpp"
+#include "messages/ChunkedLimitedQueue.hpp"
 #include "messages/MessageFlag.hpp"
 #include "messages/MessageSink.hpp"
 
@@ -139,7 +139,7 @@ protected:
 
 private:
     const QString name_;
-    LimitedQueue<MessagePtr> messages_;
+    ChunkedLimitedQueue<MessagePtr> messages_;
     Type type_;
     bool anythingLogged_ = false;
     QTimer clearCompletionModelTimer_;
@@ -2,16 +2,22 @@
 
 #include "debug/Benchmark.hpp"
 
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
 namespace chatterino {
 
-ChatterSet::ChatterSet()
-    : items(ChatterSet::CHATTER_LIMIT)
+ChatterSet::ChatterSet(size_t limit)
+    : limit_(limit)
+    , items(limit)
 {
+    assert(limit > 0);
 }
 
 void ChatterSet::addRecentChatter(const QString &userName)
 {
-    this->items.put(userName.toLower(), userName);
+    this->put(userName.toLower(), userName);
 }
 
 void ChatterSet::updateOnlineChatters(
@@ -19,24 +25,25 @@ void ChatterSet::updateOnlineChatters(
 {
     BenchmarkGuard bench("update online chatters");
 
-    // Create a new lru cache without the users that are not present anymore.
-    cache::lru_cache<QString, QString> tmp(ChatterSet::CHATTER_LIMIT);
+    // Create a new set without the users that are not present anymore.
+    ChatterSet tmp(this->limit_);
 
     for (auto &&chatter : lowerCaseUsernames)
     {
-        if (this->items.exists(chatter))
+        auto it = this->index_.find(chatter);
+        if (it != this->index_.end())
         {
-            tmp.put(chatter, this->items.get(chatter));
+            tmp.put(chatter, it->second.userName);
 
             // Less chatters than the limit => try to preserve as many as possible.
         }
-        else if (lowerCaseUsernames.size() < ChatterSet::CHATTER_LIMIT)
+        else if (lowerCaseUsernames.size() < this->limit_)
         {
             tmp.put(chatter, chatter);
         }
     }
 
-    this->items = std::move(tmp);
+    *this = std::move(tmp);
 }
 
 bool ChatterSet::contains(const QString &userName) const
@@ -44,19 +51,29 @@ bool ChatterSet::contains(const QString &userName) const
     return this->items.exists(userName.toLower());
 }
 
-std::vector<QString> ChatterSet::filterByPrefix(const QString &prefix) const
+std::vector<std::pair<QString, QString>> ChatterSet::filterByPrefix(
+    const QString &prefix) const
 {
     QString lowerPrefix = prefix.toLower();
-    std::vector<QString> result;
 
-    for (auto &&item : this->items)
+    std::vector<std::map<QString, Chatter>::const_iterator> matches;
+    for (auto it = this->index_.lower_bound(lowerPrefix);
+         it != this->index_.end() && it->first.startsWith(lowerPrefix); it++)
     {
-        if (item.first.startsWith(lowerPrefix))
-        {
-            result.push_back(item.second);
-        }
+        matches.push_back(it);
     }
 
+    // same order as the cache
+    std::ranges::sort(matches, [](const auto &a, const auto &b) {
+        return a->second.order > b->second.order;
+    });
+
+    std::vector<std::pair<QString, QString>> result;
+    result.reserve(matches.size());
+    for (const auto &it : matches)
+    {
+        result.emplace_back(it->first, it->second.userName);
+    }
     return result;
 }
 
@@ -65,4 +82,18 @@ std::vector<std::pair<QString, QString>> ChatterSet::all() const
     return {this->items.begin(), this->items.end()};
 }
 
+void ChatterSet::put(const QString &lowerCaseName, const QString &userName)
+{
+    if (this->items.size() >= this->limit_ &&
+        !this->items.exists(lowerCaseName))
+    {
+        // the cache evicts its last chatter when a new one is added
+        this->index_.erase(std::prev(this->items.end())->first);
+    }
+
+    this->items.put(lowerCaseName, userName);
+    this->index_.insert_or_assign(lowerCaseName,
+                                  Chatter{userName, this->nextOrder_++});
+}
+
 }  // namespace chatterino
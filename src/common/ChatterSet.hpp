@@ -5,7 +5,10 @@
 #include <lrucache/lrucache.hpp>
 #include <QString>
 
+#include <cstdint>
+#include <map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace chatterino {
@@ -18,7 +21,7 @@ public:
     /// The limit of how many chatters can be saved for a channel.
     static constexpr size_t CHATTER_LIMIT = 2000;
 
-    ChatterSet();
+    explicit ChatterSet(size_t limit = CHATTER_LIMIT);
 
     /// Inserts a user name if it isn't contained. Doesn't replace the original
     /// if the casing hasn't changed.
@@ -32,17 +35,35 @@ public:
     /// Checks if a username is in the list.
     bool contains(const QString &userName) const;
 
-    /// Get filtered usernames by a prefix for autocompletion. Contained items
-    /// are in mixed case if available.
-    std::vector<QString> filterByPrefix(const QString &prefix) const;
+    /// Get the chatters whose name starts with `prefix` (case-insensitive),
+    /// the most recent chatters first. Like in all(), the first pair element
+    /// is the username in lowercase and the second one the original case.
+    std::vector<std::pair<QString, QString>> filterByPrefix(
+        const QString &prefix) const;
 
     /// Get all recent chatters. The first pair element contains the username
     /// in lowercase, while the second pair element is the original case.
     std::vector<std::pair<QString, QString>> all() const;
 
 private:
+    struct Chatter {
+        /// The user name in normal case
+        QString userName;
+        /// Chatters that were added later have a higher order
+        uint64_t order = 0;
+    };
+
+    /// Adds a chatter to the cache and the index, evicting the least recent
+    /// chatter if the limit is reached.
+    void put(const QString &lowerCaseName, const QString &userName);
+
+    size_t limit_;
     // user name in lower case -> user name in normal case
     cache::lru_cache<QString, QString> items;
+    /// The chatters in `items`, sorted by their lower case name. Chatters
+    /// starting with a prefix are next to each other in here.
+    std::map<QString, Chatter> index_;
+    uint64_t nextOrder_ = 0;
 };
 
 using ChatterSet = ChatterSet;
@@ -0,0 +1,540 @@
+#include "common/network/NetworkCache.hpp"
+
+#include "common/QLogging.hpp"
+#include "singletons/Settings.hpp"
+#include "util/CombinePath.hpp"
+#include "util/DebugCount.hpp"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <unordered_set>
+
+namespace {
+
+/// "C2HC" in little endian
+constexpr quint32 MAGIC = 0x43483243;
+constexpr quint32 VERSION = 1;
+
+const QString INDEX_FILE = QStringLiteral("index");
+
+std::unique_ptr<chatterino::NetworkCache> INSTANCE;
+
+}  // namespace
+
+namespace chatterino {
+
+bool NetworkCacheEntry::isFresh() const
+{
+    return QDateTime::currentDateTimeUtc() < this->freshUntil;
+}
+
+bool NetworkCacheEntry::canRevalidate() const
+{
+    return !this->etag.isEmpty() || !this->lastModified.isEmpty();
+}
+
+NetworkCache::NetworkCache(QString directory, int64_t maxBytes)
+    : directory_(std::move(directory))
+    , maxBytes_(maxBytes)
+{
+    this->loadIndex();
+
+    this->flushTimer_.setSingleShot(true);
+    this->flushTimer_.setInterval(FLUSH_INTERVAL);
+    QObject::connect(&this->flushTimer_, &QTimer::timeout, &this->flushTimer_,
+                     [this] {
+                         std::lock_guard lock(this->mutex_);
+                         this->flushTimerArmed_ = false;
+                         this->startFlushLocked();
+                     });
+}
+
+NetworkCache::~NetworkCache()
+{
+    this->flushTimer_.stop();
+    this->flushFuture_.waitForFinished();
+    this->flush();
+}
+
+void NetworkCache::init(const QString &cacheDirectory)
+{
+    assert(!INSTANCE);
+
+    auto maxMiB = getSettings()->networkCacheSize.getValue();
+    INSTANCE = std::make_unique<NetworkCache>(
+        combinePath(cacheDirectory, "Http"),
+        int64_t{std::max(maxMiB, 0)} * 1024 * 1024);
+}
+
+void NetworkCache::deinit()
+{
+    INSTANCE.reset();
+}
+
+NetworkCache *NetworkCache::instance()
+{
+    if (!INSTANCE)
+    {
+        return nullptr;
+    }
+
+    auto maxMiB = getSettings()->networkCacheSize.getValue();
+    if (maxMiB <= 0)
+    {
+        return nullptr;
+    }
+
+    INSTANCE->setMaxBytes(int64_t{maxMiB} * 1024 * 1024);
+    return INSTANCE.get();
+}
+
+QString NetworkCache::filePath(const QString &key) const
+{
+    return combinePath(this->directory_, key);
+}
+
+std::optional<NetworkCacheEntry> NetworkCache::read(const QString &key)
+{
+    NetworkCacheEntry entry;
+    {
+        std::lock_guard lock(this->mutex_);
+        auto it = this->index_.find(key);
+        if (it == this->index_.end())
+        {
+            return std::nullopt;
+        }
+
+        auto &record = *it->second;
+        record.lastAccess = QDateTime::currentDateTimeUtc();
+        this->records_.splice(this->records_.begin(), this->records_,
+                              it->second);
+        this->dirty_ = true;
+
+        entry.etag = record.etag;
+        entry.lastModified = record.lastModified;
+        entry.freshUntil = record.freshUntil;
+
+        auto pending = this->pending_.find(key);
+        if (pending != this->pending_.end())
+        {
+            entry.data = pending->second;
+            DebugCount::increase("http cache hits");
+            return entry;
+        }
+    }
+
+    QFile file(this->filePath(key));
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        // the file was removed behind our back
+        std::lock_guard lock(this->mutex_);
+        auto it = this->index_.find(key);
+        if (it != this->index_.end() && !this->pending_.contains(key))
+        {
+            this->totalBytes_ -= it->second->size;
+            this->records_.erase(it->second);
+            this->index_.erase(it);
+            this->dirty_ = true;
+        }
+        return std::nullopt;
+    }
+
+    entry.data = file.readAll();
+    DebugCount::increase("http cache hits");
+    return entry;
+}
+
+void NetworkCache::write(const QString &key, NetworkCacheEntry entry)
+{
+    std::lock_guard lock(this->mutex_);
+
+    auto size = static_cast<int64_t>(entry.data.size());
+    auto it = this->index_.find(key);
+    if (size > this->maxBytes_)
+    {
+        // the stored response is outdated, but the new one doesn't fit
+        if (it != this->index_.end())
+        {
+            this->removeLocked(it->second);
+        }
+        return;
+    }
+
+    if (it != this->index_.end())
+    {
+        this->totalBytes_ -= it->second->size;
+        this->records_.erase(it->second);
+        this->index_.erase(it);
+    }
+
+    this->records_.push_front({
+        .key = key,
+        .size = size,
+        .lastAccess = QDateTime::currentDateTimeUtc(),
+        .freshUntil = entry.freshUntil,
+        .etag = std::move(entry.etag),
+        .lastModified = std::move(entry.lastModified),
+    });
+    this->index_[key] = this->records_.begin();
+    this->totalBytes_ += size;
+
+    auto &pending = this->pending_[key];
+    this->pendingBytes_ += size - pending.size();
+    pending = std::move(entry.data);
+    this->dirty_ = true;
+
+    this->evictLocked();
+    this->scheduleFlush();
+}
+
+void NetworkCache::refresh(const QString &key, const QDateTime &freshUntil)
+{
+    std::lock_guard lock(this->mutex_);
+    auto it = this->index_.find(key);
+    if (it == this->index_.end())
+    {
+        return;
+    }
+
+    it->second->freshUntil = freshUntil;
+    it->second->lastAccess = QDateTime::currentDateTimeUtc();
+    this->records_.splice(this->records_.begin(), this->records_, it->second);
+    this->dirty_ = true;
+}
+
+void NetworkCache::flush()
+{
+    std::lock_guard flushLock(this->flushMutex_);
+
+    std::unordered_map<QString, QByteArray> pending;
+    std::vector<QString> removed;
+    {
+        std::lock_guard lock(this->mutex_);
+        if (!this->dirty_ && this->removed_.empty())
+        {
+            return;
+        }
+        // the responses stay pending until they're written, so reads can
+        // still find them
+        pending = this->pending_;
+        removed = std::move(this->removed_);
+        this->removed_.clear();
+    }
+
+    for (const auto &key : removed)
+    {
+        QFile::remove(this->filePath(key));
+    }
+
+    QDir().mkpath(this->directory_);
+    std::vector<QString> written;
+    written.reserve(pending.size());
+    for (const auto &[key, data] : pending)
+    {
+        QSaveFile file(this->filePath(key));
+        if (!file.open(QIODevice::WriteOnly))
+        {
+            qCWarning(chatterinoCache)
+                << "Failed to open network cache file" << file.fileName();
+            continue;
+        }
+        file.write(data);
+        if (!file.commit())
+        {
+            qCWarning(chatterinoCache)
+                << "Failed to write network cache file" << file.fileName()
+                << ':' << file.errorString();
+            continue;
+        }
+        written.push_back(key);
+    }
+    DebugCount::increase("http cache writes",
+                         static_cast<int64_t>(written.size()));
+
+    QByteArray index;
+    std::vector<QString> orphans;
+    {
+        std::lock_guard lock(this->mutex_);
+        for (const auto &key : written)
+        {
+            auto it = this->pending_.find(key);
+            // only remove the response if it wasn't replaced in the meantime
+            if (it != this->pending_.end() &&
+                it->second.constData() == pending[key].constData())
+            {
+                this->pendingBytes_ -= it->second.size();
+                this->pending_.erase(it);
+            }
+            if (!this->index_.contains(key))
+            {
+                // the response was removed while it was written
+                orphans.push_back(key);
+            }
+        }
+        // responses written in the meantime wait for the next flush
+        this->scheduleFlush();
+
+        index = this->serializeIndex();
+        this->dirty_ = false;
+    }
+
+    for (const auto &key : orphans)
+    {
+        QFile::remove(this->filePath(key));
+    }
+
+    QSaveFile file(this->filePath(INDEX_FILE));
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qCWarning(chatterinoCache)
+            << "Failed to open network cache index" << file.fileName();
+        return;
+    }
+    file.write(index);
+    if (!file.commit())
+    {
+        qCWarning(chatterinoCache)
+            << "Failed to write network cache index" << file.fileName() << ':'
+            << file.errorString();
+    }
+}
+
+size_t NetworkCache::evict()
+{
+    size_t removed = 0;
+    {
+        std::lock_guard flushLock(this->flushMutex_);
+
+        std::unordered_set<QString> known;
+        {
+            std::lock_guard lock(this->mutex_);
+            auto oldest =
+                QDateTime::currentDateTimeUtc().addSecs(-MAX_AGE.count());
+            while (!this->records_.empty() &&
+                   this->records_.back().lastAccess < oldest)
+            {
+                this->removeLastLocked();
+                removed++;
+            }
+            this->evictLocked();
+
+            // files of removed responses are deleted when flushing
+            known.reserve(this->index_.size() + this->removed_.size() + 1);
+            for (const auto &[key, _] : this->index_)
+            {
+                known.insert(key);
+            }
+            known.insert(this->removed_.begin(), this->removed_.end());
+            known.insert(INDEX_FILE);
+        }
+
+        // files of a crashed session or of an index that couldn't be saved
+        for (const auto &name :
+             QDir(this->directory_).entryList(QDir::Files | QDir::Hidden))
+        {
+            if (!known.contains(name) &&
+                QFile::remove(combinePath(this->directory_, name)))
+            {
+                removed++;
+            }
+        }
+    }
+
+    this->flush();
+
+    if (removed > 0)
+    {
+        qCDebug(chatterinoCache)
+            << "Removed" << removed << "files from" << this->directory_;
+    }
+    return removed;
+}
+
+void NetworkCache::setMaxBytes(int64_t maxBytes)
+{
+    std::lock_guard lock(this->mutex_);
+    if (this->maxBytes_ == maxBytes)
+    {
+        return;
+    }
+    this->maxBytes_ = maxBytes;
+    this->evictLocked();
+}
+
+size_t NetworkCache::size() const
+{
+    std::lock_guard lock(this->mutex_);
+    return this->index_.size();
+}
+
+int64_t NetworkCache::totalBytes() const
+{
+    std::lock_guard lock(this->mutex_);
+    return this->totalBytes_;
+}
+
+std::optional<QDateTime> NetworkCache::freshUntil(
+    const QByteArray &cacheControl, const QDateTime &now)
+{
+    auto until = now.addSecs(DEFAULT_FRESHNESS.count());
+    for (const auto &part : cacheControl.split(','))
+    {
+        auto directive = part.trimmed().toLower();
+        if (directive == "no-store")
+        {
+            return std::nullopt;
+        }
+        if (directive == "no-cache")
+        {
+            // must be revalidated every time
+            return now;
+        }
+        if (directive.startsWith("max-age="))
+        {
+            bool ok = false;
+            auto seconds = directive.mid(8).toLongLong(&ok);
+            if (ok && seconds >= 0)
+            {
+                until = now.addSecs(seconds);
+            }
+        }
+    }
+    return until;
+}
+
+void NetworkCache::loadIndex()
+{
+    QFile file(this->filePath(INDEX_FILE));
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 count = 0;
+    stream >> magic >> version >> count;
+    if (stream.status() != QDataStream::Ok || magic != MAGIC ||
+        version != VERSION)
+    {
+        qCDebug(chatterinoCache)
+            << "Ignoring broken network cache index" << file.fileName();
+        return;
+    }
+
+    for (quint32 i = 0; i < count; i++)
+    {
+        Record record;
+        qint64 size = 0;
+        stream >> record.key >> size >> record.lastAccess >>
+            record.freshUntil >> record.etag >> record.lastModified;
+        if (stream.status() != QDataStream::Ok)
+        {
+            qCDebug(chatterinoCache)
+                << "Network cache index is truncated" << file.fileName();
+            break;
+        }
+        if (size < 0 || this->index_.contains(record.key))
+        {
+            continue;
+        }
+
+        record.size = size;
+        this->totalBytes_ += size;
+        this->records_.push_back(std::move(record));
+        this->index_[this->records_.back().key] = std::prev(
+            this->records_.end());
+    }
+
+    this->evictLocked();
+}
+
+QByteArray NetworkCache::serializeIndex() const
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    stream << MAGIC << VERSION << static_cast<quint32>(this->records_.size());
+    for (const auto &record : this->records_)
+    {
+        stream << record.key << static_cast<qint64>(record.size)
+               << record.lastAccess << record.freshUntil << record.etag
+               << record.lastModified;
+    }
+    return data;
+}
+
+void NetworkCache::evictLocked()
+{
+    while (this->totalBytes_ > this->maxBytes_ && !this->records_.empty())
+    {
+        this->removeLastLocked();
+    }
+}
+
+void NetworkCache::removeLastLocked()
+{
+    this->removeLocked(std::prev(this->records_.end()));
+}
+
+void NetworkCache::removeLocked(RecordList::iterator record)
+{
+    if (this->pending_.erase(record->key) > 0)
+    {
+        this->pendingBytes_ -= record->size;
+    }
+    this->removed_.push_back(record->key);
+    this->totalBytes_ -= record->size;
+    this->index_.erase(record->key);
+    this->records_.erase(record);
+    this->dirty_ = true;
+}
+
+void NetworkCache::scheduleFlush()
+{
+    if (this->pending_.empty())
+    {
+        return;
+    }
+
+    if (this->pendingBytes_ >= FLUSH_BYTES && !this->flushFuture_.isRunning())
+    {
+        this->startFlushLocked();
+        return;
+    }
+
+    if (!this->flushTimerArmed_)
+    {
+        // writes come from the network thread, the timer lives in the
+        // thread that created the cache
+        this->flushTimerArmed_ = true;
+        QMetaObject::invokeMethod(&this->flushTimer_, [this] {
+            this->flushTimer_.start();
+        });
+    }
+}
+
+void NetworkCache::startFlushLocked()
+{
+    if (this->pending_.empty() || this->flushFuture_.isRunning())
+    {
+        return;
+    }
+
+    this->flushFuture_ = QtConcurrent::run([this] {
+        this->flush();
+    });
+}
+
+}  // namespace chatterino
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QFuture>
+#include <QString>
+#include <QTimer>
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace chatterino {
+
+struct NetworkCacheEntry {
+    QByteArray data;
+    /// Value of the ETag header of the response
+    QByteArray etag;
+    /// Value of the Last-Modified header of the response
+    QByteArray lastModified;
+    /// Until then, the response is used without asking the server
+    QDateTime freshUntil;
+
+    bool isFresh() const;
+    /// Whether the server can be asked if the response is still valid
+    bool canRevalidate() const;
+};
+
+/// Stores the responses of cached GET requests on disk.
+///
+/// Every response is stored in its own file, named after the hash of its
+/// request. An index of all responses (their size, last access and
+/// validators) is kept in memory and saved to the "index" file, so looking
+/// up a response that isn't cached doesn't touch the disk. Once the
+/// responses take up more than the maximum size, the least recently used
+/// ones are removed.
+///
+/// Writes are batched: new responses are kept in memory and written (together
+/// with the index) once enough of them piled up or after FLUSH_INTERVAL.
+class NetworkCache
+{
+public:
+    /// Responses are stored in `directory`, which is created when the first
+    /// response is written
+    NetworkCache(QString directory, int64_t maxBytes);
+    /// Writes all pending responses
+    ~NetworkCache();
+
+    NetworkCache(const NetworkCache &) = delete;
+    NetworkCache(NetworkCache &&) = delete;
+    NetworkCache &operator=(const NetworkCache &) = delete;
+    NetworkCache &operator=(NetworkCache &&) = delete;
+
+    /// Creates the cache used by NetworkRequest::cache() in the "Http"
+    /// directory of `cacheDirectory`
+    static void init(const QString &cacheDirectory);
+    /// Writes the pending responses and destroys the cache created by init()
+    static void deinit();
+
+    /// The cache created by init(), or nullptr if the cache is disabled (or
+    /// wasn't created).
+    static NetworkCache *instance();
+
+    /// Returns the response stored for `key`, or nothing if there's none
+    std::optional<NetworkCacheEntry> read(const QString &key);
+
+    /// Stores `entry` for `key`, replacing the stored response
+    void write(const QString &key, NetworkCacheEntry entry);
+
+    /// The server confirmed that the response for `key` is still valid
+    void refresh(const QString &key, const QDateTime &freshUntil);
+
+    /// Writes all pending responses and the index
+    void flush();
+
+    /// Removes responses that weren't used for MAX_AGE and files that
+    /// aren't part of the index. Returns the number of removed responses.
+    size_t evict();
+
+    void setMaxBytes(int64_t maxBytes);
+
+    /// Number of stored responses
+    size_t size() const;
+    /// Bytes used by all stored responses
+    int64_t totalBytes() const;
+
+    /// Returns until when a response received at `now` with the
+    /// `cacheControl` header is fresh, or nothing if it must not be stored
+    static std::optional<QDateTime> freshUntil(const QByteArray &cacheControl,
+                                               const QDateTime &now);
+
+    /// Responses without a max-age are used this long without asking the
+    /// server
+    static constexpr std::chrono::seconds DEFAULT_FRESHNESS =
+        std::chrono::hours(24);
+    /// Responses that weren't used for this long are removed
+    static constexpr std::chrono::seconds MAX_AGE = std::chrono::days(14);
+    /// Pending responses are written once they use this many bytes...
+    static constexpr int64_t FLUSH_BYTES = 1024 * 1024;
+    /// ...or once the oldest of them is this old
+    static constexpr std::chrono::seconds FLUSH_INTERVAL =
+        std::chrono::seconds(10);
+
+private:
+    struct Record {
+        QString key;
+        int64_t size = 0;
+        QDateTime lastAccess;
+        QDateTime freshUntil;
+        QByteArray etag;
+        QByteArray lastModified;
+    };
+    /// Most recently used first
+    using RecordList = std::list<Record>;
+
+    QString filePath(const QString &key) const;
+    void loadIndex();
+    QByteArray serializeIndex() const;
+    /// Removes the least recently used responses until all of them use at
+    /// most the maximum size
+    void evictLocked();
+    /// Removes the least recently used response
+    void removeLastLocked();
+    void removeLocked(RecordList::iterator record);
+    /// Flushes right away if enough bytes are pending, otherwise starts the
+    /// flush timer
+    void scheduleFlush();
+    void startFlushLocked();
+
+    const QString directory_;
+
+    mutable std::mutex mutex_;
+    int64_t maxBytes_;
+    int64_t totalBytes_ = 0;
+    RecordList records_;
+    std::unordered_map<QString, RecordList::iterator> index_;
+    /// Responses that weren't written yet
+    std::unordered_map<QString, QByteArray> pending_;
+    int64_t pendingBytes_ = 0;
+    /// Files of removed responses that weren't deleted yet
+    std::vector<QString> removed_;
+    /// Whether the index changed since it was saved
+    bool dirty_ = false;
+    QFuture<void> flushFuture_;
+    /// Started when the first response becomes pending
+    QTimer flushTimer_;
+    bool flushTimerArmed_ = false;
+
+    /// Held while flushing, so the files are written by one thread at a time
+    std::mutex flushMutex_;
+};
+
+}  // namespace chatterino
@@ -1,11 +1,10 @@
 #include "common/network/NetworkPrivate.hpp"
 
-#include "Application.hpp"
+#include "common/network/NetworkCache.hpp"
 #include "common/network/NetworkManager.hpp"
 #include "common/network/NetworkResult.hpp"
 #include "common/network/NetworkTask.hpp"
 #include "common/QLogging.hpp"
-#include "singletons/Paths.hpp"
 #include "util/AbandonObject.hpp"
 #include "util/DebugCount.hpp"
 #include "util/PostToThread.hpp"
@@ -14,7 +13,6 @@
 #include <magic_enum/magic_enum.hpp>
 #include <QCryptographicHash>
 #include <QElapsedTimer>
-#include <QFile>
 #include <QNetworkReply>
 #include <QtConcurrent>
 
@@ -59,23 +57,49 @@ void loadUncached(std::shared_ptr<NetworkData> &&data)
 
 void loadCached(std::shared_ptr<NetworkData> &&data)
 {
-    QFile cachedFile(getApp()->getPaths().cacheDirectory() + "/" +
-                     data->getHash());
+    if (data->cacheStore == nullptr)
+    {
+        data->cacheStore = NetworkCache::instance();
+    }
+    if (data->cacheStore == nullptr)
+    {
+        data->cache = false;
+        loadUncached(std::move(data));
+        return;
+    }
 
-    if (!cachedFile.exists() || !cachedFile.open(QIODevice::ReadOnly))
+    // the hash must be computed before any validator headers are added
+    auto entry = data->cacheStore->read(data->getHash());
+    if (!entry)
     {
         loadUncached(std::move(data));
         return;
     }
 
-    // XXX: check if bytes is empty?
-    QByteArray bytes = cachedFile.readAll();
+    if (!entry->isFresh())
+    {
+        if (entry->canRevalidate())
+        {
+            if (!entry->etag.isEmpty())
+            {
+                data->request.setRawHeader("If-None-Match", entry->etag);
+            }
+            if (!entry->lastModified.isEmpty())
+            {
+                data->request.setRawHeader("If-Modified-Since",
+                                           entry->lastModified);
+            }
+            data->revalidatedData = std::move(entry->data);
+        }
+        loadUncached(std::move(data));
+        return;
+    }
 
     qCDebug(chatterinoHTTP).noquote() << data->typeString() << "[CACHED] 200"
                                       << data->request.url().toString();
 
     data->emitSuccess(
-        {NetworkResult::NetworkError::NoError, QVariant(200), bytes});
+        {NetworkResult::NetworkError::NoError, QVariant(200), entry->data});
     data->emitFinally();
 }
 
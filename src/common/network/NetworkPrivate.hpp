@@ -15,7 +15,9 @@ class QNetworkReply;
 
 namespace chatterino {
 
+class NetworkCache;
 class NetworkResult;
+class NetworkScheduler;
 
 class NetworkRequester : public QObject
 {
@@ -39,7 +41,15 @@ public:
     bool hasCaller{};
     QPointer<QObject> caller;
     bool cache{};
+    /// The cache used for the response, NetworkCache::instance() if it's not
+    /// set
+    NetworkCache *cacheStore{};
+    /// The cached response that the server is asked about, if it's stale
+    std::optional<QByteArray> revalidatedData;
     bool executeConcurrently{};
+    /// The scheduler that decides when the request is loaded, the request is
+    /// loaded right away if it's not set
+    NetworkScheduler *scheduler{};
 
     NetworkSuccessCallback onSuccess;
     NetworkErrorCallback onError;
@@ -71,4 +81,15 @@ private:
 
 void load(std::shared_ptr<NetworkData> &&data);
 
+/// Decides when requests are loaded (e.g. to respect a rate limit).
+/// Schedulers eventually call load() for every scheduled request.
+class NetworkScheduler
+{
+public:
+    virtual ~NetworkScheduler() = default;
+
+    /// Called from NetworkRequest::execute() for requests using this scheduler
+    virtual void schedule(std::shared_ptr<NetworkData> &&data) = 0;
+};
+
 }  // namespace chatterino
@@ -10,6 +10,7 @@
 #include <QtConcurrent>
 
 #include <cassert>
+#include <utility>
 
 namespace chatterino {
 
@@ -53,6 +54,12 @@ NetworkRequest NetworkRequest::caller(const QObject *caller) &&
     return std::move(*this);
 }
 
+NetworkRequest NetworkRequest::scheduler(NetworkScheduler *scheduler) &&
+{
+    this->data->scheduler = scheduler;
+    return std::move(*this);
+}
+
 NetworkRequest NetworkRequest::onError(NetworkErrorCallback cb) &&
 {
     this->data->onError = std::move(cb);
@@ -164,6 +171,13 @@ NetworkRequest NetworkRequest::cache() &&
     return std::move(*this);
 }
 
+NetworkRequest NetworkRequest::cache(NetworkCache *store) &&
+{
+    this->data->cache = true;
+    this->data->cacheStore = store;
+    return std::move(*this);
+}
+
 void NetworkRequest::execute()
 {
     this->executed_ = true;
@@ -178,6 +192,13 @@ void NetworkRequest::execute()
     // Can not have a caller and be concurrent at the same time.
     assert(!(this->data->caller && this->data->executeConcurrently));
 
+    if (this->data->scheduler != nullptr)
+    {
+        auto *scheduler = std::exchange(this->data->scheduler, nullptr);
+        scheduler->schedule(std::move(this->data));
+        return;
+    }
+
     load(std::move(this->data));
 }
 
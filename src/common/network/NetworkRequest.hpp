@@ -12,7 +12,9 @@ class QJsonDocument;
 
 namespace chatterino {
 
+class NetworkCache;
 class NetworkData;
+class NetworkScheduler;
 
 class NetworkRequest final
 {
@@ -49,11 +51,16 @@ public:
 
     NetworkRequest payload(const QByteArray &payload) &&;
     NetworkRequest cache() &&;
+    /// Caches the response in `store` instead of NetworkCache::instance()
+    NetworkRequest cache(NetworkCache *store) &&;
     /// NetworkRequest makes sure that the `caller` object still exists when the
     /// callbacks are executed. Cannot be used with concurrent() since we can't
     /// make sure that the object doesn't get deleted while the callback is
     /// running.
     NetworkRequest caller(const QObject *caller) &&;
+    /// Passes the request to `scheduler` when it's executed instead of
+    /// sending it right away. The scheduler must outlive the request.
+    NetworkRequest scheduler(NetworkScheduler *scheduler) &&;
     NetworkRequest header(const char *headerName, const char *value) &&;
     NetworkRequest header(const char *headerName, const QByteArray &value) &&;
     NetworkRequest header(const char *headerName, const QString &value) &&;
@@ -10,8 +10,10 @@
 namespace chatterino {
 
 NetworkResult::NetworkResult(NetworkError error, const QVariant &httpStatusCode,
-                             QByteArray data)
+                             QByteArray data,
+                             QList<QNetworkReply::RawHeaderPair> headers)
     : data_(std::move(data))
+    , headers_(std::move(headers))
     , error_(error)
 {
     if (httpStatusCode.isValid())
@@ -65,6 +67,18 @@ const QByteArray &NetworkResult::getData() const
     return this->data_;
 }
 
+QByteArray NetworkResult::header(QByteArrayView name) const
+{
+    for (const auto &[key, value] : this->headers_)
+    {
+        if (name.compare(key, Qt::CaseInsensitive) == 0)
+        {
+            return value;
+        }
+    }
+    return {};
+}
+
 QString NetworkResult::formatError() const
 {
     // Print the status for errors that mirror HTTP status codes (=0 || >99)
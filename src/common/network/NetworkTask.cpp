@@ -1,17 +1,15 @@
 #include "common/network/NetworkTask.hpp"
 
-#include "Application.hpp"
+#include "common/network/NetworkCache.hpp"
 #include "common/network/NetworkManager.hpp"
 #include "common/network/NetworkPrivate.hpp"
 #include "common/network/NetworkResult.hpp"
 #include "common/QLogging.hpp"
-#include "singletons/Paths.hpp"
 #include "util/AbandonObject.hpp"
 #include "util/DebugCount.hpp"
 
-#include <QFile>
+#include <QDateTime>
 #include <QNetworkReply>
-#include <QtConcurrent>
 
 namespace chatterino::network::detail {
 
@@ -140,15 +138,47 @@ void NetworkTask::logReply()
 
 void NetworkTask::writeToCache(const QByteArray &bytes) const
 {
-    std::ignore = QtConcurrent::run([data = this->data_, bytes] {
-        QFile cachedFile(getApp()->getPaths().cacheDirectory() + "/" +
-                         data->getHash());
-
-        if (cachedFile.open(QIODevice::WriteOnly))
-        {
-            cachedFile.write(bytes);
-        }
-    });
+    auto *cache = this->data_->cacheStore;
+    if (cache == nullptr)
+    {
+        return;
+    }
+
+    auto freshUntil = NetworkCache::freshUntil(
+        this->reply_->rawHeader("Cache-Control"),
+        QDateTime::currentDateTimeUtc());
+    if (!freshUntil)
+    {
+        return;
+    }
+
+    // the response is only kept in memory until the cache writes its batch
+    cache->write(this->data_->getHash(),
+                 {
+                     .data = bytes,
+                     .etag = this->reply_->rawHeader("ETag"),
+                     .lastModified = this->reply_->rawHeader("Last-Modified"),
+                     .freshUntil = *freshUntil,
+                 });
+}
+
+void NetworkTask::finishRevalidated()
+{
+    auto now = QDateTime::currentDateTimeUtc();
+    auto freshUntil = NetworkCache::freshUntil(
+        this->reply_->rawHeader("Cache-Control"), now);
+    this->data_->cacheStore->refresh(this->data_->getHash(),
+                                     freshUntil.value_or(now));
+
+    qCDebug(chatterinoHTTP).noquote()
+        << this->data_->typeString() << "[REVALIDATED] 304"
+        << this->data_->request.url().toString();
+
+    auto bytes = std::move(*this->data_->revalidatedData);
+    this->data_->revalidatedData.reset();
+    this->data_->emitSuccess(
+        {NetworkResult::NetworkError::NoError, QVariant(200), bytes});
+    this->data_->emitFinally();
 }
 
 void NetworkTask::timeout()
@@ -192,12 +222,20 @@ void NetworkTask::finished()
     if (reply->error() != QNetworkReply::NoError)
     {
         this->logReply();
-        this->data_->emitError({reply->error(), status, reply->readAll()});
+        this->data_->emitError({reply->error(), status, reply->readAll(),
+                                reply->rawHeaderPairs()});
         this->data_->emitFinally();
 
         return;
     }
 
+    if (this->data_->revalidatedData && status.toInt() == 304)
+    {
+        // our cached response is still valid
+        this->finishRevalidated();
+        return;
+    }
+
     QByteArray bytes = reply->readAll();
 
     if (this->data_->cache)
@@ -207,7 +245,8 @@ void NetworkTask::finished()
 
     DebugCount::increase("http request success");
     this->logReply();
-    this->data_->emitSuccess({reply->error(), status, bytes});
+    this->data_->emitSuccess(
+        {reply->error(), status, bytes, reply->rawHeaderPairs()});
     this->data_->emitFinally();
 }
 
@@ -37,6 +37,8 @@ private:
 
     void logReply();
     void writeToCache(const QByteArray &bytes) const;
+    /// Emits the cached response after the server confirmed it's still valid
+    void finishRevalidated();
 
     std::shared_ptr<NetworkData> data_;
     QNetworkReply *reply_{};  // parent: default (accessManager)
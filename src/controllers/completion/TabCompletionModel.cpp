@@ -15,6 +15,11 @@
 #include "controllers/plugins/PluginController.hpp"
 #include "singletons/Settings.hpp"
 
+#include <QSet>
+#include <QTimer>
+
+#include <utility>
+
 namespace chatterino {
 
 TabCompletionModel::TabCompletionModel(Channel &channel, QObject *parent)
@@ -27,6 +32,10 @@ void TabCompletionModel::updateResults(const QString &query,
                                        const QString &fullTextContent,
                                        int cursorPosition, bool isFirstWord)
 {
+#ifdef CHATTERINO_HAVE_PLUGINS
+    this->generation_++;
+    this->deferred_.clear();
+#endif
     this->updateSourceFromQuery(query);
 
     if (this->source_)
@@ -53,8 +62,75 @@ void TabCompletionModel::updateResults(const QString &query,
         auto uniqueResults = std::unique(results.begin(), results.end());
         results.erase(uniqueResults, results.end());
         this->setStringList(results);
+#ifdef CHATTERINO_HAVE_PLUGINS
+        if (getApp()->getPlugins()->hasDeferredCompletions())
+        {
+            this->queueDeferredCompletions(query, fullTextContent,
+                                           cursorPosition, isFirstWord);
+        }
+#endif
+    }
+}
+
+#ifdef CHATTERINO_HAVE_PLUGINS
+void TabCompletionModel::queueDeferredCompletions(
+    const QString &query, const QString &fullTextContent, int cursorPosition,
+    bool isFirstWord)
+{
+    auto generation = this->generation_;
+    QTimer::singleShot(0, this, [=, this] {
+        if (generation != this->generation_)
+        {
+            return;
+        }
+
+        // The user might already cycle through the shown completions, so
+        // deferred completions can't hide them (hide_others is ignored)
+        this->deferred_ = getApp()
+                              ->getPlugins()
+                              ->updateCustomCompletions(
+                                  query, fullTextContent, cursorPosition,
+                                  isFirstWord,
+                                  PluginController::CompletionPass::Deferred)
+                              .second;
+    });
+}
+
+bool TabCompletionModel::applyDeferredCompletions()
+{
+    if (this->deferred_.isEmpty())
+    {
+        return false;
+    }
+
+    auto existing = this->stringList();
+    QSet<QString> seen(existing.begin(), existing.end());
+    QStringList added;
+    for (auto &completion : std::exchange(this->deferred_, {}))
+    {
+        if (!seen.contains(completion))
+        {
+            seen.insert(completion);
+            added.append(std::move(completion));
+        }
+    }
+    if (added.isEmpty())
+    {
+        return false;
     }
+
+    // Appending the rows (instead of resetting the model) keeps the rows that
+    // are already shown
+    auto row = this->rowCount();
+    this->insertRows(row, static_cast<int>(added.size()));
+    for (const auto &completion : added)
+    {
+        this->setData(this->index(row), completion);
+        row++;
+    }
+    return true;
 }
+#endif
 
 void TabCompletionModel::updateSourceFromQuery(const QString &query)
 {
@@ -4,6 +4,7 @@
 
 #include <QObject>
 #include <QString>
+#include <QStringList>
 #include <QStringListModel>
 
 #include <optional>
@@ -33,6 +34,14 @@ public:
     void updateResults(const QString &query, const QString &fullTextContent,
                        int cursorPosition, bool isFirstWord = false);
 
+#ifdef CHATTERINO_HAVE_PLUGINS
+    /// @brief Appends the completions of the deferred plugin pass that
+    /// aren't in the results yet. The existing rows are kept, so this can be
+    /// called while the user cycles through the completions.
+    /// @return Whether any completions were added
+    bool applyDeferredCompletions();
+#endif
+
 private:
     enum class SourceKind {
         // Known to be an emote, i.e. started with :
@@ -66,6 +75,21 @@ private:
     std::unique_ptr<completion::Source> buildUserSource(bool prependAt) const;
     std::unique_ptr<completion::Source> buildCommandSource() const;
 
+#ifdef CHATTERINO_HAVE_PLUGINS
+    /// @brief Asks the plugins whose last completion was slow, once the
+    /// results of the other sources are shown. Their completions are kept
+    /// until applyDeferredCompletions() is called. They're dropped if another
+    /// query was started in the meantime.
+    void queueDeferredCompletions(const QString &query,
+                                  const QString &fullTextContent,
+                                  int cursorPosition, bool isFirstWord);
+
+    /// Incremented for every query to detect outdated deferred completions
+    size_t generation_ = 0;
+    /// Completions of the deferred pass that weren't applied yet
+    QStringList deferred_;
+#endif
+
     Channel &channel_;
     std::unique_ptr<completion::Source> source_{};
 };
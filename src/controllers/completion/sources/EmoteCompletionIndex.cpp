@@ -0,0 +1,162 @@
+#include "controllers/completion/sources/EmoteCompletionIndex.hpp"
+
+#include "messages/Emote.hpp"
+#include "providers/emoji/Emojis.hpp"
+
+#include <algorithm>
+
+namespace chatterino::completion {
+
+namespace {
+
+    void addEmotes(std::vector<EmoteItem> &out, const EmoteMap &map,
+                   const QString &providerName)
+    {
+        for (auto &&emote : map)
+        {
+            out.push_back({.emote = emote.second,
+                           .searchName = emote.first.string,
+                           .tabCompletionName = emote.first.string,
+                           .displayName = emote.second->name.string,
+                           .providerName = providerName,
+                           .isEmoji = false,
+                           .searchKey = emote.first.string.toCaseFolded()});
+        }
+    }
+
+    void addEmojis(std::vector<EmoteItem> &out,
+                   const std::vector<EmojiPtr> &map)
+    {
+        for (const auto &emoji : map)
+        {
+            for (auto &&shortCode : emoji->shortCodes)
+            {
+                out.push_back(
+                    {.emote = emoji->emote,
+                     .searchName = shortCode,
+                     .tabCompletionName = QStringLiteral(":%1:").arg(shortCode),
+                     .displayName = shortCode,
+                     .providerName = "Emoji",
+                     .isEmoji = true,
+                     .searchKey = shortCode.toCaseFolded()});
+            }
+        };
+    }
+
+}  // namespace
+
+EmoteCompletionIndex::EmoteCompletionIndex(
+    std::vector<Source> sources, const std::vector<EmojiPtr> &emojis,
+    const EmoteCompletionIndex *previous)
+    : sources_(std::move(sources))
+{
+    std::erase_if(this->sources_, [](const auto &source) {
+        return !source.emotes;
+    });
+
+    this->segments_.reserve(this->sources_.size() + 1);
+    for (const auto &source : this->sources_)
+    {
+        this->segments_.push_back({
+            .key = source.emotes.get(),
+            .providerName = source.providerName,
+        });
+    }
+    this->segments_.push_back({
+        .key = &emojis,
+        .emojiCount = emojis.size(),
+    });
+
+    for (size_t i = 0; i < this->segments_.size(); i++)
+    {
+        auto &segment = this->segments_[i];
+        segment.begin = this->items_.size();
+        if (!this->reuseSegment(previous, segment))
+        {
+            if (i < this->sources_.size())
+            {
+                addEmotes(this->items_, *this->sources_[i].emotes,
+                          segment.providerName);
+            }
+            else
+            {
+                addEmojis(this->items_, emojis);
+            }
+        }
+        segment.end = this->items_.size();
+    }
+}
+
+const std::vector<EmoteItem> &EmoteCompletionIndex::items() const
+{
+    return this->items_;
+}
+
+bool EmoteCompletionIndex::isBuiltFrom(
+    const std::vector<Source> &sources,
+    const std::vector<EmojiPtr> &emojis) const
+{
+    if (sources.size() + 1 != this->segments_.size())
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < sources.size(); i++)
+    {
+        const auto &segment = this->segments_[i];
+        if (segment.key != sources[i].emotes.get() ||
+            segment.providerName != sources[i].providerName)
+        {
+            return false;
+        }
+    }
+
+    const auto &emojiSegment = this->segments_.back();
+    return emojiSegment.key == &emojis &&
+           emojiSegment.emojiCount == emojis.size();
+}
+
+bool EmoteCompletionIndex::reuseSegment(const EmoteCompletionIndex *previous,
+                                        const Segment &segment)
+{
+    if (!previous)
+    {
+        return false;
+    }
+
+    auto it = std::ranges::find_if(previous->segments_, [&](const auto &old) {
+        return old.key == segment.key &&
+               old.providerName == segment.providerName &&
+               old.emojiCount == segment.emojiCount;
+    });
+    if (it == previous->segments_.end())
+    {
+        return false;
+    }
+
+    this->items_.insert(this->items_.end(),
+                        previous->items_.begin() +
+                            static_cast<std::ptrdiff_t>(it->begin),
+                        previous->items_.begin() +
+                            static_cast<std::ptrdiff_t>(it->end));
+    return true;
+}
+
+std::shared_ptr<const EmoteCompletionIndex> EmoteCompletionIndexCache::get(
+    std::vector<EmoteCompletionIndex::Source> sources,
+    const std::vector<EmojiPtr> &emojis)
+{
+    std::erase_if(sources, [](const auto &source) {
+        return !source.emotes;
+    });
+
+    std::lock_guard lock(this->mutex_);
+    if (!this->index_ || !this->index_->isBuiltFrom(sources, emojis))
+    {
+        this->index_ = std::make_shared<const EmoteCompletionIndex>(
+            std::move(sources), emojis, this->index_.get());
+    }
+    return this->index_;
+}
+
+}  // namespace chatterino::completion
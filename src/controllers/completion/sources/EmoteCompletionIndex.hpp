@@ -0,0 +1,103 @@
+#pragma once
+
+#include <QString>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace chatterino {
+
+struct Emote;
+using EmotePtr = std::shared_ptr<const Emote>;
+class EmoteMap;
+struct EmojiData;
+using EmojiPtr = std::shared_ptr<EmojiData>;
+
+}  // namespace chatterino
+
+namespace chatterino::completion {
+
+struct EmoteItem {
+    /// Emote image to show in input popup
+    EmotePtr emote{};
+    /// Name to check completion queries against
+    QString searchName{};
+    /// Name to insert into split input upon tab completing
+    QString tabCompletionName{};
+    /// Display name within input popup
+    QString displayName{};
+    /// Emote provider name for input popup
+    QString providerName{};
+    /// Whether emote is emoji
+    bool isEmoji{};
+    /// The case-folded searchName to check case-insensitive queries against
+    QString searchKey{};
+};
+
+/// All emotes that can be completed in a channel.
+///
+/// The emotes are kept in one segment per emote map and one for the emojis.
+/// An index can reuse the segments of a previous index whose emote maps are
+/// the same, so only emote sets that changed (e.g. through a live update)
+/// have to be processed again.
+class EmoteCompletionIndex
+{
+public:
+    struct Source {
+        std::shared_ptr<const EmoteMap> emotes;
+        QString providerName;
+    };
+
+    /// Builds the index of `sources` (skipping sources without emotes)
+    /// followed by `emojis`. Segments of `previous` are reused if it's set.
+    EmoteCompletionIndex(std::vector<Source> sources,
+                         const std::vector<EmojiPtr> &emojis,
+                         const EmoteCompletionIndex *previous = nullptr);
+
+    /// The emotes in the order of their sources, emojis last
+    const std::vector<EmoteItem> &items() const;
+
+    /// Checks if this index was built from exactly these sources and emojis
+    bool isBuiltFrom(const std::vector<Source> &sources,
+                     const std::vector<EmojiPtr> &emojis) const;
+
+private:
+    struct Segment {
+        /// The emote map or the list of emojis
+        const void *key = nullptr;
+        QString providerName;
+        /// The number of emojis of the emoji segment
+        size_t emojiCount = 0;
+        /// The range of this segment in `items_`
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    /// Copies the items of the segment of `previous` matching `segment`.
+    /// Returns false if there's no such segment.
+    bool reuseSegment(const EmoteCompletionIndex *previous,
+                      const Segment &segment);
+
+    /// Keeps the emote maps alive, so their addresses aren't reused
+    std::vector<Source> sources_;
+    std::vector<Segment> segments_;
+    std::vector<EmoteItem> items_;
+};
+
+/// Keeps the EmoteCompletionIndex of a channel until its sources change
+class EmoteCompletionIndexCache
+{
+public:
+    /// Returns the index of `sources` and `emojis`, updating the segments of
+    /// the sources that changed since the last call
+    std::shared_ptr<const EmoteCompletionIndex> get(
+        std::vector<EmoteCompletionIndex::Source> sources,
+        const std::vector<EmojiPtr> &emojis);
+
+private:
+    std::mutex mutex_;
+    std::shared_ptr<const EmoteCompletionIndex> index_;
+};
+
+}  // namespace chatterino::completion
@@ -14,42 +14,6 @@
 
 namespace chatterino::completion {
 
-namespace {
-
-    void addEmotes(std::vector<EmoteItem> &out, const EmoteMap &map,
-                   const QString &providerName)
-    {
-        for (auto &&emote : map)
-        {
-            out.push_back({.emote = emote.second,
-                           .searchName = emote.first.string,
-                           .tabCompletionName = emote.first.string,
-                           .displayName = emote.second->name.string,
-                           .providerName = providerName,
-                           .isEmoji = false});
-        }
-    }
-
-    void addEmojis(std::vector<EmoteItem> &out,
-                   const std::vector<EmojiPtr> &map)
-    {
-        for (const auto &emoji : map)
-        {
-            for (auto &&shortCode : emoji->shortCodes)
-            {
-                out.push_back(
-                    {.emote = emoji->emote,
-                     .searchName = shortCode,
-                     .tabCompletionName = QStringLiteral(":%1:").arg(shortCode),
-                     .displayName = shortCode,
-                     .providerName = "Emoji",
-                     .isEmoji = true});
-            }
-        };
-    }
-
-}  // namespace
-
 EmoteSource::EmoteSource(const Channel *channel,
                          std::unique_ptr<EmoteStrategy> strategy,
                          ActionCallback callback)
@@ -62,9 +26,9 @@ EmoteSource::EmoteSource(const Channel *channel,
 void EmoteSource::update(const QString &query)
 {
     this->output_.clear();
-    if (this->strategy_)
+    if (this->strategy_ && this->index_)
     {
-        this->strategy_->apply(this->items_, this->output_, query);
+        this->strategy_->apply(this->index_->items(), this->output_, query);
     }
 }
 
@@ -90,53 +54,43 @@ void EmoteSource::initializeFromChannel(const Channel *channel)
 {
     auto *app = getApp();
 
-    std::vector<EmoteItem> emotes;
+    std::vector<EmoteCompletionIndex::Source> sources;
     const auto *tc = dynamic_cast<const TwitchChannel *>(channel);
     // returns true also for special Twitch channels (/live, /mentions, /whispers, etc.)
     if (channel->isTwitchChannel())
     {
         if (tc)
         {
-            if (auto twitch = tc->localTwitchEmotes())
-            {
-                addEmotes(emotes, *twitch, "Local Twitch Emotes");
-            }
+            sources.push_back({tc->localTwitchEmotes(), "Local Twitch Emotes"});
 
             auto user = getApp()->getAccounts()->twitch.getCurrent();
-            addEmotes(emotes, **user->accessEmotes(), "Twitch Emote");
+            sources.push_back({*user->accessEmotes(), "Twitch Emote"});
 
             // TODO extract "Channel {BetterTTV,7TV,FrankerFaceZ}" text into a #define.
-            if (auto bttv = tc->bttvEmotes())
-            {
-                addEmotes(emotes, *bttv, "Channel BetterTTV");
-            }
-            if (auto ffz = tc->ffzEmotes())
-            {
-                addEmotes(emotes, *ffz, "Channel FrankerFaceZ");
-            }
-            if (auto seventv = tc->seventvEmotes())
-            {
-                addEmotes(emotes, *seventv, "Channel 7TV");
-            }
+            sources.push_back({tc->bttvEmotes(), "Channel BetterTTV"});
+            sources.push_back({tc->ffzEmotes(), "Channel FrankerFaceZ"});
+            sources.push_back({tc->seventvEmotes(), "Channel 7TV"});
         }
 
-        if (auto bttvG = app->getBttvEmotes()->emotes())
-        {
-            addEmotes(emotes, *bttvG, "Global BetterTTV");
-        }
-        if (auto ffzG = app->getFfzEmotes()->emotes())
-        {
-            addEmotes(emotes, *ffzG, "Global FrankerFaceZ");
-        }
-        if (auto seventvG = app->getSeventvEmotes()->globalEmotes())
-        {
-            addEmotes(emotes, *seventvG, "Global 7TV");
-        }
+        sources.push_back({app->getBttvEmotes()->emotes(), "Global BetterTTV"});
+        sources.push_back(
+            {app->getFfzEmotes()->emotes(), "Global FrankerFaceZ"});
+        sources.push_back(
+            {app->getSeventvEmotes()->globalEmotes(), "Global 7TV"});
     }
 
-    addEmojis(emotes, app->getEmotes()->getEmojis()->getEmojis());
-
-    this->items_ = std::move(emotes);
+    const auto &emojis = app->getEmotes()->getEmojis()->getEmojis();
+    if (tc)
+    {
+        // Twitch channels keep their index, so only emote sets that changed
+        // since the last completion are processed again
+        this->index_ = tc->completionEmotes().get(std::move(sources), emojis);
+    }
+    else
+    {
+        this->index_ = std::make_shared<const EmoteCompletionIndex>(
+            std::move(sources), emojis);
+    }
 }
 
 const std::vector<EmoteItem> &EmoteSource::output() const
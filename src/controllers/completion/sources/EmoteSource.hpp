@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common/Channel.hpp"
+#include "controllers/completion/sources/EmoteCompletionIndex.hpp"
 #include "controllers/completion/sources/Source.hpp"
 #include "controllers/completion/strategies/Strategy.hpp"
 #include "messages/Emote.hpp"
@@ -13,21 +14,6 @@
 
 namespace chatterino::completion {
 
-struct EmoteItem {
-    /// Emote image to show in input popup
-    EmotePtr emote{};
-    /// Name to check completion queries against
-    QString searchName{};
-    /// Name to insert into split input upon tab completing
-    QString tabCompletionName{};
-    /// Display name within input popup
-    QString displayName{};
-    /// Emote provider name for input popup
-    QString providerName{};
-    /// Whether emote is emoji
-    bool isEmoji{};
-};
-
 class EmoteSource : public Source
 {
 public:
@@ -56,7 +42,7 @@ private:
     std::unique_ptr<EmoteStrategy> strategy_;
     ActionCallback callback_;
 
-    std::vector<EmoteItem> items_{};
+    std::shared_ptr<const EmoteCompletionIndex> index_;
     std::vector<EmoteItem> output_{};
 };
 
@@ -5,6 +5,8 @@
 #include "singletons/Settings.hpp"
 #include "util/Helpers.hpp"
 
+#include <algorithm>
+
 namespace chatterino::completion {
 
 UserSource::UserSource(const Channel *channel,
@@ -20,10 +22,27 @@ UserSource::UserSource(const Channel *channel,
 void UserSource::update(const QString &query)
 {
     this->output_.clear();
-    if (this->strategy_)
+    if (!this->strategy_ || !this->channel_)
+    {
+        return;
+    }
+
+    // Users are completed by the start of their name, so only the chatters
+    // starting with the query are passed to the strategy.
+    auto prefix = query.startsWith('@') ? query.mid(1) : query;
+    auto items = this->channel_->accessChatters()->filterByPrefix(prefix);
+
+    if (this->broadcaster_)
     {
-        this->strategy_->apply(this->items_, this->output_, query);
+        auto it = std::ranges::find(items, this->broadcaster_->first,
+                                    &UserItem::first);
+        if (it == items.end())
+        {
+            items.push_back(*this->broadcaster_);
+        }
     }
+
+    this->strategy_->apply(items, this->output_, query);
 }
 
 void UserSource::addToListModel(GenericListModel &model, size_t maxCount) const
@@ -58,19 +77,11 @@ void UserSource::initializeFromChannel(const Channel *channel)
         return;
     }
 
-    this->items_ = tc->accessChatters()->all();
+    this->channel_ = tc;
 
     if (getSettings()->alwaysIncludeBroadcasterInUserCompletions)
     {
-        auto it = std::find_if(this->items_.begin(), this->items_.end(),
-                               [tc](const UserItem &user) {
-                                   return user.first == tc->getName();
-                               });
-
-        if (it == this->items_.end())
-        {
-            this->items_.emplace_back(tc->getName(), tc->getDisplayName());
-        }
+        this->broadcaster_.emplace(tc->getName(), tc->getDisplayName());
     }
 }
 
@@ -8,9 +8,16 @@
 
 #include <functional>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
+namespace chatterino {
+
+class TwitchChannel;
+
+}  // namespace chatterino
+
 namespace chatterino::completion {
 
 using UserItem = std::pair<QString, QString>;
@@ -22,8 +29,8 @@ public:
     using UserStrategy = Strategy<UserItem>;
 
     /// @brief Initializes a source for UserItems from the given channel.
-    /// @param channel Channel to initialize users from. Must be a TwitchChannel
-    /// or completion is a no-op.
+    /// @param channel Channel to complete users from. Must be a TwitchChannel
+    /// or completion is a no-op. The channel has to outlive this source.
     /// @param strategy Strategy to apply
     /// @param callback ActionCallback to invoke upon InputCompletionItem selection.
     /// See InputCompletionItem::action(). Can be nullptr.
@@ -46,7 +53,9 @@ private:
     ActionCallback callback_;
     bool prependAt_;
 
-    std::vector<UserItem> items_{};
+    const TwitchChannel *channel_ = nullptr;
+    /// Set if the broadcaster should be completed even if they didn't chat
+    std::optional<UserItem> broadcaster_;
     std::vector<UserItem> output_{};
 };
 
@@ -15,10 +15,12 @@ void ClassicEmoteStrategy::apply(const std::vector<EmoteItem> &items,
         normalizedQuery = normalizedQuery.mid(1);
     }
 
+    QString foldedQuery = normalizedQuery.toCaseFolded();
+
     // First pass: filter by contains match
     for (const auto &item : items)
     {
-        if (item.searchName.contains(normalizedQuery, Qt::CaseInsensitive))
+        if (item.searchKey.contains(foldedQuery))
         {
             output.push_back(item);
         }
@@ -53,13 +55,17 @@ void ClassicTabEmoteStrategy::apply(const std::vector<EmoteItem> &items,
                                     const QString &query) const
 {
     bool colonStart = query.startsWith(':');
-    QStringView normalizedQuery = query;
+    // The case-folded names of the emotes are checked against the case-folded
+    // query
+    QString foldedQuery = query.toCaseFolded();
+    QStringView normalizedQuery = foldedQuery;
     if (colonStart)
     {
         // TODO(Qt6): use sliced
         normalizedQuery = normalizedQuery.mid(1);
     }
 
+    bool prefixOnly = getSettings()->prefixOnlyEmoteCompletion;
     std::set<EmoteItem, CompletionEmoteOrder> emotes;
 
     for (const auto &item : items)
@@ -78,12 +84,11 @@ void ClassicTabEmoteStrategy::apply(const std::vector<EmoteItem> &items,
         }
         else
         {
-            itemQuery = query;
+            itemQuery = foldedQuery;
         }
 
-        if (startsWithOrContains(item.searchName, itemQuery,
-                                 Qt::CaseInsensitive,
-                                 getSettings()->prefixOnlyEmoteCompletion))
+        if (startsWithOrContains(item.searchKey, itemQuery, Qt::CaseSensitive,
+                                 prefixOnly))
         {
             emotes.insert(item);
         }
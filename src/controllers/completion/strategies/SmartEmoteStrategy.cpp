@@ -62,13 +62,31 @@ namespace {
         return score;
     };
 
+    /// Checks if `item` contains `query` (or starts with it if `prefixOnly`
+    /// is set). `foldedQuery` is the case-folded query, which is checked
+    /// against the case-folded name of the item if the search is case
+    /// insensitive.
+    bool matches(const EmoteItem &item, QStringView query,
+                 QStringView foldedQuery, Qt::CaseSensitivity caseHandling,
+                 bool prefixOnly)
+    {
+        if (caseHandling == Qt::CaseInsensitive)
+        {
+            return startsWithOrContains(item.searchKey, foldedQuery,
+                                        Qt::CaseSensitive, prefixOnly);
+        }
+        return startsWithOrContains(item.searchName, query, Qt::CaseSensitive,
+                                    prefixOnly);
+    }
+
     // This contains the brains of emote tab completion. Updates output to sorted completions.
     // Ensure that the query string is already normalized, that is doesn't have a leading ':'
     // matchingFunction is used for testing if the emote should be included in the search.
+    // If `limit` is set, only the best `limit` emotes are output.
     void completeEmotes(
         const std::vector<EmoteItem> &items, std::vector<EmoteItem> &output,
-        QStringView query, bool ignoreColonForCost,
-        const std::function<bool(EmoteItem, Qt::CaseSensitivity)>
+        QStringView query, bool ignoreColonForCost, size_t limit,
+        const std::function<bool(const EmoteItem &, Qt::CaseSensitivity)>
             &matchingFunction)
     {
         // Given these emotes: pajaW, PAJAW
@@ -86,6 +104,8 @@ namespace {
                 return c.isUpper();
             });
 
+        std::vector<const EmoteItem *> matching;
+
         // First search, for case 1 it will be case insensitive,
         // for cases 2, 3 and 4 it will be case sensitive
         for (const auto &item : items)
@@ -93,7 +113,7 @@ namespace {
             if (matchingFunction(
                     item, haveUpper ? Qt::CaseSensitive : Qt::CaseInsensitive))
             {
-                output.push_back(item);
+                matching.push_back(&item);
             }
         }
 
@@ -101,7 +121,7 @@ namespace {
         bool prioritizeUpper = false;
 
         // No results from search
-        if (output.empty())
+        if (matching.empty())
         {
             if (!haveUpper)
             {
@@ -118,44 +138,74 @@ namespace {
             {
                 if (matchingFunction(item, Qt::CaseInsensitive))
                 {
-                    output.push_back(item);
+                    matching.push_back(&item);
                 }
             }
-            if (output.empty())
+            if (matching.empty())
             {
                 // The second search found nothing, so don't even try to sort: case 4
                 return;
             }
         }
 
-        std::sort(output.begin(), output.end(),
-                  [query, prioritizeUpper, ignoreColonForCost](
-                      const EmoteItem &a, const EmoteItem &b) -> bool {
-                      auto tempA = a.searchName;
-                      auto tempB = b.searchName;
-                      if (ignoreColonForCost && tempA.startsWith(":"))
-                      {
-                          tempA = tempA.mid(1);
-                      }
-                      if (ignoreColonForCost && tempB.startsWith(":"))
-                      {
-                          tempB = tempB.mid(1);
-                      }
-
-                      auto costA = costOfEmote(query, tempA, prioritizeUpper);
-                      auto costB = costOfEmote(query, tempB, prioritizeUpper);
-                      if (costA == costB)
-                      {
-                          // Case difference and length came up tied for (a, b), break the tie
-                          return QString::compare(tempA, tempB,
-                                                  Qt::CaseInsensitive) < 0;
-                      }
-
-                      return costA < costB;
-                  });
+        // The cost of each emote is only calculated once
+        struct RankedEmote {
+            int cost;
+            QStringView name;
+            const EmoteItem *item;
+        };
+        std::vector<RankedEmote> ranked;
+        ranked.reserve(matching.size());
+        for (const auto *item : matching)
+        {
+            QStringView name = item->searchName;
+            if (ignoreColonForCost && name.startsWith(u':'))
+            {
+                name = name.mid(1);
+            }
+            ranked.push_back({
+                .cost = costOfEmote(query, name, prioritizeUpper),
+                .name = name,
+                .item = item,
+            });
+        }
+
+        auto better = [](const RankedEmote &a, const RankedEmote &b) -> bool {
+            if (a.cost == b.cost)
+            {
+                // Case difference and length came up tied, break the tie
+                return a.name.compare(b.name, Qt::CaseInsensitive) < 0;
+            }
+
+            return a.cost < b.cost;
+        };
+
+        // Only the best emotes have to be in order
+        auto end = ranked.end();
+        if (limit != 0 && limit < ranked.size())
+        {
+            end = ranked.begin() + static_cast<std::ptrdiff_t>(limit);
+            std::partial_sort(ranked.begin(), end, ranked.end(), better);
+        }
+        else
+        {
+            std::sort(ranked.begin(), ranked.end(), better);
+        }
+
+        output.reserve(output.size() +
+                       static_cast<size_t>(end - ranked.begin()));
+        for (auto it = ranked.begin(); it != end; it++)
+        {
+            output.push_back(*it->item);
+        }
     }
 }  // namespace
 
+SmartEmoteStrategy::SmartEmoteStrategy(size_t limit)
+    : limit_(limit)
+{
+}
+
 void SmartEmoteStrategy::apply(const std::vector<EmoteItem> &items,
                                std::vector<EmoteItem> &output,
                                const QString &query) const
@@ -167,12 +217,13 @@ void SmartEmoteStrategy::apply(const std::vector<EmoteItem> &items,
         normalizedQuery = normalizedQuery.mid(1);
         ignoreColonForCost = true;
     }
-    completeEmotes(items, output, normalizedQuery, ignoreColonForCost,
-                   [normalizedQuery](const EmoteItem &left,
-                                     Qt::CaseSensitivity caseHandling) {
-                       return left.searchName.contains(normalizedQuery,
-                                                       caseHandling);
-                   });
+    QString foldedQuery = normalizedQuery.toCaseFolded();
+    completeEmotes(
+        items, output, normalizedQuery, ignoreColonForCost, this->limit_,
+        [&](const EmoteItem &item, Qt::CaseSensitivity caseHandling) {
+            return matches(item, normalizedQuery, foldedQuery, caseHandling,
+                           false);
+        });
 }
 
 void SmartTabEmoteStrategy::apply(const std::vector<EmoteItem> &items,
@@ -181,35 +232,30 @@ void SmartTabEmoteStrategy::apply(const std::vector<EmoteItem> &items,
 {
     bool colonStart = query.startsWith(':');
     QStringView normalizedQuery = query;
+    QString foldedQuery = query.toCaseFolded();
+    QStringView foldedNormalizedQuery = foldedQuery;
     if (colonStart)
     {
         // TODO(Qt6): use sliced
         normalizedQuery = normalizedQuery.mid(1);
+        foldedNormalizedQuery = foldedNormalizedQuery.mid(1);
     }
 
+    bool prefixOnly = getSettings()->prefixOnlyEmoteCompletion;
     completeEmotes(
-        items, output, normalizedQuery, false,
+        items, output, normalizedQuery, false, 0,
         [&](const EmoteItem &item, Qt::CaseSensitivity caseHandling) -> bool {
-            QStringView itemQuery;
             if (item.isEmoji)
             {
-                if (colonStart)
-                {
-                    itemQuery = normalizedQuery;
-                }
-                else
+                if (!colonStart)
                 {
                     return false;  // ignore emojis when not completing with ':'
                 }
-            }
-            else
-            {
-                itemQuery = query;
+                return matches(item, normalizedQuery, foldedNormalizedQuery,
+                               caseHandling, prefixOnly);
             }
 
-            return startsWithOrContains(
-                item.searchName, itemQuery, caseHandling,
-                getSettings()->prefixOnlyEmoteCompletion);
+            return matches(item, query, foldedQuery, caseHandling, prefixOnly);
         });
 }
 
@@ -7,9 +7,17 @@ namespace chatterino::completion {
 
 class SmartEmoteStrategy : public Strategy<EmoteItem>
 {
+public:
+    /// @param limit Only the best `limit` emotes are output. Zero indicates
+    /// unlimited.
+    explicit SmartEmoteStrategy(size_t limit = 0);
+
+private:
     void apply(const std::vector<EmoteItem> &items,
                std::vector<EmoteItem> &output,
                const QString &query) const override;
+
+    size_t limit_;
 };
 
 class SmartTabEmoteStrategy : public Strategy<EmoteItem>
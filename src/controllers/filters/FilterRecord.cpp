@@ -58,10 +58,12 @@ bool FilterRecord::valid() const
     return this->filter_ != nullptr;
 }
 
-bool FilterRecord::filter(const filters::ContextMap &context) const
+bool FilterRecord::filter(filters::FilterContext &context) const
 {
     assert(this->valid());
-    return this->filter_->execute(context).toBool();
+    auto result = this->filter_->execute(context);
+    const auto *matched = std::get_if<bool>(&result);
+    return matched != nullptr && *matched;
 }
 
 bool FilterRecord::operator==(const FilterRecord &other) const
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "controllers/filters/lang/expressions/Expression.hpp"
+#include "controllers/filters/lang/Program.hpp"
 #include "controllers/filters/lang/Types.hpp"
 
 #include <QString>
@@ -22,8 +23,12 @@ namespace chatterino::filters {
 // For example, flags.highlighted is a boolean variable, so it is marked as Type::Bool
 // below. These variable types will be used to check whether a filter "makes sense",
 // i.e. if all the variables and operators being used have compatible types.
+// The variables and their types are defined in FilterContext.cpp.
 extern const QMap<QString, Type> MESSAGE_TYPING_CONTEXT;
 
+/// Computes all variables of `m` at once.
+/// Prefer evaluating filters with a FilterContext, which only computes the
+/// variables a filter references.
 ContextMap buildContextMap(const MessagePtr &m, chatterino::Channel *channel);
 
 class Filter;
@@ -39,16 +44,21 @@ public:
     static FilterResult fromString(const QString &str);
 
     Type returnType() const;
+
+    /// Evaluates the filter by walking the expression tree
     QVariant execute(const ContextMap &context) const;
+    /// Evaluates the compiled filter
+    Value execute(FilterContext &context) const;
 
     QString filterString() const;
     QString debugString(const TypingContext &context) const;
 
 private:
-    Filter(ExpressionPtr expression, Type returnType);
+    Filter(ExpressionPtr expression, Type returnType, Program program);
 
     ExpressionPtr expression_;
     Type returnType_;
+    Program program_;
 };
 
 }  // namespace chatterino::filters
@@ -0,0 +1,218 @@
+#include "controllers/filters/lang/FilterContext.hpp"
+
+#include "Application.hpp"
+#include "common/Channel.hpp"
+#include "messages/Message.hpp"
+#include "providers/twitch/TwitchBadge.hpp"
+#include "providers/twitch/TwitchChannel.hpp"
+#include "providers/twitch/TwitchIrcServer.hpp"
+
+namespace {
+
+using namespace chatterino;
+using namespace chatterino::filters;
+
+bool hasBadge(const Message &m, const QString &key)
+{
+    for (const auto &badge : m.badges)
+    {
+        if (badge.key_ == key)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool isSubscribed(const Message &m)
+{
+    return hasBadge(m, QStringLiteral("subscriber")) ||
+           hasBadge(m, QStringLiteral("founder"));
+}
+
+int subLength(const Message &m)
+{
+    int length = 0;
+    for (const auto *subBadge : {"subscriber", "founder"})
+    {
+        if (!hasBadge(m, QString::fromLatin1(subBadge)))
+        {
+            continue;
+        }
+        auto it = m.badgeInfos.find(subBadge);
+        if (it != m.badgeInfos.end())
+        {
+            length = it->second.toInt();
+        }
+    }
+    return length;
+}
+
+struct Variable {
+    const char *identifier;
+    Type type;
+    Value (*compute)(const Message &m, Channel *channel);
+};
+
+template <MessageFlag flag>
+Value hasFlag(const Message &m, Channel * /*channel*/)
+{
+    return m.flags.has(flag);
+}
+
+/*
+ * Looking to add a new identifier to filters? Here's what to do:
+ *  1. Update validIdentifiersMap in Tokenizer.cpp
+ *  2. Add the identifier, its type and how to compute it to the list below
+ *  3. Bump FilterContext::VARIABLE_COUNT
+ *
+ * MESSAGE_TYPING_CONTEXT is built from this list, so the types used for type
+ * checking and the values computed at runtime can't get out of sync.
+ */
+constexpr Variable VARIABLES[] = {
+    {"author.badges", Type::StringList,
+     [](const Message &m, Channel *) -> Value {
+         QStringList badges;
+         badges.reserve(static_cast<qsizetype>(m.badges.size()));
+         for (const auto &e : m.badges)
+         {
+             badges << e.key_;
+         }
+         return badges;
+     }},
+    {"author.color", Type::Color,
+     [](const Message &m, Channel *) -> Value {
+         return m.usernameColor;
+     }},
+    {"author.name", Type::String,
+     [](const Message &m, Channel *) -> Value {
+         return m.displayName;
+     }},
+    {"author.user_id", Type::String,
+     [](const Message &m, Channel *) -> Value {
+         return m.userID;
+     }},
+    {"author.no_color", Type::Bool,
+     [](const Message &m, Channel *) -> Value {
+         return !m.usernameColor.isValid();
+     }},
+    {"author.subbed", Type::Bool,
+     [](const Message &m, Channel *) -> Value {
+         return isSubscribed(m);
+     }},
+    {"author.sub_length", Type::Int,
+     [](const Message &m, Channel *) -> Value {
+         return subLength(m);
+     }},
+
+    {"channel.name", Type::String,
+     [](const Message &m, Channel *) -> Value {
+         return m.channelName;
+     }},
+    {"channel.watching", Type::Bool,
+     [](const Message &m, Channel *) -> Value {
+         auto watchingChannel =
+             getApp()->getTwitch()->getWatchingChannel().get();
+         return !watchingChannel->getName().isEmpty() &&
+                watchingChannel->getName().compare(
+                    m.channelName, Qt::CaseInsensitive) == 0;
+     }},
+    {"channel.live", Type::Bool,
+     [](const Message & /*m*/, Channel *channel) -> Value {
+         auto *tc = dynamic_cast<TwitchChannel *>(channel);
+         return channel && !channel->isEmpty() && tc && tc->isLive();
+     }},
+
+    {"flags.action", Type::Bool, hasFlag<MessageFlag::Action>},
+    {"flags.highlighted", Type::Bool, hasFlag<MessageFlag::Highlighted>},
+    {"flags.points_redeemed", Type::Bool,
+     hasFlag<MessageFlag::RedeemedHighlight>},
+    {"flags.sub_message", Type::Bool, hasFlag<MessageFlag::Subscription>},
+    {"flags.system_message", Type::Bool, hasFlag<MessageFlag::System>},
+    {"flags.reward_message", Type::Bool,
+     hasFlag<MessageFlag::RedeemedChannelPointReward>},
+    {"flags.first_message", Type::Bool, hasFlag<MessageFlag::FirstMessage>},
+    {"flags.elevated_message", Type::Bool,
+     hasFlag<MessageFlag::ElevatedMessage>},
+    {"flags.hype_chat", Type::Bool, hasFlag<MessageFlag::ElevatedMessage>},
+    {"flags.cheer_message", Type::Bool, hasFlag<MessageFlag::CheerMessage>},
+    {"flags.whisper", Type::Bool, hasFlag<MessageFlag::Whisper>},
+    {"flags.reply", Type::Bool, hasFlag<MessageFlag::ReplyMessage>},
+    {"flags.automod", Type::Bool, hasFlag<MessageFlag::AutoMod>},
+    {"flags.restricted", Type::Bool, hasFlag<MessageFlag::RestrictedMessage>},
+    {"flags.monitored", Type::Bool, hasFlag<MessageFlag::MonitoredMessage>},
+    {"flags.shared", Type::Bool, hasFlag<MessageFlag::SharedMessage>},
+    {"flags.similar", Type::Bool, hasFlag<MessageFlag::Similar>},
+
+    {"message.content", Type::String,
+     [](const Message &m, Channel *) -> Value {
+         return m.messageText;
+     }},
+    {"message.length", Type::Int,
+     [](const Message &m, Channel *) -> Value {
+         return static_cast<int>(m.messageText.length());
+     }},
+
+    {"reward.title", Type::String,
+     [](const Message &m, Channel *) -> Value {
+         return m.reward ? m.reward->title : QString();
+     }},
+    {"reward.cost", Type::Int,
+     [](const Message &m, Channel *) -> Value {
+         return m.reward ? m.reward->cost : -1;
+     }},
+    {"reward.id", Type::String,
+     [](const Message &m, Channel *) -> Value {
+         return m.reward ? m.reward->id : QString();
+     }},
+};
+
+static_assert(std::size(VARIABLES) == FilterContext::VARIABLE_COUNT);
+
+}  // namespace
+
+namespace chatterino::filters {
+
+FilterContext::FilterContext(const MessagePtr &message, Channel *channel)
+    : message_(*message)
+    , channel_(channel)
+{
+}
+
+int FilterContext::slotOf(const QString &identifier)
+{
+    for (size_t i = 0; i < VARIABLE_COUNT; ++i)
+    {
+        if (identifier == QLatin1String(VARIABLES[i].identifier))
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+QString FilterContext::identifierAt(int slot)
+{
+    assert(slot >= 0 && static_cast<size_t>(slot) < VARIABLE_COUNT);
+    return QString::fromLatin1(VARIABLES[slot].identifier);
+}
+
+Type FilterContext::typeAt(int slot)
+{
+    assert(slot >= 0 && static_cast<size_t>(slot) < VARIABLE_COUNT);
+    return VARIABLES[slot].type;
+}
+
+const Value &FilterContext::get(int slot)
+{
+    assert(slot >= 0 && static_cast<size_t>(slot) < VARIABLE_COUNT);
+
+    auto &value = this->values_[slot];
+    if (!value)
+    {
+        value = VARIABLES[slot].compute(this->message_, this->channel_);
+    }
+    return *value;
+}
+
+}  // namespace chatterino::filters
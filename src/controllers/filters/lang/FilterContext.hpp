@@ -0,0 +1,49 @@
+#pragma once
+
+#include "controllers/filters/lang/Program.hpp"
+#include "controllers/filters/lang/Types.hpp"
+
+#include <QString>
+
+#include <array>
+#include <memory>
+#include <optional>
+
+namespace chatterino {
+
+class Channel;
+struct Message;
+using MessagePtr = std::shared_ptr<const Message>;
+
+}  // namespace chatterino
+
+namespace chatterino::filters {
+
+/// The values of all filter variables for one message.
+///
+/// Values are computed on first access, so a filter that only checks
+/// `flags.highlighted` never computes the author's badges or the channel's
+/// live status. One context can be shared between all filters that look at
+/// the same message.
+class FilterContext
+{
+public:
+    static constexpr size_t VARIABLE_COUNT = 32;
+
+    FilterContext(const MessagePtr &message, Channel *channel);
+
+    /// Returns the slot of `identifier` or -1 if there's no such variable
+    static int slotOf(const QString &identifier);
+    static QString identifierAt(int slot);
+    static Type typeAt(int slot);
+
+    const Value &get(int slot);
+
+private:
+    const Message &message_;
+    Channel *channel_;
+
+    std::array<std::optional<Value>, VARIABLE_COUNT> values_;
+};
+
+}  // namespace chatterino::filters
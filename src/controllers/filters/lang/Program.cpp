@@ -0,0 +1,444 @@
+#include "controllers/filters/lang/Program.hpp"
+
+#include "controllers/filters/lang/expressions/BinaryOperation.hpp"
+#include "controllers/filters/lang/expressions/Expression.hpp"
+#include "controllers/filters/lang/expressions/ListExpression.hpp"
+#include "controllers/filters/lang/expressions/UnaryOperation.hpp"
+#include "controllers/filters/lang/Filter.hpp"
+#include "controllers/filters/lang/FilterContext.hpp"
+#include "util/QMagicEnum.hpp"
+
+#include <boost/container/small_vector.hpp>
+
+#include <functional>
+
+namespace {
+
+using namespace chatterino::filters;
+
+// Most filters don't need more than a handful of stack slots, so evaluating
+// them doesn't allocate.
+using Stack = boost::container::small_vector<Value, 8>;
+
+template <typename T>
+T pop(Stack &stack)
+{
+    assert(!stack.empty());
+    T value = std::get<T>(std::move(stack.back()));
+    stack.pop_back();
+    return value;
+}
+
+/// Replaces the two topmost values `(left, right)` with `fn(left, right)`
+template <typename L, typename R, typename Fn>
+void binary(Stack &stack, Fn &&fn)
+{
+    auto right = pop<R>(stack);
+    auto &top = stack.back();
+    Value result = fn(std::get<L>(top), right);
+    top = std::move(result);
+}
+
+int divide(int left, int right)
+{
+    // Division by zero is undefined, let's settle on 0
+    return right == 0 ? 0 : left / right;
+}
+
+int modulo(int left, int right)
+{
+    return right == 0 ? 0 : left % right;
+}
+
+}  // namespace
+
+namespace chatterino::filters {
+
+QVariant valueToVariant(const Value &value)
+{
+    return std::visit(
+        [](const auto &v) -> QVariant {
+            using T = std::decay_t<decltype(v)>;
+            if constexpr (std::is_same_v<T, QVariant>)
+            {
+                return v;
+            }
+            else
+            {
+                return QVariant::fromValue(v);
+            }
+        },
+        value);
+}
+
+Value valueFromVariant(const QVariant &variant, Type type)
+{
+    switch (type)
+    {
+        case Type::Bool:
+            return variant.toBool();
+        case Type::Int:
+            return variant.toInt();
+        case Type::String:
+            return variant.toString();
+        case Type::Color:
+            return variant.value<QColor>();
+        case Type::StringList:
+            return variant.toStringList();
+        case Type::RegularExpression:
+            return variant.toRegularExpression();
+        default:
+            return variant;
+    }
+}
+
+Program Program::compile(const Expression &expression)
+{
+    ProgramBuilder builder;
+    expression.compile(builder);
+    return builder.build();
+}
+
+bool Program::isEmpty() const
+{
+    return this->instructions_.empty();
+}
+
+Value Program::execute(FilterContext &context) const
+{
+    Stack stack;
+    stack.reserve(this->maxStackDepth_);
+
+    const auto size = this->instructions_.size();
+    for (size_t pc = 0; pc < size; ++pc)
+    {
+        const auto &ins = this->instructions_[pc];
+        switch (ins.op)
+        {
+            case OpCode::PushConstant:
+                stack.push_back(this->constants_[ins.arg]);
+                break;
+            case OpCode::LoadVariable:
+                stack.push_back(context.get(ins.arg));
+                break;
+            case OpCode::JumpIfFalseOrPop:
+                if (!std::get<bool>(stack.back()))
+                {
+                    pc = static_cast<size_t>(ins.arg) - 1;
+                }
+                else
+                {
+                    stack.pop_back();
+                }
+                break;
+            case OpCode::JumpIfTrueOrPop:
+                if (std::get<bool>(stack.back()))
+                {
+                    pc = static_cast<size_t>(ins.arg) - 1;
+                }
+                else
+                {
+                    stack.pop_back();
+                }
+                break;
+
+            case OpCode::Not: {
+                auto &top = std::get<bool>(stack.back());
+                top = !top;
+            }
+            break;
+
+            case OpCode::IntAdd:
+                binary<int, int>(stack, std::plus<int>{});
+                break;
+            case OpCode::IntSubtract:
+                binary<int, int>(stack, std::minus<int>{});
+                break;
+            case OpCode::IntMultiply:
+                binary<int, int>(stack, std::multiplies<int>{});
+                break;
+            case OpCode::IntDivide:
+                binary<int, int>(stack, divide);
+                break;
+            case OpCode::IntModulo:
+                binary<int, int>(stack, modulo);
+                break;
+
+            case OpCode::IntEqual:
+                binary<int, int>(stack, std::equal_to<int>{});
+                break;
+            case OpCode::IntNotEqual:
+                binary<int, int>(stack, std::not_equal_to<int>{});
+                break;
+            case OpCode::IntLess:
+                binary<int, int>(stack, std::less<int>{});
+                break;
+            case OpCode::IntGreater:
+                binary<int, int>(stack, std::greater<int>{});
+                break;
+            case OpCode::IntLessEqual:
+                binary<int, int>(stack, std::less_equal<int>{});
+                break;
+            case OpCode::IntGreaterEqual:
+                binary<int, int>(stack, std::greater_equal<int>{});
+                break;
+
+            case OpCode::BoolEqual:
+                binary<bool, bool>(stack, std::equal_to<bool>{});
+                break;
+            case OpCode::BoolNotEqual:
+                binary<bool, bool>(stack, std::not_equal_to<bool>{});
+                break;
+
+            case OpCode::StringConcat:
+                binary<QString, QString>(
+                    stack, [](const QString &l, const QString &r) -> QString {
+                        return l + r;
+                    });
+                break;
+            case OpCode::StringConcatInt:
+                binary<QString, int>(
+                    stack, [](const QString &l, int r) -> QString {
+                        return l + QString::number(r);
+                    });
+                break;
+            case OpCode::StringEqual:
+                binary<QString, QString>(
+                    stack, [](const QString &l, const QString &r) {
+                        return l.compare(r, Qt::CaseInsensitive) == 0;
+                    });
+                break;
+            case OpCode::StringNotEqual:
+                binary<QString, QString>(
+                    stack, [](const QString &l, const QString &r) {
+                        return l.compare(r, Qt::CaseInsensitive) != 0;
+                    });
+                break;
+            case OpCode::StringContains:
+                binary<QString, QString>(
+                    stack, [](const QString &l, const QString &r) {
+                        return l.contains(r, Qt::CaseInsensitive);
+                    });
+                break;
+            case OpCode::StringStartsWith:
+                binary<QString, QString>(
+                    stack, [](const QString &l, const QString &r) {
+                        return l.startsWith(r, Qt::CaseInsensitive);
+                    });
+                break;
+            case OpCode::StringEndsWith:
+                binary<QString, QString>(
+                    stack, [](const QString &l, const QString &r) {
+                        return l.endsWith(r, Qt::CaseInsensitive);
+                    });
+                break;
+
+            case OpCode::StringListContains:
+                binary<QStringList, QString>(
+                    stack, [](const QStringList &l, const QString &r) {
+                        return l.contains(r, Qt::CaseInsensitive);
+                    });
+                break;
+            case OpCode::StringListStartsWith:
+                binary<QStringList, QString>(
+                    stack, [](const QStringList &l, const QString &r) {
+                        return !l.isEmpty() &&
+                               l.first().compare(r, Qt::CaseInsensitive) == 0;
+                    });
+                break;
+            case OpCode::StringListEndsWith:
+                binary<QStringList, QString>(
+                    stack, [](const QStringList &l, const QString &r) {
+                        return !l.isEmpty() &&
+                               l.last().compare(r, Qt::CaseInsensitive) == 0;
+                    });
+                break;
+
+            case OpCode::RegexMatch:
+                binary<QString, QRegularExpression>(
+                    stack,
+                    [](const QString &l, const QRegularExpression &r) {
+                        return r.match(l).hasMatch();
+                    });
+                break;
+
+            case OpCode::MakeStringList: {
+                QStringList list;
+                list.reserve(ins.arg);
+                auto first = stack.end() - ins.arg;
+                for (auto it = first; it != stack.end(); ++it)
+                {
+                    list.append(std::get<QString>(std::move(*it)));
+                }
+                stack.erase(first, stack.end());
+                stack.emplace_back(std::move(list));
+            }
+            break;
+            case OpCode::MakeList: {
+                QList<QVariant> list;
+                list.reserve(ins.arg);
+                auto first = stack.end() - ins.arg;
+                for (auto it = first; it != stack.end(); ++it)
+                {
+                    list.append(valueToVariant(*it));
+                }
+                stack.erase(first, stack.end());
+                stack.emplace_back(valueFromVariant(
+                    makeListVariant(std::move(list)), ins.type));
+            }
+            break;
+
+            case OpCode::GenericBinary: {
+                auto right = valueToVariant(stack.back());
+                stack.pop_back();
+                auto left = valueToVariant(stack.back());
+                stack.back() = valueFromVariant(
+                    evaluateBinaryOperation(static_cast<TokenType>(ins.arg),
+                                            std::move(left), std::move(right)),
+                    ins.type);
+            }
+            break;
+            case OpCode::GenericUnary: {
+                auto right = valueToVariant(stack.back());
+                stack.back() = valueFromVariant(
+                    evaluateUnaryOperation(static_cast<TokenType>(ins.arg),
+                                           right),
+                    ins.type);
+            }
+            break;
+        }
+    }
+
+    assert(stack.size() == 1);
+    return std::move(stack.back());
+}
+
+QString Program::disassemble() const
+{
+    QStringList lines;
+    for (size_t i = 0; i < this->instructions_.size(); ++i)
+    {
+        const auto &ins = this->instructions_[i];
+        auto line = QString("%1: %2").arg(i).arg(
+            chatterino::qmagicenum::enumNameString(ins.op));
+        switch (ins.op)
+        {
+            case OpCode::PushConstant:
+                line += ' ' + valueToVariant(this->constants_[ins.arg])
+                                  .toString();
+                break;
+            case OpCode::LoadVariable:
+                line += ' ' + FilterContext::identifierAt(ins.arg);
+                break;
+            case OpCode::GenericBinary:
+            case OpCode::GenericUnary:
+                line += ' ' + tokenTypeToInfoString(
+                                  static_cast<TokenType>(ins.arg));
+                break;
+            case OpCode::JumpIfFalseOrPop:
+            case OpCode::JumpIfTrueOrPop:
+            case OpCode::MakeStringList:
+            case OpCode::MakeList:
+                line += ' ' + QString::number(ins.arg);
+                break;
+            default:
+                break;
+        }
+        lines.append(line);
+    }
+    return lines.join('\n');
+}
+
+ProgramBuilder::ProgramBuilder() = default;
+
+Type ProgramBuilder::typeOf(const Expression &expression) const
+{
+    auto possible = expression.synthesizeType(MESSAGE_TYPING_CONTEXT);
+    assert(isWellTyped(possible));
+    if (const auto *type = std::get_if<TypeClass>(&possible))
+    {
+        return type->type;
+    }
+    return Type::Bool;
+}
+
+void ProgramBuilder::emitOp(OpCode op, int32_t arg, Type type)
+{
+    switch (op)
+    {
+        case OpCode::PushConstant:
+        case OpCode::LoadVariable:
+            this->adjustStack(1);
+            break;
+        case OpCode::JumpIfFalseOrPop:
+        case OpCode::JumpIfTrueOrPop:
+            // The fallthrough path pops the condition. When jumping, the
+            // condition takes the place of the right hand side.
+            this->adjustStack(-1);
+            break;
+        case OpCode::Not:
+        case OpCode::GenericUnary:
+            break;
+        case OpCode::MakeStringList:
+        case OpCode::MakeList:
+            this->adjustStack(1 - arg);
+            break;
+        default:
+            // binary operators
+            this->adjustStack(-1);
+            break;
+    }
+
+    this->program_.instructions_.push_back({op, type, arg});
+}
+
+void ProgramBuilder::emitConstant(Value value)
+{
+    this->program_.constants_.emplace_back(std::move(value));
+    this->emitOp(OpCode::PushConstant,
+               static_cast<int32_t>(this->program_.constants_.size() - 1));
+}
+
+void ProgramBuilder::emitVariable(const QString &identifier)
+{
+    auto slot = FilterContext::slotOf(identifier);
+    if (slot < 0)
+    {
+        // Unreachable for type checked expressions
+        assert(false && "Unbound identifier");
+        this->emitConstant(QVariant());
+        return;
+    }
+
+    this->emitOp(OpCode::LoadVariable, slot);
+}
+
+size_t ProgramBuilder::emitJump(OpCode op)
+{
+    assert(op == OpCode::JumpIfFalseOrPop || op == OpCode::JumpIfTrueOrPop);
+    this->emitOp(op);
+    return this->program_.instructions_.size() - 1;
+}
+
+void ProgramBuilder::patchJump(size_t position)
+{
+    this->program_.instructions_[position].arg =
+        static_cast<int32_t>(this->program_.instructions_.size());
+}
+
+Program ProgramBuilder::build()
+{
+    assert(this->stackDepth_ == 1);
+    this->stackDepth_ = 0;
+    return std::move(this->program_);
+}
+
+void ProgramBuilder::adjustStack(int delta)
+{
+    this->stackDepth_ = static_cast<size_t>(
+        static_cast<int64_t>(this->stackDepth_) + delta);
+    this->program_.maxStackDepth_ =
+        std::max(this->program_.maxStackDepth_, this->stackDepth_);
+}
+
+}  // namespace chatterino::filters
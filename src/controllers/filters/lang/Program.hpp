@@ -0,0 +1,167 @@
+#pragma once
+
+#include "controllers/filters/lang/Tokenizer.hpp"
+#include "controllers/filters/lang/Types.hpp"
+
+#include <QColor>
+#include <QRegularExpression>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+
+#include <cstdint>
+#include <variant>
+#include <vector>
+
+namespace chatterino::filters {
+
+class Expression;
+class FilterContext;
+
+/// A value on the stack of a compiled filter Program.
+///
+/// Every filter type with a "hot" operation gets its own alternative, so the
+/// common operations never have to box their operands in a QVariant.
+/// Lists of mixed types, matching specifiers and maps are rare enough that they
+/// are kept as a QVariant and handled by the generic operations.
+using Value = std::variant<bool, int, QString, QColor, QStringList,
+                           QRegularExpression, QVariant>;
+
+QVariant valueToVariant(const Value &value);
+
+/// Converts the result of a generic (QVariant) operation back to the
+/// alternative that the typed operations expect for `type`.
+Value valueFromVariant(const QVariant &variant, Type type);
+
+enum class OpCode : uint8_t {
+    /// Push constant number `arg`
+    PushConstant,
+    /// Push the variable in context slot `arg`
+    LoadVariable,
+    /// If the Bool on top of the stack is false, jump to `arg`.
+    /// Otherwise, pop it and continue.
+    JumpIfFalseOrPop,
+    /// If the Bool on top of the stack is true, jump to `arg`.
+    /// Otherwise, pop it and continue.
+    JumpIfTrueOrPop,
+
+    /// !Bool
+    Not,
+
+    /// Int (+ - * / %) Int
+    IntAdd,
+    IntSubtract,
+    IntMultiply,
+    IntDivide,
+    IntModulo,
+
+    /// Int (== != < > <= >=) Int
+    IntEqual,
+    IntNotEqual,
+    IntLess,
+    IntGreater,
+    IntLessEqual,
+    IntGreaterEqual,
+
+    /// Bool (== !=) Bool
+    BoolEqual,
+    BoolNotEqual,
+
+    /// String + String
+    StringConcat,
+    /// String + Int
+    StringConcatInt,
+    /// String (== != contains startswith endswith) String, case-insensitive
+    StringEqual,
+    StringNotEqual,
+    StringContains,
+    StringStartsWith,
+    StringEndsWith,
+
+    /// StringList (contains startswith endswith) String, case-insensitive
+    StringListContains,
+    StringListStartsWith,
+    StringListEndsWith,
+
+    /// String match RegularExpression
+    RegexMatch,
+
+    /// Pop `arg` Strings and push them as one StringList
+    MakeStringList,
+    /// Pop `arg` values and push them as a list, see ListExpression::execute
+    MakeList,
+
+    /// Pop two values and apply the binary operator `arg` on their QVariant
+    /// representation. The result is converted back to `type`.
+    GenericBinary,
+    /// Pop one value and apply the unary operator `arg` on its QVariant
+    /// representation. The result is converted back to `type`.
+    GenericUnary,
+};
+
+struct Instruction {
+    OpCode op;
+    /// Result type of generic operations
+    Type type = Type::Bool;
+    int32_t arg = 0;
+};
+
+/// A filter expression compiled to a flat list of typed instructions.
+///
+/// Variables are resolved to FilterContext slots at compile time, so
+/// evaluating a program only computes the message fields it references.
+class Program
+{
+public:
+    Program() = default;
+
+    /// Compiles the well-typed expression `expression`.
+    /// The expression must have been type checked against
+    /// MESSAGE_TYPING_CONTEXT.
+    static Program compile(const Expression &expression);
+
+    Value execute(FilterContext &context) const;
+
+    bool isEmpty() const;
+
+    /// Human readable listing of the instructions, used for debugging
+    QString disassemble() const;
+
+private:
+    friend class ProgramBuilder;
+
+    std::vector<Instruction> instructions_;
+    std::vector<Value> constants_;
+    size_t maxStackDepth_ = 0;
+};
+
+/// Collects instructions while compiling an Expression tree.
+/// See Expression::compile.
+class ProgramBuilder
+{
+public:
+    ProgramBuilder();
+
+    /// Returns the type of `expression` in MESSAGE_TYPING_CONTEXT.
+    /// Compiled expressions are always well-typed, so this never fails.
+    Type typeOf(const Expression &expression) const;
+
+    void emitOp(OpCode op, int32_t arg = 0, Type type = Type::Bool);
+    void emitConstant(Value value);
+    void emitVariable(const QString &identifier);
+
+    /// Emits a conditional jump and returns its position to patch it later
+    size_t emitJump(OpCode op);
+    /// Points the jump at `position` to the next emitted instruction
+    void patchJump(size_t position);
+
+    Program build();
+
+private:
+    void adjustStack(int delta);
+
+    Program program_;
+    size_t stackDepth_ = 0;
+};
+
+}  // namespace chatterino::filters
@@ -1,7 +1,11 @@
 #include "controllers/filters/lang/expressions/BinaryOperation.hpp"
 
+#include "controllers/filters/lang/Program.hpp"
+
 #include <QRegularExpression>
 
+#include <optional>
+
 namespace {
 
 /// Loosely compares `lhs` with `rhs`.
@@ -51,9 +55,13 @@ BinaryOperation::BinaryOperation(TokenType op, ExpressionPtr left,
 
 QVariant BinaryOperation::execute(const ContextMap &context) const
 {
-    auto left = this->left_->execute(context);
-    auto right = this->right_->execute(context);
-    switch (this->op_)
+    return evaluateBinaryOperation(this->op_, this->left_->execute(context),
+                                   this->right_->execute(context));
+}
+
+QVariant evaluateBinaryOperation(TokenType op, QVariant left, QVariant right)
+{
+    switch (op)
     {
         case PLUS:
             if (variantIs(left, QMetaType::QString) &&
@@ -269,6 +277,131 @@ QVariant BinaryOperation::execute(const ContextMap &context) const
     }
 }
 
+void BinaryOperation::compile(ProgramBuilder &builder) const
+{
+    auto left = builder.typeOf(*this->left_);
+    auto right = builder.typeOf(*this->right_);
+
+    if (this->op_ == AND || this->op_ == OR)
+    {
+        // Both operands are Bools, so we can short-circuit
+        this->left_->compile(builder);
+        auto jump = builder.emitJump(this->op_ == AND
+                                         ? OpCode::JumpIfFalseOrPop
+                                         : OpCode::JumpIfTrueOrPop);
+        this->right_->compile(builder);
+        builder.patchJump(jump);
+        return;
+    }
+
+    this->left_->compile(builder);
+    this->right_->compile(builder);
+
+    auto typedOp = [&]() -> std::optional<OpCode> {
+        if (left == Type::Int && right == Type::Int)
+        {
+            switch (this->op_)
+            {
+                case PLUS:
+                    return OpCode::IntAdd;
+                case MINUS:
+                    return OpCode::IntSubtract;
+                case MULTIPLY:
+                    return OpCode::IntMultiply;
+                case DIVIDE:
+                    return OpCode::IntDivide;
+                case MOD:
+                    return OpCode::IntModulo;
+                case EQ:
+                    return OpCode::IntEqual;
+                case NEQ:
+                    return OpCode::IntNotEqual;
+                case LT:
+                    return OpCode::IntLess;
+                case GT:
+                    return OpCode::IntGreater;
+                case LTE:
+                    return OpCode::IntLessEqual;
+                case GTE:
+                    return OpCode::IntGreaterEqual;
+                default:
+                    return std::nullopt;
+            }
+        }
+
+        if (left == Type::Bool && right == Type::Bool)
+        {
+            switch (this->op_)
+            {
+                case EQ:
+                    return OpCode::BoolEqual;
+                case NEQ:
+                    return OpCode::BoolNotEqual;
+                default:
+                    return std::nullopt;
+            }
+        }
+
+        if (left == Type::String && right == Type::Int && this->op_ == PLUS)
+        {
+            return OpCode::StringConcatInt;
+        }
+
+        if (left == Type::String && right == Type::String)
+        {
+            switch (this->op_)
+            {
+                case PLUS:
+                    return OpCode::StringConcat;
+                case EQ:
+                    return OpCode::StringEqual;
+                case NEQ:
+                    return OpCode::StringNotEqual;
+                case CONTAINS:
+                    return OpCode::StringContains;
+                case STARTS_WITH:
+                    return OpCode::StringStartsWith;
+                case ENDS_WITH:
+                    return OpCode::StringEndsWith;
+                default:
+                    return std::nullopt;
+            }
+        }
+
+        if (left == Type::StringList && right == Type::String)
+        {
+            switch (this->op_)
+            {
+                case CONTAINS:
+                    return OpCode::StringListContains;
+                case STARTS_WITH:
+                    return OpCode::StringListStartsWith;
+                case ENDS_WITH:
+                    return OpCode::StringListEndsWith;
+                default:
+                    return std::nullopt;
+            }
+        }
+
+        if (left == Type::String && right == Type::RegularExpression &&
+            this->op_ == MATCH)
+        {
+            return OpCode::RegexMatch;
+        }
+
+        return std::nullopt;
+    }();
+
+    if (typedOp)
+    {
+        builder.emitOp(*typedOp);
+    }
+    else
+    {
+        builder.emitOp(OpCode::GenericBinary, this->op_, builder.typeOf(*this));
+    }
+}
+
 PossibleType BinaryOperation::synthesizeType(const TypingContext &context) const
 {
     auto leftSyn = this->left_->synthesizeType(context);
@@ -11,6 +11,7 @@ public:
     BinaryOperation(TokenType op, ExpressionPtr left, ExpressionPtr right);
 
     QVariant execute(const ContextMap &context) const override;
+    void compile(ProgramBuilder &builder) const override;
     PossibleType synthesizeType(const TypingContext &context) const override;
     QString debug(const TypingContext &context) const override;
     QString filterString() const override;
@@ -21,4 +22,7 @@ private:
     ExpressionPtr right_;
 };
 
+/// Applies the binary operator `op` to two evaluated operands
+QVariant evaluateBinaryOperation(TokenType op, QVariant left, QVariant right);
+
 }  // namespace chatterino::filters
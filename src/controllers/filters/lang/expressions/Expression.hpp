@@ -11,12 +11,16 @@
 
 namespace chatterino::filters {
 
+class ProgramBuilder;
+
 class Expression
 {
 public:
     virtual ~Expression() = default;
 
     virtual QVariant execute(const ContextMap &context) const = 0;
+    /// Appends the instructions that evaluate this expression to `builder`
+    virtual void compile(ProgramBuilder &builder) const = 0;
     virtual PossibleType synthesizeType(const TypingContext &context) const = 0;
     virtual QString debug(const TypingContext &context) const = 0;
     virtual QString filterString() const = 0;
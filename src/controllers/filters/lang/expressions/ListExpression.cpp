@@ -1,5 +1,7 @@
 #include "controllers/filters/lang/expressions/ListExpression.hpp"
 
+#include "controllers/filters/lang/Program.hpp"
+
 namespace chatterino::filters {
 
 ListExpression::ListExpression(ExpressionList &&list)
@@ -8,15 +10,43 @@ ListExpression::ListExpression(ExpressionList &&list)
 QVariant ListExpression::execute(const ContextMap &context) const
 {
     QList<QVariant> results;
-    bool allStrings = true;
+    results.reserve(static_cast<qsizetype>(this->list_.size()));
+    for (const auto &exp : this->list_)
+    {
+        results.append(exp->execute(context));
+    }
+
+    return makeListVariant(std::move(results));
+}
+
+void ListExpression::compile(ProgramBuilder &builder) const
+{
     for (const auto &exp : this->list_)
     {
-        auto res = exp->execute(context);
-        if (allStrings && variantIsNot(res, QMetaType::QString))
+        exp->compile(builder);
+    }
+
+    auto count = static_cast<int32_t>(this->list_.size());
+    if (builder.typeOf(*this) == Type::StringList)
+    {
+        builder.emitOp(OpCode::MakeStringList, count);
+    }
+    else
+    {
+        builder.emitOp(OpCode::MakeList, count, builder.typeOf(*this));
+    }
+}
+
+QVariant makeListVariant(QList<QVariant> results)
+{
+    bool allStrings = true;
+    for (const auto &res : results)
+    {
+        if (variantIsNot(res, QMetaType::QString))
         {
             allStrings = false;
+            break;
         }
-        results.append(res);
     }
 
     // if everything is a string return a QStringList for case-insensitive comparison
@@ -11,6 +11,7 @@ public:
     ListExpression(ExpressionList &&list);
 
     QVariant execute(const ContextMap &context) const override;
+    void compile(ProgramBuilder &builder) const override;
     PossibleType synthesizeType(const TypingContext &context) const override;
     QString debug(const TypingContext &context) const override;
     QString filterString() const override;
@@ -19,4 +20,9 @@ private:
     ExpressionList list_;
 };
 
+/// Builds the value of a list from its evaluated items.
+/// If all items are Strings, this returns a QStringList so comparisons can be
+/// case-insensitive.
+QVariant makeListVariant(QList<QVariant> results);
+
 }  // namespace chatterino::filters
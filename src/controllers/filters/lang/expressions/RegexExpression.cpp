@@ -1,5 +1,7 @@
 #include "controllers/filters/lang/expressions/RegexExpression.hpp"
 
+#include "controllers/filters/lang/Program.hpp"
+
 namespace chatterino::filters {
 
 RegexExpression::RegexExpression(const QString &regex, bool caseInsensitive)
@@ -14,6 +16,11 @@ QVariant RegexExpression::execute(const ContextMap & /*context*/) const
     return this->regex_;
 }
 
+void RegexExpression::compile(ProgramBuilder &builder) const
+{
+    builder.emitConstant(this->regex_);
+}
+
 PossibleType RegexExpression::synthesizeType(
     const TypingContext & /*context*/) const
 {
@@ -13,6 +13,7 @@ public:
     RegexExpression(const QString &regex, bool caseInsensitive);
 
     QVariant execute(const ContextMap &context) const override;
+    void compile(ProgramBuilder &builder) const override;
     PossibleType synthesizeType(const TypingContext &context) const override;
     QString debug(const TypingContext &context) const override;
     QString filterString() const override;
@@ -1,5 +1,7 @@
 #include "controllers/filters/lang/expressions/UnaryOperation.hpp"
 
+#include "controllers/filters/lang/Program.hpp"
+
 namespace chatterino::filters {
 
 UnaryOperation::UnaryOperation(TokenType op, ExpressionPtr right)
@@ -10,8 +12,12 @@ UnaryOperation::UnaryOperation(TokenType op, ExpressionPtr right)
 
 QVariant UnaryOperation::execute(const ContextMap &context) const
 {
-    auto right = this->right_->execute(context);
-    switch (this->op_)
+    return evaluateUnaryOperation(this->op_, this->right_->execute(context));
+}
+
+QVariant evaluateUnaryOperation(TokenType op, const QVariant &right)
+{
+    switch (op)
     {
         case NOT:
             return right.canConvert<bool>() && !right.toBool();
@@ -20,6 +26,19 @@ QVariant UnaryOperation::execute(const ContextMap &context) const
     }
 }
 
+void UnaryOperation::compile(ProgramBuilder &builder) const
+{
+    this->right_->compile(builder);
+
+    if (this->op_ == NOT && builder.typeOf(*this->right_) == Type::Bool)
+    {
+        builder.emitOp(OpCode::Not);
+        return;
+    }
+
+    builder.emitOp(OpCode::GenericUnary, this->op_, builder.typeOf(*this));
+}
+
 PossibleType UnaryOperation::synthesizeType(const TypingContext &context) const
 {
     auto rightSyn = this->right_->synthesizeType(context);
@@ -11,6 +11,7 @@ public:
     UnaryOperation(TokenType op, ExpressionPtr right);
 
     QVariant execute(const ContextMap &context) const override;
+    void compile(ProgramBuilder &builder) const override;
     PossibleType synthesizeType(const TypingContext &context) const override;
     QString debug(const TypingContext &context) const override;
     QString filterString() const override;
@@ -20,4 +21,7 @@ private:
     ExpressionPtr right_;
 };
 
+/// Applies the unary operator `op` to an evaluated operand
+QVariant evaluateUnaryOperation(TokenType op, const QVariant &right);
+
 }  // namespace chatterino::filters
@@ -1,5 +1,6 @@
 #include "controllers/filters/lang/expressions/ValueExpression.hpp"
 
+#include "controllers/filters/lang/Program.hpp"
 #include "controllers/filters/lang/Tokenizer.hpp"
 
 namespace chatterino::filters {
@@ -19,6 +20,25 @@ QVariant ValueExpression::execute(const ContextMap &context) const
     return this->value_;
 }
 
+void ValueExpression::compile(ProgramBuilder &builder) const
+{
+    switch (this->type_)
+    {
+        case TokenType::IDENTIFIER:
+            builder.emitVariable(this->value_.toString());
+            break;
+        case TokenType::INT:
+            builder.emitConstant(this->value_.toInt());
+            break;
+        case TokenType::STRING:
+            builder.emitConstant(this->value_.toString());
+            break;
+        default:
+            builder.emitConstant(this->value_);
+            break;
+    }
+}
+
 PossibleType ValueExpression::synthesizeType(const TypingContext &context) const
 {
     switch (this->type_)
@@ -5,6 +5,7 @@
 #include "controllers/accounts/AccountController.hpp"
 #include "controllers/highlights/HighlightBadge.hpp"
 #include "controllers/highlights/HighlightPhrase.hpp"
+#include "controllers/highlights/HighlightPhraseMatcher.hpp"
 #include "messages/Message.hpp"
 #include "messages/MessageBuilder.hpp"
 #include "providers/colors/ColorProvider.hpp"
@@ -17,40 +18,104 @@ namespace {
 
 using namespace chatterino;
 
-auto highlightPhraseCheck(const HighlightPhrase &highlight) -> HighlightCheck
+HighlightResult highlightPhraseResult(const HighlightPhrase &highlight)
 {
-    return HighlightCheck{
-        [highlight](const auto &args, const auto &badges,
-                    const auto &senderName, const auto &originalMessage,
-                    const auto &flags,
-                    const auto self) -> std::optional<HighlightResult> {
-            (void)args;        // unused
-            (void)badges;      // unused
-            (void)senderName;  // unused
-            (void)flags;       // unused
+    std::optional<QUrl> highlightSoundUrl;
+    if (highlight.hasCustomSound())
+    {
+        highlightSoundUrl = highlight.getSoundUrl();
+    }
+
+    return HighlightResult{
+        highlight.hasAlert(),       highlight.hasSound(),
+        highlightSoundUrl,          highlight.getColor(),
+        highlight.showInMentions(),
+    };
+}
+
+/// Sets all properties of `result` that aren't set yet from `other`
+void mergeHighlightResult(HighlightResult &result,
+                          const HighlightResult &other)
+{
+    if (other.alert)
+    {
+        if (!result.alert)
+        {
+            result.alert = other.alert;
+        }
+    }
+
+    if (other.playSound)
+    {
+        if (!result.playSound)
+        {
+            result.playSound = other.playSound;
+        }
+    }
+
+    if (other.customSoundUrl)
+    {
+        if (!result.customSoundUrl)
+        {
+            result.customSoundUrl = other.customSoundUrl;
+        }
+    }
+
+    if (other.color)
+    {
+        if (!result.color)
+        {
+            result.color = other.color;
+        }
+    }
+
+    if (other.showInMentions)
+    {
+        if (!result.showInMentions)
+        {
+            result.showInMentions = other.showInMentions;
+        }
+    }
+}
 
+/// Checks all message phrases at once.
+///
+/// The results of all matching phrases are merged in order, just like the
+/// results of separate checks would be.
+auto highlightPhrasesCheck(std::vector<HighlightPhrase> phrases)
+    -> HighlightCheck
+{
+    auto matcher =
+        std::make_shared<const HighlightPhraseMatcher>(std::move(phrases));
+
+    return HighlightCheck{
+        [matcher](const auto & /*args*/, const auto & /*badges*/,
+                  const auto & /*senderName*/, const auto &originalMessage,
+                  const auto & /*flags*/,
+                  const auto self) -> std::optional<HighlightResult> {
             if (self)
             {
                 // Phrase checks should ignore highlights from the user
                 return std::nullopt;
             }
 
-            if (!highlight.isMatch(originalMessage))
+            auto matches = matcher->findMatches(originalMessage);
+            if (matches.empty())
             {
                 return std::nullopt;
             }
 
-            std::optional<QUrl> highlightSoundUrl;
-            if (highlight.hasCustomSound())
+            auto result = HighlightResult::emptyResult();
+            for (auto i : matches)
             {
-                highlightSoundUrl = highlight.getSoundUrl();
+                mergeHighlightResult(
+                    result, highlightPhraseResult(matcher->phrases()[i]));
+                if (result.full())
+                {
+                    break;
+                }
             }
-
-            return HighlightResult{
-                highlight.hasAlert(),       highlight.hasSound(),
-                highlightSoundUrl,          highlight.getColor(),
-                highlight.showInMentions(),
-            };
+            return result;
         }};
 }
 
@@ -186,23 +251,26 @@ void rebuildMessageHighlights(Settings &settings,
     auto currentUser = getApp()->getAccounts()->twitch.getCurrent();
     QString currentUsername = currentUser->getUserName();
 
+    // The self highlight comes before all other phrases
+    std::vector<HighlightPhrase> phrases;
     if (settings.enableSelfHighlight && !currentUsername.isEmpty() &&
         !currentUser->isAnon())
     {
-        HighlightPhrase highlight(
+        phrases.emplace_back(
             currentUsername, settings.showSelfHighlightInMentions,
             settings.enableSelfHighlightTaskbar,
             settings.enableSelfHighlightSound, false, false,
             settings.selfHighlightSoundUrl.getValue(),
             ColorProvider::instance().color(ColorType::SelfHighlight));
-
-        checks.emplace_back(highlightPhraseCheck(highlight));
     }
 
     auto messageHighlights = settings.highlightedMessages.readOnly();
-    for (const auto &highlight : *messageHighlights)
+    phrases.insert(phrases.end(), messageHighlights->begin(),
+                   messageHighlights->end());
+
+    if (!phrases.empty())
     {
-        checks.emplace_back(highlightPhraseCheck(highlight));
+        checks.emplace_back(highlightPhrasesCheck(std::move(phrases)));
     }
 
     if (settings.enableAutomodHighlight)
@@ -563,45 +631,7 @@ std::pair<bool, HighlightResult> HighlightController::check(
         {
             highlighted = true;
 
-            if (checkResult->alert)
-            {
-                if (!result.alert)
-                {
-                    result.alert = checkResult->alert;
-                }
-            }
-
-            if (checkResult->playSound)
-            {
-                if (!result.playSound)
-                {
-                    result.playSound = checkResult->playSound;
-                }
-            }
-
-            if (checkResult->customSoundUrl)
-            {
-                if (!result.customSoundUrl)
-                {
-                    result.customSoundUrl = checkResult->customSoundUrl;
-                }
-            }
-
-            if (checkResult->color)
-            {
-                if (!result.color)
-                {
-                    result.color = checkResult->color;
-                }
-            }
-
-            if (checkResult->showInMentions)
-            {
-                if (!result.showInMentions)
-                {
-                    result.showInMentions = checkResult->showInMentions;
-                }
-            }
+            mergeHighlightResult(result, *checkResult);
 
             if (result.full())
             {
@@ -0,0 +1,138 @@
+#include "controllers/highlights/HighlightPhraseMatcher.hpp"
+
+#include "common/QLogging.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+using namespace chatterino;
+
+enum class Candidate : uint8_t {
+    No,
+    /// Found by a prefilter, needs to be checked with the phrase's expression
+    Maybe,
+    Yes,
+};
+
+bool isAscii(const QString &str)
+{
+    return std::ranges::all_of(str, [](QChar c) {
+        return c.unicode() < 0x80;
+    });
+}
+
+}  // namespace
+
+namespace chatterino {
+
+HighlightPhraseMatcher::HighlightPhraseMatcher(
+    std::vector<HighlightPhrase> phrases)
+    : phrases_(std::move(phrases))
+{
+    std::vector<QString> plainPatterns;
+    std::vector<CombinedRegex::Pattern> regexPatterns;
+
+    for (size_t i = 0; i < this->phrases_.size(); i++)
+    {
+        const auto &phrase = this->phrases_[i];
+        if (!phrase.isValid())
+        {
+            // never matches
+            continue;
+        }
+
+        const auto &pattern = phrase.getPattern();
+        if (!phrase.isRegex() && isAscii(pattern))
+        {
+            // The automaton only finds candidates, the phrase's expression
+            // still checks the word boundaries and its case sensitivity.
+            // Case folding can map non-ASCII characters to ASCII ones (e.g.
+            // the Kelvin sign), but never the other way around.
+            plainPatterns.push_back(pattern);
+            this->plainPhrases_.push_back(i);
+        }
+        else if (phrase.isRegex() && CombinedRegex::canCombine(pattern))
+        {
+            regexPatterns.push_back({
+                .pattern = pattern,
+                .caseSensitivity = phrase.isCaseSensitive()
+                                       ? Qt::CaseSensitive
+                                       : Qt::CaseInsensitive,
+            });
+            this->combinedPhrases_.push_back(i);
+        }
+        else
+        {
+            this->otherPhrases_.push_back(i);
+        }
+    }
+
+    this->plainAutomaton_ = AhoCorasick(plainPatterns, Qt::CaseInsensitive);
+
+    this->combinedRegex_ = CombinedRegex(regexPatterns);
+    if (!this->combinedRegex_.empty() && !this->combinedRegex_.isValid())
+    {
+        qCWarning(chatterinoHighlights)
+            << "Failed to combine regex highlights:"
+            << this->combinedRegex_.errorString();
+        this->otherPhrases_.insert(this->otherPhrases_.end(),
+                                   this->combinedPhrases_.begin(),
+                                   this->combinedPhrases_.end());
+        std::ranges::sort(this->otherPhrases_);
+        this->combinedPhrases_.clear();
+        this->combinedRegex_ = {};
+    }
+}
+
+std::vector<size_t> HighlightPhraseMatcher::findMatches(
+    const QString &subject) const
+{
+    std::vector<Candidate> candidates(this->phrases_.size(), Candidate::No);
+
+    this->plainAutomaton_.forEachMatch(subject, [&](size_t pattern, auto) {
+        candidates[this->plainPhrases_[pattern]] = Candidate::Maybe;
+        return true;
+    });
+
+    if (!this->combinedRegex_.empty())
+    {
+        auto match = this->combinedRegex_.match(subject);
+        if (match.hasMatch())
+        {
+            // The group that matched is known to match on its own. All other
+            // regex phrases could still match later in the subject.
+            for (size_t i = 0; i < this->combinedPhrases_.size(); i++)
+            {
+                candidates[this->combinedPhrases_[i]] =
+                    this->combinedRegex_.isMatchOf(match, i) ? Candidate::Yes
+                                                             : Candidate::Maybe;
+            }
+        }
+    }
+
+    for (auto i : this->otherPhrases_)
+    {
+        candidates[i] = Candidate::Maybe;
+    }
+
+    std::vector<size_t> matches;
+    for (size_t i = 0; i < candidates.size(); i++)
+    {
+        if (candidates[i] == Candidate::Yes ||
+            (candidates[i] == Candidate::Maybe &&
+             this->phrases_[i].isMatch(subject)))
+        {
+            matches.push_back(i);
+        }
+    }
+    return matches;
+}
+
+const std::vector<HighlightPhrase> &HighlightPhraseMatcher::phrases() const
+{
+    return this->phrases_;
+}
+
+}  // namespace chatterino
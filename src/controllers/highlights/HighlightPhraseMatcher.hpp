@@ -0,0 +1,48 @@
+#pragma once
+
+#include "controllers/highlights/HighlightPhrase.hpp"
+#include "util/AhoCorasick.hpp"
+#include "util/CombinedRegex.hpp"
+
+#include <QString>
+
+#include <vector>
+
+namespace chatterino {
+
+/// Finds all HighlightPhrases that match a message.
+///
+/// Instead of running the regular expression of every phrase, plain phrases
+/// are searched for with one Aho-Corasick automaton and regex phrases with one
+/// combined alternation. Only phrases found that way are checked with their
+/// own expression, so the results are the same as HighlightPhrase::isMatch.
+class HighlightPhraseMatcher
+{
+public:
+    HighlightPhraseMatcher() = default;
+    explicit HighlightPhraseMatcher(std::vector<HighlightPhrase> phrases);
+
+    /// Returns the indices of all phrases that match `subject`, in the order
+    /// the phrases were given
+    std::vector<size_t> findMatches(const QString &subject) const;
+
+    const std::vector<HighlightPhrase> &phrases() const;
+
+private:
+    std::vector<HighlightPhrase> phrases_;
+
+    /// Plain ASCII phrases, case-insensitive
+    AhoCorasick plainAutomaton_;
+    /// Phrase index for each pattern of plainAutomaton_
+    std::vector<size_t> plainPhrases_;
+
+    /// Regex phrases that can be combined into one expression
+    CombinedRegex combinedRegex_;
+    /// Phrase index for each group of combinedRegex_
+    std::vector<size_t> combinedPhrases_;
+
+    /// Phrases that always need to be checked with their own expression
+    std::vector<size_t> otherPhrases_;
+};
+
+}  // namespace chatterino
@@ -9,6 +9,9 @@
 #include "providers/twitch/TwitchIrc.hpp"
 #include "singletons/Settings.hpp"
 
+#include <algorithm>
+#include <mutex>
+
 namespace {
 
 using namespace chatterino::literals;
@@ -127,69 +130,16 @@ QString makeRegexReplacement(QStringView source,
     return dst;
 }
 
-}  // namespace
-
-namespace chatterino {
+enum class ReplaceResult : uint8_t {
+    Unchanged,
+    Replaced,
+    /// The message was replaced with an error, no other phrases must run
+    TooManyReplacements,
+};
 
-bool isIgnoredMessage(IgnoredMessageParameters &&params)
-{
-    if (!params.message.isEmpty())
-    {
-        // TODO(pajlada): Do we need to check if the phrase is valid first?
-        auto phrases = getSettings()->ignoredMessages.readOnly();
-        for (const auto &phrase : *phrases)
-        {
-            if (phrase.isBlock() && phrase.isMatch(params.message))
-            {
-                qCDebug(chatterinoMessage)
-                    << "Blocking message because it contains ignored phrase"
-                    << phrase.getPattern();
-                return true;
-            }
-        }
-    }
-
-    if (!params.twitchUserID.isEmpty() &&
-        getSettings()->enableTwitchBlockedUsers)
-    {
-        auto sourceUserID = params.twitchUserID;
-
-        bool isBlocked = getApp()
-                             ->getAccounts()
-                             ->twitch.getCurrent()
-                             ->blockedUserIds()
-                             .contains(sourceUserID);
-        if (isBlocked)
-        {
-            switch (static_cast<ShowIgnoredUsersMessages>(
-                getSettings()->showBlockedUsersMessages.getValue()))
-            {
-                case ShowIgnoredUsersMessages::IfModerator:
-                    if (params.isMod || params.isBroadcaster)
-                    {
-                        return false;
-                    }
-                    break;
-                case ShowIgnoredUsersMessages::IfBroadcaster:
-                    if (params.isBroadcaster)
-                    {
-                        return false;
-                    }
-                    break;
-                case ShowIgnoredUsersMessages::Never:
-                    break;
-            }
-
-            return true;
-        }
-    }
-
-    return false;
-}
-
-void processIgnorePhrases(const std::vector<IgnorePhrase> &phrases,
-                          QString &content,
-                          std::vector<TwitchEmoteOccurrence> &twitchEmotes)
+/// Runs the replacements of a single phrase on `content`
+ReplaceResult replacePhrase(const IgnorePhrase &phrase, QString &content,
+                            std::vector<TwitchEmoteOccurrence> &twitchEmotes)
 {
     using SizeType = QString::size_type;
 
@@ -220,9 +170,8 @@ void processIgnorePhrases(const std::vector<IgnorePhrase> &phrases,
         }
     };
 
-    auto addReplEmotes = [&twitchEmotes](const IgnorePhrase &phrase,
-                                         const auto &midrepl,
-                                         SizeType startIndex) {
+    auto addReplEmotes = [&twitchEmotes, &phrase](const auto &midrepl,
+                                                  SizeType startIndex) {
         if (!phrase.containsEmote())
         {
             return;
@@ -258,8 +207,8 @@ void processIgnorePhrases(const std::vector<IgnorePhrase> &phrases,
         }
     };
 
-    auto replaceMessageAt = [&](const IgnorePhrase &phrase, SizeType from,
-                                SizeType length, const QString &replacement) {
+    auto replaceMessageAt = [&](SizeType from, SizeType length,
+                                const QString &replacement) {
         auto removedEmotes = removeEmotesInRange(from, length);
         content.replace(from, length, replacement);
         auto wordStart = from;
@@ -311,63 +260,281 @@ void processIgnorePhrases(const std::vector<IgnorePhrase> &phrases,
             }
         }
 
-        addReplEmotes(phrase, midExtendedRef, wordStart);
+        addReplEmotes(midExtendedRef, wordStart);
     };
 
+    if (phrase.isBlock())
+    {
+        return ReplaceResult::Unchanged;
+    }
+    const auto &pattern = phrase.getPattern();
+    if (pattern.isEmpty())
+    {
+        return ReplaceResult::Unchanged;
+    }
+    if (phrase.isRegex())
+    {
+        const auto &regex = phrase.getRegex();
+        if (!regex.isValid())
+        {
+            return ReplaceResult::Unchanged;
+        }
+
+        QRegularExpressionMatch match;
+        size_t iterations = 0;
+        SizeType from = 0;
+        while ((from = content.indexOf(regex, from, &match)) != -1)
+        {
+            auto replacement = phrase.getReplace();
+            if (regex.captureCount() > 0)
+            {
+                replacement = makeRegexReplacement(content, regex, match,
+                                                   replacement);
+            }
+
+            replaceMessageAt(from, match.capturedLength(), replacement);
+            from += phrase.getReplace().length();
+            iterations++;
+            if (iterations >= 128)
+            {
+                content = u"Too many replacements - check your ignores!"_s;
+                return ReplaceResult::TooManyReplacements;
+            }
+        }
+
+        return iterations == 0 ? ReplaceResult::Unchanged
+                               : ReplaceResult::Replaced;
+    }
+
+    auto result = ReplaceResult::Unchanged;
+    SizeType from = 0;
+    while ((from = content.indexOf(pattern, from,
+                                   phrase.caseSensitivity())) != -1)
+    {
+        replaceMessageAt(from, pattern.length(), phrase.getReplace());
+        from += phrase.getReplace().length();
+        result = ReplaceResult::Replaced;
+    }
+    return result;
+}
+
+}  // namespace
+
+namespace chatterino {
+
+bool isIgnoredMessage(IgnoredMessageParameters &&params)
+{
+    if (!params.message.isEmpty())
+    {
+        // TODO(pajlada): Do we need to check if the phrase is valid first?
+        auto phrases = getSettings()->ignoredMessages.readOnly();
+        for (const auto &phrase : *phrases)
+        {
+            if (phrase.isBlock() && phrase.isMatch(params.message))
+            {
+                qCDebug(chatterinoMessage)
+                    << "Blocking message because it contains ignored phrase"
+                    << phrase.getPattern();
+                return true;
+            }
+        }
+    }
+
+    if (!params.twitchUserID.isEmpty() &&
+        getSettings()->enableTwitchBlockedUsers)
+    {
+        auto sourceUserID = params.twitchUserID;
+
+        bool isBlocked = getApp()
+                             ->getAccounts()
+                             ->twitch.getCurrent()
+                             ->blockedUserIds()
+                             .contains(sourceUserID);
+        if (isBlocked)
+        {
+            switch (static_cast<ShowIgnoredUsersMessages>(
+                getSettings()->showBlockedUsersMessages.getValue()))
+            {
+                case ShowIgnoredUsersMessages::IfModerator:
+                    if (params.isMod || params.isBroadcaster)
+                    {
+                        return false;
+                    }
+                    break;
+                case ShowIgnoredUsersMessages::IfBroadcaster:
+                    if (params.isBroadcaster)
+                    {
+                        return false;
+                    }
+                    break;
+                case ShowIgnoredUsersMessages::Never:
+                    break;
+            }
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void processIgnorePhrases(const std::vector<IgnorePhrase> &phrases,
+                          QString &content,
+                          std::vector<TwitchEmoteOccurrence> &twitchEmotes)
+{
     for (const auto &phrase : phrases)
     {
-        if (phrase.isBlock())
+        if (replacePhrase(phrase, content, twitchEmotes) ==
+            ReplaceResult::TooManyReplacements)
         {
-            continue;
+            return;
         }
+    }
+}
+
+void processIgnorePhrases(QString &content,
+                          std::vector<TwitchEmoteOccurrence> &twitchEmotes)
+{
+    static std::mutex mutex;
+    static std::shared_ptr<const std::vector<IgnorePhrase>> compiledPhrases;
+    static std::shared_ptr<const IgnorePhraseReplacer> replacer;
+
+    auto phrases = getSettings()->ignoredMessages.readOnly();
+    std::shared_ptr<const IgnorePhraseReplacer> current;
+    {
+        std::lock_guard lock(mutex);
+        // readOnly() returns a new vector every time the phrases change
+        if (phrases != compiledPhrases)
+        {
+            replacer = std::make_shared<const IgnorePhraseReplacer>(phrases);
+            compiledPhrases = std::move(phrases);
+        }
+        current = replacer;
+    }
+
+    current->process(content, twitchEmotes);
+}
+
+IgnorePhraseReplacer::IgnorePhraseReplacer(
+    std::shared_ptr<const std::vector<IgnorePhrase>> phrases)
+    : phrases_(std::move(phrases))
+{
+    std::vector<QString> plainPatterns;
+    std::vector<CombinedRegex::Pattern> regexPatterns;
+
+    for (size_t i = 0; i < this->phrases_->size(); i++)
+    {
+        const auto &phrase = (*this->phrases_)[i];
         const auto &pattern = phrase.getPattern();
-        if (pattern.isEmpty())
+        if (phrase.isBlock() || pattern.isEmpty())
         {
             continue;
         }
+
         if (phrase.isRegex())
         {
-            const auto &regex = phrase.getRegex();
-            if (!regex.isValid())
+            if (!phrase.isRegexValid())
             {
                 continue;
             }
 
-            QRegularExpressionMatch match;
-            size_t iterations = 0;
-            SizeType from = 0;
-            while ((from = content.indexOf(regex, from, &match)) != -1)
+            if (CombinedRegex::canCombine(pattern))
             {
-                auto replacement = phrase.getReplace();
-                if (regex.captureCount() > 0)
-                {
-                    replacement = makeRegexReplacement(content, regex, match,
-                                                       replacement);
-                }
-
-                replaceMessageAt(phrase, from, match.capturedLength(),
-                                 replacement);
-                from += phrase.getReplace().length();
-                iterations++;
-                if (iterations >= 128)
-                {
-                    content = u"Too many replacements - check your ignores!"_s;
-                    return;
-                }
+                regexPatterns.push_back({
+                    .pattern = pattern,
+                    .caseSensitivity = phrase.caseSensitivity(),
+                });
+                this->combinedPhrases_.push_back(i);
             }
+            else
+            {
+                this->otherPhrases_.push_back(i);
+            }
+        }
+        else if (std::ranges::none_of(pattern, [](QChar c) {
+                     return c.isSurrogate();
+                 }))
+        {
+            // QString::indexOf folds the case of whole code points, the
+            // automaton only of single UTF-16 code units
+            plainPatterns.push_back(pattern);
+            this->plainPhrases_.push_back(i);
+        }
+        else
+        {
+            this->otherPhrases_.push_back(i);
+        }
+    }
+
+    this->plainAutomaton_ = AhoCorasick(plainPatterns, Qt::CaseInsensitive);
 
+    this->combinedRegex_ = CombinedRegex(regexPatterns);
+    if (!this->combinedRegex_.empty() && !this->combinedRegex_.isValid())
+    {
+        qCWarning(chatterinoMessage)
+            << "Failed to combine regex ignore phrases:"
+            << this->combinedRegex_.errorString();
+        this->otherPhrases_.insert(this->otherPhrases_.end(),
+                                   this->combinedPhrases_.begin(),
+                                   this->combinedPhrases_.end());
+        this->combinedPhrases_.clear();
+        this->combinedRegex_ = {};
+    }
+}
+
+void IgnorePhraseReplacer::process(
+    QString &content, std::vector<TwitchEmoteOccurrence> &twitchEmotes) const
+{
+    auto candidates = this->findCandidates(content);
+
+    for (size_t i = 0; i < this->phrases_->size(); i++)
+    {
+        if (!candidates[i])
+        {
             continue;
         }
 
-        SizeType from = 0;
-        while ((from = content.indexOf(pattern, from,
-                                       phrase.caseSensitivity())) != -1)
+        auto result =
+            replacePhrase((*this->phrases_)[i], content, twitchEmotes);
+        if (result == ReplaceResult::TooManyReplacements)
         {
-            replaceMessageAt(phrase, from, pattern.length(),
-                             phrase.getReplace());
-            from += phrase.getReplace().length();
+            return;
+        }
+        if (result == ReplaceResult::Replaced)
+        {
+            // The following phrases run on the replaced message
+            candidates = this->findCandidates(content);
         }
     }
 }
 
+std::vector<bool> IgnorePhraseReplacer::findCandidates(
+    const QString &content) const
+{
+    std::vector<bool> candidates(this->phrases_->size(), false);
+
+    this->plainAutomaton_.forEachMatch(content, [&](size_t pattern, auto) {
+        candidates[this->plainPhrases_[pattern]] = true;
+        return true;
+    });
+
+    // Phrases that didn't produce the first match could still match later
+    // in the message, so all of them need to run
+    if (!this->combinedRegex_.empty() &&
+        this->combinedRegex_.match(content).hasMatch())
+    {
+        for (auto i : this->combinedPhrases_)
+        {
+            candidates[i] = true;
+        }
+    }
+
+    for (auto i : this->otherPhrases_)
+    {
+        candidates[i] = true;
+    }
+
+    return candidates;
+}
+
 }  // namespace chatterino
@@ -1,7 +1,11 @@
 #pragma once
 
+#include "util/AhoCorasick.hpp"
+#include "util/CombinedRegex.hpp"
+
 #include <QString>
 
+#include <memory>
 #include <vector>
 
 namespace chatterino {
@@ -34,4 +38,48 @@ void processIgnorePhrases(const std::vector<IgnorePhrase> &phrases,
                           QString &content,
                           std::vector<TwitchEmoteOccurrence> &twitchEmotes);
 
+/// @brief Processes the replacement ignore-phrases from the settings for a
+/// message
+///
+/// Same as processIgnorePhrases with all ignored messages, but the phrases are
+/// only compiled into an IgnorePhraseReplacer when they change.
+void processIgnorePhrases(QString &content,
+                          std::vector<TwitchEmoteOccurrence> &twitchEmotes);
+
+/// Runs the replacements of a list of ignore phrases.
+///
+/// Plain phrases are searched for with one Aho-Corasick automaton and regex
+/// phrases with one combined expression. Only phrases found that way run their
+/// replacements, in the order of the list, so the result is the same as the
+/// one of processIgnorePhrases.
+class IgnorePhraseReplacer
+{
+public:
+    explicit IgnorePhraseReplacer(
+        std::shared_ptr<const std::vector<IgnorePhrase>> phrases);
+
+    /// @see processIgnorePhrases
+    void process(QString &content,
+                 std::vector<TwitchEmoteOccurrence> &twitchEmotes) const;
+
+private:
+    /// Returns for each phrase if it might replace something in `content`
+    std::vector<bool> findCandidates(const QString &content) const;
+
+    std::shared_ptr<const std::vector<IgnorePhrase>> phrases_;
+
+    /// Plain phrases, case-insensitive
+    AhoCorasick plainAutomaton_;
+    /// Phrase index for each pattern of plainAutomaton_
+    std::vector<size_t> plainPhrases_;
+
+    /// Regex phrases that can be combined into one expression
+    CombinedRegex combinedRegex_;
+    /// Phrase index for each pattern of combinedRegex_
+    std::vector<size_t> combinedPhrases_;
+
+    /// Phrases that always need to run
+    std::vector<size_t> otherPhrases_;
+};
+
 }  // namespace chatterino
@@ -118,5 +118,56 @@ QString toString(lua_State *L, StackIdx idx)
     const auto *ptr = luaL_tolstring(L, idx, &len);
     return QString::fromUtf8(ptr, int(len));
 }
+
+namespace {
+
+// The innermost budget of this thread. Lua states are only used by one thread.
+thread_local TimeBudget *currentBudget = nullptr;
+
+}  // namespace
+
+TimeBudget::TimeBudget(lua_State *L, std::chrono::milliseconds budget)
+    : L(L)
+    , budget(budget)
+    , start(std::chrono::steady_clock::now())
+    , previous(currentBudget)
+    , previousHook(lua_gethook(L))
+    , previousMask(lua_gethookmask(L))
+    , previousCount(lua_gethookcount(L))
+{
+    currentBudget = this;
+    lua_sethook(L, &TimeBudget::hook, LUA_MASKCOUNT, CHECK_INTERVAL);
+}
+
+TimeBudget::~TimeBudget()
+{
+    lua_sethook(this->L, this->previousHook, this->previousMask,
+                this->previousCount);
+    currentBudget = this->previous;
+}
+
+bool TimeBudget::exceeded() const
+{
+    return this->exceeded_;
+}
+
+std::chrono::nanoseconds TimeBudget::elapsed() const
+{
+    return std::chrono::steady_clock::now() - this->start;
+}
+
+void TimeBudget::hook(lua_State *L, lua_Debug * /*ar*/)
+{
+    auto *budget = currentBudget;
+    if (budget == nullptr || budget->elapsed() <= budget->budget)
+    {
+        return;
+    }
+
+    budget->exceeded_ = true;
+    luaL_error(L, "Exceeded the time budget of %d ms",
+               static_cast<int>(budget->budget.count()));
+}
+
 }  // namespace chatterino::lua
 #endif
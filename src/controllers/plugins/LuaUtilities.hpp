@@ -9,6 +9,7 @@
 #    include <sol/state_view.hpp>
 
 #    include <cassert>
+#    include <chrono>
 #    include <string>
 #    include <string_view>
 #    include <type_traits>
@@ -104,6 +105,50 @@ public:
     }
 };
 
+/**
+ * @brief Aborts Lua code that runs longer than a time budget.
+ *
+ * While this object exists, a count hook checks the time every thousand
+ * instructions and raises an error once the budget is exceeded. The error
+ * is returned by the protected call that ran the code. Code that's stuck in
+ * a single C function can't be interrupted and only fails once it returns.
+ * Coroutines that were created before the budget aren't checked.
+ */
+class TimeBudget
+{
+public:
+    TimeBudget(lua_State *L, std::chrono::milliseconds budget);
+    ~TimeBudget();
+
+    TimeBudget operator=(TimeBudget &) = delete;
+    TimeBudget &operator=(TimeBudget &&) = delete;
+    TimeBudget(TimeBudget &) = delete;
+    TimeBudget(TimeBudget &&) = delete;
+
+    /// Whether the code was aborted because it exceeded the budget
+    bool exceeded() const;
+
+    /// The time since this budget was created
+    std::chrono::nanoseconds elapsed() const;
+
+    /// How many instructions run between two checks of the time
+    static constexpr int CHECK_INTERVAL = 1000;
+
+private:
+    static void hook(lua_State *L, lua_Debug *ar);
+
+    lua_State *L;
+    std::chrono::milliseconds budget;
+    std::chrono::steady_clock::time_point start;
+    bool exceeded_ = false;
+
+    // restored when this budget ends
+    TimeBudget *previous;
+    lua_Hook previousHook;
+    int previousMask;
+    int previousCount;
+};
+
 /**
  * @brief Creates a table mapping enum names to unique values.
  *
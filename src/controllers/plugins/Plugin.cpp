@@ -189,6 +189,29 @@ PluginMeta::PluginMeta(const QJsonObject &obj)
     }
 }
 
+void PluginCallbackStats::record(std::chrono::nanoseconds elapsed,
+                                 bool wasAborted)
+{
+    this->calls++;
+    if (wasAborted)
+    {
+        this->aborted++;
+    }
+    this->total += elapsed;
+    this->max = std::max(this->max, elapsed);
+    this->last = elapsed;
+    this->lastAborted = wasAborted;
+}
+
+std::chrono::nanoseconds PluginCallbackStats::average() const
+{
+    if (this->calls == 0)
+    {
+        return {};
+    }
+    return this->total / static_cast<int64_t>(this->calls);
+}
+
 bool Plugin::registerCommand(const QString &name,
                              sol::protected_function function)
 {
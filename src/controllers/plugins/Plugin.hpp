@@ -13,6 +13,8 @@
 #    include <semver/semver.hpp>
 #    include <sol/forward.hpp>
 
+#    include <chrono>
+#    include <map>
 #    include <memory>
 #    include <optional>
 #    include <unordered_map>
@@ -63,6 +65,20 @@ struct PluginMeta {
     PluginMeta() = default;
 };
 
+/// How long the calls of a plugin's callback took
+struct PluginCallbackStats {
+    size_t calls = 0;
+    /// Calls that were aborted because they exceeded their time budget
+    size_t aborted = 0;
+    std::chrono::nanoseconds total{};
+    std::chrono::nanoseconds max{};
+    std::chrono::nanoseconds last{};
+    bool lastAborted = false;
+
+    void record(std::chrono::nanoseconds elapsed, bool wasAborted);
+    std::chrono::nanoseconds average() const;
+};
+
 class Plugin
 {
 public:
@@ -139,6 +155,9 @@ public:
     bool hasNetworkPermission() const;
 
     std::map<lua::api::EventType, sol::protected_function> callbacks;
+    std::map<lua::api::EventType, PluginCallbackStats> callbackStats;
+    /// The calls of the commands registered with c2.register_command
+    PluginCallbackStats commandStats;
 
     // In-flight HTTP Requests
     // This is a lifetime hack to ensure they get deleted with the plugin. This relies on the Plugin getting deleted on reload!
@@ -29,10 +29,30 @@
 #    include <sol/variadic_args.hpp>
 #    include <sol/variadic_results.hpp>
 
+#    include <algorithm>
 #    include <memory>
 #    include <utility>
 #    include <variant>
 
+namespace {
+
+using namespace chatterino;
+
+/// Whether the last completion of `plugin` was slow or aborted
+bool isSlowCompletion(const Plugin &plugin)
+{
+    auto it = plugin.callbackStats.find(
+        lua::api::EventType::CompletionRequested);
+    if (it == plugin.callbackStats.end())
+    {
+        return false;
+    }
+    return it->second.lastAborted ||
+           it->second.last > PluginController::SLOW_COMPLETION;
+}
+
+}  // namespace
+
 namespace chatterino {
 
 PluginController::PluginController(const Paths &paths_)
@@ -328,8 +348,10 @@ QString PluginController::tryExecPluginCommand(const QString &commandName,
                 "channel", lua::api::ChannelRef(ctx.channel)  //
             );
 
+            lua::TimeBudget budget(plugin->state_, COMMAND_BUDGET);
             auto result =
                 lua::tryCall<std::optional<QString>>(it->second, args);
+            plugin->commandStats.record(budget.elapsed(), budget.exceeded());
             if (!result)
             {
                 ctx.channel->addSystemMessage(
@@ -386,7 +408,7 @@ const std::map<QString, std::unique_ptr<Plugin>> &PluginController::plugins()
 
 std::pair<bool, QStringList> PluginController::updateCustomCompletions(
     const QString &query, const QString &fullTextContent, int cursorPosition,
-    bool isFirstWord) const
+    bool isFirstWord, CompletionPass pass) const
 {
     QStringList results;
 
@@ -396,6 +418,10 @@ std::pair<bool, QStringList> PluginController::updateCustomCompletions(
         {
             continue;
         }
+        if (isSlowCompletion(*pl) != (pass == CompletionPass::Deferred))
+        {
+            continue;
+        }
 
         auto opt = pl->getCompletionCallback();
         if (opt)
@@ -404,6 +430,7 @@ std::pair<bool, QStringList> PluginController::updateCustomCompletions(
                 << "Processing custom completions from plugin" << name;
             auto &cb = *opt;
             sol::state_view view(pl->state_);
+            lua::TimeBudget budget(pl->state_, COMPLETION_BUDGET);
             auto errOrList = lua::tryCall<sol::table>(
                 cb,
                 toTable(pl->state_, lua::api::CompletionEvent{
@@ -412,6 +439,8 @@ std::pair<bool, QStringList> PluginController::updateCustomCompletions(
                                         .cursor_position = cursorPosition,
                                         .is_first_word = isFirstWord,
                                     }));
+            pl->callbackStats[lua::api::EventType::CompletionRequested].record(
+                budget.elapsed(), budget.exceeded());
             if (!errOrList.has_value())
             {
                 qCDebug(chatterinoLua)
@@ -434,6 +463,14 @@ std::pair<bool, QStringList> PluginController::updateCustomCompletions(
     return {false, results};
 }
 
+bool PluginController::hasDeferredCompletions() const
+{
+    return std::ranges::any_of(this->plugins(), [](const auto &entry) {
+        const auto &pl = entry.second;
+        return isSlowCompletion(*pl) && pl->getCompletionCallback();
+    });
+}
+
 WebSocketPool &PluginController::webSocketPool()
 {
     return this->webSocketPool_;
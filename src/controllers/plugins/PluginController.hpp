@@ -14,6 +14,7 @@
 #    include <sol/forward.hpp>
 
 #    include <algorithm>
+#    include <chrono>
 #    include <map>
 #    include <memory>
 #    include <utility>
@@ -34,6 +35,8 @@ public:
 
     void initialize(Settings &settings);
 
+    /// Runs the plugin command `commandName`. It's aborted if it runs longer
+    /// than COMMAND_BUDGET.
     QString tryExecPluginCommand(const QString &commandName,
                                  const CommandContext &ctx);
 
@@ -58,9 +61,38 @@ public:
      */
     static bool isPluginEnabled(const QString &id);
 
+    /// Which plugins updateCustomCompletions() asks for completions
+    enum class CompletionPass {
+        /// Plugins whose last completion was fast
+        Immediate,
+        /// Plugins whose last completion was slow or aborted. These are asked
+        /// after the built-in completions are shown.
+        Deferred,
+    };
+
+    /// Completion callbacks are aborted if they run longer than this
+    static constexpr std::chrono::milliseconds COMPLETION_BUDGET{100};
+    /// Plugins whose last completion took longer than this are deferred
+    static constexpr std::chrono::milliseconds SLOW_COMPLETION{10};
+    /// Commands are aborted if they run longer than this. They only run when
+    /// the user sends them, so they get more time than completions.
+    static constexpr std::chrono::milliseconds COMMAND_BUDGET{500};
+
+    /**
+     * @brief Asks the plugins of `pass` for completions of `query`.
+     *
+     * Each callback is aborted if it runs longer than COMPLETION_BUDGET. The
+     * time it took is recorded in the callbackStats of the plugin.
+     *
+     * @return whether other completions should be hidden and the completions
+     */
     std::pair<bool, QStringList> updateCustomCompletions(
         const QString &query, const QString &fullTextContent,
-        int cursorPosition, bool isFirstWord) const;
+        int cursorPosition, bool isFirstWord,
+        CompletionPass pass = CompletionPass::Immediate) const;
+
+    /// Checks if any plugin would be asked in the deferred completion pass
+    bool hasDeferredCompletions() const;
 
     WebSocketPool &webSocketPool();
 
@@ -0,0 +1,628 @@
+#pragma once
+
+#include "messages/LimitedQueueSnapshot.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace chatterino {
+
+/// A LimitedQueue for one writer and many readers.
+///
+/// Items are stored in fixed-size chunks that are shared with snapshots, so
+/// taking a snapshot is O(1) and never copies items. Readers (`get`, `first`,
+/// `last`, `find`, `rfind` and `getSnapshot`) don't take any locks and never
+/// wait for the writer.
+///
+/// The writer appends to the last chunk in place, since no reader can see
+/// slots past the end of the queue. Every other modification (replacing,
+/// inserting, pushing to the front) copies the affected chunks and publishes a
+/// new list of chunks. Writers are serialized with a mutex, but the queue is
+/// meant to be written from a single thread.
+///
+/// Evicted items stay alive until their whole chunk is evicted. Chunks are
+/// sized so this is at most ~6% of the limit.
+template <typename T>
+class ChunkedLimitedQueue
+{
+    using Chunks = detail::LimitedQueueChunks<T>;
+    using Chunk = typename Chunks::Chunk;
+
+    struct Range {
+        size_t head = 0;
+        size_t size = 0;
+    };
+
+public:
+    ChunkedLimitedQueue(size_t limit = 1000)
+        : limit_(limit)
+        , chunkShift_(chunkShiftFor(limit))
+    {
+        assert(limit > 0 && limit <= UINT32_MAX);
+
+        this->publish(this->makeChunks(), {});
+    }
+
+    ChunkedLimitedQueue(const ChunkedLimitedQueue &) = delete;
+    ChunkedLimitedQueue(ChunkedLimitedQueue &&) = delete;
+    ChunkedLimitedQueue &operator=(const ChunkedLimitedQueue &) = delete;
+    ChunkedLimitedQueue &operator=(ChunkedLimitedQueue &&) = delete;
+    ~ChunkedLimitedQueue() = default;
+
+    /**
+     * @brief Return the limit of the queue
+     */
+    [[nodiscard]] size_t limit() const
+    {
+        return this->limit_;
+    }
+
+    /**
+     * @brief Return true if the buffer is empty
+     */
+    [[nodiscard]] bool empty() const
+    {
+        ReadGuard guard(*this);
+
+        return guard.range.size == 0;
+    }
+
+    /// Value Accessors
+    // Copies of values are returned so that references aren't invalidated
+
+    /**
+     * @brief Get the item at the given index safely
+     *
+     * @param[in] index the index of the item to fetch
+     * @return the item at the index if it's populated, or none if it's not
+     */
+    [[nodiscard]] std::optional<T> get(size_t index) const
+    {
+        ReadGuard guard(*this);
+
+        if (index >= guard.range.size)
+        {
+            return std::nullopt;
+        }
+
+        return guard.at(index);
+    }
+
+    /**
+     * @brief Get the first item from the queue
+     *
+     * @return the item at the front of the queue if it's populated, or none the queue is empty
+     */
+    [[nodiscard]] std::optional<T> first() const
+    {
+        return this->get(0);
+    }
+
+    /**
+     * @brief Get the last item from the queue
+     *
+     * @return the item at the back of the queue if it's populated, or none the queue is empty
+     */
+    [[nodiscard]] std::optional<T> last() const
+    {
+        ReadGuard guard(*this);
+
+        if (guard.range.size == 0)
+        {
+            return std::nullopt;
+        }
+
+        return guard.at(guard.range.size - 1);
+    }
+
+    /// Modifiers
+
+    // Clear the buffer
+    void clear()
+    {
+        std::lock_guard lock(this->writeMutex_);
+
+        this->publish(this->makeChunks(), {});
+    }
+
+    /**
+     * @brief Push an item to the end of the queue
+     *
+     * @param item the item to push
+     * @param[out] deleted the item that was deleted
+     * @return true if an element was deleted to make room
+     */
+    bool pushBack(const T &item, T &deleted)
+    {
+        return this->pushBackImpl(item, &deleted);
+    }
+
+    /**
+     * @brief Push an item to the end of the queue
+     *
+     * @param item the item to push
+     * @return true if an element was deleted to make room
+     */
+    bool pushBack(const T &item)
+    {
+        return this->pushBackImpl(item, nullptr);
+    }
+
+    /**
+     * @brief Push items into beginning of queue
+     *
+     * Items are inserted in reverse order.
+     * Items will only be inserted if they fit,
+     * meaning no elements can be deleted from using this function.
+     *
+     * @param items the vector of items to push
+     * @return vector of elements that were pushed
+     */
+    std::vector<T> pushFront(const std::vector<T> &items)
+    {
+        std::lock_guard lock(this->writeMutex_);
+
+        auto range = this->writerRange();
+        size_t numToPush = std::min(items.size(), this->limit_ - range.size);
+        std::vector<T> pushed(
+            items.end() - static_cast<std::ptrdiff_t>(numToPush), items.end());
+        if (pushed.empty())
+        {
+            return pushed;
+        }
+
+        auto all = pushed;
+        this->appendItemsTo(all);
+        this->rebuild(all);
+
+        return pushed;
+    }
+
+    /**
+     * @brief Replace the needle with the given item
+     *
+     * @param[in] needle the item to search for
+     * @param[in] replacement the item to replace needle with
+     * @tparam Equality function object to use for comparison
+     * @return the index of the replaced item, or -1 if no replacement took place
+     */
+    template <typename Equals = std::equal_to<T>>
+    int replaceItem(const T &needle, const T &replacement)
+    {
+        std::lock_guard lock(this->writeMutex_);
+
+        auto range = this->writerRange();
+        Equals eq;
+        for (size_t i = 0; i < range.size; ++i)
+        {
+            if (eq(this->current_->at(range.head + i), needle))
+            {
+                this->replaceAt(range, i, replacement);
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Replace the item at index with the given item
+     *
+     * @param[in] index the index of the item to replace
+     * @param[in] replacement the item to put in place of the item at index
+     * @param[out] prev (optional) the item located at @a index before replacing
+     * @return true if a replacement took place
+     */
+    bool replaceItem(size_t index, const T &replacement, T *prev = nullptr)
+    {
+        std::lock_guard lock(this->writeMutex_);
+
+        auto range = this->writerRange();
+        if (index >= range.size)
+        {
+            return false;
+        }
+
+        if (prev)
+        {
+            *prev = this->current_->at(range.head + index);
+        }
+        this->replaceAt(range, index, replacement);
+        return true;
+    }
+
+    /**
+     * @brief Replace the needle with the given item
+     *
+     * @param hint A hint on where the needle _might_ be
+     * @param[in] needle the item to search for
+     * @param[in] replacement the item to replace needle with
+     * @return the index of the replaced item, or -1 if no replacement took place
+     */
+    int replaceItem(size_t hint, const T &needle, const T &replacement)
+    {
+        std::lock_guard lock(this->writeMutex_);
+
+        auto range = this->writerRange();
+        if (hint < range.size &&
+            this->current_->at(range.head + hint) == needle)
+        {
+            this->replaceAt(range, hint, replacement);
+            return static_cast<int>(hint);
+        }
+
+        for (size_t i = 0; i < range.size; ++i)
+        {
+            if (this->current_->at(range.head + i) == needle)
+            {
+                this->replaceAt(range, i, replacement);
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Inserts the given item before another item
+     *
+     * @param[in] needle the item to use as positional reference
+     * @param[in] item the item to insert before needle
+     * @tparam Equality function object to use for comparison
+     * @return true if an insertion took place
+     */
+    template <typename Equals = std::equal_to<T>>
+    bool insertBefore(const T &needle, const T &item)
+    {
+        return this->insertImpl<Equals>(needle, item, false);
+    }
+
+    /**
+     * @brief Inserts the given item after another item
+     *
+     * @param[in] needle the item to use as positional reference
+     * @param[in] item the item to insert after needle
+     * @tparam Equality function object to use for comparison
+     * @return true if an insertion took place
+     */
+    template <typename Equals = std::equal_to<T>>
+    bool insertAfter(const T &needle, const T &item)
+    {
+        return this->insertImpl<Equals>(needle, item, true);
+    }
+
+    [[nodiscard]] LimitedQueueSnapshot<T> getSnapshot() const
+    {
+        ReadGuard guard(*this);
+
+        return LimitedQueueSnapshot<T>(guard.chunks->shared_from_this(),
+                                       guard.range.head, guard.range.size);
+    }
+
+    // Actions
+
+    /**
+     * @brief Returns the first item matching a predicate
+     *
+     * The contents of the queue are iterated over from front to back until the
+     * first element that satisfies `pred(item)`. If no item satisfies the
+     * predicate, or if the queue is empty, then std::nullopt is returned.
+     *
+     * @param[in] pred predicate that will be applied to items
+     * @return the first item found or std::nullopt
+     */
+    template <typename Predicate>
+    [[nodiscard]] std::optional<T> find(Predicate pred) const
+    {
+        ReadGuard guard(*this);
+
+        for (size_t i = 0; i < guard.range.size; ++i)
+        {
+            const auto &item = guard.at(i);
+            if (pred(item))
+            {
+                return item;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Find an item with a hint
+     *
+     * @param hint A hint on where the needle _might_ be
+     * @param predicate that will used to find the item
+     * @return the item and its index or none if it's not found
+     */
+    std::optional<std::pair<size_t, T>> find(size_t hint,
+                                             auto &&predicate) const
+    {
+        ReadGuard guard(*this);
+
+        if (hint < guard.range.size && predicate(guard.at(hint)))
+        {
+            return std::pair{hint, guard.at(hint)};
+        }
+
+        for (size_t i = 0; i < guard.range.size; i++)
+        {
+            const auto &item = guard.at(i);
+            if (predicate(item))
+            {
+                return std::pair{i, item};
+            }
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Returns the first item matching a predicate, checking in reverse
+     *
+     * The contents of the queue are iterated over from back to front until the
+     * first element that satisfies `pred(item)`. If no item satisfies the
+     * predicate, or if the queue is empty, then std::nullopt is returned.
+     *
+     * @param[in] pred predicate that will be applied to items
+     * @return the first item found or std::nullopt
+     */
+    template <typename Predicate>
+    [[nodiscard]] std::optional<T> rfind(Predicate pred) const
+    {
+        ReadGuard guard(*this);
+
+        for (size_t i = guard.range.size; i > 0; --i)
+        {
+            const auto &item = guard.at(i - 1);
+            if (pred(item))
+            {
+                return item;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+private:
+    /// Keeps the published chunks alive while a reader accesses them.
+    ///
+    /// The writer only destroys replaced chunks while no reader is active (see
+    /// publish()). A reader that becomes active after that check is
+    /// guaranteed to see the newly published chunks.
+    class ReadGuard
+    {
+    public:
+        explicit ReadGuard(const ChunkedLimitedQueue &queue)
+            : activeReaders_(queue.activeReaders_)
+        {
+            this->activeReaders_.fetch_add(1);
+            this->chunks = queue.published_.load();
+            this->range =
+                unpack(this->chunks->range.load(std::memory_order_acquire));
+        }
+
+        ~ReadGuard()
+        {
+            this->activeReaders_.fetch_sub(1);
+        }
+
+        ReadGuard(const ReadGuard &) = delete;
+        ReadGuard(ReadGuard &&) = delete;
+        ReadGuard &operator=(const ReadGuard &) = delete;
+        ReadGuard &operator=(ReadGuard &&) = delete;
+
+        const T &at(size_t index) const
+        {
+            return this->chunks->at(this->range.head + index);
+        }
+
+        const Chunks *chunks = nullptr;
+        Range range;
+
+    private:
+        std::atomic<size_t> &activeReaders_;
+    };
+
+    static size_t chunkShiftFor(size_t limit)
+    {
+        // ~16 chunks per queue, with at least 16 and at most 1024 items each
+        return std::clamp<size_t>(std::bit_width(limit / 16), 4, 10);
+    }
+
+    static uint64_t pack(Range range)
+    {
+        return (static_cast<uint64_t>(range.head) << 32) |
+               static_cast<uint64_t>(range.size);
+    }
+
+    static Range unpack(uint64_t packed)
+    {
+        return {
+            .head = static_cast<size_t>(packed >> 32),
+            .size = static_cast<size_t>(packed & 0xFFFFFFFF),
+        };
+    }
+
+    size_t chunkSize() const
+    {
+        return size_t{1} << this->chunkShift_;
+    }
+
+    std::shared_ptr<Chunks> makeChunks() const
+    {
+        return std::make_shared<Chunks>(this->chunkShift_);
+    }
+
+    /// The current range, only valid for the writer
+    Range writerRange() const
+    {
+        return unpack(this->current_->range.load(std::memory_order_relaxed));
+    }
+
+    /// Makes `next` visible to readers. The replaced chunks are kept alive
+    /// until no reader can access them anymore.
+    void publish(std::shared_ptr<Chunks> next, Range range)
+    {
+        next->range.store(pack(range), std::memory_order_relaxed);
+        this->published_.store(next.get());
+
+        if (this->current_)
+        {
+            this->retired_.emplace_back(std::move(this->current_));
+        }
+        this->current_ = std::move(next);
+
+        if (this->activeReaders_.load() == 0)
+        {
+            this->retired_.clear();
+        }
+    }
+
+    bool pushBackImpl(const T &item, T *deleted)
+    {
+        std::lock_guard lock(this->writeMutex_);
+
+        auto range = this->writerRange();
+        bool full = range.size == this->limit_;
+        if (full)
+        {
+            if (deleted)
+            {
+                *deleted = this->current_->at(range.head);
+            }
+            range.head++;
+        }
+        else
+        {
+            range.size++;
+        }
+
+        // The slot of the new item is past the end of every published range,
+        // so it can be written in place
+        size_t tail = range.head + range.size - 1;
+        bool dropFirst = range.head >= this->chunkSize();
+        bool needChunk =
+            (tail >> this->chunkShift_) >= this->current_->chunks.size();
+
+        if (!dropFirst && !needChunk)
+        {
+            this->current_->at(tail) = item;
+            this->current_->range.store(pack(range), std::memory_order_release);
+            return full;
+        }
+
+        const auto &chunks = this->current_->chunks;
+        auto next = this->makeChunks();
+        next->chunks.assign(
+            dropFirst ? std::next(chunks.begin()) : chunks.begin(),
+            chunks.end());
+        if (dropFirst)
+        {
+            range.head -= this->chunkSize();
+            tail -= this->chunkSize();
+        }
+        if (needChunk)
+        {
+            next->chunks.emplace_back(
+                std::make_shared<Chunk>(this->chunkSize()));
+        }
+        next->at(tail) = item;
+
+        this->publish(std::move(next), range);
+        return full;
+    }
+
+    /// Replaces the item at `index` in a copy of its chunk
+    void replaceAt(Range range, size_t index, const T &replacement)
+    {
+        size_t position = range.head + index;
+        size_t chunkIndex = position >> this->chunkShift_;
+
+        auto next = this->makeChunks();
+        next->chunks = this->current_->chunks;
+        next->chunks[chunkIndex] =
+            std::make_shared<Chunk>(*this->current_->chunks[chunkIndex]);
+        next->at(position) = replacement;
+
+        this->publish(std::move(next), range);
+    }
+
+    template <typename Equals>
+    bool insertImpl(const T &needle, const T &item, bool after)
+    {
+        std::lock_guard lock(this->writeMutex_);
+
+        std::vector<T> all;
+        this->appendItemsTo(all);
+
+        Equals eq;
+        for (auto it = all.begin(); it != all.end(); ++it)
+        {
+            if (eq(*it, needle))
+            {
+                all.insert(after ? std::next(it) : it, item);
+                if (all.size() > this->limit_)
+                {
+                    // like boost::circular_buffer, drop the first item
+                    all.erase(all.begin());
+                }
+                this->rebuild(all);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void appendItemsTo(std::vector<T> &items) const
+    {
+        auto range = this->writerRange();
+        items.reserve(items.size() + range.size);
+        for (size_t i = 0; i < range.size; ++i)
+        {
+            items.push_back(this->current_->at(range.head + i));
+        }
+    }
+
+    /// Publishes fresh chunks containing `items`
+    void rebuild(const std::vector<T> &items)
+    {
+        assert(items.size() <= this->limit_);
+
+        auto next = this->makeChunks();
+        for (size_t i = 0; i < items.size(); i += this->chunkSize())
+        {
+            auto chunk = std::make_shared<Chunk>(this->chunkSize());
+            auto end = std::min(items.size(), i + this->chunkSize());
+            std::copy(items.begin() + static_cast<std::ptrdiff_t>(i),
+                      items.begin() + static_cast<std::ptrdiff_t>(end),
+                      chunk->begin());
+            next->chunks.emplace_back(std::move(chunk));
+        }
+
+        this->publish(std::move(next), {.head = 0, .size = items.size()});
+    }
+
+    const size_t limit_;
+    const size_t chunkShift_;
+
+    /// Serializes writers, never taken by readers
+    std::mutex writeMutex_;
+    /// The chunks readers see, owned by current_
+    std::atomic<Chunks *> published_{nullptr};
+    std::shared_ptr<Chunks> current_;
+    /// Replaced chunks that a reader might still access
+    std::vector<std::shared_ptr<Chunks>> retired_;
+    mutable std::atomic<size_t> activeReaders_{0};
+};
+
+}  // namespace chatterino
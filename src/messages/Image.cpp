@@ -7,26 +7,38 @@
 #include "common/QLogging.hpp"
 #include "debug/AssertInGuiThread.hpp"
 #include "debug/Benchmark.hpp"
+#include "messages/ImageDecodePool.hpp"
+#include "messages/ImageFrameCache.hpp"
 #include "singletons/Emotes.hpp"
 #include "singletons/helper/GifTimer.hpp"
+#include "singletons/Settings.hpp"
 #include "singletons/WindowManager.hpp"
 #include "util/DebugCount.hpp"
 #include "util/PostToThread.hpp"
 
 #include <boost/functional/hash.hpp>
 #include <QBuffer>
+#include <QElapsedTimer>
 #include <QImageReader>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QNetworkRequest>
 #include <QTimer>
 
+#include <algorithm>
 #include <atomic>
+#include <numeric>
 
 // Duration between each check of every Image instance
 const auto IMAGE_POOL_CLEANUP_INTERVAL = std::chrono::minutes(1);
 // Duration since last usage of Image pixmap before expiration of frames
 const auto IMAGE_POOL_IMAGE_LIFETIME = std::chrono::minutes(10);
+// Images used more recently than this are kept even if the memory budget is
+// exceeded, they're most likely visible
+const auto IMAGE_POOL_BUDGET_MINIMUM_AGE = std::chrono::seconds(10);
+// Delay before images are freed after the memory budget was exceeded, so many
+// images loaded at once only cause one pass
+const auto IMAGE_POOL_BUDGET_FREE_DELAY = std::chrono::seconds(1);
 
 namespace chatterino::detail {
 
@@ -74,8 +86,12 @@ Frames::Frames(QList<Frame> &&frames)
         this->processOffset();
     }
 
-    DebugCount::increase("image bytes", this->memoryUsage());
-    DebugCount::increase("image bytes (ever loaded)", this->memoryUsage());
+    auto bytes = this->memoryUsage();
+    DebugCount::increase("image bytes", bytes);
+    DebugCount::increase("image bytes (ever loaded)", bytes);
+#ifndef DISABLE_IMAGE_EXPIRATION_POOL
+    ImageExpirationPool::instance().addLoadedBytes(bytes);
+#endif
 }
 
 Frames::~Frames()
@@ -91,8 +107,12 @@ Frames::~Frames()
     {
         DebugCount::decrease("animated images");
     }
-    DebugCount::decrease("image bytes", this->memoryUsage());
-    DebugCount::increase("image bytes (ever unloaded)", this->memoryUsage());
+    auto bytes = this->memoryUsage();
+    DebugCount::decrease("image bytes", bytes);
+    DebugCount::increase("image bytes (ever unloaded)", bytes);
+#ifndef DISABLE_IMAGE_EXPIRATION_POOL
+    ImageExpirationPool::instance().addLoadedBytes(-bytes);
+#endif
 
     this->gifTimerConnection_.disconnect();
 }
@@ -147,8 +167,12 @@ void Frames::clear()
     {
         DebugCount::decrease("loaded images");
     }
-    DebugCount::decrease("image bytes", this->memoryUsage());
-    DebugCount::increase("image bytes (ever unloaded)", this->memoryUsage());
+    auto bytes = this->memoryUsage();
+    DebugCount::decrease("image bytes", bytes);
+    DebugCount::increase("image bytes (ever unloaded)", bytes);
+#ifndef DISABLE_IMAGE_EXPIRATION_POOL
+    ImageExpirationPool::instance().addLoadedBytes(-bytes);
+#endif
 
     this->items_.clear();
     this->index_ = 0;
@@ -186,16 +210,26 @@ std::optional<QPixmap> Frames::first() const
     return this->items_.front().image;
 }
 
-QList<Frame> readFrames(QImageReader &reader, const Url &url)
+QList<DecodedFrame> readFrames(QImageReader &reader, const Url &url,
+                               const std::weak_ptr<Image> &image)
 {
-    QList<Frame> frames;
+    QList<DecodedFrame> frames;
     frames.reserve(reader.imageCount());
 
     for (int index = 0; index < reader.imageCount(); ++index)
     {
-        auto pixmap = QPixmap::fromImageReader(&reader);
-        if (!pixmap.isNull())
+        if (image.expired())
         {
+            return {};
+        }
+
+        auto frame = reader.read();
+        if (!frame.isNull())
+        {
+            // This is the format QPixmap uses on raster platforms, so the
+            // conversion in the GUI thread doesn't need to touch the pixels
+            frame.convertTo(QImage::Format_ARGB32_Premultiplied);
+
             // It seems that browsers have special logic for fast animations.
             // This implements Chrome and Firefox's behavior which uses
             // a duration of 100 ms for any frames that specify a duration of <= 10 ms.
@@ -207,8 +241,8 @@ QList<Frame> readFrames(QImageReader &reader, const Url &url)
                 duration = 100;
             }
             duration = std::max(20, duration);
-            frames.append(Frame{
-                .image = std::move(pixmap),
+            frames.append(DecodedFrame{
+                .image = std::move(frame),
                 .duration = duration,
             });
         }
@@ -223,17 +257,28 @@ QList<Frame> readFrames(QImageReader &reader, const Url &url)
     return frames;
 }
 
-void assignFrames(std::weak_ptr<Image> weak, QList<Frame> parsed)
+void assignFrames(std::weak_ptr<Image> weak, QList<DecodedFrame> decoded)
 {
     static bool isPushQueued;
 
-    auto cb = [parsed = std::move(parsed), weak = std::move(weak)]() mutable {
+    auto cb = [decoded = std::move(decoded),
+               weak = std::move(weak)]() mutable {
         auto shared = weak.lock();
         if (!shared)
         {
             return;
         }
-        shared->frames_ = std::make_unique<detail::Frames>(std::move(parsed));
+
+        QList<Frame> frames;
+        frames.reserve(decoded.size());
+        for (auto &frame : decoded)
+        {
+            frames.append(Frame{
+                .image = QPixmap::fromImage(std::move(frame.image)),
+                .duration = frame.duration,
+            });
+        }
+        shared->frames_ = std::make_unique<detail::Frames>(std::move(frames));
 
         // Avoid too many layouts in one event-loop iteration
         //
@@ -257,6 +302,88 @@ void assignFrames(std::weak_ptr<Image> weak, QList<Frame> parsed)
     postToGuiThread(cb);
 }
 
+void decodeImage(const std::weak_ptr<Image> &weak, const QByteArray &data)
+{
+    Url url;
+    qreal scale = 1;
+    {
+        auto shared = weak.lock();
+        if (!shared)
+        {
+            return;
+        }
+        url = shared->url();
+        scale = shared->scale();
+    }
+
+    QBuffer buffer;
+    buffer.setData(data);
+    QImageReader reader(&buffer);
+
+    auto markEmpty = [&weak] {
+        if (auto shared = weak.lock())
+        {
+            shared->empty_ = true;
+        }
+    };
+
+    if (!reader.canRead())
+    {
+        qCDebug(chatterinoImage) << "Error: image cant be read " << url.string;
+        markEmpty();
+        return;
+    }
+
+    const auto size = reader.size();
+    if (size.isEmpty())
+    {
+        markEmpty();
+        return;
+    }
+
+    // returns 1 for non-animated formats
+    if (reader.imageCount() <= 0)
+    {
+        qCDebug(chatterinoImage) << "Error: image has less than 1 frame "
+                                 << url.string << ": " << reader.errorString();
+        markEmpty();
+        return;
+    }
+
+    // use "double" to prevent int overflows
+    if (double(size.width()) * double(size.height()) *
+            double(reader.imageCount()) * 4.0 >
+        double(Image::maxBytesRam))
+    {
+        qCDebug(chatterinoImage) << "image too large in RAM";
+
+        markEmpty();
+        return;
+    }
+
+    auto format = QString::fromLatin1(reader.format());
+    QElapsedTimer timer;
+    timer.start();
+
+    auto frames = readFrames(reader, url, weak);
+    if (weak.expired())
+    {
+        return;
+    }
+
+    DebugCount::increase(QString("images decoded (%1)").arg(format));
+    DebugCount::increase(
+        QString("image decode time in microseconds (%1)").arg(format),
+        timer.nsecsElapsed() / 1000);
+
+    if (auto *cache = ImageFrameCache::instance())
+    {
+        cache->write(url.string, scale, frames);
+    }
+
+    assignFrames(weak, std::move(frames));
+}
+
 }  // namespace chatterino::detail
 
 namespace chatterino {
@@ -275,6 +402,8 @@ Image::~Image()
         return;
     }
 
+    ImageDecodePool::instance().cancel(this);
+
     // Ensure the destructor for our frames is called in the GUI thread
     // If the Image destructor is called outside of the GUI thread, move the
     // ownership of the frames to the GUI thread, otherwise the frames will be
@@ -407,7 +536,12 @@ std::optional<QPixmap> Image::pixmapOrLoad() const
 
     this->load();
 
-    return this->frames_->current();
+    auto pixmap = this->frames_->current();
+    if (!pixmap && !this->visible_.exchange(true))
+    {
+        ImageDecodePool::instance().prioritize(this);
+    }
+    return pixmap;
 }
 
 void Image::load() const
@@ -470,60 +604,69 @@ int Image::height() const
 
 void Image::actuallyLoad()
 {
-    auto weak = weakOf(this);
-    NetworkRequest(this->url().string)
-        .concurrent()
-        .cache()
-        .onSuccess([weak](auto result) {
-            auto shared = weak.lock();
-            if (!shared)
-            {
-                return;
-            }
-
-            QBuffer buffer;
-            buffer.setData(result.getData());
-            QImageReader reader(&buffer);
+    auto *cache = ImageFrameCache::instance();
+    if (cache == nullptr)
+    {
+        this->loadFromNetwork();
+        return;
+    }
 
-            if (!reader.canRead())
+    // Images that were decoded before are read from the disk cache in the
+    // decoder threads, only missing ones are requested
+    auto weak = weakOf(this);
+    ImageDecodePool::instance().submit(
+        this,
+        [weak, cache] {
+            Url url;
+            qreal scale = 1;
             {
-                qCDebug(chatterinoImage)
-                    << "Error: image cant be read " << shared->url().string;
-                shared->empty_ = true;
-                return;
+                auto shared = weak.lock();
+                if (!shared)
+                {
+                    return;
+                }
+                url = shared->url();
+                scale = shared->scale();
             }
 
-            const auto size = reader.size();
-            if (size.isEmpty())
+            auto frames = cache->read(url.string, scale);
+            if (frames)
             {
-                shared->empty_ = true;
+                detail::assignFrames(weak, std::move(*frames));
                 return;
             }
 
-            // returns 1 for non-animated formats
-            if (reader.imageCount() <= 0)
-            {
-                qCDebug(chatterinoImage)
-                    << "Error: image has less than 1 frame "
-                    << shared->url().string << ": " << reader.errorString();
-                shared->empty_ = true;
-                return;
-            }
+            postToThread([weak] {
+                if (auto shared = weak.lock())
+                {
+                    shared->loadFromNetwork();
+                }
+            });
+        },
+        this->visible_ ? ImageDecodePool::Priority::Visible
+                       : ImageDecodePool::Priority::Normal);
+}
 
-            // use "double" to prevent int overflows
-            if (double(size.width()) * double(size.height()) *
-                    double(reader.imageCount()) * 4.0 >
-                double(Image::maxBytesRam))
+void Image::loadFromNetwork()
+{
+    auto weak = weakOf(this);
+    NetworkRequest(this->url().string)
+        .concurrent()
+        .cache()
+        .onSuccess([weak](auto result) {
+            auto shared = weak.lock();
+            if (!shared)
             {
-                qCDebug(chatterinoImage) << "image too large in RAM";
-
-                shared->empty_ = true;
                 return;
             }
 
-            auto parsed = detail::readFrames(reader, shared->url());
-
-            assignFrames(shared, parsed);
+            ImageDecodePool::instance().submit(
+                shared.get(),
+                [weak, data = result.getData()] {
+                    detail::decodeImage(weak, data);
+                },
+                shared->visible_ ? ImageDecodePool::Priority::Visible
+                                 : ImageDecodePool::Priority::Normal);
         })
         .onError([weak](auto /*result*/) {
             auto shared = weak.lock();
@@ -545,10 +688,21 @@ void Image::expireFrames()
     assertInGuiThread();
     this->frames_->clear();
     this->shouldLoad_ = true;  // Mark as needing load again
+    this->visible_ = false;
 }
 
 #ifndef DISABLE_IMAGE_EXPIRATION_POOL
 
+namespace {
+
+/// The memory budget of the ImageExpirationPool in bytes
+int64_t memoryBudget()
+{
+    return int64_t{getSettings()->imageMemoryBudget.getValue()} * 1024 * 1024;
+}
+
+}  // namespace
+
 ImageExpirationPool::ImageExpirationPool()
     : freeTimer_(new QTimer)
 {
@@ -575,6 +729,8 @@ ImageExpirationPool::ImageExpirationPool()
                           DebugCount::Flag::DataSize);
     DebugCount::configure("image bytes (ever unloaded)",
                           DebugCount::Flag::DataSize);
+    DebugCount::configure("image pool bytes", DebugCount::Flag::DataSize);
+    DebugCount::configure("image pool budget", DebugCount::Flag::DataSize);
 }
 
 ImageExpirationPool &ImageExpirationPool::instance()
@@ -613,10 +769,11 @@ void ImageExpirationPool::freeOld()
 {
     std::lock_guard<std::mutex> lock(this->mutex_);
 
-    size_t numExpired = 0;
-    size_t eligible = 0;
+    std::vector<ExpiryCandidate> candidates;
+    std::vector<decltype(this->allImages_)::iterator> candidateIts;
+    candidates.reserve(this->allImages_.size());
+    candidateIts.reserve(this->allImages_.size());
 
-    auto now = std::chrono::steady_clock::now();
     for (auto it = this->allImages_.begin(); it != this->allImages_.end();)
     {
         auto img = it->second.lock();
@@ -635,22 +792,39 @@ void ImageExpirationPool::freeOld()
             continue;
         }
 
-        ++eligible;
+        candidates.push_back({
+            .lastUsed = img->lastUsed_,
+            .bytes = img->frames_->memoryUsage(),
+        });
+        candidateIts.push_back(it);
+        ++it;
+    }
+
+    auto budget = memoryBudget();
+    DebugCount::set("image pool budget", budget);
+
+    auto expired = selectExpired(candidates, Clock::now(),
+                                 {
+                                     .lifetime = IMAGE_POOL_IMAGE_LIFETIME,
+                                     .memoryBudget = budget,
+                                     .minimumAge =
+                                         IMAGE_POOL_BUDGET_MINIMUM_AGE,
+                                 });
 
-        // Check if image has expired and, if so, expire its frame data
-        auto diff = now - img->lastUsed_;
-        if (diff > IMAGE_POOL_IMAGE_LIFETIME)
+    for (auto index : expired)
+    {
+        auto it = candidateIts[index];
+        if (auto img = it->second.lock())
         {
-            ++numExpired;
             img->expireFrames();
-            // erase without mutex locking issue
-            it = this->allImages_.erase(it);
-            continue;
         }
-
-        ++it;
+        // erase without mutex locking issue
+        this->allImages_.erase(it);
     }
 
+    size_t numExpired = expired.size();
+    size_t eligible = candidates.size();
+
 #    ifndef NDEBUG
     qCDebug(chatterinoImage) << "freed frame data for" << numExpired << "/"
                              << eligible << "eligible images";
@@ -660,6 +834,80 @@ void ImageExpirationPool::freeOld()
     DebugCount::set("last image gc: left after gc", this->allImages_.size());
 }
 
+std::vector<size_t> ImageExpirationPool::selectExpired(
+    const std::vector<ExpiryCandidate> &candidates, Clock::time_point now,
+    const ExpiryPolicy &policy)
+{
+    std::vector<size_t> order(candidates.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::stable_sort(order, [&](size_t a, size_t b) {
+        return candidates[a].lastUsed < candidates[b].lastUsed;
+    });
+
+    int64_t totalBytes = 0;
+    for (const auto &candidate : candidates)
+    {
+        totalBytes += candidate.bytes;
+    }
+    const int64_t targetBytes = policy.memoryBudget / 10 * 9;
+    bool overBudget = false;
+
+    std::vector<size_t> expired;
+    // Candidates are sorted by their age, so everything after the first one
+    // that's kept is kept as well
+    for (auto index : order)
+    {
+        const auto &candidate = candidates[index];
+        auto age = now - candidate.lastUsed;
+
+        if (age <= policy.lifetime)
+        {
+            // All images past their lifetime are gone, check the budget with
+            // what's left
+            if (!overBudget)
+            {
+                overBudget = policy.memoryBudget > 0 &&
+                             totalBytes > policy.memoryBudget;
+            }
+            if (!overBudget || totalBytes <= targetBytes ||
+                age < policy.minimumAge)
+            {
+                break;
+            }
+        }
+
+        expired.push_back(index);
+        totalBytes -= candidate.bytes;
+    }
+
+    return expired;
+}
+
+void ImageExpirationPool::addLoadedBytes(int64_t bytes)
+{
+    assertInGuiThread();
+
+    this->loadedBytes_ += bytes;
+    DebugCount::set("image pool bytes", this->loadedBytes_);
+
+    if (bytes <= 0 || this->freeQueued_)
+    {
+        return;
+    }
+
+    auto budget = memoryBudget();
+    if (budget <= 0 || this->loadedBytes_ <= budget)
+    {
+        return;
+    }
+
+    this->freeQueued_ = true;
+    QTimer::singleShot(IMAGE_POOL_BUDGET_FREE_DELAY, [this] {
+        this->freeQueued_ = false;
+        this->freeOld();
+    });
+}
+
 #endif
 
 }  // namespace chatterino
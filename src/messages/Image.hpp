@@ -4,6 +4,8 @@
 
 #include <boost/variant.hpp>
 #include <pajlada/signals/signal.hpp>
+#include <QByteArray>
+#include <QImage>
 #include <QList>
 #include <QPixmap>
 #include <QString>
@@ -16,6 +18,7 @@
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <vector>
 
 namespace chatterino {
 
@@ -30,6 +33,13 @@ struct Frame {
     int duration;
 };
 
+/// A frame decoded outside of the GUI thread, which can only be turned into a
+/// QPixmap in the GUI thread
+struct DecodedFrame {
+    QImage image;
+    int duration;
+};
+
 class Frames
 {
 public:
@@ -49,9 +59,10 @@ public:
     void advance();
     std::optional<QPixmap> current() const;
     std::optional<QPixmap> first() const;
+    /// Approximate number of bytes used by all frames
+    int64_t memoryUsage() const;
 
 private:
-    int64_t memoryUsage() const;
     void processOffset();
     QList<Frame> items_;
     QList<Frame>::size_type index_{0};
@@ -59,8 +70,14 @@ private:
     pajlada::Signals::Connection gifTimerConnection_;
 };
 
-QList<Frame> readFrames(QImageReader &reader, const Url &url);
-void assignFrames(std::weak_ptr<Image> weak, QList<Frame> parsed);
+/// Decodes all frames from `reader` as premultiplied images.
+/// Stops early (returning no frames) once `image` is destroyed.
+QList<DecodedFrame> readFrames(QImageReader &reader, const Url &url,
+                               const std::weak_ptr<Image> &image);
+/// Converts the frames to pixmaps and assigns them in the GUI thread
+void assignFrames(std::weak_ptr<Image> weak, QList<DecodedFrame> decoded);
+/// Decodes the downloaded `data` of an image, runs in the ImageDecodePool
+void decodeImage(const std::weak_ptr<Image> &weak, const QByteArray &data);
 
 }  // namespace chatterino::detail
 
@@ -110,6 +127,7 @@ private:
 
     void setPixmap(const QPixmap &pixmap);
     void actuallyLoad();
+    void loadFromNetwork();
     void expireFrames();
 
     const Url url_{};
@@ -123,6 +141,9 @@ private:
     std::atomic_bool empty_{false};
 
     bool shouldLoad_{false};
+    /// Set once the image is painted before it's loaded, its frames are then
+    /// decoded before the ones of other images
+    mutable std::atomic_bool visible_{false};
 
     mutable std::chrono::time_point<std::chrono::steady_clock> lastUsed_;
 
@@ -131,7 +152,9 @@ private:
 
     friend class ImageExpirationPool;
     friend void detail::assignFrames(std::weak_ptr<Image>,
-                                     QList<detail::Frame>);
+                                     QList<detail::DecodedFrame>);
+    friend void detail::decodeImage(const std::weak_ptr<Image> &,
+                                    const QByteArray &);
 };
 
 // forward-declarable function that calls Image::getEmpty() under the hood.
@@ -142,6 +165,25 @@ ImagePtr getEmptyImagePtr();
 class ImageExpirationPool
 {
 public:
+    using Clock = std::chrono::steady_clock;
+
+    struct ExpiryCandidate {
+        /// Last time the image was painted
+        Clock::time_point lastUsed;
+        int64_t bytes = 0;
+    };
+
+    struct ExpiryPolicy {
+        /// Images that weren't used for this long are always expired
+        Clock::duration lifetime;
+        /// Once all images use more bytes than this, the least recently used
+        /// ones are expired until they use at most 90% of it
+        int64_t memoryBudget = 0;
+        /// Images used more recently than this are likely visible and never
+        /// expired because of the memory budget
+        Clock::duration minimumAge;
+    };
+
     ImageExpirationPool();
     static ImageExpirationPool &instance();
 
@@ -151,11 +193,23 @@ public:
     /**
      * @brief Frees frame data for all images that ImagePool deems to have expired.
      * 
-     * Expiration is based on last accessed time of the Image, stored in Image::lastUsed_.
+     * Expiration is based on last accessed time of the Image, stored in Image::lastUsed_,
+     * and on the memory budget from the settings (see selectExpired).
      * Must be ran in the GUI thread.
      */
     void freeOld();
 
+    /// Returns the indices of the candidates that should be expired under
+    /// `policy`, in the order they should be expired (least recently used
+    /// first)
+    static std::vector<size_t> selectExpired(
+        const std::vector<ExpiryCandidate> &candidates, Clock::time_point now,
+        const ExpiryPolicy &policy);
+
+    /// Tracks the bytes used by loaded frames and frees old images soon if
+    /// they exceed the memory budget. Must be called from the GUI thread.
+    void addLoadedBytes(int64_t bytes);
+
     /*
      * Debug function that unloads all images in the pool. This is intended to
      * test for possible memory leaks from tracked images.
@@ -166,6 +220,10 @@ public:
     QTimer *freeTimer_;
     std::map<Image *, std::weak_ptr<Image>> allImages_;
     std::mutex mutex_;
+
+    // gui thread only
+    int64_t loadedBytes_ = 0;
+    bool freeQueued_ = false;
 };
 
 #endif
@@ -0,0 +1,170 @@
+#include "messages/ImageDecodePool.hpp"
+
+#include "singletons/Settings.hpp"
+#include "util/DebugCount.hpp"
+#include "util/RenameThread.hpp"
+
+#include <algorithm>
+
+namespace chatterino {
+
+ImageDecodePool::ImageDecodePool()
+    : threadCount_(0)
+{
+}
+
+ImageDecodePool::ImageDecodePool(size_t threadCount)
+    : threadCount_(std::max<size_t>(threadCount, 1))
+{
+}
+
+ImageDecodePool::~ImageDecodePool()
+{
+    {
+        std::lock_guard lock(this->mutex_);
+        this->stopping_ = true;
+        this->visible_.clear();
+        this->normal_.clear();
+        this->pending_.clear();
+    }
+    this->condition_.notify_all();
+
+    for (auto &thread : this->threads_)
+    {
+        thread.join();
+    }
+}
+
+ImageDecodePool &ImageDecodePool::instance()
+{
+    static auto *instance = new ImageDecodePool;
+    return *instance;
+}
+
+void ImageDecodePool::submit(const void *owner, Job job, Priority priority)
+{
+    {
+        std::lock_guard lock(this->mutex_);
+        if (this->threads_.empty())
+        {
+            this->startThreads();
+        }
+
+        auto existing = this->pending_.find(owner);
+        if (existing != this->pending_.end())
+        {
+            // keep the higher priority of both jobs
+            priority = std::max(priority, existing->second.priority);
+            this->queue(existing->second.priority).erase(existing->second.it);
+            this->pending_.erase(existing);
+        }
+
+        auto &queue = this->queue(priority);
+        queue.push_back({owner, std::move(job)});
+        this->pending_.emplace(owner,
+                               Pending{priority, std::prev(queue.end())});
+        this->updateQueueDepth();
+    }
+    this->condition_.notify_one();
+}
+
+void ImageDecodePool::prioritize(const void *owner)
+{
+    std::lock_guard lock(this->mutex_);
+    auto it = this->pending_.find(owner);
+    if (it == this->pending_.end() ||
+        it->second.priority == Priority::Visible)
+    {
+        return;
+    }
+
+    this->visible_.splice(this->visible_.end(), this->normal_, it->second.it);
+    it->second.priority = Priority::Visible;
+}
+
+void ImageDecodePool::cancel(const void *owner)
+{
+    std::lock_guard lock(this->mutex_);
+    auto it = this->pending_.find(owner);
+    if (it == this->pending_.end())
+    {
+        return;
+    }
+
+    this->queue(it->second.priority).erase(it->second.it);
+    this->pending_.erase(it);
+    this->updateQueueDepth();
+}
+
+size_t ImageDecodePool::pending() const
+{
+    std::lock_guard lock(this->mutex_);
+    return this->pending_.size();
+}
+
+void ImageDecodePool::startThreads()
+{
+    auto threadCount = this->threadCount_;
+    if (threadCount == 0)
+    {
+        auto configured = getSettings()->imageDecoderThreads.getValue();
+        if (configured > 0)
+        {
+            threadCount = static_cast<size_t>(configured);
+        }
+        else
+        {
+            // leave some room for the GUI and network threads
+            threadCount = std::clamp<size_t>(
+                std::thread::hardware_concurrency() / 2, 1, 4);
+        }
+    }
+
+    for (size_t i = 0; i < threadCount; i++)
+    {
+        auto &thread = this->threads_.emplace_back([this] {
+            this->run();
+        });
+        renameThread(thread, "ImageDecoder");
+    }
+}
+
+ImageDecodePool::Queue &ImageDecodePool::queue(Priority priority)
+{
+    return priority == Priority::Visible ? this->visible_ : this->normal_;
+}
+
+void ImageDecodePool::updateQueueDepth() const
+{
+    DebugCount::set("image decode queue",
+                    static_cast<int64_t>(this->pending_.size()));
+}
+
+void ImageDecodePool::run()
+{
+    std::unique_lock lock(this->mutex_);
+    while (true)
+    {
+        this->condition_.wait(lock, [this] {
+            return this->stopping_ || !this->pending_.empty();
+        });
+        if (this->stopping_)
+        {
+            return;
+        }
+
+        auto &queue = this->visible_.empty() ? this->normal_ : this->visible_;
+        auto job = std::move(queue.front().job);
+        this->pending_.erase(queue.front().owner);
+        queue.pop_front();
+        this->updateQueueDepth();
+
+        lock.unlock();
+        job();
+        // destroy the job (and everything it captured) outside of the lock
+        job = nullptr;
+        lock.lock();
+    }
+}
+
+}  // namespace chatterino
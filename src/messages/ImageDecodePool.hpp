@@ -0,0 +1,94 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace chatterino {
+
+/// Decodes downloaded images on a fixed number of worker threads.
+///
+/// Every job belongs to an owner (usually an Image) which has at most one
+/// pending job. Jobs of owners that are visible run before all other jobs, in
+/// the order they were submitted. Pending jobs can be cancelled, e.g. when
+/// their image is destroyed.
+class ImageDecodePool
+{
+public:
+    enum class Priority : uint8_t {
+        Normal,
+        /// The image is painted but not loaded yet
+        Visible,
+    };
+
+    using Job = std::function<void()>;
+
+    /// The number of threads is read from the imageDecoderThreads setting
+    /// when the first job is submitted
+    ImageDecodePool();
+    /// The worker threads are started with the first job
+    explicit ImageDecodePool(size_t threadCount);
+
+    /// Drops all pending jobs and waits for the running ones
+    ~ImageDecodePool();
+
+    ImageDecodePool(const ImageDecodePool &) = delete;
+    ImageDecodePool(ImageDecodePool &&) = delete;
+    ImageDecodePool &operator=(const ImageDecodePool &) = delete;
+    ImageDecodePool &operator=(ImageDecodePool &&) = delete;
+
+    /// The pool used by all images
+    static ImageDecodePool &instance();
+
+    /// Queues `job` for `owner`, replacing its pending job
+    void submit(const void *owner, Job job, Priority priority);
+
+    /// Runs the pending job of `owner` (if any) before all jobs with a
+    /// normal priority
+    void prioritize(const void *owner);
+
+    /// Drops the pending job of `owner` (if any).
+    /// A job that's already running isn't interrupted.
+    void cancel(const void *owner);
+
+    /// Returns the number of pending jobs
+    size_t pending() const;
+
+private:
+    struct Entry {
+        const void *owner;
+        Job job;
+    };
+    using Queue = std::list<Entry>;
+
+    struct Pending {
+        Priority priority;
+        Queue::iterator it;
+    };
+
+    void startThreads();
+    Queue &queue(Priority priority);
+    void updateQueueDepth() const;
+    void run();
+
+    /// 0 if the setting should be used
+    const size_t threadCount_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable condition_;
+    Queue visible_;
+    Queue normal_;
+    std::unordered_map<const void *, Pending> pending_;
+    bool stopping_ = false;
+
+    std::vector<std::thread> threads_;
+};
+
+}  // namespace chatterino
@@ -0,0 +1,313 @@
+#include "messages/ImageFrameCache.hpp"
+
+#include "Application.hpp"
+#include "common/QLogging.hpp"
+#include "singletons/Paths.hpp"
+#include "singletons/Settings.hpp"
+#include "util/CombinePath.hpp"
+#include "util/DebugCount.hpp"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+/// "C2FC" in little endian, files written on a machine with another byte
+/// order are rejected
+constexpr uint32_t MAGIC = 0x43463243;
+constexpr uint32_t VERSION = 1;
+
+/// Pixels of every frame start at a multiple of this
+constexpr int64_t ALIGNMENT = 16;
+
+struct FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t frameCount;
+    uint32_t reserved;
+};
+
+struct FrameHeader {
+    int32_t duration;
+    int32_t width;
+    int32_t height;
+    int32_t bytesPerLine;
+    /// Offset of the first pixel from the start of the file
+    int64_t offset;
+};
+
+static_assert(sizeof(FileHeader) == 16);
+static_assert(sizeof(FrameHeader) == 24);
+
+int64_t alignUp(int64_t offset)
+{
+    return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+bool isValidFrame(const FrameHeader &frame, int64_t fileSize)
+{
+    if (frame.width <= 0 || frame.height <= 0 ||
+        frame.bytesPerLine < int64_t{frame.width} * 4 || frame.offset < 0 ||
+        frame.offset % ALIGNMENT != 0)
+    {
+        return false;
+    }
+
+    return frame.offset + int64_t{frame.bytesPerLine} * frame.height <=
+           fileSize;
+}
+
+/// Sets the modification time of the file at `path` to now. The file has to
+/// be opened for writing, setting the time through a read-only handle fails
+/// on Windows.
+bool touch(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadWrite | QIODevice::ExistingOnly))
+    {
+        return false;
+    }
+    return file.setFileTime(QDateTime::currentDateTime(),
+                            QFileDevice::FileModificationTime);
+}
+
+}  // namespace
+
+namespace chatterino {
+
+ImageFrameCache::ImageFrameCache(QString directory, int64_t maxBytes)
+    : directory_(std::move(directory))
+    , maxBytes_(maxBytes)
+{
+}
+
+ImageFrameCache *ImageFrameCache::instance()
+{
+    auto *app = tryGetApp();
+    if (app == nullptr)
+    {
+        return nullptr;
+    }
+
+    auto maxMiB = getSettings()->imageFrameCacheSize.getValue();
+    if (maxMiB <= 0)
+    {
+        return nullptr;
+    }
+
+    static ImageFrameCache cache(
+        combinePath(app->getPaths().cacheDirectory(), "Frames"), 0);
+    cache.maxBytes_ = int64_t{maxMiB} * 1024 * 1024;
+    return &cache;
+}
+
+QString ImageFrameCache::filePath(const QString &url, qreal scale) const
+{
+    auto key = url.toUtf8() + '@' + QByteArray::number(scale);
+    auto hash = QCryptographicHash::hash(key, QCryptographicHash::Sha256);
+    return combinePath(this->directory_,
+                       QString::fromLatin1(hash.toHex() + ".frames"));
+}
+
+std::optional<QList<detail::DecodedFrame>> ImageFrameCache::read(
+    const QString &url, qreal scale) const
+{
+    QFile file(this->filePath(url, scale));
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return std::nullopt;
+    }
+
+    auto fileSize = file.size();
+    if (fileSize < static_cast<int64_t>(sizeof(FileHeader)))
+    {
+        return std::nullopt;
+    }
+
+    const auto *data = file.map(0, fileSize);
+    if (data == nullptr)
+    {
+        return std::nullopt;
+    }
+
+    FileHeader header{};
+    std::memcpy(&header, data, sizeof(FileHeader));
+    if (header.magic != MAGIC || header.version != VERSION ||
+        header.frameCount == 0 ||
+        sizeof(FileHeader) + header.frameCount * sizeof(FrameHeader) >
+            static_cast<uint64_t>(fileSize))
+    {
+        qCDebug(chatterinoCache) << "Ignoring broken frame cache file"
+                                 << file.fileName();
+        return std::nullopt;
+    }
+
+    QList<detail::DecodedFrame> frames;
+    frames.reserve(header.frameCount);
+    for (uint32_t i = 0; i < header.frameCount; i++)
+    {
+        FrameHeader frame{};
+        std::memcpy(&frame,
+                    data + sizeof(FileHeader) + i * sizeof(FrameHeader),
+                    sizeof(FrameHeader));
+        if (!isValidFrame(frame, fileSize))
+        {
+            qCDebug(chatterinoCache) << "Ignoring broken frame cache file"
+                                     << file.fileName();
+            return std::nullopt;
+        }
+
+        QImage image(frame.width, frame.height,
+                     QImage::Format_ARGB32_Premultiplied);
+        if (image.isNull())
+        {
+            return std::nullopt;
+        }
+
+        const auto *pixels = data + frame.offset;
+        auto lineBytes = static_cast<size_t>(frame.width) * 4;
+        for (int y = 0; y < frame.height; y++)
+        {
+            std::memcpy(image.scanLine(y), pixels, lineBytes);
+            pixels += frame.bytesPerLine;
+        }
+
+        frames.append(detail::DecodedFrame{
+            .image = std::move(image),
+            .duration = frame.duration,
+        });
+    }
+
+    // the modification time is used as the last access for the eviction
+    file.close();
+    if (!touch(file.fileName()))
+    {
+        qCDebug(chatterinoCache)
+            << "Failed to update the access time of" << file.fileName();
+    }
+    DebugCount::increase("image frame cache hits");
+
+    return frames;
+}
+
+void ImageFrameCache::write(const QString &url, qreal scale,
+                            const QList<detail::DecodedFrame> &frames)
+{
+    if (frames.empty())
+    {
+        return;
+    }
+
+    std::vector<FrameHeader> table;
+    table.reserve(frames.size());
+    auto offset = alignUp(static_cast<int64_t>(
+        sizeof(FileHeader) + frames.size() * sizeof(FrameHeader)));
+    for (const auto &frame : frames)
+    {
+        if (frame.image.format() != QImage::Format_ARGB32_Premultiplied)
+        {
+            return;
+        }
+
+        table.push_back({
+            .duration = frame.duration,
+            .width = frame.image.width(),
+            .height = frame.image.height(),
+            .bytesPerLine = frame.image.width() * 4,
+            .offset = offset,
+        });
+        offset = alignUp(offset + int64_t{table.back().bytesPerLine} *
+                                      table.back().height);
+    }
+
+    QDir().mkpath(this->directory_);
+    QSaveFile file(this->filePath(url, scale));
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qCWarning(chatterinoCache)
+            << "Failed to open frame cache file" << file.fileName();
+        return;
+    }
+
+    FileHeader header{
+        .magic = MAGIC,
+        .version = VERSION,
+        .frameCount = static_cast<uint32_t>(frames.size()),
+        .reserved = 0,
+    };
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(table.data()),
+               static_cast<qint64>(table.size() * sizeof(FrameHeader)));
+
+    const QByteArray padding(ALIGNMENT, '\0');
+    for (qsizetype i = 0; i < frames.size(); i++)
+    {
+        const auto &image = frames[i].image;
+        const auto &frame = table[static_cast<size_t>(i)];
+        file.write(padding.constData(), frame.offset - file.pos());
+        for (int y = 0; y < frame.height; y++)
+        {
+            file.write(reinterpret_cast<const char *>(image.constScanLine(y)),
+                       frame.bytesPerLine);
+        }
+    }
+
+    if (!file.commit())
+    {
+        qCWarning(chatterinoCache)
+            << "Failed to write frame cache file" << file.fileName() << ':'
+            << file.errorString();
+        return;
+    }
+
+    DebugCount::increase("image frame cache writes");
+
+    auto maxBytes = this->maxBytes_.load();
+    if (this->written_.fetch_add(offset) + offset > maxBytes / 4)
+    {
+        this->written_ = 0;
+        this->evict();
+    }
+}
+
+size_t ImageFrameCache::evict() const
+{
+    auto maxBytes = this->maxBytes_.load();
+    auto files = QDir(this->directory_)
+                     .entryInfoList({"*.frames"}, QDir::Files, QDir::Time);
+
+    // most recently used first, everything after the first file that
+    // exceeds the maximum size is removed
+    auto oldest = QDateTime::currentDateTime().addSecs(-MAX_AGE.count());
+    int64_t totalBytes = 0;
+    size_t removed = 0;
+    for (const auto &info : files)
+    {
+        totalBytes += info.size();
+        if (info.lastModified() >= oldest &&
+            (maxBytes <= 0 || totalBytes <= maxBytes))
+        {
+            continue;
+        }
+
+        if (QFile::remove(info.absoluteFilePath()))
+        {
+            removed++;
+        }
+    }
+
+    if (removed > 0)
+    {
+        qCDebug(chatterinoCache)
+            << "Removed" << removed << "files from" << this->directory_;
+    }
+    return removed;
+}
+
+}  // namespace chatterino
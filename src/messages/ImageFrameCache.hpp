@@ -0,0 +1,66 @@
+#pragma once
+
+#include "messages/Image.hpp"
+
+#include <QList>
+#include <QString>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace chatterino {
+
+/// Stores the decoded frames of images on disk, so images that were shown
+/// before don't have to be decoded again.
+///
+/// Every image is stored in its own file, named after the hash of its url and
+/// scale. A file starts with a header and a table of all frames, followed by
+/// the raw premultiplied ARGB32 pixels of each frame. The pixels are aligned,
+/// so the file can be mapped into memory and copied line by line.
+///
+/// Files are written atomically, so multiple threads (or instances) can use
+/// the same directory.
+class ImageFrameCache
+{
+public:
+    /// Cache files are stored in `directory`, which is created when the first
+    /// file is written. Once more than a quarter of `maxBytes` was written,
+    /// old files are evicted.
+    ImageFrameCache(QString directory, int64_t maxBytes);
+
+    /// The cache in the "Frames" directory of the cache directory used by all
+    /// images, or nullptr if the cache is disabled (or there's no
+    /// application).
+    static ImageFrameCache *instance();
+
+    /// Returns the cached frames of `url` at `scale`, or nothing if they aren't
+    /// cached or the cache file is broken
+    std::optional<QList<detail::DecodedFrame>> read(const QString &url,
+                                                    qreal scale) const;
+
+    /// Stores the `frames` of `url` at `scale`, replacing the cached ones
+    void write(const QString &url, qreal scale,
+               const QList<detail::DecodedFrame> &frames);
+
+    /// Removes files that weren't read or written for MAX_AGE, then the least
+    /// recently used files until all files use at most the maximum size.
+    /// Returns the number of removed files.
+    size_t evict() const;
+
+    /// The path of the file for `url` at `scale`
+    QString filePath(const QString &url, qreal scale) const;
+
+    /// Files that weren't used for this long are removed
+    static constexpr std::chrono::seconds MAX_AGE = std::chrono::days(14);
+
+private:
+    const QString directory_;
+    std::atomic<int64_t> maxBytes_;
+
+    /// Bytes written since the last eviction
+    std::atomic<int64_t> written_ = 0;
+};
+
+}  // namespace chatterino
@@ -4,7 +4,9 @@
 
 #include <boost/circular_buffer.hpp>
 
+#include <bit>
 #include <cassert>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <shared_mutex>
@@ -321,7 +323,15 @@ public:
     [[nodiscard]] LimitedQueueSnapshot<T> getSnapshot() const
     {
         std::shared_lock lock(this->mutex_);
-        return LimitedQueueSnapshot<T>(this->buffer_);
+
+        // All items go into a single chunk that's large enough
+        auto chunks = std::make_shared<detail::LimitedQueueChunks<T>>(
+            std::bit_width(this->buffer_.size()));
+        chunks->chunks.push_back(
+            std::make_shared<std::vector<T>>(this->buffer_.begin(),
+                                             this->buffer_.end()));
+        return LimitedQueueSnapshot<T>(std::move(chunks), 0,
+                                       this->buffer_.size());
     }
 
     // Actions
@@ -1,9 +1,13 @@
 #pragma once
 
-#include <boost/circular_buffer.hpp>
-
+#include <atomic>
 #include <cassert>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace chatterino {
@@ -11,52 +15,224 @@ namespace chatterino {
 template <typename T>
 class LimitedQueue;
 
+template <typename T>
+class ChunkedLimitedQueue;
+
+namespace detail {
+
+/// Fixed-size chunks of queue items shared between a queue and its snapshots.
+///
+/// Once published, the list of chunks is never modified. Items that are
+/// visible to a snapshot are never overwritten; a queue only writes to slots
+/// past the end of every published range (see ChunkedLimitedQueue).
+template <typename T>
+struct LimitedQueueChunks
+    : public std::enable_shared_from_this<LimitedQueueChunks<T>> {
+    using Chunk = std::vector<T>;
+
+    explicit LimitedQueueChunks(size_t chunkShift_)
+        : chunkShift(chunkShift_)
+    {
+    }
+
+    const T &at(size_t position) const
+    {
+        return (*this->chunks[position >> this->chunkShift])
+            [position & this->chunkMask()];
+    }
+
+    T &at(size_t position)
+    {
+        return (*this->chunks[position >> this->chunkShift])
+            [position & this->chunkMask()];
+    }
+
+    size_t chunkSize() const
+    {
+        return size_t{1} << this->chunkShift;
+    }
+
+    size_t chunkMask() const
+    {
+        return this->chunkSize() - 1;
+    }
+
+    std::vector<std::shared_ptr<Chunk>> chunks;
+    const size_t chunkShift;
+
+    /// The range of valid items, packed as (head << 32 | size).
+    /// Only used by ChunkedLimitedQueue, where it's updated by the writer
+    /// until these chunks are replaced.
+    std::atomic<uint64_t> range{0};
+};
+
+}  // namespace detail
+
+/// An immutable view of the items of a LimitedQueue at some point in time.
+///
+/// Snapshots share their items with the queue, so taking one doesn't copy any
+/// items when it's taken from a ChunkedLimitedQueue.
 template <typename T>
 class LimitedQueueSnapshot
 {
+    using Chunks = detail::LimitedQueueChunks<T>;
+
 private:
     friend class LimitedQueue<T>;
+    friend class ChunkedLimitedQueue<T>;
 
-    LimitedQueueSnapshot(const boost::circular_buffer<T> &buf)
-        : buffer_(buf.begin(), buf.end())
+    LimitedQueueSnapshot(std::shared_ptr<const Chunks> chunks, size_t head,
+                         size_t size)
+        : chunks_(std::move(chunks))
+        , head_(head)
+        , size_(size)
     {
     }
 
 public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        Iterator() = default;
+
+        Iterator(const Chunks *chunks, size_t position)
+            : chunks_(chunks)
+            , position_(position)
+        {
+        }
+
+        reference operator*() const
+        {
+            return this->chunks_->at(this->position_);
+        }
+
+        pointer operator->() const
+        {
+            return &**this;
+        }
+
+        reference operator[](difference_type n) const
+        {
+            return *(*this + n);
+        }
+
+        Iterator &operator++()
+        {
+            ++this->position_;
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            auto copy = *this;
+            ++this->position_;
+            return copy;
+        }
+
+        Iterator &operator--()
+        {
+            --this->position_;
+            return *this;
+        }
+
+        Iterator operator--(int)
+        {
+            auto copy = *this;
+            --this->position_;
+            return copy;
+        }
+
+        Iterator &operator+=(difference_type n)
+        {
+            this->position_ = static_cast<size_t>(
+                static_cast<difference_type>(this->position_) + n);
+            return *this;
+        }
+
+        Iterator &operator-=(difference_type n)
+        {
+            return *this += -n;
+        }
+
+        friend Iterator operator+(Iterator it, difference_type n)
+        {
+            return it += n;
+        }
+
+        friend Iterator operator+(difference_type n, Iterator it)
+        {
+            return it += n;
+        }
+
+        friend Iterator operator-(Iterator it, difference_type n)
+        {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const Iterator &a, const Iterator &b)
+        {
+            return static_cast<difference_type>(a.position_) -
+                   static_cast<difference_type>(b.position_);
+        }
+
+        friend bool operator==(const Iterator &a, const Iterator &b)
+        {
+            return a.position_ == b.position_;
+        }
+
+        friend auto operator<=>(const Iterator &a, const Iterator &b)
+        {
+            return a.position_ <=> b.position_;
+        }
+
+    private:
+        const Chunks *chunks_ = nullptr;
+        size_t position_ = 0;
+    };
+
     LimitedQueueSnapshot() = default;
 
     size_t size() const
     {
-        return this->buffer_.size();
+        return this->size_;
     }
 
     const T &operator[](size_t index) const
     {
-        return this->buffer_[index];
+        assert(index < this->size_);
+        return this->chunks_->at(this->head_ + index);
     }
 
-    auto begin() const
+    Iterator begin() const
     {
-        return this->buffer_.begin();
+        return {this->chunks_.get(), this->head_};
     }
 
-    auto end() const
+    Iterator end() const
     {
-        return this->buffer_.end();
+        return {this->chunks_.get(), this->head_ + this->size_};
     }
 
     auto rbegin() const
     {
-        return this->buffer_.rbegin();
+        return std::reverse_iterator(this->end());
     }
 
     auto rend() const
     {
-        return this->buffer_.rend();
+        return std::reverse_iterator(this->begin());
     }
 
 private:
-    std::vector<T> buffer_;
+    std::shared_ptr<const Chunks> chunks_;
+    size_t head_ = 0;
+    size_t size_ = 0;
 };
 
 }  // namespace chatterino
@@ -0,0 +1,166 @@
+#include "messages/MergedEmoteMap.hpp"
+
+#include "messages/Emote.hpp"
+#include "messages/MessageElement.hpp"
+
+#include <QSet>
+
+namespace {
+
+using namespace chatterino;
+
+const QSet<QString> BTTV_ZERO_WIDTH_EMOTES{
+    "SoSnowy",  "IceCold",   "SantaHat", "TopHat",
+    "ReinDeer", "CandyCane", "cvMask",   "cvHazmat",
+};
+
+bool isZeroWidth(MergedEmoteMap::ZeroWidth zeroWidth, const EmoteName &name,
+                 const Emote &emote)
+{
+    switch (zeroWidth)
+    {
+        case MergedEmoteMap::ZeroWidth::Never:
+            return false;
+        case MergedEmoteMap::ZeroWidth::FromEmote:
+            return emote.zeroWidth;
+        case MergedEmoteMap::ZeroWidth::BttvGlobal:
+            return MergedEmoteMap::isBttvZeroWidth(name);
+    }
+    return false;
+}
+
+}  // namespace
+
+namespace chatterino {
+
+MergedEmoteMap::MergedEmoteMap(std::vector<Source> sources)
+    : sources_(std::move(sources))
+{
+    size_t total = 0;
+    for (const auto &source : this->sources_)
+    {
+        if (source.emotes)
+        {
+            total += source.emotes->size();
+        }
+    }
+
+    size_t capacity = 16;
+    while (capacity < total * 2)
+    {
+        capacity *= 2;
+    }
+    this->slots_.resize(capacity);
+
+    for (const auto &source : this->sources_)
+    {
+        if (!source.emotes)
+        {
+            continue;
+        }
+
+        for (const auto &[name, emote] : *source.emotes)
+        {
+            if (!emote || name.string.isEmpty())
+            {
+                continue;
+            }
+
+            auto hash = qHash(name.string);
+            auto &slot = this->slots_[this->findSlot(name.string, hash)];
+            if (slot.entry.emote)
+            {
+                // A previous source has an emote with this name
+                continue;
+            }
+
+            slot.hash = hash;
+            slot.name = name.string;
+            slot.entry = {
+                .emote = emote,
+                .flag = source.flag,
+                .zeroWidth = isZeroWidth(source.zeroWidth, name, *emote),
+            };
+            this->size_++;
+
+            this->minLength_ = std::min(this->minLength_, name.string.size());
+            this->maxLength_ = std::max(this->maxLength_, name.string.size());
+            auto first = name.string.at(0).unicode();
+            if (first < this->asciiStarts_.size())
+            {
+                this->asciiStarts_.set(first);
+            }
+            else
+            {
+                this->nonAsciiStarts_ = true;
+            }
+        }
+    }
+}
+
+const MergedEmoteMap::Entry *MergedEmoteMap::find(const QString &name) const
+{
+    if (name.size() < this->minLength_ || name.size() > this->maxLength_)
+    {
+        return nullptr;
+    }
+    auto first = name.at(0).unicode();
+    if (first < this->asciiStarts_.size() ? !this->asciiStarts_[first]
+                                          : !this->nonAsciiStarts_)
+    {
+        return nullptr;
+    }
+
+    const auto &slot = this->slots_[this->findSlot(name, qHash(name))];
+    if (!slot.entry.emote)
+    {
+        return nullptr;
+    }
+    return &slot.entry;
+}
+
+bool MergedEmoteMap::isMergedFrom(const std::vector<Source> &sources) const
+{
+    return std::equal(this->sources_.begin(), this->sources_.end(),
+                      sources.begin(), sources.end(),
+                      [](const Source &a, const Source &b) {
+                          return a.emotes == b.emotes && a.flag == b.flag &&
+                                 a.zeroWidth == b.zeroWidth;
+                      });
+}
+
+size_t MergedEmoteMap::size() const
+{
+    return this->size_;
+}
+
+bool MergedEmoteMap::isBttvZeroWidth(const EmoteName &name)
+{
+    return BTTV_ZERO_WIDTH_EMOTES.contains(name.string);
+}
+
+size_t MergedEmoteMap::findSlot(const QString &name, size_t hash) const
+{
+    const auto mask = this->slots_.size() - 1;
+    for (auto i = hash & mask;; i = (i + 1) & mask)
+    {
+        const auto &slot = this->slots_[i];
+        if (!slot.entry.emote || (slot.hash == hash && slot.name == name))
+        {
+            return i;
+        }
+    }
+}
+
+std::shared_ptr<const MergedEmoteMap> MergedEmoteMapCache::get(
+    std::vector<MergedEmoteMap::Source> sources)
+{
+    std::lock_guard lock(this->mutex_);
+    if (!this->map_ || !this->map_->isMergedFrom(sources))
+    {
+        this->map_ = std::make_shared<const MergedEmoteMap>(std::move(sources));
+    }
+    return this->map_;
+}
+
+}  // namespace chatterino
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "common/Aliases.hpp"
+
+#include <QString>
+
+#include <bitset>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace chatterino {
+
+struct Emote;
+using EmotePtr = std::shared_ptr<const Emote>;
+class EmoteMap;
+enum class MessageElementFlag : int64_t;
+
+/// The third party emotes of multiple emote maps in one table.
+///
+/// Looking up a word hashes it once and probes one table instead of checking
+/// every emote map on its own. Words that can't be an emote (e.g. because of
+/// their length or first character) are rejected without hashing them.
+class MergedEmoteMap
+{
+public:
+    /// How to tell if an emote of a source is zero-width
+    enum class ZeroWidth : uint8_t {
+        Never,
+        /// Emote::zeroWidth (7TV)
+        FromEmote,
+        /// The hardcoded global zero-width emotes of BTTV
+        BttvGlobal,
+    };
+
+    struct Source {
+        std::shared_ptr<const EmoteMap> emotes;
+        MessageElementFlag flag;
+        ZeroWidth zeroWidth = ZeroWidth::Never;
+    };
+
+    struct Entry {
+        EmotePtr emote;
+        MessageElementFlag flag{};
+        bool zeroWidth = false;
+    };
+
+    /// Merges the emotes of `sources`. If multiple sources have an emote with
+    /// the same name, the first source wins.
+    explicit MergedEmoteMap(std::vector<Source> sources);
+
+    /// Returns the emote called `name` or nullptr
+    const Entry *find(const QString &name) const;
+
+    /// Checks if this map was merged from exactly these emote maps
+    bool isMergedFrom(const std::vector<Source> &sources) const;
+
+    size_t size() const;
+
+    /// Checks if `name` is one of the hardcoded global zero-width emotes of
+    /// BTTV
+    static bool isBttvZeroWidth(const EmoteName &name);
+
+private:
+    struct Slot {
+        size_t hash = 0;
+        QString name;
+        Entry entry;
+    };
+
+    /// Returns the index of the slot of `name` or of the empty slot where it
+    /// would be inserted
+    size_t findSlot(const QString &name, size_t hash) const;
+
+    std::vector<Source> sources_;
+    /// Open addressing with linear probing, at most half of the slots are used
+    std::vector<Slot> slots_;
+    size_t size_ = 0;
+
+    qsizetype minLength_ = std::numeric_limits<qsizetype>::max();
+    qsizetype maxLength_ = 0;
+    std::bitset<128> asciiStarts_;
+    bool nonAsciiStarts_ = false;
+};
+
+/// Keeps a MergedEmoteMap until one of its sources changes
+class MergedEmoteMapCache
+{
+public:
+    /// Returns the merged map of `sources`, merging them again if they
+    /// changed since the last call
+    std::shared_ptr<const MergedEmoteMap> get(
+        std::vector<MergedEmoteMap::Source> sources);
+
+private:
+    std::mutex mutex_;
+    std::shared_ptr<const MergedEmoteMap> map_;
+};
+
+}  // namespace chatterino
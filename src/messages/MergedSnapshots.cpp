@@ -0,0 +1,120 @@
+#include "messages/MergedSnapshots.hpp"
+
+#include "messages/Message.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace chatterino {
+
+void MergedSnapshots::add(LimitedQueueSnapshot<MessagePtr> snapshot,
+                          Filter filter)
+{
+    assert(!this->started_ && "messages can't be added while iterating");
+
+    this->cursors_.push_back({
+        .snapshot = std::move(snapshot),
+        .filter = std::move(filter),
+    });
+}
+
+MergedSnapshots::Iterator MergedSnapshots::begin()
+{
+    if (!this->started_)
+    {
+        this->started_ = true;
+
+        this->heap_.reserve(this->cursors_.size());
+        for (size_t i = 0; i < this->cursors_.size(); i++)
+        {
+            if (settle(this->cursors_[i]))
+            {
+                this->heap_.push_back(i);
+            }
+        }
+        std::ranges::make_heap(this->heap_, [this](size_t a, size_t b) {
+            return this->after(a, b);
+        });
+
+        this->advance();
+    }
+
+    return Iterator(this);
+}
+
+std::default_sentinel_t MergedSnapshots::end() const
+{
+    return std::default_sentinel;
+}
+
+std::vector<MessagePtr> MergedSnapshots::collect()
+{
+    std::vector<MessagePtr> messages;
+    for (const auto &message : *this)
+    {
+        messages.push_back(message);
+    }
+    return messages;
+}
+
+bool MergedSnapshots::settle(Cursor &cursor)
+{
+    const auto &snapshot = cursor.snapshot;
+    while (cursor.position < snapshot.size())
+    {
+        const auto &message = snapshot[cursor.position];
+        if (!cursor.filter || cursor.filter(message))
+        {
+            cursor.time = message->serverReceivedTime.toMSecsSinceEpoch();
+            return true;
+        }
+        cursor.position++;
+    }
+    return false;
+}
+
+bool MergedSnapshots::after(size_t a, size_t b) const
+{
+    const auto &lhs = this->cursors_[a];
+    const auto &rhs = this->cursors_[b];
+    if (lhs.time != rhs.time)
+    {
+        return lhs.time > rhs.time;
+    }
+    // messages received at the same time are ordered by their snapshot
+    return a > b;
+}
+
+void MergedSnapshots::advance()
+{
+    auto later = [this](size_t a, size_t b) {
+        return this->after(a, b);
+    };
+
+    this->current_.reset();
+    while (!this->heap_.empty())
+    {
+        std::ranges::pop_heap(this->heap_, later);
+        auto &cursor = this->cursors_[this->heap_.back()];
+        const auto &message = cursor.snapshot[cursor.position];
+        cursor.position++;
+
+        if (settle(cursor))
+        {
+            std::ranges::push_heap(this->heap_, later);
+        }
+        else
+        {
+            this->heap_.pop_back();
+        }
+
+        // messages without an ID (e.g. system messages) are never duplicates
+        if (message->id.isEmpty() || this->seenIDs_.insert(message->id).second)
+        {
+            this->current_ = message;
+            return;
+        }
+    }
+}
+
+}  // namespace chatterino
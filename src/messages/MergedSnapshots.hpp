@@ -0,0 +1,120 @@
+#pragma once
+
+#include "messages/LimitedQueueSnapshot.hpp"
+
+#include <QString>
+#include <QtGlobal>
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+namespace chatterino {
+
+struct Message;
+using MessagePtr = std::shared_ptr<const Message>;
+
+/// Merges the message snapshots of multiple channels into one sequence,
+/// ordered by Message::serverReceivedTime.
+///
+/// The messages of each snapshot are already ordered by time, so they're
+/// merged (k-way) instead of being sorted. Messages with an ID that was
+/// already returned (e.g. from two splits of the same channel) are skipped.
+///
+/// Messages are merged while iterating, so consumers that only need the
+/// first few messages can stop early. Like an input range, this can only be
+/// iterated once.
+class MergedSnapshots
+{
+public:
+    /// Returns true for the messages that should be merged
+    using Filter = std::function<bool(const MessagePtr &)>;
+
+    class Iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = MessagePtr;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const MessagePtr *;
+        using reference = const MessagePtr &;
+
+        Iterator() = default;
+
+        explicit Iterator(MergedSnapshots *merged)
+            : merged_(merged)
+        {
+        }
+
+        reference operator*() const
+        {
+            return this->merged_->current_;
+        }
+
+        pointer operator->() const
+        {
+            return &this->merged_->current_;
+        }
+
+        Iterator &operator++()
+        {
+            this->merged_->advance();
+            return *this;
+        }
+
+        void operator++(int)
+        {
+            this->merged_->advance();
+        }
+
+        friend bool operator==(const Iterator &it, std::default_sentinel_t)
+        {
+            return !it.merged_->current_;
+        }
+
+    private:
+        MergedSnapshots *merged_ = nullptr;
+    };
+
+    /// Adds the messages of `snapshot` that match `filter` (or all messages
+    /// if there's no filter). Must be called before iterating.
+    void add(LimitedQueueSnapshot<MessagePtr> snapshot, Filter filter = {});
+
+    Iterator begin();
+    std::default_sentinel_t end() const;
+
+    /// Merges all remaining messages
+    std::vector<MessagePtr> collect();
+
+private:
+    struct Cursor {
+        LimitedQueueSnapshot<MessagePtr> snapshot;
+        Filter filter;
+        size_t position = 0;
+        /// The time of the message at `position` in ms since epoch
+        qint64 time = 0;
+    };
+
+    /// Moves `cursor` to its next message that matches its filter. Returns
+    /// false if there are no messages left.
+    static bool settle(Cursor &cursor);
+
+    /// Orders the heap by the time of the next message of each cursor
+    bool after(size_t a, size_t b) const;
+
+    /// Finds the next message that wasn't returned before
+    void advance();
+
+    std::vector<Cursor> cursors_;
+    /// Indices of the cursors that have messages left, a heap with the cursor
+    /// with the earliest message at the front.
+    std::vector<size_t> heap_;
+    std::unordered_set<QString> seenIDs_;
+    MessagePtr current_;
+    bool started_ = false;
+};
+
+}  // namespace chatterino
@@ -9,8 +9,10 @@
 #include "controllers/ignores/IgnoreController.hpp"
 #include "controllers/ignores/IgnorePhrase.hpp"
 #include "controllers/userdata/UserDataController.hpp"
+#include "debug/AssertInGuiThread.hpp"
 #include "messages/Emote.hpp"
 #include "messages/Image.hpp"
+#include "messages/MergedEmoteMap.hpp"
 #include "messages/Message.hpp"
 #include "messages/MessageColor.hpp"
 #include "messages/MessageElement.hpp"
@@ -32,6 +34,7 @@
 #include "providers/twitch/TwitchBadges.hpp"
 #include "providers/twitch/TwitchChannel.hpp"
 #include "providers/twitch/TwitchIrc.hpp"
+#include "providers/twitch/TwitchIrcLine.hpp"
 #include "providers/twitch/TwitchIrcServer.hpp"
 #include "providers/twitch/TwitchUsers.hpp"
 #include "singletons/Emotes.hpp"
@@ -43,6 +46,7 @@
 #include "util/FormatTime.hpp"
 #include "util/Helpers.hpp"
 #include "util/IrcHelpers.hpp"
+#include "util/PostToThread.hpp"
 #include "util/QStringHash.hpp"
 #include "util/Variant.hpp"
 #include "widgets/Window.hpp"
@@ -53,6 +57,7 @@
 #include <QDateTime>
 #include <QDebug>
 #include <QFileInfo>
+#include <QPointer>
 #include <QStringBuilder>
 #include <QTimeZone>
 
@@ -79,11 +84,6 @@ const QRegularExpression allUsernamesMentionRegex("^" + regexHelpString);
 
 const QRegularExpression SPACE_REGEX("\\s");
 
-const QSet<QString> zeroWidthEmotes{
-    "SoSnowy",  "IceCold",   "SantaHat", "TopHat",
-    "ReinDeer", "CandyCane", "cvMask",   "cvHazmat",
-};
-
 struct HypeChatPaidLevel {
     std::chrono::seconds duration;
     uint8_t numeric;
@@ -426,12 +426,28 @@ EmotePtr makeSharedChatBadge(const QString &sourceName,
 }
 
 std::tuple<std::optional<EmotePtr>, MessageElementFlags, bool> parseEmote(
-    TwitchChannel *twitchChannel, const EmoteName &name)
+    const MergedEmoteMap *channelEmotes, const EmoteName &name)
 {
+    if (channelEmotes != nullptr)
+    {
+        // Has the channel and global emotes (see TwitchChannel::mergedEmotes)
+        const auto *entry = channelEmotes->find(name.string);
+        if (entry == nullptr)
+        {
+            return {
+                {},
+                {},
+                false,
+            };
+        }
+        return {
+            entry->emote,
+            entry->flag,
+            entry->zeroWidth,
+        };
+    }
+
     // Emote order:
-    //  - FrankerFaceZ Channel
-    //  - BetterTTV Channel
-    //  - 7TV Channel
     //  - FrankerFaceZ Global
     //  - BetterTTV Global
     //  - 7TV Global
@@ -442,41 +458,6 @@ std::tuple<std::optional<EmotePtr>, MessageElementFlags, bool> parseEmote(
 
     std::optional<EmotePtr> emote{};
 
-    if (twitchChannel != nullptr)
-    {
-        // Check for channel emotes
-
-        emote = twitchChannel->ffzEmote(name);
-        if (emote)
-        {
-            return {
-                emote,
-                MessageElementFlag::FfzEmote,
-                false,
-            };
-        }
-
-        emote = twitchChannel->bttvEmote(name);
-        if (emote)
-        {
-            return {
-                emote,
-                MessageElementFlag::BttvEmote,
-                false,
-            };
-        }
-
-        emote = twitchChannel->seventvEmote(name);
-        if (emote)
-        {
-            return {
-                emote,
-                MessageElementFlag::SevenTVEmote,
-                emote.value()->zeroWidth,
-            };
-        }
-    }
-
     // Check for global emotes
 
     emote = globalFfzEmotes->emote(name);
@@ -495,7 +476,7 @@ std::tuple<std::optional<EmotePtr>, MessageElementFlags, bool> parseEmote(
         return {
             emote,
             MessageElementFlag::BttvEmote,
-            zeroWidthEmotes.contains(name.string),
+            MergedEmoteMap::isBttvZeroWidth(name),
         };
     }
 
@@ -1263,7 +1244,22 @@ void MessageBuilder::addLink(const linkparser::Parsed &parsedLink,
                                    MessageElementFlag::Text, this->textColor_);
     }
 
-    getApp()->getLinkResolver()->resolve(el->linkInfo());
+    auto *linkInfo = el->linkInfo();
+    if (isGuiThread())
+    {
+        getApp()->getLinkResolver()->resolve(linkInfo);
+        return;
+    }
+
+    // Messages built in other threads are used in the GUI thread, which is
+    // where the link is resolved
+    linkInfo->moveToThread(QCoreApplication::instance()->thread());
+    postToThread([linkInfo = QPointer<LinkInfo>(linkInfo)] {
+        if (linkInfo)
+        {
+            getApp()->getLinkResolver()->resolve(linkInfo);
+        }
+    });
 }
 
 bool MessageBuilder::isIgnored(const QString &originalMessage,
@@ -2152,19 +2148,18 @@ MessagePtrMut MessageBuilder::makeClearChatMessage(const QDateTime &now,
 }
 
 std::pair<MessagePtrMut, HighlightAlert> MessageBuilder::makeIrcMessage(
-    /* mutable */ Channel *channel, const Communi::IrcMessage *ircMessage,
+    /* mutable */ Channel *channel, const TwitchIrcLine &line,
     const MessageParseArgs &args, /* mutable */ QString content,
     const QString::size_type messageOffset,
     const std::shared_ptr<MessageThread> &thread, const MessagePtr &parent)
 {
-    assert(ircMessage != nullptr);
     assert(channel != nullptr);
 
-    auto tags = ircMessage->tags();
+    auto userID = line.tag(TwitchTag::UserId);
+
     if (args.allowIgnore)
     {
-        bool ignored = MessageBuilder::isIgnored(
-            content, tags.value("user-id").toString(), channel);
+        bool ignored = MessageBuilder::isIgnored(content, userID, channel);
         if (ignored)
         {
             return {};
@@ -2173,10 +2168,8 @@ std::pair<MessagePtrMut, HighlightAlert> MessageBuilder::makeIrcMessage(
 
     auto *twitchChannel = dynamic_cast<TwitchChannel *>(channel);
 
-    auto userID = tags.value("user-id").toString();
-
     MessageBuilder builder;
-    builder.parseUsernameColor(tags, userID);
+    builder.parseUsernameColor(line, userID);
     builder->userID = userID;
 
     if (args.isAction)
@@ -2185,7 +2178,7 @@ std::pair<MessagePtrMut, HighlightAlert> MessageBuilder::makeIrcMessage(
         builder->flags.set(MessageFlag::Action);
     }
 
-    builder.parseUsername(ircMessage, twitchChannel,
+    builder.parseUsername(line, twitchChannel,
                           args.trimSubscriberUsername);
 
     builder->flags.set(MessageFlag::Collapsed);
@@ -2194,10 +2187,10 @@ std::pair<MessagePtrMut, HighlightAlert> MessageBuilder::makeIrcMessage(
 
     builder->channelName = channel->getName();
 
-    builder.parseMessageID(tags);
+    builder.parseMessageID(line);
 
-    MessageBuilder::parseRoomID(tags, twitchChannel);
-    twitchChannel = builder.parseSharedChatInfo(tags, twitchChannel);
+    MessageBuilder::parseRoomID(line, twitchChannel);
+    twitchChannel = builder.parseSharedChatInfo(line, twitchChannel);
 
     // If it is a reward it has to be appended first
     if (!args.channelPointRewardId.isEmpty())
@@ -2215,37 +2208,36 @@ std::pair<MessagePtrMut, HighlightAlert> MessageBuilder::makeIrcMessage(
 
     builder.appendChannelName(channel);
 
-    if (tags.contains("rm-deleted"))
+    if (line.hasTag(TwitchTag::RmDeleted))
     {
         builder->flags.set(MessageFlag::Disabled);
     }
 
-    if (tags.contains("msg-id") &&
-        tags["msg-id"].toString().split(';').contains("highlighted-message"))
+    if (line.tag(TwitchTag::MsgId).split(';').contains("highlighted-message"))
     {
         builder->flags.set(MessageFlag::RedeemedHighlight);
     }
 
-    if (tags.contains("first-msg") && tags["first-msg"].toString() == "1")
+    if (line.rawTag(TwitchTag::FirstMsg) == "1")
     {
         builder->flags.set(MessageFlag::FirstMessage);
     }
 
-    if (tags.contains("pinned-chat-paid-amount"))
+    if (line.hasTag(TwitchTag::PinnedChatPaidAmount))
     {
         builder->flags.set(MessageFlag::ElevatedMessage);
     }
 
-    if (tags.contains("bits"))
+    if (line.hasTag(TwitchTag::Bits))
     {
         builder->flags.set(MessageFlag::CheerMessage);
     }
 
     // reply threads
-    builder.parseThread(content, tags, channel, thread, parent);
+    builder.parseThread(content, line, channel, thread, parent);
 
     // timestamp
-    builder->serverReceivedTime = calculateMessageTime(ircMessage);
+    builder->serverReceivedTime = calculateMessageTime(line);
     builder.emplace<TimestampElement>(builder->serverReceivedTime.time());
 
     bool shouldAddModerationElements = [&] {
@@ -2255,7 +2247,7 @@ std::pair<MessagePtrMut, HighlightAlert> MessageBuilder::makeIrcMessage(
             return false;
         }
 
-        if (tags.value("user-type").toString() == "mod" &&
+        if (line.rawTag(TwitchTag::UserType) == "mod" &&
             !args.isStaffOrBroadcaster)
         {
             // You cannot timeout moderators UNLESS you are Twitch Staff or the broadcaster of the channel
@@ -2269,32 +2261,30 @@ std::pair<MessagePtrMut, HighlightAlert> MessageBuilder::makeIrcMessage(
         builder.emplace<TwitchModerationElement>();
     }
 
-    builder.appendTwitchBadges(tags, twitchChannel);
+    builder.appendTwitchBadges(line, twitchChannel);
 
     builder.appendChatterinoBadges(userID);
     builder.appendFfzBadges(twitchChannel, userID);
     builder.appendSeventvBadges(userID);
 
-    builder.appendUsername(tags, args);
+    builder.appendUsername(line, args);
 
     TextState textState{.twitchChannel = twitchChannel};
     QString bits;
 
-    auto iterator = tags.find("bits");
-    if (iterator != tags.end())
+    if (line.hasTag(TwitchTag::Bits))
     {
+        bits = line.tag(TwitchTag::Bits);
         textState.hasBits = true;
-        textState.bitsLeft = iterator.value().toInt();
-        bits = iterator.value().toString();
+        textState.bitsLeft = bits.toInt();
     }
 
     // Twitch emotes
     auto twitchEmotes =
-        parseTwitchEmotes(tags, content, static_cast<int>(messageOffset));
+        parseTwitchEmotes(line, content, static_cast<int>(messageOffset));
 
     // This runs through all ignored phrases and runs its replacements on content
-    processIgnorePhrases(*getSettings()->ignoredMessages.readOnly(), content,
-                         twitchEmotes);
+    processIgnorePhrases(content, twitchEmotes);
 
     std::ranges::sort(twitchEmotes, [](const auto &a, const auto &b) {
         return a.start < b.start;
@@ -2319,8 +2309,8 @@ std::pair<MessagePtrMut, HighlightAlert> MessageBuilder::makeIrcMessage(
                           builder->searchText;
 
     // highlights
-    HighlightAlert highlight = builder.parseHighlights(tags, content, args);
-    if (tags.contains("historical"))
+    HighlightAlert highlight = builder.parseHighlights(line, content, args);
+    if (line.hasTag(TwitchTag::Historical))
     {
         highlight.playSound = false;
         highlight.windowAlert = false;
@@ -2334,7 +2324,8 @@ std::pair<MessagePtrMut, HighlightAlert> MessageBuilder::makeIrcMessage(
             ColorProvider::instance().color(ColorType::Whisper);
     }
 
-    if (!args.isReceivedWhisper && tags.value("msg-id") != "announcement")
+    if (!args.isReceivedWhisper &&
+        line.rawTag(TwitchTag::MsgId) != "announcement")
     {
         if (thread)
         {
@@ -2377,7 +2368,7 @@ void MessageBuilder::addTextOrEmote(TextState &state, QString string)
     // Emote name: "forsenPuke" - if string in ignoredEmotes
     // Will match emote regardless of source (i.e. bttv, ffz)
     // Emote source + name: "bttv:nyanPls"
-    if (this->tryAppendEmote(state.twitchChannel, {string}))
+    if (this->tryAppendEmote(state, {string}))
     {
         // Successfully appended an emote
         return;
@@ -2490,7 +2481,7 @@ TextElement *MessageBuilder::emplaceSystemTextAndUpdate(const QString &text,
                                       MessageColor::System);
 }
 
-void MessageBuilder::parseUsernameColor(const QVariantMap &tags,
+void MessageBuilder::parseUsernameColor(const TwitchIrcLine &line,
                                         const QString &userID)
 {
     const auto *userData = getApp()->getUserData();
@@ -2506,34 +2497,32 @@ void MessageBuilder::parseUsernameColor(const QVariantMap &tags,
         }
     }
 
-    const auto iterator = tags.find("color");
-    if (iterator != tags.end())
+    if (const auto color = line.tag(TwitchTag::Color); !color.isEmpty())
     {
-        if (const auto color = iterator.value().toString(); !color.isEmpty())
-        {
-            this->usernameColor_ = QColor(color);
-            this->message().usernameColor = this->usernameColor_;
-            return;
-        }
+        this->usernameColor_ = QColor(color);
+        this->message().usernameColor = this->usernameColor_;
+        return;
     }
 
-    if (getSettings()->colorizeNicknames && tags.contains("user-id"))
+    if (getSettings()->colorizeNicknames && line.hasTag(TwitchTag::UserId))
     {
-        this->usernameColor_ = getRandomColor(tags.value("user-id").toString());
+        this->usernameColor_ = getRandomColor(userID);
         this->message().usernameColor = this->usernameColor_;
     }
 }
 
-void MessageBuilder::parseUsername(const Communi::IrcMessage *ircMessage,
+void MessageBuilder::parseUsername(const TwitchIrcLine &line,
                                    TwitchChannel *twitchChannel,
                                    bool trimSubscriberUsername)
 {
     // username
-    auto userName = ircMessage->nick();
+    const auto nick = QString::fromUtf8(
+        line.nick().data(), static_cast<qsizetype>(line.nick().size()));
+    auto userName = nick;
 
     if (userName.isEmpty() || trimSubscriberUsername)
     {
-        userName = ircMessage->tag("login").toString();
+        userName = line.tag(TwitchTag::Login);
     }
 
     this->message_->loginName = userName;
@@ -2544,23 +2533,21 @@ void MessageBuilder::parseUsername(const Communi::IrcMessage *ircMessage,
 
     // Update current user color if this is our message
     auto currentUser = getApp()->getAccounts()->twitch.getCurrent();
-    if (ircMessage->nick() == currentUser->getUserName())
+    if (nick == currentUser->getUserName())
     {
         currentUser->setColor(this->message_->usernameColor);
     }
 }
 
-void MessageBuilder::parseMessageID(const QVariantMap &tags)
+void MessageBuilder::parseMessageID(const TwitchIrcLine &line)
 {
-    auto iterator = tags.find("id");
-
-    if (iterator != tags.end())
+    if (line.hasTag(TwitchTag::Id))
     {
-        this->message().id = iterator.value().toString();
+        this->message().id = line.tag(TwitchTag::Id);
     }
 }
 
-QString MessageBuilder::parseRoomID(const QVariantMap &tags,
+QString MessageBuilder::parseRoomID(const TwitchIrcLine &line,
                                     TwitchChannel *twitchChannel)
 {
     if (twitchChannel == nullptr)
@@ -2568,11 +2555,9 @@ QString MessageBuilder::parseRoomID(const QVariantMap &tags,
         return {};
     }
 
-    auto iterator = tags.find("room-id");
-
-    if (iterator != std::end(tags))
+    if (line.hasTag(TwitchTag::RoomId))
     {
-        auto roomID = iterator->toString();
+        auto roomID = line.tag(TwitchTag::RoomId);
         if (twitchChannel->roomId() != roomID)
         {
             if (twitchChannel->roomId().isEmpty())
@@ -2593,7 +2578,7 @@ QString MessageBuilder::parseRoomID(const QVariantMap &tags,
     return {};
 }
 
-TwitchChannel *MessageBuilder::parseSharedChatInfo(const QVariantMap &tags,
+TwitchChannel *MessageBuilder::parseSharedChatInfo(const TwitchIrcLine &line,
                                                    TwitchChannel *twitchChannel)
 {
     if (!twitchChannel)
@@ -2601,9 +2586,9 @@ TwitchChannel *MessageBuilder::parseSharedChatInfo(const QVariantMap &tags,
         return twitchChannel;
     }
 
-    if (auto it = tags.find("source-room-id"); it != tags.end())
+    if (line.hasTag(TwitchTag::SourceRoomId))
     {
-        auto sourceRoom = it.value().toString();
+        auto sourceRoom = line.tag(TwitchTag::SourceRoomId);
         if (twitchChannel->roomId() != sourceRoom)
         {
             this->message().flags.set(MessageFlag::SharedMessage);
@@ -2628,7 +2613,7 @@ TwitchChannel *MessageBuilder::parseSharedChatInfo(const QVariantMap &tags,
 }
 
 void MessageBuilder::parseThread(const QString &messageContent,
-                                 const QVariantMap &tags,
+                                 const TwitchIrcLine &line,
                                  const Channel *channel,
                                  const std::shared_ptr<MessageThread> &thread,
                                  const MessagePtr &parent)
@@ -2688,15 +2673,15 @@ void MessageBuilder::parseThread(const QString &messageContent,
                 color, FontStyle::ChatMediumSmall)
             ->setLink({Link::ViewThread, thread->rootId()});
     }
-    else if (tags.find("reply-parent-msg-id") != tags.end())
+    else if (line.hasTag(TwitchTag::ReplyParentMsgId))
     {
         // Message is a reply but we couldn't find the original message.
         // Render the message using the additional reply tags
 
-        auto replyDisplayName = tags.find("reply-parent-display-name");
-        auto replyBody = tags.find("reply-parent-msg-body");
+        auto replyDisplayName = line.tag("reply-parent-display-name");
+        auto replyBody = line.tag("reply-parent-msg-body");
 
-        if (replyDisplayName != tags.end() && replyBody != tags.end())
+        if (!replyDisplayName.isNull() && !replyBody.isNull())
         {
             QString body;
 
@@ -2706,21 +2691,20 @@ void MessageBuilder::parseThread(const QString &messageContent,
                 MessageColor::System, FontStyle::ChatMediumSmall);
 
             bool ignored = MessageBuilder::isIgnored(
-                messageContent, tags.value("reply-parent-user-id").toString(),
-                channel);
+                messageContent, line.tag("reply-parent-user-id"), channel);
             if (ignored)
             {
                 body = QString("[Blocked user]");
             }
             else
             {
-                auto name = replyDisplayName->toString();
-                body = parseTagString(replyBody->toString());
+                body = parseTagString(replyBody);
 
                 this->emplace<TextElement>(
-                        "@" + name + ":", MessageElementFlag::RepliedMessage,
-                        this->textColor_, FontStyle::ChatMediumSmall)
-                    ->setLink({Link::UserInfo, name});
+                        "@" + replyDisplayName + ":",
+                        MessageElementFlag::RepliedMessage, this->textColor_,
+                        FontStyle::ChatMediumSmall)
+                    ->setLink({Link::UserInfo, replyDisplayName});
             }
 
             this->emplace<SingleLineTextElement>(
@@ -2732,7 +2716,7 @@ void MessageBuilder::parseThread(const QString &messageContent,
     }
 }
 
-HighlightAlert MessageBuilder::parseHighlights(const QVariantMap &tags,
+HighlightAlert MessageBuilder::parseHighlights(const TwitchIrcLine &line,
                                                const QString &originalMessage,
                                                const MessageParseArgs &args)
 {
@@ -2742,7 +2726,7 @@ HighlightAlert MessageBuilder::parseHighlights(const QVariantMap &tags,
         return {};
     }
 
-    auto badges = parseBadgeTag(tags);
+    auto badges = parseBadgeTag(line);
     auto [highlighted, highlightResult] = getApp()->getHighlights()->check(
         args, badges, this->message().loginName, originalMessage,
         this->message().flags);
@@ -2787,7 +2771,7 @@ void MessageBuilder::appendChannelName(const Channel *channel)
         ->setLink(link);
 }
 
-void MessageBuilder::appendUsername(const QVariantMap &tags,
+void MessageBuilder::appendUsername(const TwitchIrcLine &line,
                                     const MessageParseArgs &args)
 {
     auto *app = getApp();
@@ -2795,11 +2779,10 @@ void MessageBuilder::appendUsername(const QVariantMap &tags,
     QString username = this->message_->loginName;
     QString localizedName;
 
-    auto iterator = tags.find("display-name");
-    if (iterator != tags.end())
+    if (line.hasTag(TwitchTag::DisplayName))
     {
         QString displayName =
-            parseTagString(iterator.value().toString()).trimmed();
+            parseTagString(line.tag(TwitchTag::DisplayName)).trimmed();
 
         if (QString::compare(displayName, username, Qt::CaseInsensitive) == 0)
         {
@@ -2861,10 +2844,14 @@ void MessageBuilder::appendUsername(const QVariantMap &tags,
     }
 }
 
-Outcome MessageBuilder::tryAppendEmote(TwitchChannel *twitchChannel,
-                                       const EmoteName &name)
+Outcome MessageBuilder::tryAppendEmote(TextState &state, const EmoteName &name)
 {
-    auto [emote, flags, zeroWidth] = parseEmote(twitchChannel, name);
+    if (state.twitchChannel != nullptr && !state.channelEmotes)
+    {
+        state.channelEmotes = state.twitchChannel->mergedEmotes();
+    }
+    auto [emote, flags, zeroWidth] =
+        parseEmote(state.channelEmotes.get(), name);
 
     if (!emote)
     {
@@ -3001,7 +2988,7 @@ void MessageBuilder::addWords(
     }
 }
 
-void MessageBuilder::appendTwitchBadges(const QVariantMap &tags,
+void MessageBuilder::appendTwitchBadges(const TwitchIrcLine &line,
                                         TwitchChannel *twitchChannel)
 {
     if (twitchChannel == nullptr)
@@ -3011,7 +2998,7 @@ void MessageBuilder::appendTwitchBadges(const QVariantMap &tags,
 
     if (this->message().flags.has(MessageFlag::SharedMessage))
     {
-        const QString sourceId = tags["source-room-id"].toString();
+        const QString sourceId = line.tag(TwitchTag::SourceRoomId);
         QString sourceName;
         QString sourceProfilePicture;
         QString sourceLogin;
@@ -3042,8 +3029,8 @@ void MessageBuilder::appendTwitchBadges(const QVariantMap &tags,
             MessageElementFlag::BadgeSharedChannel);
     }
 
-    auto badgeInfos = parseBadgeInfoTag(tags);
-    auto badges = parseBadgeTag(tags);
+    auto badgeInfos = parseBadgeInfoTag(line);
+    auto badges = parseBadgeTag(line);
     appendBadges(this, badges, badgeInfos, twitchChannel);
 }
 
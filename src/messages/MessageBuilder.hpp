@@ -38,6 +38,8 @@ using EmotePtr = std::shared_ptr<const Emote>;
 
 class Channel;
 class TwitchChannel;
+class TwitchIrcLine;
+class MergedEmoteMap;
 class MessageThread;
 class IgnorePhrase;
 struct HelixVip;
@@ -221,7 +223,7 @@ public:
     static MessagePtr makeLowTrustUpdateMessage(
         const PubSubLowTrustUsersMessage &action);
 
-    /// @brief Builds a message out of an `ircMessage`.
+    /// @brief Builds a message out of an IRC `line`.
     ///
     /// Building a message won't cause highlights to be triggered. They will
     /// only be parsed. To trigger highlights (play sound etc.), use
@@ -229,11 +231,10 @@ public:
     ///
     /// @param channel The channel this message was sent to. Must not be
     ///                `nullptr`.
-    /// @param ircMessage The original message. This can be any message
-    ///                   (PRIVMSG, USERNOTICE, etc.). Its content is not
-    ///                   accessed through this parameter but through `content`,
-    ///                   as the content might be inside a tag (e.g. gifts in a
-    ///                   USERNOTICE).
+    /// @param line The original message. This can be any message (PRIVMSG,
+    ///             USERNOTICE, etc.). Its content is not accessed through this
+    ///             parameter but through `content`, as the content might be
+    ///             inside a tag (e.g. gifts in a USERNOTICE).
     /// @param args Arguments from parsing a chat message.
     /// @param content The message text. This isn't always the entire text. In
     ///                replies, the leading mention can be cut off.
@@ -255,7 +256,7 @@ public:
     ///          ignored (e.g. from a blocked user), then the returned pointer
     ///          will be en empty `shared_ptr`.
     static std::pair<MessagePtrMut, HighlightAlert> makeIrcMessage(
-        Channel *channel, const Communi::IrcMessage *ircMessage,
+        Channel *channel, const TwitchIrcLine &line,
         const MessageParseArgs &args, QString content,
         QString::size_type messageOffset,
         const std::shared_ptr<MessageThread> &thread = {},
@@ -282,6 +283,8 @@ public:
 private:
     struct TextState {
         TwitchChannel *twitchChannel = nullptr;
+        /// The emotes of twitchChannel, looked up by the first emote
+        std::shared_ptr<const MergedEmoteMap> channelEmotes;
         bool hasBits = false;
         bool bitsStacked = false;
         int bitsLeft = 0;
@@ -290,54 +293,54 @@ private:
     void addTextOrEmote(TextState &state, QString string);
 
     Outcome tryAppendCheermote(TextState &state, const QString &string);
-    Outcome tryAppendEmote(TwitchChannel *twitchChannel, const EmoteName &name);
+    Outcome tryAppendEmote(TextState &state, const EmoteName &name);
 
     bool isEmpty() const;
     MessageElement &back();
     std::unique_ptr<MessageElement> releaseBack();
 
     void parse();
-    void parseUsernameColor(const QVariantMap &tags, const QString &userID);
-    void parseUsername(const Communi::IrcMessage *ircMessage,
-                       TwitchChannel *twitchChannel,
+    void parseUsernameColor(const TwitchIrcLine &line, const QString &userID);
+    void parseUsername(const TwitchIrcLine &line, TwitchChannel *twitchChannel,
                        bool trimSubscriberUsername);
-    void parseMessageID(const QVariantMap &tags);
+    void parseMessageID(const TwitchIrcLine &line);
 
     /// Parses the room-ID this message was received in
     ///
     /// @returns The room-ID
-    static QString parseRoomID(const QVariantMap &tags,
+    static QString parseRoomID(const TwitchIrcLine &line,
                                TwitchChannel *twitchChannel);
 
     /// Parses the shared-chat information from this message.
     ///
-    /// @param tags The tags of the received message
+    /// @param line The received message
     /// @param twitchChannel The channel this message was received in
     /// @returns The source channel - the channel this message originated from.
     ///          If there's no channel currently open, @a twitchChannel is
     ///          returned.
-    TwitchChannel *parseSharedChatInfo(const QVariantMap &tags,
+    TwitchChannel *parseSharedChatInfo(const TwitchIrcLine &line,
                                        TwitchChannel *twitchChannel);
 
     // Parse & build thread information into the message
     // Will read information from thread_ or from IRC tags
-    void parseThread(const QString &messageContent, const QVariantMap &tags,
+    void parseThread(const QString &messageContent, const TwitchIrcLine &line,
                      const Channel *channel,
                      const std::shared_ptr<MessageThread> &thread,
                      const MessagePtr &parent);
     // parseHighlights only updates the visual state of the message, but leaves the playing of alerts and sounds to the triggerHighlights function
-    HighlightAlert parseHighlights(const QVariantMap &tags,
+    HighlightAlert parseHighlights(const TwitchIrcLine &line,
                                    const QString &originalMessage,
                                    const MessageParseArgs &args);
 
     void appendChannelName(const Channel *channel);
-    void appendUsername(const QVariantMap &tags, const MessageParseArgs &args);
+    void appendUsername(const TwitchIrcLine &line,
+                        const MessageParseArgs &args);
 
     void addWords(const QStringList &words,
                   const std::vector<TwitchEmoteOccurrence> &twitchEmotes,
                   TextState &state);
 
-    void appendTwitchBadges(const QVariantMap &tags,
+    void appendTwitchBadges(const TwitchIrcLine &line,
                             TwitchChannel *twitchChannel);
     void appendChatterinoBadges(const QString &userID);
     void appendFfzBadges(TwitchChannel *twitchChannel, const QString &userID);
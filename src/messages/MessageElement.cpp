@@ -583,8 +583,9 @@ void TextElement::addToContainer(MessageLayoutContainer &container,
 
     if (ctx.flags.hasAny(this->getFlags()))
     {
-        QFontMetrics metrics =
-            app->getFonts()->getFontMetrics(this->style_, container.getScale());
+        auto &advances = app->getFonts()->getAdvanceCache(
+            this->style_, container.getScale());
+        const auto &metrics = advances.metrics();
 
         for (const auto &word : this->words_)
         {
@@ -605,7 +606,7 @@ void TextElement::addToContainer(MessageLayoutContainer &container,
                 return e;
             };
 
-            auto width = metrics.horizontalAdvance(word);
+            auto width = advances.horizontalAdvance(word);
 
             // see if the text fits in the current line
             if (container.fitsInLine(width))
@@ -640,9 +641,11 @@ void TextElement::addToContainer(MessageLayoutContainer &container,
                 auto isSurrogate = word.size() > i + 1 &&
                                    QChar::isHighSurrogate(word[i].unicode());
 
-                auto charWidth = isSurrogate
-                                     ? metrics.horizontalAdvance(word.mid(i, 2))
-                                     : metrics.horizontalAdvance(word[i]);
+                auto charWidth =
+                    isSurrogate
+                        ? advances.horizontalAdvance(
+                              QChar::surrogateToUcs4(word[i], word[i + 1]))
+                        : advances.horizontalAdvance(word[i]);
 
                 if (!container.fitsInLine(width + charWidth))
                 {
@@ -7,59 +7,19 @@
 #include "singletons/Settings.hpp"
 
 #include <algorithm>
+#include <optional>
 #include <vector>
 
 namespace {
 
 using namespace chatterino;
 
-float relativeSimilarity(QStringView str1, QStringView str2)
-{
-    using SizeType = QStringView::size_type;
-
-    // Longest Common Substring Problem
-    std::vector<std::vector<int>> tree(str1.size(),
-                                       std::vector<int>(str2.size(), 0));
-    int z = 0;
-
-    for (SizeType i = 0; i < str1.size(); ++i)
-    {
-        for (SizeType j = 0; j < str2.size(); ++j)
-        {
-            if (str1[i] == str2[j])
-            {
-                if (i == 0 || j == 0)
-                {
-                    tree[i][j] = 1;
-                }
-                else
-                {
-                    tree[i][j] = tree[i - 1][j - 1] + 1;
-                }
-                z = std::max(tree[i][j], z);
-            }
-            else
-            {
-                tree[i][j] = 0;
-            }
-        }
-    }
-
-    // ensure that no div by 0
-    if (z == 0)
-    {
-        return 0.F;
-    }
-
-    auto div = std::max<>({static_cast<SizeType>(1), str1.size(), str2.size()});
-
-    return float(z) / float(div);
-}
-
 template <std::ranges::bidirectional_range T>
-float inMessages(const MessagePtr &msg, const T &messages)
+bool isSimilarToPrevious(const MessagePtr &msg, const T &messages)
 {
-    float similarityPercent = 0.0F;
+    const float threshold = getSettings()->similarityPercentage;
+    // Only built once a message has to be compared
+    std::optional<SubstringMatcher> matcher;
 
     for (const auto &prevMsg :
          messages | std::views::reverse |
@@ -75,12 +35,18 @@ float inMessages(const MessagePtr &msg, const T &messages)
         {
             continue;
         }
-        similarityPercent = std::max(
-            similarityPercent,
-            relativeSimilarity(msg->messageText, prevMsg->messageText));
+
+        if (!matcher)
+        {
+            matcher.emplace(msg->messageText);
+        }
+        if (matcher->isMoreSimilarThan(prevMsg->messageText, threshold))
+        {
+            return true;
+        }
     }
 
-    return similarityPercent;
+    return false;
 }
 
 }  // namespace
@@ -102,7 +68,7 @@ void setSimilarityFlags(const MessagePtr &message, const T &messages)
             return;
         }
 
-        if (inMessages(message, messages) > getSettings()->similarityPercentage)
+        if (isSimilarToPrevious(message, messages))
         {
             message->flags.set(MessageFlag::Similar);
             if (getSettings()->colorSimilarDisabled)
@@ -113,6 +79,222 @@ void setSimilarityFlags(const MessagePtr &message, const T &messages)
     }
 }
 
+SubstringMatcher::SubstringMatcher(QStringView needle)
+    : needleSize_(needle.size())
+    , histogram_(histogramOf(needle))
+{
+    // A suffix automaton has at most 2n - 1 states and 3n - 4 edges
+    this->states_.reserve(static_cast<size_t>(2 * needle.size() + 1));
+    this->edges_.reserve(static_cast<size_t>(3 * needle.size() + 1));
+    this->states_.emplace_back();
+
+    for (QChar c : needle)
+    {
+        this->extend(c.unicode());
+    }
+}
+
+float SubstringMatcher::relativeSimilarity(QStringView other) const
+{
+    auto longest = this->longestCommonSubstring(other, other.size());
+
+    // ensure that no div by 0
+    if (longest == 0)
+    {
+        return 0.F;
+    }
+
+    auto div = std::max<>(
+        {static_cast<SizeType>(1), this->needleSize_, other.size()});
+
+    return float(longest) / float(div);
+}
+
+bool SubstringMatcher::isMoreSimilarThan(QStringView other,
+                                         float threshold) const
+{
+    auto div = std::max<>(
+        {static_cast<SizeType>(1), this->needleSize_, other.size()});
+
+    // Find the shortest substring that's similar enough. This uses the same
+    // float division as relativeSimilarity, so the results always agree.
+    auto isEnough = [&](SizeType length) {
+        return float(length) / float(div) > threshold;
+    };
+    if (isEnough(0))
+    {
+        return true;
+    }
+    auto required = std::clamp(static_cast<SizeType>(threshold * float(div)),
+                               static_cast<SizeType>(0), div);
+    while (required > 0 && isEnough(required - 1))
+    {
+        required--;
+    }
+    while (required <= div && !isEnough(required))
+    {
+        required++;
+    }
+
+    if (std::min(this->needleSize_, other.size()) < required)
+    {
+        return false;
+    }
+    if (this->commonCharacters(other) < required)
+    {
+        return false;
+    }
+
+    return this->longestCommonSubstring(other, required) >= required;
+}
+
+void SubstringMatcher::extend(char16_t c)
+{
+    auto current = static_cast<int32_t>(this->states_.size());
+    this->states_.push_back({
+        .length = this->states_[this->last_].length + 1,
+    });
+
+    auto p = this->last_;
+    while (p != -1 && this->findEdge(p, c) == -1)
+    {
+        this->addEdge(p, c, current);
+        p = this->states_[p].link;
+    }
+
+    if (p == -1)
+    {
+        this->states_[current].link = 0;
+    }
+    else
+    {
+        auto q = this->edges_[this->findEdge(p, c)].target;
+        if (this->states_[p].length + 1 == this->states_[q].length)
+        {
+            this->states_[current].link = q;
+        }
+        else
+        {
+            auto clone = static_cast<int32_t>(this->states_.size());
+            this->states_.push_back({
+                .length = this->states_[p].length + 1,
+                .link = this->states_[q].link,
+            });
+            for (auto e = this->states_[q].firstEdge; e != -1;
+                 e = this->edges_[e].next)
+            {
+                auto edge = this->edges_[e];
+                this->addEdge(clone, edge.character, edge.target);
+            }
+
+            while (p != -1)
+            {
+                auto e = this->findEdge(p, c);
+                if (this->edges_[e].target != q)
+                {
+                    break;
+                }
+                this->edges_[e].target = clone;
+                p = this->states_[p].link;
+            }
+            this->states_[q].link = clone;
+            this->states_[current].link = clone;
+        }
+    }
+
+    this->last_ = current;
+}
+
+int32_t SubstringMatcher::findEdge(int32_t state, char16_t c) const
+{
+    for (auto e = this->states_[state].firstEdge; e != -1;
+         e = this->edges_[e].next)
+    {
+        if (this->edges_[e].character == c)
+        {
+            return e;
+        }
+    }
+    return -1;
+}
+
+void SubstringMatcher::addEdge(int32_t state, char16_t c, int32_t target)
+{
+    this->edges_.push_back({
+        .character = c,
+        .target = target,
+        .next = this->states_[state].firstEdge,
+    });
+    this->states_[state].firstEdge =
+        static_cast<int32_t>(this->edges_.size() - 1);
+}
+
+SubstringMatcher::SizeType SubstringMatcher::longestCommonSubstring(
+    QStringView other, SizeType stopAt) const
+{
+    int32_t state = 0;
+    SizeType length = 0;
+    SizeType longest = 0;
+
+    for (QChar c : other)
+    {
+        auto e = this->findEdge(state, c.unicode());
+        while (e == -1 && state != 0)
+        {
+            state = this->states_[state].link;
+            length = this->states_[state].length;
+            e = this->findEdge(state, c.unicode());
+        }
+
+        if (e == -1)
+        {
+            length = 0;
+            continue;
+        }
+
+        state = this->edges_[e].target;
+        length++;
+        if (length > longest)
+        {
+            longest = length;
+            if (longest >= stopAt)
+            {
+                break;
+            }
+        }
+    }
+
+    return longest;
+}
+
+SubstringMatcher::SizeType SubstringMatcher::commonCharacters(
+    QStringView other) const
+{
+    auto histogram = histogramOf(other);
+
+    SizeType common = 0;
+    for (size_t i = 0; i < HISTOGRAM_SIZE; i++)
+    {
+        common += std::min(histogram[i], this->histogram_[i]);
+    }
+    return common;
+}
+
+SubstringMatcher::Histogram SubstringMatcher::histogramOf(QStringView str)
+{
+    // Characters share buckets, which only makes the bound less tight
+    Histogram histogram{};
+    for (QChar c : str)
+    {
+        auto &count = histogram[c.unicode() % HISTOGRAM_SIZE];
+        if (count < UINT16_MAX)
+        {
+            count++;
+        }
+    }
+    return histogram;
+}
+
 template void setSimilarityFlags<std::vector<MessagePtr>>(
     const MessagePtr &msg, const std::vector<MessagePtr> &messages);
 template void setSimilarityFlags<LimitedQueueSnapshot<MessagePtr>>(
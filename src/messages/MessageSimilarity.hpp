@@ -2,10 +2,75 @@
 
 #include "messages/Message.hpp"
 
+#include <QStringView>
+
+#include <array>
+#include <cstdint>
 #include <ranges>
+#include <vector>
+
 namespace chatterino {
 
 template <std::ranges::bidirectional_range T>
 void setSimilarityFlags(const MessagePtr &message, const T &messages);
 
+/// Compares one string (the needle) with many others by their longest common
+/// substring.
+///
+/// The needle is indexed in a suffix automaton once, after which every
+/// comparison takes time linear in the length of the other string.
+class SubstringMatcher
+{
+public:
+    explicit SubstringMatcher(QStringView needle);
+
+    /// Returns the length of the longest common substring of the needle and
+    /// `other`, relative to the length of the longer string (0 to 1).
+    float relativeSimilarity(QStringView other) const;
+
+    /// Returns true if relativeSimilarity(other) > threshold.
+    ///
+    /// Strings are rejected by their length and a histogram of their
+    /// characters first, and the search stops as soon as a long enough
+    /// substring was found.
+    bool isMoreSimilarThan(QStringView other, float threshold) const;
+
+private:
+    using SizeType = QStringView::size_type;
+
+    static constexpr size_t HISTOGRAM_SIZE = 64;
+    using Histogram = std::array<uint16_t, HISTOGRAM_SIZE>;
+
+    struct State {
+        SizeType length = 0;
+        int32_t link = -1;
+        int32_t firstEdge = -1;
+    };
+
+    struct Edge {
+        char16_t character;
+        int32_t target;
+        int32_t next;
+    };
+
+    void extend(char16_t c);
+    /// Returns the index of the edge from `state` labelled `c` or -1
+    int32_t findEdge(int32_t state, char16_t c) const;
+    void addEdge(int32_t state, char16_t c, int32_t target);
+
+    /// Longest common substring, stopping at `stopAt` characters
+    SizeType longestCommonSubstring(QStringView other, SizeType stopAt) const;
+    /// Upper bound for the longest common substring
+    SizeType commonCharacters(QStringView other) const;
+
+    static Histogram histogramOf(QStringView str);
+
+    SizeType needleSize_;
+    Histogram histogram_{};
+
+    std::vector<State> states_;
+    std::vector<Edge> edges_;
+    int32_t last_ = 0;
+};
+
 }  // namespace chatterino
@@ -0,0 +1,356 @@
+#include "messages/ScrollbackArchive.hpp"
+
+#include "common/QLogging.hpp"
+#include "util/CombinePath.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+/// "C2SB" in little endian, files written on a machine with another byte
+/// order are rejected
+constexpr uint32_t MAGIC = 0x42533243;
+
+/// Every segment file ends with the start of each record followed by this
+struct SegmentFooter {
+    uint32_t recordCount;
+    uint32_t magic;
+};
+
+static_assert(sizeof(SegmentFooter) == 8);
+
+/// Held by the archive while it exists, so the directory isn't removed by
+/// removeStale() of another instance
+const QString LOCK_FILE = QStringLiteral("lock");
+
+/// Held in the parent directory while an archive creates and locks its
+/// directory and while removeStale() checks a directory, so removeStale()
+/// never sees a directory that wasn't locked yet
+const QString PARENT_LOCK_FILE = QStringLiteral("creation.lock");
+
+/// How long to wait for the lock of the parent directory
+constexpr std::chrono::seconds PARENT_LOCK_TIMEOUT{2};
+
+/// Creates `parentDirectory` and returns the template for QTemporaryDir
+QString directoryTemplate(const QString &parentDirectory, const QString &name)
+{
+    QDir().mkpath(parentDirectory);
+
+    QString safeName;
+    for (auto c : name)
+    {
+        safeName.append(c.isLetterOrNumber() ? c : QChar(u'_'));
+    }
+    return combinePath(parentDirectory, safeName + "-XXXXXX");
+}
+
+}  // namespace
+
+namespace chatterino {
+
+ScrollbackArchive::ScrollbackArchive(const QString &parentDirectory,
+                                     const QString &name, size_t maxRecords)
+    : maxSegments_(std::max<size_t>(
+          1, (maxRecords + SEGMENT_RECORDS - 1) / SEGMENT_RECORDS))
+{
+    auto directoryName = directoryTemplate(parentDirectory, name);
+    QLockFile parentLock(combinePath(parentDirectory, PARENT_LOCK_FILE));
+    if (!parentLock.tryLock(PARENT_LOCK_TIMEOUT))
+    {
+        qCWarning(chatterinoCache)
+            << "Failed to lock scrollback archives in" << parentDirectory;
+    }
+    else
+    {
+        this->directory_.emplace(directoryName);
+        if (!this->directory_->isValid())
+        {
+            qCWarning(chatterinoCache)
+                << "Failed to create scrollback archive in" << parentDirectory
+                << ':' << this->directory_->errorString();
+        }
+        else
+        {
+            this->lock_.emplace(this->directory_->filePath(LOCK_FILE));
+            if (!this->lock_->tryLock())
+            {
+                qCWarning(chatterinoCache)
+                    << "Failed to lock scrollback archive"
+                    << this->directory_->path();
+            }
+        }
+    }
+    this->current_.offsets.reserve(SEGMENT_RECORDS);
+
+    this->writer_.setMaxThreadCount(1);
+    this->writer_.setObjectName("ScrollbackArchive");
+}
+
+bool ScrollbackArchive::isValid() const
+{
+    // without the lock, removeStale() of another instance could remove the
+    // directory at any time
+    return this->lock_ && this->lock_->isLocked();
+}
+
+void ScrollbackArchive::append(const QByteArray &record)
+{
+    std::lock_guard lock(this->mutex_);
+
+    this->current_.offsets.push_back(
+        static_cast<uint32_t>(this->current_.data.size()));
+    this->current_.data.append(record);
+
+    if (this->current_.offsets.size() >= SEGMENT_RECORDS)
+    {
+        this->writeSegment();
+    }
+}
+
+size_t ScrollbackArchive::firstIndex() const
+{
+    std::lock_guard lock(this->mutex_);
+    return this->firstSegment_ * SEGMENT_RECORDS;
+}
+
+size_t ScrollbackArchive::endIndex() const
+{
+    std::lock_guard lock(this->mutex_);
+    return this->currentSegment_ * SEGMENT_RECORDS +
+           this->current_.offsets.size();
+}
+
+std::vector<QByteArray> ScrollbackArchive::read(size_t begin, size_t end) const
+{
+    std::unique_lock lock(this->mutex_);
+
+    begin = std::max(begin, this->firstSegment_ * SEGMENT_RECORDS);
+    end = std::min(end, this->currentSegment_ * SEGMENT_RECORDS +
+                            this->current_.offsets.size());
+    if (begin >= end)
+    {
+        return {};
+    }
+
+    auto readMemory = [](const Segment &segment, size_t first, size_t last,
+                         std::vector<QByteArray> &records) {
+        for (auto i = first; i < last; i++)
+        {
+            auto offset = segment.offsets[i];
+            auto next = i + 1 < segment.offsets.size()
+                            ? segment.offsets[i + 1]
+                            : static_cast<uint32_t>(segment.data.size());
+            records.push_back(segment.data.mid(offset, next - offset));
+        }
+    };
+
+    std::vector<QByteArray> records;
+    records.reserve(end - begin);
+    while (begin < end)
+    {
+        auto segment = begin / SEGMENT_RECORDS;
+        auto segmentEnd = std::min(end, (segment + 1) * SEGMENT_RECORDS);
+        auto first = begin - segment * SEGMENT_RECORDS;
+        auto last = segmentEnd - segment * SEGMENT_RECORDS;
+        begin = segmentEnd;
+
+        if (segment == this->currentSegment_)
+        {
+            readMemory(this->current_, first, last, records);
+            continue;
+        }
+
+        auto writing = this->writing_.find(segment);
+        if (writing != this->writing_.end())
+        {
+            readMemory(*writing->second, first, last, records);
+            continue;
+        }
+
+        // segments on disk don't change, only the current one needs the lock
+        lock.unlock();
+        this->readSegment(segment, first, last, records);
+        lock.lock();
+    }
+
+    return records;
+}
+
+void ScrollbackArchive::waitForWrites()
+{
+    this->writer_.waitForDone();
+}
+
+size_t ScrollbackArchive::removeStale(const QString &parentDirectory)
+{
+    size_t removed = 0;
+    for (const auto &info :
+         QDir(parentDirectory).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot))
+    {
+        QLockFile parentLock(combinePath(parentDirectory, PARENT_LOCK_FILE));
+        if (!parentLock.tryLock(PARENT_LOCK_TIMEOUT))
+        {
+            continue;
+        }
+
+        // The lock of a running archive can't be taken. Locks of crashed
+        // processes are detected as stale, but quiet archives must not be,
+        // so the age of the lock file doesn't matter.
+        QLockFile lock(combinePath(info.absoluteFilePath(), LOCK_FILE));
+        lock.setStaleLockTime(0);
+        if (!lock.tryLock())
+        {
+            continue;
+        }
+
+        lock.unlock();
+        if (QDir(info.absoluteFilePath()).removeRecursively())
+        {
+            removed++;
+        }
+    }
+
+    if (removed > 0)
+    {
+        qCDebug(chatterinoCache)
+            << "Removed" << removed << "scrollback archives from"
+            << parentDirectory;
+    }
+    return removed;
+}
+
+QString ScrollbackArchive::segmentPath(size_t segment) const
+{
+    return this->directory_->filePath(QString::number(segment) + ".segment");
+}
+
+void ScrollbackArchive::writeSegment()
+{
+    auto index = this->currentSegment_++;
+    auto segment =
+        std::make_shared<const Segment>(std::exchange(this->current_, {}));
+    this->current_.offsets.reserve(SEGMENT_RECORDS);
+    this->writing_.emplace(index, segment);
+
+    std::vector<size_t> removed;
+    while (this->currentSegment_ - this->firstSegment_ > this->maxSegments_)
+    {
+        this->writing_.erase(this->firstSegment_);
+        removed.push_back(this->firstSegment_);
+        this->firstSegment_++;
+    }
+
+    // the writer runs one task at a time, so segments are removed after they
+    // were written
+    this->writer_.start([this, index, segment = std::move(segment),
+                         removed = std::move(removed)] {
+        if (this->isValid())
+        {
+            QSaveFile file(this->segmentPath(index));
+            if (file.open(QIODevice::WriteOnly))
+            {
+                SegmentFooter footer{
+                    .recordCount =
+                        static_cast<uint32_t>(segment->offsets.size()),
+                    .magic = MAGIC,
+                };
+                file.write(segment->data);
+                file.write(
+                    reinterpret_cast<const char *>(segment->offsets.data()),
+                    static_cast<qint64>(segment->offsets.size() *
+                                        sizeof(uint32_t)));
+                file.write(reinterpret_cast<const char *>(&footer),
+                           sizeof(footer));
+            }
+            if (!file.commit())
+            {
+                qCWarning(chatterinoCache)
+                    << "Failed to write scrollback segment" << file.fileName()
+                    << ':' << file.errorString();
+            }
+
+            for (auto old : removed)
+            {
+                QFile::remove(this->segmentPath(old));
+            }
+        }
+
+        std::lock_guard lock(this->mutex_);
+        this->writing_.erase(index);
+    });
+}
+
+void ScrollbackArchive::readSegment(size_t segment, size_t begin, size_t end,
+                                    std::vector<QByteArray> &records) const
+{
+    auto missing = [&] {
+        records.resize(records.size() + (end - begin));
+    };
+
+    if (!this->isValid())
+    {
+        missing();
+        return;
+    }
+
+    QFile file(this->segmentPath(segment));
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        missing();
+        return;
+    }
+
+    auto fileSize = file.size();
+    const auto *data =
+        fileSize >= static_cast<qint64>(sizeof(SegmentFooter))
+            ? file.map(0, fileSize)
+            : nullptr;
+    if (data == nullptr)
+    {
+        missing();
+        return;
+    }
+
+    SegmentFooter footer{};
+    std::memcpy(&footer, data + fileSize - sizeof(SegmentFooter),
+                sizeof(SegmentFooter));
+    auto tableSize =
+        static_cast<qint64>(footer.recordCount * sizeof(uint32_t));
+    auto dataSize =
+        fileSize - static_cast<qint64>(sizeof(SegmentFooter)) - tableSize;
+    if (footer.magic != MAGIC || footer.recordCount < end || dataSize < 0)
+    {
+        qCDebug(chatterinoCache)
+            << "Ignoring broken scrollback segment" << file.fileName();
+        missing();
+        return;
+    }
+
+    auto offsetAt = [&](size_t i) -> qint64 {
+        if (i >= footer.recordCount)
+        {
+            return dataSize;
+        }
+        uint32_t offset = 0;
+        std::memcpy(&offset, data + dataSize + i * sizeof(uint32_t),
+                    sizeof(uint32_t));
+        return std::min<qint64>(offset, dataSize);
+    };
+
+    for (auto i = begin; i < end; i++)
+    {
+        auto offset = offsetAt(i);
+        auto next = std::max(offset, offsetAt(i + 1));
+        records.emplace_back(reinterpret_cast<const char *>(data + offset),
+                             static_cast<qsizetype>(next - offset));
+    }
+}
+
+}  // namespace chatterino
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <QByteArray>
+#include <QLockFile>
+#include <QString>
+#include <QTemporaryDir>
+#include <QThreadPool>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace chatterino {
+
+/// Keeps records (e.g. serialized messages) that no longer fit into a
+/// channel's message queue on disk.
+///
+/// Records are appended to an in-memory segment. Once it holds
+/// SEGMENT_RECORDS records, it's written to its own file in a background
+/// thread and a new segment is started, so only one segment is kept in memory
+/// (plus the ones that are being written) no matter how many records were
+/// archived. Records are read back by memory-mapping the segment files. Once
+/// there are more than the maximum number of records, the oldest segment
+/// files are removed.
+///
+/// Every record has an index, which is counted from the first record that was
+/// ever appended and doesn't change when old segments are removed.
+///
+/// The segment files are stored in a directory that's unique to the archive
+/// and removed with it. The directory contains a lock file that's held while
+/// the archive exists. It's created and locked while holding a lock in the
+/// parent directory, which removeStale() takes as well.
+///
+/// Records must only be appended from one thread, but they can be read from
+/// any thread.
+class ScrollbackArchive
+{
+public:
+    /// Creates the directory for the segment files in `parentDirectory`. Its
+    /// name starts with `name`.
+    ScrollbackArchive(const QString &parentDirectory, const QString &name,
+                      size_t maxRecords);
+
+    ScrollbackArchive(const ScrollbackArchive &) = delete;
+    ScrollbackArchive(ScrollbackArchive &&) = delete;
+    ScrollbackArchive &operator=(const ScrollbackArchive &) = delete;
+    ScrollbackArchive &operator=(ScrollbackArchive &&) = delete;
+
+    /// Whether the directory for the segment files could be created and
+    /// locked
+    bool isValid() const;
+
+    void append(const QByteArray &record);
+
+    /// The index of the oldest record that's still archived
+    size_t firstIndex() const;
+    /// The index the next appended record will get
+    size_t endIndex() const;
+
+    /// Returns the records from `begin` up to (excluding) `end`. The range is
+    /// clamped to the archived records. Records of segments that couldn't be
+    /// written or read are empty.
+    std::vector<QByteArray> read(size_t begin, size_t end) const;
+
+    /// Blocks until all segments were written
+    void waitForWrites();
+
+    /// Removes the directories in `parentDirectory` that don't belong to an
+    /// archive of a running process (e.g. left behind by a crash). Returns
+    /// the number of removed directories.
+    static size_t removeStale(const QString &parentDirectory);
+
+    static constexpr size_t SEGMENT_RECORDS = 1024;
+
+private:
+    struct Segment {
+        /// The records, one after another
+        QByteArray data;
+        /// Start of every record in `data`
+        std::vector<uint32_t> offsets;
+    };
+
+    QString segmentPath(size_t segment) const;
+    /// Starts writing the current segment and removes the segments that
+    /// exceed the maximum number of records
+    void writeSegment();
+    void readSegment(size_t segment, size_t begin, size_t end,
+                     std::vector<QByteArray> &records) const;
+
+    /// Empty if the parent directory couldn't be locked
+    std::optional<QTemporaryDir> directory_;
+    /// Empty if the directory couldn't be created
+    std::optional<QLockFile> lock_;
+    size_t maxSegments_;
+
+    mutable std::mutex mutex_;
+
+    /// The oldest segment that's still on disk
+    size_t firstSegment_ = 0;
+    /// The segment that's currently in memory, all segments before it were
+    /// written (or are being written)
+    size_t currentSegment_ = 0;
+
+    Segment current_;
+    /// Segments that are still being written, they're read from memory
+    std::map<size_t, std::shared_ptr<const Segment>> writing_;
+
+    /// Writes and removes the segment files one after another. It's
+    /// destroyed (and waited for) before the rest of the archive.
+    QThreadPool writer_;
+};
+
+}  // namespace chatterino
@@ -42,6 +42,7 @@ MessageLayout::MessageLayout(MessagePtr message)
 
 MessageLayout::~MessageLayout()
 {
+    this->deleteBuffer();
     DebugCount::decrease("message layout");
 }
 
@@ -223,20 +224,42 @@ MessagePaintResult MessageLayout::paint(const MessagePaintContext &ctx)
 {
     MessagePaintResult result;
 
-    QPixmap *pixmap = this->ensureBuffer(ctx.painter, ctx.canvasWidth,
-                                         ctx.messageColors.hasTransparency);
+    const int width = ctx.canvasWidth;
+    const int height = this->container_.getHeight();
 
-    if (!this->bufferValid_)
+    if (this->shouldPaintDirectly(ctx))
     {
-        if (ctx.messageColors.hasTransparency)
+        if (!ctx.paintDirectly)
         {
-            pixmap->fill(Qt::transparent);
+            // the message grew too large for a buffer
+            this->deleteBuffer();
         }
-        this->updateBuffer(pixmap, ctx);
+
+        ctx.painter.save();
+        ctx.painter.translate(0, ctx.y);
+        ctx.painter.setClipRect(0, 0, width, height, Qt::IntersectClip);
+        ctx.painter.setRenderHint(QPainter::SmoothPixmapTransform);
+        this->paintContent(ctx.painter, ctx);
+        ctx.painter.restore();
     }
+    else
+    {
+        QPixmap *pixmap = this->ensureBuffer(
+            ctx.painter, width, ctx.messageColors.hasTransparency);
 
-    // draw on buffer
-    ctx.painter.drawPixmap(0, ctx.y, *pixmap);
+        if (!this->bufferValid_)
+        {
+            if (ctx.messageColors.hasTransparency)
+            {
+                pixmap->fill(Qt::transparent);
+            }
+            this->updateBuffer(pixmap, ctx);
+            this->bufferValid_ = true;
+        }
+
+        // draw on buffer
+        ctx.painter.drawPixmap(0, ctx.y, *pixmap);
+    }
 
     // draw gif emotes
     result.hasAnimatedElements =
@@ -245,14 +268,14 @@ MessagePaintResult MessageLayout::paint(const MessagePaintContext &ctx)
     // draw disabled
     if (this->message_->flags.has(MessageFlag::Disabled))
     {
-        ctx.painter.fillRect(0, ctx.y, pixmap->width(), pixmap->height(),
+        ctx.painter.fillRect(0, ctx.y, width, height,
                              ctx.messageColors.disabled);
     }
 
     if (this->message_->flags.has(MessageFlag::RecentMessage) &&
         ctx.preferences.fadeMessageHistory)
     {
-        ctx.painter.fillRect(0, ctx.y, pixmap->width(), pixmap->height(),
+        ctx.painter.fillRect(0, ctx.y, width, height,
                              ctx.messageColors.disabled);
     }
 
@@ -262,7 +285,7 @@ MessagePaintResult MessageLayout::paint(const MessagePaintContext &ctx)
         ctx.preferences.enableRedeemedHighlight)
     {
         ctx.painter.fillRect(
-            0, ctx.y, int(this->scale_ * 4), pixmap->height(),
+            0, ctx.y, int(this->scale_ * 4), height,
             *ColorProvider::instance().color(ColorType::RedeemedHighlight));
     }
 
@@ -298,14 +321,30 @@ MessagePaintResult MessageLayout::paint(const MessagePaintContext &ctx)
         QBrush brush(color, ctx.preferences.lastMessagePattern);
 
         ctx.painter.fillRect(0, ctx.y + this->container_.getHeight() - 1,
-                             pixmap->width(), 1, brush);
+                             width, 1, brush);
     }
 
-    this->bufferValid_ = true;
-
     return result;
 }
 
+bool MessageLayout::shouldPaintDirectly(const MessagePaintContext &ctx) const
+{
+    if (this->buffer_ != nullptr && this->bufferValid_)
+    {
+        return false;
+    }
+
+    if (ctx.paintDirectly)
+    {
+        return true;
+    }
+
+    auto ratio = ctx.painter.device()->devicePixelRatioF();
+    auto pixels = qreal(ctx.canvasWidth) * ratio *
+                  qreal(this->container_.getHeight()) * ratio;
+    return pixels * 4 > MAX_BUFFER_BYTES;
+}
+
 QPixmap *MessageLayout::ensureBuffer(QPainter &painter, int width, bool clear)
 {
     if (this->buffer_ != nullptr)
@@ -341,6 +380,14 @@ void MessageLayout::updateBuffer(QPixmap *buffer,
     QPainter painter(buffer);
     painter.setRenderHint(QPainter::SmoothPixmapTransform);
 
+    this->paintContent(painter, ctx);
+}
+
+void MessageLayout::paintContent(QPainter &painter,
+                                 const MessagePaintContext &ctx)
+{
+    const QRect rect(0, 0, ctx.canvasWidth, this->container_.getHeight());
+
     // draw background
     QColor backgroundColor = [&] {
         if (ctx.preferences.alternateMessages &&
@@ -418,7 +465,7 @@ void MessageLayout::updateBuffer(QPixmap *buffer,
         backgroundColor = QColor("#4A273D");
     }
 
-    painter.fillRect(buffer->rect(), backgroundColor);
+    painter.fillRect(rect, backgroundColor);
 
     // draw message
     this->container_.paintElements(painter, ctx);
@@ -426,8 +473,7 @@ void MessageLayout::updateBuffer(QPixmap *buffer,
 #ifdef FOURTF
     // debug
     painter.setPen(QColor(255, 0, 0));
-    painter.drawRect(buffer->rect().x(), buffer->rect().y(),
-                     buffer->rect().width() - 1, buffer->rect().height() - 1);
+    painter.drawRect(rect.x(), rect.y(), rect.width() - 1, rect.height() - 1);
 
     QTextOption option;
     option.setAlignment(Qt::AlignRight | Qt::AlignTop);
@@ -114,10 +114,20 @@ private:
     // methods
     void actuallyLayout(const MessageLayoutContext &ctx);
     void updateBuffer(QPixmap *buffer, const MessagePaintContext &ctx);
+    // Paint the background and all elements at (0, 0)
+    void paintContent(QPainter &painter, const MessagePaintContext &ctx);
+
+    // Whether the message should be painted without its buffer.
+    // A valid buffer is always used, new buffers aren't created while
+    // scrolling or if they would be too large.
+    bool shouldPaintDirectly(const MessagePaintContext &ctx) const;
 
     // Create new buffer if required, returning the buffer
     QPixmap *ensureBuffer(QPainter &painter, int width, bool clear);
 
+    // Messages whose buffer would use more bytes are always painted directly
+    static constexpr qreal MAX_BUFFER_BYTES = 2 * 1024 * 1024;
+
     // variables
     const MessagePtr message_;
     MessageLayoutContainer container_;
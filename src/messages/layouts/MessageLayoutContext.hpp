@@ -83,6 +83,10 @@ struct MessagePaintContext {
     size_t messageIndex{};
 
     bool isLastReadMessage{};
+
+    // whether messages without a valid buffer should be painted directly,
+    // e.g. because the view is scrolled quickly
+    const bool paintDirectly{};
 };
 
 struct MessageLayoutContext {
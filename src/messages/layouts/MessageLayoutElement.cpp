@@ -470,13 +470,14 @@ int TextLayoutElement::getMouseOverIndex(const QPoint &abs) const
 
     auto *app = getApp();
 
-    auto metrics = app->getFonts()->getFontMetrics(this->style_, this->scale_);
+    auto &advances =
+        app->getFonts()->getAdvanceCache(this->style_, this->scale_);
     auto x = this->getRect().left();
 
     for (auto i = 0; i < this->getText().size(); i++)
     {
         auto &&text = this->getText();
-        auto width = metrics.horizontalAdvance(this->getText()[i]);
+        auto width = advances.horizontalAdvance(this->getText()[i]);
 
         // accept mouse to be at only 50%+ of character width to increase index
         if (x + (width * 0.5) > abs.x())
@@ -504,8 +505,8 @@ int TextLayoutElement::getXFromIndex(size_t index)
 {
     auto *app = getApp();
 
-    QFontMetrics metrics =
-        app->getFonts()->getFontMetrics(this->style_, this->scale_);
+    auto &advances =
+        app->getFonts()->getAdvanceCache(this->style_, this->scale_);
 
     if (index <= 0)
     {
@@ -516,7 +517,7 @@ int TextLayoutElement::getXFromIndex(size_t index)
         int x = 0;
         for (size_t i = 0; i < index; i++)
         {
-            x += metrics.horizontalAdvance(
+            x += advances.horizontalAdvance(
                 this->getText()[static_cast<QString::size_type>(i)]);
         }
         return x + this->getRect().left();
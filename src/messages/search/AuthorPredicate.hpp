@@ -24,6 +24,11 @@ public:
      */
     AuthorPredicate(const QString &authors, bool negate);
 
+    const QStringList &authors() const
+    {
+        return this->authors_;
+    }
+
 protected:
     /**
      * @brief Checks whether the message is authored by any of the users passed
@@ -38,6 +38,11 @@ public:
         return result;
     }
 
+    bool isNegated() const
+    {
+        return this->isNegated_;
+    }
+
 protected:
     explicit MessagePredicate(bool negate)
         : isNegated_(negate)
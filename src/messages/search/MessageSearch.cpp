@@ -0,0 +1,183 @@
+#include "messages/search/MessageSearch.hpp"
+
+#include "messages/Message.hpp"
+#include "messages/search/AuthorPredicate.hpp"
+#include "messages/search/MessagePredicate.hpp"
+#include "util/CancellationToken.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+using namespace chatterino;
+
+/// How many messages are checked between looking at the cancellation token
+constexpr size_t CANCELLATION_CHECK_INTERVAL = 1024;
+
+std::vector<size_t> intersect(const std::vector<size_t> &a,
+                              const std::vector<size_t> &b)
+{
+    std::vector<size_t> result;
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                          std::back_inserter(result));
+    return result;
+}
+
+bool isSpace(QChar c)
+{
+    return c.isSpace();
+}
+
+/// Returns the text after the last whitespace of `text`
+QStringView lastTerm(QStringView text)
+{
+    auto it = std::find_if(text.rbegin(), text.rend(), isSpace);
+    return text.last(std::distance(text.rbegin(), it));
+}
+
+}  // namespace
+
+namespace chatterino {
+
+MessageSearch::MessageSearch(LimitedQueueSnapshot<MessagePtr> messages)
+    : messages_(std::move(messages))
+{
+}
+
+const LimitedQueueSnapshot<MessagePtr> &MessageSearch::messages() const
+{
+    return this->messages_;
+}
+
+std::optional<std::vector<size_t>> MessageSearch::search(
+    const std::vector<std::unique_ptr<MessagePredicate>> &predicates,
+    const std::vector<size_t> *candidates,
+    const CancellationToken &token) const
+{
+    // Narrow down the messages to check with the author index
+    std::optional<std::vector<size_t>> indexed;
+    for (const auto &predicate : predicates)
+    {
+        const auto *author = dynamic_cast<AuthorPredicate *>(predicate.get());
+        if (author == nullptr || author->isNegated())
+        {
+            continue;
+        }
+
+        std::vector<size_t> positions;
+        for (const auto &name : author->authors())
+        {
+            const auto *messages = this->messagesFrom(name);
+            if (messages == nullptr)
+            {
+                continue;
+            }
+            std::vector<size_t> merged;
+            std::set_union(positions.begin(), positions.end(),
+                           messages->begin(), messages->end(),
+                           std::back_inserter(merged));
+            positions = std::move(merged);
+        }
+
+        indexed = indexed ? intersect(*indexed, positions)
+                          : std::move(positions);
+    }
+    if (indexed && candidates != nullptr)
+    {
+        indexed = intersect(*indexed, *candidates);
+    }
+    if (indexed)
+    {
+        candidates = &*indexed;
+    }
+
+    auto count = candidates != nullptr ? candidates->size()
+                                       : this->messages_.size();
+    std::vector<size_t> results;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (i % CANCELLATION_CHECK_INTERVAL == 0 && token.isCancelled())
+        {
+            return std::nullopt;
+        }
+
+        auto position = candidates != nullptr ? (*candidates)[i] : i;
+        const auto &message = this->messages_[position];
+
+        // Discard the message as soon as one predicate fails
+        auto accept = std::all_of(predicates.begin(), predicates.end(),
+                                  [&](const auto &predicate) {
+                                      return predicate->appliesTo(*message);
+                                  });
+        if (accept)
+        {
+            results.push_back(position);
+        }
+    }
+
+    return results;
+}
+
+bool MessageSearch::narrows(const QString &previous, const QString &query)
+{
+    if (!query.startsWith(previous))
+    {
+        return false;
+    }
+    if (previous.trimmed().isEmpty())
+    {
+        return true;
+    }
+    // Quoted values may contain spaces, so new terms could end up in a
+    // previous value
+    if (query.contains(u'"'))
+    {
+        return false;
+    }
+
+    auto added = QStringView(query).sliced(previous.size());
+    if (previous.back().isSpace() || added.isEmpty() || added.front().isSpace())
+    {
+        // Only new terms were added
+        return true;
+    }
+
+    // The last term was continued. A plain text term only matches messages
+    // that contain the shorter term as well.
+    auto continuedLength = std::find_if(added.begin(), added.end(), isSpace) -
+                           added.begin();
+    auto continued = lastTerm(
+        QStringView(query).first(previous.size() + continuedLength));
+    return !lastTerm(previous).contains(u':') && !continued.contains(u':');
+}
+
+const std::vector<size_t> *MessageSearch::messagesFrom(
+    const QString &author) const
+{
+    std::call_once(this->indexed_, [this] {
+        for (size_t i = 0; i < this->messages_.size(); i++)
+        {
+            const auto &message = this->messages_[i];
+            auto login = message->loginName.toLower();
+            auto display = message->displayName.toLower();
+            if (!login.isEmpty())
+            {
+                this->authors_[login].push_back(i);
+            }
+            if (!display.isEmpty() && display != login)
+            {
+                this->authors_[display].push_back(i);
+            }
+        }
+    });
+
+    auto it = this->authors_.find(author.toLower());
+    if (it == this->authors_.end())
+    {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+}  // namespace chatterino
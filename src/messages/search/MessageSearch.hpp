@@ -0,0 +1,71 @@
+#pragma once
+
+#include "messages/LimitedQueueSnapshot.hpp"
+
+#include <QString>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace chatterino {
+
+struct Message;
+using MessagePtr = std::shared_ptr<const Message>;
+class MessagePredicate;
+class CancellationToken;
+
+/**
+ * @brief Searches a fixed list of messages for messages matching predicates.
+ *
+ * The messages are indexed by their author the first time a search needs it,
+ * so searching for authors (`from:`) only checks the messages of these
+ * authors. All functions are thread-safe.
+ */
+class MessageSearch
+{
+public:
+    explicit MessageSearch(LimitedQueueSnapshot<MessagePtr> messages);
+
+    const LimitedQueueSnapshot<MessagePtr> &messages() const;
+
+    /**
+     * @brief Finds the messages that all `predicates` apply to.
+     *
+     * @param predicates  the predicates to check
+     * @param candidates  if set, only these positions are checked (e.g. the
+     *                    results of a query that's narrowed by this one)
+     * @param token       stops the search when cancelled
+     *
+     * @return the sorted positions of the matching messages or std::nullopt if
+     *         the search was cancelled
+     */
+    std::optional<std::vector<size_t>> search(
+        const std::vector<std::unique_ptr<MessagePredicate>> &predicates,
+        const std::vector<size_t> *candidates,
+        const CancellationToken &token) const;
+
+    /**
+     * @brief Checks if all messages matching `query` also match `previous`.
+     *
+     * That's the case if `query` adds new terms to `previous` or if it
+     * continues typing the last (plain text) term of `previous`. Then only
+     * the results of `previous` need to be searched.
+     */
+    static bool narrows(const QString &previous, const QString &query);
+
+private:
+    const std::vector<size_t> *messagesFrom(const QString &author) const;
+
+    LimitedQueueSnapshot<MessagePtr> messages_;
+
+    mutable std::once_flag indexed_;
+    /// Positions of the messages by the lowercase login and display names
+    /// of their authors
+    mutable std::unordered_map<QString, std::vector<size_t>> authors_;
+};
+
+}  // namespace chatterino
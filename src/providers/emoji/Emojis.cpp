@@ -13,6 +13,7 @@
 #include <rapidjson/error/error.h>
 #include <rapidjson/rapidjson.h>
 
+#include <algorithm>
 #include <map>
 #include <memory>
 
@@ -152,6 +153,113 @@ QString getToneNames(const QString &tones)
 
 namespace chatterino {
 
+EmojiTrie::EmojiTrie(
+    const std::vector<std::pair<QString, const EmojiData *>> &sequences)
+{
+    struct BuildNode {
+        std::map<char16_t, size_t> children;
+        int32_t sequence = -1;
+    };
+    std::vector<BuildNode> tree(1);
+
+    for (size_t i = 0; i < sequences.size(); i++)
+    {
+        const auto &units = sequences[i].first;
+        if (units.isEmpty())
+        {
+            continue;
+        }
+        this->starts_.set(units.at(0).unicode());
+
+        size_t node = 0;
+        for (auto unit : units)
+        {
+            auto [it, inserted] =
+                tree[node].children.try_emplace(unit.unicode(), tree.size());
+            node = it->second;
+            if (inserted)
+            {
+                tree.emplace_back();
+            }
+        }
+        if (tree[node].sequence < 0)
+        {
+            tree[node].sequence = static_cast<int32_t>(this->emojis_.size());
+        }
+        this->emojis_.emplace_back(sequences[i].second);
+    }
+
+    // Lay out the nodes breadth first, so the children of every node are
+    // next to each other
+    this->nodes_.resize(1);
+    std::vector<std::pair<size_t, size_t>> queue{{0, 0}};
+    for (size_t i = 0; i < queue.size(); i++)
+    {
+        auto [from, to] = queue[i];
+        this->nodes_[to].firstChild =
+            static_cast<uint32_t>(this->nodes_.size());
+        this->nodes_[to].childCount =
+            static_cast<uint32_t>(tree[from].children.size());
+        for (auto [unit, child] : tree[from].children)
+        {
+            queue.emplace_back(child, this->nodes_.size());
+            this->nodes_.push_back({
+                .unit = unit,
+                .sequence = tree[child].sequence,
+            });
+        }
+    }
+}
+
+EmojiTrie::Match EmojiTrie::match(QStringView text) const
+{
+    Match result;
+    int32_t bestSequence = -1;
+
+    const Node *node = &this->nodes_.front();
+    for (qsizetype i = 0; i < text.size(); i++)
+    {
+        auto unit = text[i].unicode();
+        const auto *begin = this->nodes_.data() + node->firstChild;
+        const auto *end = begin + node->childCount;
+        const auto *child = std::lower_bound(begin, end, unit,
+                                             [](const Node &n, char16_t u) {
+                                                 return n.unit < u;
+                                             });
+        if (child == end || child->unit != unit)
+        {
+            break;
+        }
+        node = child;
+
+        if (node->sequence >= 0 &&
+            (bestSequence < 0 || node->sequence < bestSequence))
+        {
+            bestSequence = node->sequence;
+            result.length = i + 1;
+        }
+    }
+
+    if (bestSequence >= 0)
+    {
+        result.emoji = this->emojis_[static_cast<size_t>(bestSequence)];
+    }
+    return result;
+}
+
+qsizetype EmojiTrie::findStart(QStringView text, qsizetype from) const
+{
+    for (auto i = from; i < text.size(); i++)
+    {
+        if (this->starts_[text[i].unicode()])
+        {
+            return i;
+        }
+    }
+
+    return text.size();
+}
+
 void Emojis::load()
 {
     if (this->loaded_)
@@ -196,8 +304,6 @@ void Emojis::loadEmojis()
             this->shortCodes.emplace_back(shortCode);
         }
 
-        this->emojiFirstByte_[emojiData->value.at(0)].append(emojiData);
-
         this->emojis.push_back(emojiData);
 
         if (unparsedEmoji.HasMember("skin_variations"))
@@ -217,9 +323,6 @@ void Emojis::loadEmojis()
                     variationEmojiData->shortCodes[0], variationEmojiData);
                 this->shortCodes.push_back(variationEmojiData->shortCodes[0]);
 
-                this->emojiFirstByte_[variationEmojiData->value.at(0)].append(
-                    variationEmojiData);
-
                 this->emojis.push_back(variationEmojiData);
             }
         }
@@ -228,13 +331,31 @@ void Emojis::loadEmojis()
 
 void Emojis::sortEmojis()
 {
-    for (auto &p : this->emojiFirstByte_)
+    // Longer emojis are matched first. The non-qualified string of an emoji
+    // is checked right after its qualified one.
+    std::vector<const EmojiData *> byLength;
+    for (const auto &emoji : this->emojis)
     {
-        std::stable_sort(p.begin(), p.end(),
-                         [](const auto &lhs, const auto &rhs) {
-                             return lhs->value.length() > rhs->value.length();
-                         });
+        byLength.emplace_back(emoji.get());
     }
+    std::stable_sort(byLength.begin(), byLength.end(),
+                     [](const auto *lhs, const auto *rhs) {
+                         return lhs->value.length() > rhs->value.length();
+                     });
+
+    std::vector<std::pair<QString, const EmojiData *>> sequences;
+    for (const auto *emoji : byLength)
+    {
+        sequences.emplace_back(emoji->value, emoji);
+        if (!emoji->nonQualified.isNull())
+        {
+            // The non-qualified string is assumed to start with the same
+            // character as the qualified one
+            sequences.emplace_back(
+                emoji->value.at(0) + emoji->nonQualified.mid(1), emoji);
+        }
+    }
+    this->emojiTrie_ = EmojiTrie(sequences);
 
     auto &p = this->shortCodes;
     std::stable_sort(p.begin(), p.end(), [](const auto &lhs, const auto &rhs) {
@@ -304,79 +425,17 @@ std::vector<boost::variant<EmotePtr, QString>> Emojis::parse(
     auto result = std::vector<boost::variant<EmotePtr, QString>>();
     QString::size_type lastParsedEmojiEndIndex = 0;
 
-    for (qsizetype i = 0; i < text.length(); ++i)
+    for (auto i = this->emojiTrie_.findStart(text, 0); i < text.length();
+         i = this->emojiTrie_.findStart(text, i))
     {
-        const QChar character = text.at(i);
-
-        if (character.isLowSurrogate())
-        {
-            continue;
-        }
-
-        auto it = this->emojiFirstByte_.find(character);
-        if (it == this->emojiFirstByte_.end())
-        {
-            // No emoji starts with this character
-            continue;
-        }
-
-        const auto &possibleEmojis = it.value();
-
-        auto remainingCharacters = text.length() - i - 1;
-
-        std::shared_ptr<EmojiData> matchedEmoji;
-
-        QString::size_type matchedEmojiLength = 0;
-
-        for (const std::shared_ptr<EmojiData> &emoji : possibleEmojis)
-        {
-            auto emojiNonQualifiedExtraCharacters =
-                emoji->nonQualified.length() - 1;
-            auto emojiExtraCharacters = emoji->value.length() - 1;
-            if (remainingCharacters >= emojiExtraCharacters)
-            {
-                // look in emoji->value
-                bool match = QStringView{emoji->value}.mid(1) ==
-                             QStringView{text}.mid(i + 1, emojiExtraCharacters);
-
-                if (match)
-                {
-                    matchedEmoji = emoji;
-                    matchedEmojiLength = emoji->value.length();
-
-                    break;
-                }
-            }
-            if (!emoji->nonQualified.isNull() &&
-                remainingCharacters >= emojiNonQualifiedExtraCharacters)
-            {
-                // This checking here relies on the fact that the nonQualified string
-                // always starts with the same byte as value (the unified string)
-                bool match = QStringView{emoji->nonQualified}.mid(1) ==
-                             QStringView{text}.mid(
-                                 i + 1, emojiNonQualifiedExtraCharacters);
-
-                if (match)
-                {
-                    matchedEmoji = emoji;
-                    matchedEmojiLength = emoji->nonQualified.length();
-
-                    break;
-                }
-            }
-        }
-
-        if (matchedEmojiLength == 0)
+        auto match = this->emojiTrie_.match(QStringView{text}.sliced(i));
+        if (match.emoji == nullptr)
         {
+            ++i;
             continue;
         }
 
-        auto currentParsedEmojiFirstIndex = i;
-        auto currentParsedEmojiEndIndex = i + (matchedEmojiLength);
-
-        auto charactersFromLastParsedEmoji =
-            currentParsedEmojiFirstIndex - lastParsedEmojiEndIndex;
-
+        auto charactersFromLastParsedEmoji = i - lastParsedEmojiEndIndex;
         if (charactersFromLastParsedEmoji > 0)
         {
             // Add characters inbetween emojis
@@ -385,11 +444,10 @@ std::vector<boost::variant<EmotePtr, QString>> Emojis::parse(
         }
 
         // Push the emoji as a word to parsedWords
-        result.emplace_back(matchedEmoji->emote);
-
-        lastParsedEmojiEndIndex = currentParsedEmojiEndIndex;
+        result.emplace_back(match.emoji->emote);
 
-        i += matchedEmojiLength - 1;
+        i += match.length;
+        lastParsedEmojiEndIndex = i;
     }
 
     if (lastParsedEmojiEndIndex < text.length())
@@ -5,9 +5,12 @@
 #include <boost/variant.hpp>
 #include <QMap>
 #include <QRegularExpression>
-#include <QVector>
+#include <QStringView>
 
+#include <bitset>
+#include <cstdint>
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace chatterino {
@@ -47,6 +50,45 @@ struct EmojiData {
 
 using EmojiPtr = std::shared_ptr<EmojiData>;
 
+/// A trie over the UTF-16 code units of emojis
+class EmojiTrie
+{
+public:
+    EmojiTrie() = default;
+
+    /// Builds the trie from a list of code unit sequences and their emojis.
+    /// If multiple sequences match, the first one in the list wins.
+    explicit EmojiTrie(
+        const std::vector<std::pair<QString, const EmojiData *>> &sequences);
+
+    struct Match {
+        const EmojiData *emoji = nullptr;
+        qsizetype length = 0;
+    };
+
+    /// Finds the emoji at the start of `text`
+    Match match(QStringView text) const;
+
+    /// Returns the position of the first code unit in `text` at or after
+    /// `from` that starts an emoji sequence, or the size of `text`
+    qsizetype findStart(QStringView text, qsizetype from) const;
+
+private:
+    struct Node {
+        /// The children are stored next to each other, sorted by their unit
+        uint32_t firstChild = 0;
+        uint32_t childCount = 0;
+        char16_t unit = 0;
+        /// The index of the sequence ending here or -1
+        int32_t sequence = -1;
+    };
+
+    std::vector<Node> nodes_{1};
+    std::vector<const EmojiData *> emojis_;
+    /// The code units that start a sequence
+    std::bitset<0x10000> starts_;
+};
+
 class IEmojis
 {
 public:
@@ -86,9 +128,8 @@ private:
     // shortCodeToEmoji maps strings like "sunglasses" to its emoji
     QMap<QString, std::shared_ptr<EmojiData>> emojiShortCodeToEmoji_;
 
-    // Maps the first character of the emoji unicode string to a vector of
-    // possible emojis
-    QMap<QChar, QVector<std::shared_ptr<EmojiData>>> emojiFirstByte_;
+    // Matches the qualified and non-qualified emoji unicode strings
+    EmojiTrie emojiTrie_;
 
     bool loaded_ = false;
 };
@@ -4,19 +4,136 @@
 #include "common/network/NetworkResult.hpp"
 #include "common/QLogging.hpp"
 #include "providers/recentmessages/Impl.hpp"
+#include "providers/twitch/TwitchChannel.hpp"
+#include "singletons/Settings.hpp"
 #include "util/PostToThread.hpp"
+#include "util/VectorMessageSink.hpp"
+
+#include <QtConcurrent>
 
 namespace {
 
+using namespace chatterino;
+using namespace chatterino::recentmessages;
+using namespace chatterino::recentmessages::detail;
+
 // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
 const auto &LOG = chatterinoRecentMessages;
 
+/// Builds the recent messages of a channel. If message builder threads are
+/// enabled, the chunks are prepared in the global thread pool and finished in
+/// the GUI thread as soon as all chunks before them are finished, so the GUI
+/// thread is never blocked by a whole backfill.
+class Backfill : public std::enable_shared_from_this<Backfill>
+{
+public:
+    Backfill(std::shared_ptr<TwitchChannel> channel, QJsonObject root,
+             ResultCallback onLoaded)
+        : channel_(std::move(channel))
+        , root_(std::move(root))
+        , onLoaded_(std::move(onLoaded))
+    {
+    }
+
+    /// Prepares all chunks, must be called in the GUI thread
+    void start()
+    {
+        auto chunks = splitRecentMessages(this->root_);
+        this->prepared_.resize(chunks.size());
+        if (chunks.empty())
+        {
+            this->finish();
+            return;
+        }
+
+        // Building messages outside of the GUI thread is experimental, so
+        // it's only done if message builder threads are enabled
+        if (getSettings()->messageBuilderThreads.getValue() <= 0)
+        {
+            for (size_t i = 0; i < chunks.size(); i++)
+            {
+                this->chunkPrepared(i, prepareRecentMessages(
+                                           chunks[i], this->channel_.get(),
+                                           false));
+            }
+            return;
+        }
+
+        for (size_t i = 0; i < chunks.size(); i++)
+        {
+            std::ignore = QtConcurrent::run(
+                [self = this->shared_from_this(), i,
+                 lines = std::move(chunks[i])]() mutable {
+                    auto prepared =
+                        prepareRecentMessages(lines, self->channel_.get());
+
+                    // The last reference (and the channel) is only released
+                    // in the GUI thread
+                    postToThread([self = std::move(self), i,
+                                  prepared = std::move(prepared)]() mutable {
+                        self->chunkPrepared(i, std::move(prepared));
+                    });
+                });
+        }
+    }
+
+private:
+    void chunkPrepared(size_t index, PreparedRecentMessages prepared)
+    {
+        this->prepared_[index] = std::move(prepared);
+
+        while (this->nextChunk_ < this->prepared_.size() &&
+               this->prepared_[this->nextChunk_])
+        {
+            finishRecentMessages(*this->prepared_[this->nextChunk_],
+                                 this->sink_, this->channel_.get());
+            this->prepared_[this->nextChunk_].reset();
+            this->nextChunk_++;
+        }
+
+        if (this->nextChunk_ == this->prepared_.size())
+        {
+            this->finish();
+        }
+    }
+
+    void finish()
+    {
+        auto messages = std::move(this->sink_).takeMessages();
+
+        // Notify user about a possible gap in logs if it returned some messages
+        // but isn't currently joined to a channel
+        const auto errorCode = this->root_.value("error_code").toString();
+        if (!errorCode.isEmpty())
+        {
+            qCDebug(LOG) << QString("Got error from API: error_code=%1, "
+                                    "channel=%2")
+                                .arg(errorCode, this->channel_->getName());
+            if (errorCode == "channel_not_joined" && !messages.empty())
+            {
+                this->channel_->addSystemMessage(
+                    "Message history service recovering, there may "
+                    "be gaps in the message history.");
+            }
+        }
+
+        this->onLoaded_(messages);
+    }
+
+    std::shared_ptr<TwitchChannel> channel_;
+    QJsonObject root_;
+    ResultCallback onLoaded_;
+
+    std::vector<std::optional<PreparedRecentMessages>> prepared_;
+    /// The first chunk that wasn't finished yet
+    size_t nextChunk_ = 0;
+    VectorMessageSink sink_{{}, MessageFlag::RecentMessage};
+};
+
 }  // namespace
 
 namespace chatterino::recentmessages {
 
-using namespace recentmessages::detail;
-
 void load(
     const QString &channelName, std::weak_ptr<Channel> channelPtr,
     ResultCallback onLoaded, ErrorCallback onError, const int limit,
@@ -44,37 +161,18 @@ void load(
                 qCDebug(LOG) << "Successfully loaded recent messages for"
                              << shared->getName();
 
-                auto root = result.parseJson();
-                auto parsedMessages = parseRecentMessages(root);
-
-                // build the Communi messages into chatterino messages
-                auto builtMessages =
-                    buildRecentMessages(parsedMessages, shared.get());
-
-                postToThread([shared = std::move(shared),
-                              root = std::move(root),
-                              messages = std::move(builtMessages),
-                              onLoaded]() mutable {
-                    // Notify user about a possible gap in logs if it returned some messages
-                    // but isn't currently joined to a channel
-                    const auto errorCode = root.value("error_code").toString();
-                    if (!errorCode.isEmpty())
-                    {
-                        qCDebug(LOG)
-                            << QString("Got error from API: error_code=%1, "
-                                       "channel=%2")
-                                   .arg(errorCode, shared->getName());
-                        if (errorCode == "channel_not_joined" &&
-                            !messages.empty())
-                        {
-                            shared->addSystemMessage(
-                                "Message history service recovering, there may "
-                                "be gaps in the message history.");
-                        }
-                    }
-
-                    onLoaded(messages);
-                });
+                auto twitchChannel =
+                    std::dynamic_pointer_cast<TwitchChannel>(shared);
+                if (!twitchChannel)
+                {
+                    // only Twitch channels have recent messages
+                    onLoaded({});
+                    return;
+                }
+
+                std::make_shared<Backfill>(std::move(twitchChannel),
+                                           result.parseJson(), onLoaded)
+                    ->start();
             })
             .onError([channelPtr, onError](const NetworkResult &result) {
                 auto shared = channelPtr.lock();
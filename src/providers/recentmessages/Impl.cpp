@@ -4,12 +4,39 @@
 #include "messages/MessageBuilder.hpp"
 #include "providers/twitch/IrcMessageHandler.hpp"
 #include "providers/twitch/TwitchChannel.hpp"
+#include "providers/twitch/TwitchIrcLine.hpp"
 #include "util/Helpers.hpp"
 #include "util/VectorMessageSink.hpp"
 
 #include <QJsonArray>
 #include <QUrlQuery>
 
+namespace {
+
+using namespace chatterino;
+
+QDate receivedDate(const Communi::IrcMessage &message)
+{
+    return QDateTime::fromMSecsSinceEpoch(
+               message.tags().value("rm-received-ts").toLongLong())
+        .date();
+}
+
+/// Adds a message stating that a new day began if `date` isn't the date of
+/// the previous message in `channel`
+void addDateChange(const QDate &date, MessageSink &sink, Channel *channel)
+{
+    if (date != channel->lastDate_)
+    {
+        channel->lastDate_ = date;
+        auto msg = makeSystemMessage(
+            QLocale().toString(date, QLocale::LongFormat), QTime(0, 0));
+        sink.addMessage(msg, MessageContext::Original);
+    }
+}
+
+}  // namespace
+
 namespace chatterino::recentmessages::detail {
 
 // Parse the IRC messages returned in JSON form into Communi messages
@@ -54,20 +81,7 @@ std::vector<MessagePtr> buildRecentMessages(
     {
         if (message->tags().contains("rm-received-ts"))
         {
-            const auto msgDate =
-                QDateTime::fromMSecsSinceEpoch(
-                    message->tags().value("rm-received-ts").toLongLong())
-                    .date();
-
-            // Check if we need to insert a message stating that a new day began
-            if (msgDate != channel->lastDate_)
-            {
-                channel->lastDate_ = msgDate;
-                auto msg = makeSystemMessage(
-                    QLocale().toString(msgDate, QLocale::LongFormat),
-                    QTime(0, 0));
-                sink.addMessage(msg, MessageContext::Original);
-            }
+            addDateChange(receivedDate(*message), sink, channel);
         }
 
         IrcMessageHandler::parseMessageInto(message, sink, twitchChannel);
@@ -78,6 +92,90 @@ std::vector<MessagePtr> buildRecentMessages(
     return std::move(sink).takeMessages();
 }
 
+std::vector<std::vector<QByteArray>> splitRecentMessages(
+    const QJsonObject &jsonRoot, size_t chunkSize)
+{
+    const auto jsonMessages = jsonRoot.value("messages").toArray();
+    std::vector<std::vector<QByteArray>> chunks;
+    chunks.reserve((jsonMessages.size() + chunkSize - 1) / chunkSize);
+
+    for (const auto &jsonMessage : jsonMessages)
+    {
+        if (chunks.empty() || chunks.back().size() >= chunkSize)
+        {
+            chunks.emplace_back().reserve(chunkSize);
+        }
+        chunks.back().push_back(
+            unescapeZeroWidthJoiner(jsonMessage.toString()).toUtf8());
+    }
+
+    return chunks;
+}
+
+PreparedRecentMessages prepareRecentMessages(
+    const std::vector<QByteArray> &lines, TwitchChannel *channel, bool build)
+{
+    PreparedRecentMessages prepared;
+    prepared.reserve(lines.size());
+
+    for (const auto &line : lines)
+    {
+        auto &entry = prepared.emplace_back();
+        // the data of `line` is shared, so the parsed line stays valid
+        entry.line = line;
+        entry.parsed = TwitchIrcLine::parse(entry.line);
+        const auto &parsed = entry.parsed;
+
+        if (parsed && parsed->hasTag(TwitchTag::RmReceivedTs))
+        {
+            entry.date = QDateTime::fromMSecsSinceEpoch(
+                             parsed->tag(TwitchTag::RmReceivedTs).toLongLong())
+                             .date();
+        }
+
+        // Only PRIVMSGs are built here, so other lines don't need to be
+        // parsed by Communi twice
+        if (build && parsed && parsed->command() == "PRIVMSG")
+        {
+            std::unique_ptr<Communi::IrcMessage> message(
+                Communi::IrcMessage::fromData(line, nullptr));
+            auto *privMessage =
+                dynamic_cast<Communi::IrcPrivateMessage *>(message.get());
+            if (privMessage)
+            {
+                entry.add = IrcMessageHandler::buildPrivMessageInto(
+                    privMessage, *parsed, channel);
+            }
+        }
+    }
+
+    return prepared;
+}
+
+void finishRecentMessages(PreparedRecentMessages &prepared, MessageSink &sink,
+                          TwitchChannel *channel)
+{
+    for (auto &entry : prepared)
+    {
+        if (entry.date.isValid())
+        {
+            addDateChange(entry.date, sink, channel);
+        }
+
+        if (entry.add)
+        {
+            // parseMessageInto does this for the other messages
+            IrcMessageHandler::updateSelfBadges(*entry.parsed, *channel);
+            entry.add(sink);
+            continue;
+        }
+
+        std::unique_ptr<Communi::IrcMessage> message(
+            Communi::IrcMessage::fromData(entry.line, nullptr));
+        IrcMessageHandler::parseMessageInto(message.get(), sink, channel);
+    }
+}
+
 // Returns the URL to be used for querying the Recent Messages API for the
 // given channel.
 QUrl constructRecentMessagesUrl(
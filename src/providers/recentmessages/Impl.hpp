@@ -2,19 +2,48 @@
 
 #include "common/Channel.hpp"
 #include "messages/Message.hpp"
+#include "providers/twitch/TwitchIrcLine.hpp"
 
 #include <IrcMessage>
+#include <QByteArray>
+#include <QDate>
 #include <QJsonObject>
 #include <QString>
 #include <QUrl>
 
 #include <chrono>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <vector>
 
+namespace chatterino {
+
+class MessageSink;
+class TwitchChannel;
+
+}  // namespace chatterino
+
 namespace chatterino::recentmessages::detail {
 
+/// Number of recent messages that are parsed and built by one task
+inline constexpr size_t CHUNK_SIZE = 100;
+
+/// A recent message that was parsed (and built if possible) in any thread
+struct PreparedRecentMessage {
+    /// The day the message was received on, if the API included it
+    QDate date;
+    /// The IRC message
+    QByteArray line;
+    /// The parsed `line`, which refers to its data
+    std::optional<TwitchIrcLine> parsed;
+    /// Adds the built messages to a sink, empty if the message couldn't be
+    /// built in advance (e.g. a reply)
+    std::function<void(MessageSink &)> add;
+};
+
+using PreparedRecentMessages = std::vector<PreparedRecentMessage>;
+
 // Parse the IRC messages returned in JSON form into Communi messages
 std::vector<Communi::IrcMessage *> parseRecentMessages(
     const QJsonObject &jsonRoot);
@@ -24,6 +53,24 @@ std::vector<Communi::IrcMessage *> parseRecentMessages(
 std::vector<MessagePtr> buildRecentMessages(
     std::vector<Communi::IrcMessage *> &messages, Channel *channel);
 
+/// Splits the IRC messages returned in JSON form into chunks of at most
+/// `chunkSize` messages, which can be prepared independently
+std::vector<std::vector<QByteArray>> splitRecentMessages(
+    const QJsonObject &jsonRoot, size_t chunkSize = CHUNK_SIZE);
+
+/// Parses the IRC messages of one chunk. If `build` is set, the ones that
+/// don't depend on the previous messages are built as well. Can be called
+/// from any thread.
+PreparedRecentMessages prepareRecentMessages(
+    const std::vector<QByteArray> &lines, TwitchChannel *channel,
+    bool build = true);
+
+/// Adds the prepared messages of a chunk to `sink` in order, together with a
+/// message whenever a new day begins. Chunks have to be finished in order in
+/// the GUI thread.
+void finishRecentMessages(PreparedRecentMessages &prepared, MessageSink &sink,
+                          TwitchChannel *channel);
+
 // Returns the URL to be used for querying the Recent Messages API for the
 // given channel.
 QUrl constructRecentMessagesUrl(
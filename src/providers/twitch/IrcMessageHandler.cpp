@@ -18,6 +18,7 @@
 #include "providers/twitch/TwitchAccountManager.hpp"
 #include "providers/twitch/TwitchChannel.hpp"
 #include "providers/twitch/TwitchHelpers.hpp"
+#include "providers/twitch/TwitchIrcLine.hpp"
 #include "providers/twitch/TwitchIrcServer.hpp"
 #include "singletons/Settings.hpp"
 #include "singletons/StreamerMode.hpp"
@@ -25,6 +26,8 @@
 #include "util/FormatTime.hpp"
 #include "util/Helpers.hpp"
 #include "util/IrcHelpers.hpp"
+#include "util/KeyedThreadPool.hpp"
+#include "util/PostToThread.hpp"
 
 #include <IrcMessage>
 #include <QLocale>
@@ -84,7 +87,9 @@ MessagePtr generateBannedMessage(bool confirmedBan)
     return builder.release();
 }
 
-int stripLeadingReplyMention(const QVariantMap &tags, QString &content)
+/// Strips the mention of `displayName` (the reply-parent-display-name tag, a
+/// null string if the message isn't a reply) from `content`
+int stripLeadingReplyMention(const QString &displayName, QString &content)
 {
     if (!getSettings()->stripReplyMention)
     {
@@ -96,11 +101,8 @@ int stripLeadingReplyMention(const QVariantMap &tags, QString &content)
         return 0;
     }
 
-    if (const auto it = tags.find("reply-parent-display-name");
-        it != tags.end())
+    if (!displayName.isNull())
     {
-        auto displayName = it.value().toString();
-
         if (content.length() <= 1 + displayName.length())
         {
             // The reply contains no content
@@ -184,6 +186,89 @@ struct ReplyContext {
     MessagePtr parent;
 };
 
+QString channelPointRewardId(const QVariantMap &tags)
+{
+    if (const auto it = tags.find("custom-reward-id"); it != tags.end())
+    {
+        return it.value().toString();
+    }
+
+    if (const auto typeIt = tags.find("msg-id"); typeIt != tags.end())
+    {
+        // slight hack to treat bits power-ups as channel point redemptions
+        const auto msgId = typeIt.value().toString();
+        if (msgId == "animated-message" || msgId == "gigantified-emote-message")
+        {
+            return msgId;
+        }
+    }
+
+    return {};
+}
+
+/// Replies and redemptions (see channelPointRewardId) depend on the previous
+/// messages and the rewards of the channel, so they can only be built in the
+/// GUI thread
+bool dependsOnChannelState(const TwitchIrcLine &line)
+{
+    if (line.hasTag(TwitchTag::ReplyThreadParentMsgId))
+    {
+        return true;
+    }
+    if (line.hasTag(TwitchTag::CustomRewardId))
+    {
+        return !line.rawTag(TwitchTag::CustomRewardId).empty();
+    }
+
+    auto msgId = line.rawTag(TwitchTag::MsgId);
+    return msgId == "animated-message" || msgId == "gigantified-emote-message";
+}
+
+/// Adds a built message to `sink` (and the mentions), this depends on the
+/// previous messages and has to run in the GUI thread
+void addBuiltMessage(const MessagePtrMut &msg, const HighlightAlert &alert,
+                     MessageSink &sink, TwitchChannel *chan,
+                     ITwitchIrcServer &twitch)
+{
+    sink.applySimilarityFilters(msg);
+
+    if (!msg->flags.has(MessageFlag::Similar) ||
+        (!getSettings()->hideSimilar &&
+         getSettings()->shownSimilarTriggerHighlights))
+    {
+        MessageBuilder::triggerHighlights(chan, alert);
+    }
+
+    const auto highlighted = msg->flags.has(MessageFlag::Highlighted);
+    const auto showInMentions = msg->flags.has(MessageFlag::ShowInMentions);
+
+    if (highlighted && showInMentions &&
+        sink.sinkTraits().has(MessageSinkTrait::AddMentionsToGlobalChannel))
+    {
+        twitch.getMentionsChannel()->addMessage(msg, MessageContext::Original);
+    }
+
+    sink.addMessage(msg, MessageContext::Original);
+    chan->addRecentChatter(msg->displayName);
+}
+
+void addPrivMessage(Communi::IrcPrivateMessage *message, MessageSink &sink,
+                    TwitchChannel *channel)
+{
+    IrcMessageHandler::addMessage(
+        message, sink, channel, unescapeZeroWidthJoiner(message->content()),
+        *getApp()->getTwitch(), false, message->isAction());
+
+    if (message->tags().contains(u"pinned-chat-paid-amount"_s))
+    {
+        auto ptr = MessageBuilder::buildHypeChatMessage(message);
+        if (ptr)
+        {
+            sink.addMessage(ptr, MessageContext::Original);
+        }
+    }
+}
+
 std::optional<ClearChatMessage> parseClearChatMessage(
     Communi::IrcMessage *message)
 {
@@ -349,37 +434,155 @@ void IrcMessageHandler::handlePrivMessage(Communi::IrcPrivateMessage *message,
     parsePrivMessageInto(message, *twitchChannel, twitchChannel);
 }
 
-void IrcMessageHandler::parsePrivMessageInto(
-    Communi::IrcPrivateMessage *message, MessageSink &sink,
-    TwitchChannel *channel)
+void IrcMessageHandler::handlePrivMessage(Communi::IrcPrivateMessage *message,
+                                          ITwitchIrcServer &twitchServer,
+                                          KeyedThreadPool &pool)
 {
-    auto currentUser = getApp()->getAccounts()->twitch.getCurrent();
-    if (message->tag("user-id") == currentUser->getUserId())
+    auto chan = channelOrEmptyByTarget(message->target(), twitchServer);
+    if (chan->isEmpty())
     {
-        auto badgesTag = message->tag("badges");
-        if (badgesTag.isValid())
+        return;
+    }
+
+    auto twitchChannel = std::dynamic_pointer_cast<TwitchChannel>(chan);
+    if (!twitchChannel)
+    {
+        return;
+    }
+
+    // The tags are read from the line, so the GUI thread doesn't build the
+    // tag map of the message
+    auto data = message->toData();
+    auto line = TwitchIrcLine::parse(data).value_or(TwitchIrcLine{});
+
+    updateSelfBadges(line, *twitchChannel);
+    // Setting the room ID reloads the channel, so it can't happen while
+    // building the message
+    if (twitchChannel->roomId().isEmpty())
+    {
+        auto roomID = line.tag(TwitchTag::RoomId);
+        if (!roomID.isEmpty())
         {
-            auto parsedBadges = parseBadges(badgesTag.toString());
-            channel->setMod(parsedBadges.contains("moderator"));
-            channel->setVIP(parsedBadges.contains("vip"));
-            channel->setStaff(parsedBadges.contains("staff"));
+            twitchChannel->setRoomId(roomID);
         }
     }
 
-    IrcMessageHandler::addMessage(
-        message, sink, channel, unescapeZeroWidthJoiner(message->content()),
-        *getApp()->getTwitch(), false, message->isAction());
+    // Replies and redemptions are parsed in the GUI thread, but still go
+    // through the pool to stay in order with the other messages of the
+    // channel.
+    bool dependsOnChannel = dependsOnChannelState(line);
 
-    if (message->tags().contains(u"pinned-chat-paid-amount"_s))
+    auto *key = twitchChannel.get();
+    pool.submit(key, [data = std::move(data), chan = std::move(twitchChannel),
+                      dependsOnChannel]() mutable {
+        if (dependsOnChannel)
+        {
+            postToThread([data, chan = std::move(chan)] {
+                std::unique_ptr<Communi::IrcMessage> ircMessage(
+                    Communi::IrcMessage::fromData(data, nullptr));
+                auto *message = dynamic_cast<Communi::IrcPrivateMessage *>(
+                    ircMessage.get());
+                if (message)
+                {
+                    addPrivMessage(message, *chan, chan.get());
+                }
+            });
+            return;
+        }
+
+        // The channel is only released in the GUI thread
+        postToThread(
+            IrcMessageHandler::buildPrivMessage(data, std::move(chan)));
+    });
+}
+
+std::function<void()> IrcMessageHandler::buildPrivMessage(
+    const QByteArray &data, std::shared_ptr<TwitchChannel> channel)
+{
+    std::unique_ptr<Communi::IrcMessage> ircMessage(
+        Communi::IrcMessage::fromData(data, nullptr));
+    auto *message =
+        dynamic_cast<Communi::IrcPrivateMessage *>(ircMessage.get());
+    auto line = TwitchIrcLine::parse(data);
+    if (!message || !line)
     {
-        auto ptr = MessageBuilder::buildHypeChatMessage(message);
-        if (ptr)
+        return [channel = std::move(channel)] {};
+    }
+
+    auto add = buildPrivMessageInto(message, *line, channel.get());
+    return [channel = std::move(channel), add = std::move(add)] {
+        if (add)
         {
-            sink.addMessage(ptr, MessageContext::Original);
+            add(*channel);
+        }
+    };
+}
+
+std::function<void(MessageSink &)> IrcMessageHandler::buildPrivMessageInto(
+    Communi::IrcPrivateMessage *message, const TwitchIrcLine &line,
+    TwitchChannel *channel)
+{
+    if (dependsOnChannelState(line))
+    {
+        return {};
+    }
+
+    MessageParseArgs args;
+    args.isStaffOrBroadcaster = channel->isBroadcaster();
+    args.isAction = message->isAction();
+    args.allowIgnore = true;
+
+    QString content = unescapeZeroWidthJoiner(message->content());
+    int messageOffset = stripLeadingReplyMention(
+        line.tag("reply-parent-display-name"), content);
+
+    auto built = MessageBuilder::makeIrcMessage(
+        channel, line, args, content, messageOffset, nullptr, nullptr);
+
+    MessagePtr hypeChat;
+    if (line.hasTag(TwitchTag::PinnedChatPaidAmount))
+    {
+        hypeChat = MessageBuilder::buildHypeChatMessage(message);
+    }
+
+    return [channel, built = std::move(built),
+            hypeChat = std::move(hypeChat)](MessageSink &sink) {
+        if (built.first)
+        {
+            addBuiltMessage(built.first, built.second, sink, channel,
+                            *getApp()->getTwitch());
+        }
+        if (hypeChat)
+        {
+            sink.addMessage(hypeChat, MessageContext::Original);
         }
+    };
+}
+
+void IrcMessageHandler::updateSelfBadges(const TwitchIrcLine &line,
+                                         TwitchChannel &channel)
+{
+    auto currentUser = getApp()->getAccounts()->twitch.getCurrent();
+    if (line.hasTag(TwitchTag::Badges) &&
+        line.tag(TwitchTag::UserId) == currentUser->getUserId())
+    {
+        auto parsedBadges = parseBadges(line.tag(TwitchTag::Badges));
+        channel.setMod(parsedBadges.contains("moderator"));
+        channel.setVIP(parsedBadges.contains("vip"));
+        channel.setStaff(parsedBadges.contains("staff"));
     }
 }
 
+void IrcMessageHandler::parsePrivMessageInto(
+    Communi::IrcPrivateMessage *message, MessageSink &sink,
+    TwitchChannel *channel)
+{
+    auto data = message->toData();
+    updateSelfBadges(TwitchIrcLine::parse(data).value_or(TwitchIrcLine{}),
+                     *channel);
+    addPrivMessage(message, sink, channel);
+}
+
 void IrcMessageHandler::handleRoomStateMessage(Communi::IrcMessage *message)
 {
     const auto &tags = message->tags();
@@ -580,9 +783,10 @@ void IrcMessageHandler::handleWhisperMessage(Communi::IrcMessage *ircMessage)
 
     auto *c = getApp()->getTwitch()->getWhispersChannel().get();
 
+    auto data = ircMessage->toData();
+    auto line = TwitchIrcLine::parse(data).value_or(TwitchIrcLine{});
     auto [message, alert] = MessageBuilder::makeIrcMessage(
-        c, ircMessage, args, unescapeZeroWidthJoiner(ircMessage->parameter(1)),
-        0);
+        c, line, args, unescapeZeroWidthJoiner(ircMessage->parameter(1)), 0);
     if (!message)
     {
         return;
@@ -986,20 +1190,7 @@ void IrcMessageHandler::addMessage(Communi::IrcMessage *message,
     args.isAction = isAction;
 
     const auto &tags = message->tags();
-    QString rewardId;
-    if (const auto it = tags.find("custom-reward-id"); it != tags.end())
-    {
-        rewardId = it.value().toString();
-    }
-    else if (const auto typeIt = tags.find("msg-id"); typeIt != tags.end())
-    {
-        // slight hack to treat bits power-ups as channel point redemptions
-        const auto msgId = typeIt.value().toString();
-        if (msgId == "animated-message" || msgId == "gigantified-emote-message")
-        {
-            rewardId = msgId;
-        }
-    }
+    QString rewardId = channelPointRewardId(tags);
     if (!rewardId.isEmpty() &&
         sink.sinkTraits().has(
             MessageSinkTrait::RequiresKnownChannelPointReward) &&
@@ -1013,8 +1204,12 @@ void IrcMessageHandler::addMessage(Communi::IrcMessage *message,
     }
     args.channelPointRewardId = rewardId;
 
+    auto data = message->toData();
+    auto line = TwitchIrcLine::parse(data).value_or(TwitchIrcLine{});
+
     QString content = originalContent;
-    int messageOffset = stripLeadingReplyMention(tags, content);
+    int messageOffset = stripLeadingReplyMention(
+        line.tag("reply-parent-display-name"), content);
 
     ReplyContext replyCtx;
 
@@ -1085,7 +1280,7 @@ void IrcMessageHandler::addMessage(Communi::IrcMessage *message,
 
     args.allowIgnore = !isSub;
     auto [msg, alert] = MessageBuilder::makeIrcMessage(
-        chan, message, args, content, messageOffset, replyCtx.thread,
+        chan, line, args, content, messageOffset, replyCtx.thread,
         replyCtx.parent);
 
     if (msg)
@@ -1102,27 +1297,7 @@ void IrcMessageHandler::addMessage(Communi::IrcMessage *message,
             }
         }
 
-        sink.applySimilarityFilters(msg);
-
-        if (!msg->flags.has(MessageFlag::Similar) ||
-            (!getSettings()->hideSimilar &&
-             getSettings()->shownSimilarTriggerHighlights))
-        {
-            MessageBuilder::triggerHighlights(chan, alert);
-        }
-
-        const auto highlighted = msg->flags.has(MessageFlag::Highlighted);
-        const auto showInMentions = msg->flags.has(MessageFlag::ShowInMentions);
-
-        if (highlighted && showInMentions &&
-            sink.sinkTraits().has(MessageSinkTrait::AddMentionsToGlobalChannel))
-        {
-            twitch.getMentionsChannel()->addMessage(msg,
-                                                    MessageContext::Original);
-        }
-
-        sink.addMessage(msg, MessageContext::Original);
-        chan->addRecentChatter(msg->displayName);
+        addBuiltMessage(msg, alert, sink, chan, twitch);
     }
 }
 
@@ -4,6 +4,8 @@
 
 #include <IrcMessage>
 
+#include <functional>
+#include <memory>
 #include <optional>
 #include <vector>
 
@@ -17,6 +19,8 @@ using MessagePtr = std::shared_ptr<const Message>;
 class TwitchChannel;
 class TwitchMessageBuilder;
 class MessageSink;
+class KeyedThreadPool;
+class TwitchIrcLine;
 
 struct ClearChatMessage {
     MessagePtr message;
@@ -39,8 +43,33 @@ public:
 
     void handlePrivMessage(Communi::IrcPrivateMessage *message,
                            ITwitchIrcServer &twitchServer);
+    /// Like handlePrivMessage, but builds the message in `pool`.
+    /// Messages of a channel are added in the order they were received.
+    void handlePrivMessage(Communi::IrcPrivateMessage *message,
+                           ITwitchIrcServer &twitchServer,
+                           KeyedThreadPool &pool);
+    /// Builds the PRIVMSG in `data` for `channel` in the calling thread. It
+    /// must not be a reply or a redemption, as these depend on the state of
+    /// the channel.
+    ///
+    /// Returns a function that adds the built messages to `channel`, which has
+    /// to be called in the GUI thread.
+    static std::function<void()> buildPrivMessage(
+        const QByteArray &data, std::shared_ptr<TwitchChannel> channel);
+    /// Like buildPrivMessage, but the returned function adds the built
+    /// messages to a sink. `line` is the parsed data of `message`. Returns an
+    /// empty function for replies and redemptions, which have to be parsed
+    /// with parseMessageInto.
+    static std::function<void(MessageSink &)> buildPrivMessageInto(
+        Communi::IrcPrivateMessage *message, const TwitchIrcLine &line,
+        TwitchChannel *channel);
     static void parsePrivMessageInto(Communi::IrcPrivateMessage *message,
                                      MessageSink &sink, TwitchChannel *channel);
+    /// Updates the mod/VIP/staff state of `channel` if `line` is a message of
+    /// the current user. Messages built with buildPrivMessageInto don't do
+    /// this, it has to be called in the GUI thread.
+    static void updateSelfBadges(const TwitchIrcLine &line,
+                                 TwitchChannel &channel);
 
     void handleRoomStateMessage(Communi::IrcMessage *message);
     void handleClearChatMessage(Communi::IrcMessage *message);
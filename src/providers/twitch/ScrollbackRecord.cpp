@@ -0,0 +1,276 @@
+#include "providers/twitch/ScrollbackRecord.hpp"
+
+#include "common/Literals.hpp"
+#include "messages/Emote.hpp"
+#include "messages/Message.hpp"
+#include "messages/MessageBuilder.hpp"
+#include "messages/MessageElement.hpp"
+#include "providers/twitch/IrcMessageHandler.hpp"
+#include "providers/twitch/TwitchBadge.hpp"
+#include "providers/twitch/TwitchChannel.hpp"
+#include "providers/twitch/TwitchIrcLine.hpp"
+#include "util/VectorMessageSink.hpp"
+
+#include <IrcMessage>
+#include <QDataStream>
+#include <QStringList>
+
+#include <map>
+
+namespace {
+
+using namespace chatterino;
+using namespace literals;
+
+constexpr quint8 VERSION = 1;
+
+enum class RecordKind : quint8 {
+    Privmsg = 0,
+    Text = 1,
+};
+
+/// Escapes `value` for an IRCv3 tag
+QString escapeTagValue(const QString &value)
+{
+    QString escaped;
+    escaped.reserve(value.size());
+    for (auto c : value)
+    {
+        switch (c.unicode())
+        {
+            case u';':
+                escaped += u"\\:";
+                break;
+            case u' ':
+                escaped += u"\\s";
+                break;
+            case u'\\':
+                escaped += u"\\\\";
+                break;
+            case u'\r':
+                escaped += u"\\r";
+                break;
+            case u'\n':
+                escaped += u"\\n";
+                break;
+            default:
+                escaped += c;
+        }
+    }
+    return escaped;
+}
+
+/// Builds the "emotes" tag for the Twitch emotes of `message`. The positions
+/// are code point indices of the words in the message text.
+QString twitchEmotesTag(const Message &message)
+{
+    std::map<QString, QString> idsByName;
+    for (const auto &element : message.elements)
+    {
+        const auto *emote = dynamic_cast<const EmoteElement *>(element.get());
+        if (emote != nullptr &&
+            emote->getFlags().has(MessageElementFlag::TwitchEmote))
+        {
+            idsByName.emplace(emote->getEmote()->name.string,
+                              emote->getEmote()->id.string);
+        }
+    }
+    if (idsByName.empty())
+    {
+        return {};
+    }
+
+    std::map<QString, QStringList> positionsById;
+    qsizetype position = 0;
+    for (auto word : QStringView(message.messageText).split(u' '))
+    {
+        auto length = static_cast<qsizetype>(word.toUcs4().size());
+        auto it = idsByName.find(word.toString());
+        if (it != idsByName.end() && length > 0)
+        {
+            positionsById[it->second].append(QString::number(position) + u'-' +
+                                             QString::number(position +
+                                                             length - 1));
+        }
+        position += length + 1;
+    }
+
+    QStringList emotes;
+    for (const auto &[id, positions] : positionsById)
+    {
+        emotes.append(id + u':' + positions.join(u','));
+    }
+    return emotes.join(u'/');
+}
+
+QByteArray makePrivmsg(const Message &message)
+{
+    QStringList badges;
+    for (const auto &badge : message.badges)
+    {
+        badges.append(badge.key_ + u'/' + badge.value_);
+    }
+    QStringList badgeInfos;
+    for (const auto &[key, value] : message.badgeInfos)
+    {
+        badgeInfos.append(key + u'/' + value);
+    }
+
+    QStringList tags{
+        u"badge-info="_s + escapeTagValue(badgeInfos.join(u',')),
+        u"badges="_s + escapeTagValue(badges.join(u',')),
+        u"color="_s + (message.usernameColor.isValid()
+                         ? message.usernameColor.name()
+                         : QString()),
+        u"display-name="_s + escapeTagValue(message.displayName),
+        u"emotes="_s + twitchEmotesTag(message),
+        u"id="_s + escapeTagValue(message.id),
+        u"tmi-sent-ts="_s +
+            QString::number(message.serverReceivedTime.toMSecsSinceEpoch()),
+        u"user-id="_s + escapeTagValue(message.userID),
+    };
+
+    auto text = message.messageText;
+    if (message.flags.has(MessageFlag::Action))
+    {
+        text = u"\x01ACTION "_s + text + u'\x01';
+    }
+
+    const auto &login = message.loginName;
+    return (u'@' + tags.join(u';') + u" :"_s + login + u'!' + login + u'@' +
+            login + u".tmi.twitch.tv PRIVMSG #"_s + message.channelName +
+            u" :"_s + text)
+        .toUtf8();
+}
+
+}  // namespace
+
+namespace chatterino {
+
+QByteArray makeScrollbackRecord(const Message &message)
+{
+    QByteArray record;
+    QDataStream stream(&record, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    // chat messages are the only ones with a sender that aren't system
+    // messages (subs, timeouts, etc.)
+    bool isPrivmsg =
+        !message.loginName.isEmpty() && !message.channelName.isEmpty() &&
+        !message.flags.hasAny(MessageFlag::System, MessageFlag::Subscription,
+                              MessageFlag::Timeout, MessageFlag::Whisper,
+                              MessageFlag::ModerationAction);
+
+    stream << VERSION;
+    if (isPrivmsg)
+    {
+        stream << RecordKind::Privmsg
+               << message.flags.has(MessageFlag::Disabled)
+               << makePrivmsg(message);
+    }
+    else
+    {
+        stream << RecordKind::Text
+               << static_cast<qint64>(message.flags.value())
+               << message.serverReceivedTime
+               << (message.messageText.isEmpty() ? message.searchText
+                                                 : message.messageText);
+    }
+    return record;
+}
+
+std::function<std::vector<MessagePtr>()> prepareScrollbackRecord(
+    const QByteArray &record, TwitchChannel *channel, bool build)
+{
+    QDataStream stream(record);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint8 version = 0;
+    RecordKind kind{};
+    stream >> version >> kind;
+    if (stream.status() != QDataStream::Ok || version != VERSION)
+    {
+        return [] {
+            return std::vector<MessagePtr>{};
+        };
+    }
+
+    if (kind == RecordKind::Text)
+    {
+        qint64 flags = 0;
+        QDateTime time;
+        QString text;
+        stream >> flags >> time >> text;
+        if (stream.status() != QDataStream::Ok)
+        {
+            return [] {
+                return std::vector<MessagePtr>{};
+            };
+        }
+
+        return [flags, time = std::move(time), text = std::move(text)] {
+            auto message = makeSystemMessage(text, time.toLocalTime().time());
+            message->flags = MessageFlags(static_cast<MessageFlag>(flags));
+            return std::vector<MessagePtr>{message};
+        };
+    }
+
+    bool disabled = false;
+    QByteArray line;
+    stream >> disabled >> line;
+    if (stream.status() != QDataStream::Ok || kind != RecordKind::Privmsg)
+    {
+        return [] {
+            return std::vector<MessagePtr>{};
+        };
+    }
+
+    std::function<void(MessageSink &)> add;
+    if (build)
+    {
+        std::unique_ptr<Communi::IrcMessage> ircMessage(
+            Communi::IrcMessage::fromData(line, nullptr));
+        auto *privMessage =
+            dynamic_cast<Communi::IrcPrivateMessage *>(ircMessage.get());
+        auto parsed = TwitchIrcLine::parse(line);
+        if (privMessage && parsed)
+        {
+            add = IrcMessageHandler::buildPrivMessageInto(privMessage, *parsed,
+                                                          channel);
+        }
+    }
+
+    return [line = std::move(line), add = std::move(add), channel, disabled] {
+        VectorMessageSink sink;
+        if (add)
+        {
+            add(sink);
+        }
+        else
+        {
+            // replies and redemptions depend on the state of the channel
+            std::unique_ptr<Communi::IrcMessage> ircMessage(
+                Communi::IrcMessage::fromData(line, nullptr));
+            IrcMessageHandler::parseMessageInto(ircMessage.get(), sink,
+                                                channel);
+        }
+
+        auto messages = std::move(sink).takeMessages();
+        if (disabled)
+        {
+            for (const auto &message : messages)
+            {
+                message->flags.set(MessageFlag::Disabled);
+            }
+        }
+        return messages;
+    };
+}
+
+std::vector<MessagePtr> parseScrollbackRecord(const QByteArray &record,
+                                              TwitchChannel *channel)
+{
+    return prepareScrollbackRecord(record, channel, false)();
+}
+
+}  // namespace chatterino
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QByteArray>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace chatterino {
+
+struct Message;
+using MessagePtr = std::shared_ptr<const Message>;
+class TwitchChannel;
+
+/// Serializes `message` for the scrollback archive of a Twitch channel.
+///
+/// Chat messages are stored as the PRIVMSG they were built from (including
+/// their badges, color and Twitch emotes), so they can be built again with
+/// third party emotes, links and highlights. All other messages are stored as
+/// their text.
+QByteArray makeScrollbackRecord(const Message &message);
+
+/// Builds the messages stored in `record` (see makeScrollbackRecord) in
+/// `channel`. Returns nothing if the record is broken or the message is
+/// ignored.
+std::vector<MessagePtr> parseScrollbackRecord(const QByteArray &record,
+                                              TwitchChannel *channel);
+
+/// Like parseScrollbackRecord, but split in two steps: the record is decoded
+/// in the calling thread, which can be any thread. If `build` is set, chat
+/// messages that don't depend on the state of `channel` are built there as
+/// well (see IrcMessageHandler::buildPrivMessageInto).
+///
+/// Returns a function that builds the rest and returns the messages, which
+/// has to be called in the GUI thread.
+std::function<std::vector<MessagePtr>()> prepareScrollbackRecord(
+    const QByteArray &record, TwitchChannel *channel, bool build);
+
+}  // namespace chatterino
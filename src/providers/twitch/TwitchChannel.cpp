@@ -8,6 +8,7 @@
 #include "common/network/NetworkResult.hpp"
 #include "common/QLogging.hpp"
 #include "controllers/accounts/AccountController.hpp"
+#include "controllers/completion/sources/EmoteCompletionIndex.hpp"
 #include "controllers/notifications/NotificationController.hpp"
 #include "controllers/twitch/LiveController.hpp"
 #include "messages/Emote.hpp"
@@ -17,6 +18,7 @@
 #include "messages/MessageBuilder.hpp"
 #include "messages/MessageElement.hpp"
 #include "messages/MessageThread.hpp"
+#include "messages/ScrollbackArchive.hpp"
 #include "providers/bttv/BttvEmotes.hpp"
 #include "providers/bttv/BttvLiveUpdates.hpp"
 #include "providers/bttv/liveupdates/BttvLiveUpdateMessages.hpp"
@@ -32,15 +34,18 @@
 #include "providers/twitch/eventsub/Controller.hpp"
 #include "providers/twitch/IrcMessageHandler.hpp"
 #include "providers/twitch/PubSubManager.hpp"
+#include "providers/twitch/ScrollbackRecord.hpp"
 #include "providers/twitch/TwitchAccount.hpp"
 #include "providers/twitch/TwitchCommon.hpp"
 #include "providers/twitch/TwitchIrcServer.hpp"
 #include "providers/twitch/TwitchUsers.hpp"
 #include "singletons/Emotes.hpp"
+#include "singletons/Paths.hpp"
 #include "singletons/Settings.hpp"
 #include "singletons/StreamerMode.hpp"
 #include "singletons/Toasts.hpp"
 #include "singletons/WindowManager.hpp"
+#include "util/CombinePath.hpp"
 #include "util/Helpers.hpp"
 #include "util/PostToThread.hpp"
 #include "util/QStringHash.hpp"
@@ -53,6 +58,7 @@
 #include <QJsonObject>
 #include <QJsonValue>
 #include <QStringBuilder>
+#include <QtConcurrent>
 #include <QThread>
 #include <QTimer>
 #include <rapidjson/document.h>
@@ -105,6 +111,8 @@ TwitchChannel::TwitchChannel(const QString &name)
     , bttvEmotes_(std::make_shared<EmoteMap>())
     , ffzEmotes_(std::make_shared<EmoteMap>())
     , seventvEmotes_(std::make_shared<EmoteMap>())
+    , completionEmotes_(
+          std::make_unique<completion::EmoteCompletionIndexCache>())
 {
     qCDebug(chatterinoTwitch) << "[TwitchChannel" << name << "] Opened";
 
@@ -1006,6 +1014,36 @@ std::shared_ptr<const EmoteMap> TwitchChannel::seventvEmotes() const
     return this->seventvEmotes_.get();
 }
 
+std::shared_ptr<const MergedEmoteMap> TwitchChannel::mergedEmotes() const
+{
+    using ZeroWidth = MergedEmoteMap::ZeroWidth;
+
+    // Emote order:
+    //  - FrankerFaceZ Channel
+    //  - BetterTTV Channel
+    //  - 7TV Channel
+    //  - FrankerFaceZ Global
+    //  - BetterTTV Global
+    //  - 7TV Global
+    auto *app = getApp();
+    return this->mergedEmotes_.get({
+        {this->ffzEmotes_.get(), MessageElementFlag::FfzEmote},
+        {this->bttvEmotes_.get(), MessageElementFlag::BttvEmote},
+        {this->seventvEmotes_.get(), MessageElementFlag::SevenTVEmote,
+         ZeroWidth::FromEmote},
+        {app->getFfzEmotes()->emotes(), MessageElementFlag::FfzEmote},
+        {app->getBttvEmotes()->emotes(), MessageElementFlag::BttvEmote,
+         ZeroWidth::BttvGlobal},
+        {app->getSeventvEmotes()->globalEmotes(),
+         MessageElementFlag::SevenTVEmote, ZeroWidth::FromEmote},
+    });
+}
+
+completion::EmoteCompletionIndexCache &TwitchChannel::completionEmotes() const
+{
+    return *this->completionEmotes_;
+}
+
 const QString &TwitchChannel::seventvUserID() const
 {
     return this->seventvUserID_;
@@ -1281,6 +1319,75 @@ void TwitchChannel::messageRemovedFromStart(const MessagePtr &msg)
             this->threads_.erase(msg->replyThread->rootId());
         }
     }
+
+    auto limit = getSettings()->scrollbackArchiveLimit.getValue();
+    if (limit <= 0)
+    {
+        return;
+    }
+    if (!this->scrollbackArchive_)
+    {
+        this->scrollbackArchive_ = std::make_unique<ScrollbackArchive>(
+            combinePath(getApp()->getPaths().cacheDirectory(), "Scrollback"),
+            this->getName(), static_cast<size_t>(limit));
+    }
+    this->scrollbackArchive_->append(makeScrollbackRecord(*msg));
+}
+
+const ScrollbackArchive *TwitchChannel::scrollbackArchive() const
+{
+    return this->scrollbackArchive_.get();
+}
+
+void TwitchChannel::loadArchivedMessages(
+    size_t begin, size_t end,
+    std::function<void(std::vector<std::pair<size_t, MessagePtr>>)> onLoaded)
+{
+    if (!this->scrollbackArchive_)
+    {
+        onLoaded({});
+        return;
+    }
+
+    // Building messages outside of the GUI thread is experimental, so the
+    // records are only decoded there unless message builder threads are used
+    bool build = getSettings()->messageBuilderThreads.getValue() > 0;
+    std::ignore = QtConcurrent::run(
+        [self = std::dynamic_pointer_cast<TwitchChannel>(
+             this->shared_from_this()),
+         archive = this->scrollbackArchive_.get(), begin, end, build,
+         onLoaded = std::move(onLoaded)]() mutable {
+            // read() clamps the range, so the first record might be after
+            // `begin`
+            auto records = archive->read(begin, end);
+            auto index = std::min(end, archive->endIndex()) - records.size();
+
+            std::vector<
+                std::pair<size_t, std::function<std::vector<MessagePtr>()>>>
+                prepared;
+            prepared.reserve(records.size());
+            for (const auto &record : records)
+            {
+                prepared.emplace_back(index++, prepareScrollbackRecord(
+                                                   record, self.get(), build));
+            }
+
+            // The channel is only released in the GUI thread
+            postToThread([self = std::move(self),
+                          prepared = std::move(prepared),
+                          onLoaded = std::move(onLoaded)] {
+                std::vector<std::pair<size_t, MessagePtr>> messages;
+                messages.reserve(prepared.size());
+                for (const auto &[index, finish] : prepared)
+                {
+                    for (auto &message : finish())
+                    {
+                        messages.emplace_back(index, std::move(message));
+                    }
+                }
+                onLoaded(std::move(messages));
+            });
+        });
 }
 
 const QString &TwitchChannel::subscriptionUrl()
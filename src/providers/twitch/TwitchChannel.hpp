@@ -6,6 +6,7 @@
 #include "common/ChannelChatters.hpp"
 #include "common/Common.hpp"
 #include "common/UniqueAccess.hpp"
+#include "messages/MergedEmoteMap.hpp"
 #include "providers/ffz/FfzBadges.hpp"
 #include "providers/ffz/FfzEmotes.hpp"
 #include "providers/twitch/eventsub/SubscriptionHandle.hpp"
@@ -22,6 +23,7 @@
 #include <QRegularExpression>
 
 #include <atomic>
+#include <functional>
 #include <mutex>
 #include <optional>
 #include <unordered_map>
@@ -61,6 +63,11 @@ using HelixChannelBadges = HelixGlobalBadges;
 
 class TwitchIrcServer;
 class TwitchAccount;
+class ScrollbackArchive;
+
+namespace completion {
+    class EmoteCompletionIndexCache;
+}  // namespace completion
 
 const int MAX_QUEUED_REDEMPTIONS = 16;
 
@@ -204,6 +211,32 @@ public:
     std::shared_ptr<const EmoteMap> ffzEmotes() const;
     std::shared_ptr<const EmoteMap> seventvEmotes() const;
 
+    /**
+     * Returns the FFZ, BTTV and 7TV emotes of this channel followed by the
+     * global ones in one map. The map is merged again if any of them changed.
+     */
+    std::shared_ptr<const MergedEmoteMap> mergedEmotes() const;
+
+    /// Returns the cache of the emotes that can be completed in this channel
+    completion::EmoteCompletionIndexCache &completionEmotes() const;
+
+    /**
+     * Returns the archive of messages that were removed from the start of
+     * this channel, or nullptr if nothing was archived (yet).
+     */
+    const ScrollbackArchive *scrollbackArchive() const;
+
+    /**
+     * Builds the archived messages from `begin` up to (excluding) `end`
+     * again and calls `onLoaded` in the GUI thread with each message and the
+     * archive index it was stored at. Records are read and decoded outside
+     * of the GUI thread. Messages that are ignored now are skipped.
+     */
+    void loadArchivedMessages(
+        size_t begin, size_t end,
+        std::function<void(std::vector<std::pair<size_t, MessagePtr>>)>
+            onLoaded);
+
     void refreshTwitchChannelEmotes(bool manualRefresh);
     void refreshBTTVChannelEmotes(bool manualRefresh);
     void refreshFFZChannelEmotes(bool manualRefresh);
@@ -445,6 +478,9 @@ protected:
     Atomic<std::shared_ptr<const EmoteMap>> bttvEmotes_;
     Atomic<std::shared_ptr<const EmoteMap>> ffzEmotes_;
     Atomic<std::shared_ptr<const EmoteMap>> seventvEmotes_;
+    mutable MergedEmoteMapCache mergedEmotes_;
+    const std::unique_ptr<completion::EmoteCompletionIndexCache>
+        completionEmotes_;
     Atomic<std::optional<EmotePtr>> ffzCustomModBadge_;
     Atomic<std::optional<EmotePtr>> ffzCustomVipBadge_;
 
@@ -505,6 +541,9 @@ private:
     /** A list of the emotes listed in the lat live emote update message. */
     std::vector<QString> lastLiveUpdateEmoteNames_;
 
+    /** Created when the first message is archived. */
+    std::unique_ptr<ScrollbackArchive> scrollbackArchive_;
+
     pajlada::Signals::SignalHolder signalHolder_;
     std::vector<boost::signals2::scoped_connection> bSignals_;
 
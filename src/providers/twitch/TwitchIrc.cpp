@@ -3,6 +3,7 @@
 #include "Application.hpp"
 #include "common/Aliases.hpp"
 #include "common/QLogging.hpp"
+#include "providers/twitch/TwitchIrcLine.hpp"
 #include "singletons/Emotes.hpp"
 #include "util/IrcHelpers.hpp"
 
@@ -81,21 +82,11 @@ void appendTwitchEmoteOccurrences(const QString &emote,
     }
 }
 
-}  // namespace
-
-namespace chatterino {
-
-std::unordered_map<QString, QString> parseBadgeInfoTag(const QVariantMap &tags)
+std::unordered_map<QString, QString> parseBadgeInfoValue(const QString &value)
 {
     std::unordered_map<QString, QString> infoMap;
 
-    auto infoIt = tags.constFind("badge-info");
-    if (infoIt == tags.end())
-    {
-        return infoMap;
-    }
-
-    auto info = infoIt.value().toString().split(',', Qt::SkipEmptyParts);
+    auto info = value.split(',', Qt::SkipEmptyParts);
 
     for (const QString &badge : info)
     {
@@ -105,17 +96,11 @@ std::unordered_map<QString, QString> parseBadgeInfoTag(const QVariantMap &tags)
     return infoMap;
 }
 
-std::vector<Badge> parseBadgeTag(const QVariantMap &tags)
+std::vector<Badge> parseBadgeValue(const QString &value)
 {
     std::vector<Badge> b;
 
-    auto badgesIt = tags.constFind("badges");
-    if (badgesIt == tags.end())
-    {
-        return b;
-    }
-
-    auto badges = badgesIt.value().toString().split(',', Qt::SkipEmptyParts);
+    auto badges = value.split(',', Qt::SkipEmptyParts);
 
     for (const QString &badge : badges)
     {
@@ -131,21 +116,14 @@ std::vector<Badge> parseBadgeTag(const QVariantMap &tags)
     return b;
 }
 
-std::vector<TwitchEmoteOccurrence> parseTwitchEmotes(const QVariantMap &tags,
-                                                     const QString &content,
-                                                     int messageOffset)
+std::vector<TwitchEmoteOccurrence> parseEmotesValue(const QString &value,
+                                                    const QString &content,
+                                                    int messageOffset)
 {
     // Twitch emotes
     std::vector<TwitchEmoteOccurrence> twitchEmotes;
 
-    auto emotesTag = tags.find("emotes");
-
-    if (emotesTag == tags.end())
-    {
-        return twitchEmotes;
-    }
-
-    QStringList emoteString = emotesTag.value().toString().split('/');
+    QStringList emoteString = value.split('/');
     std::vector<int> correctPositions;
     for (int i = 0; i < content.size(); ++i)
     {
@@ -163,4 +141,64 @@ std::vector<TwitchEmoteOccurrence> parseTwitchEmotes(const QVariantMap &tags,
     return twitchEmotes;
 }
 
+}  // namespace
+
+namespace chatterino {
+
+std::unordered_map<QString, QString> parseBadgeInfoTag(const QVariantMap &tags)
+{
+    auto infoIt = tags.constFind("badge-info");
+    if (infoIt == tags.end())
+    {
+        return {};
+    }
+    return parseBadgeInfoValue(infoIt.value().toString());
+}
+
+std::unordered_map<QString, QString> parseBadgeInfoTag(
+    const TwitchIrcLine &line)
+{
+    return parseBadgeInfoValue(line.tag(TwitchTag::BadgeInfo));
+}
+
+std::vector<Badge> parseBadgeTag(const QVariantMap &tags)
+{
+    auto badgesIt = tags.constFind("badges");
+    if (badgesIt == tags.end())
+    {
+        return {};
+    }
+    return parseBadgeValue(badgesIt.value().toString());
+}
+
+std::vector<Badge> parseBadgeTag(const TwitchIrcLine &line)
+{
+    return parseBadgeValue(line.tag(TwitchTag::Badges));
+}
+
+std::vector<TwitchEmoteOccurrence> parseTwitchEmotes(const QVariantMap &tags,
+                                                     const QString &content,
+                                                     int messageOffset)
+{
+    auto emotesTag = tags.find("emotes");
+    if (emotesTag == tags.end())
+    {
+        return {};
+    }
+    return parseEmotesValue(emotesTag.value().toString(), content,
+                            messageOffset);
+}
+
+std::vector<TwitchEmoteOccurrence> parseTwitchEmotes(const TwitchIrcLine &line,
+                                                     const QString &content,
+                                                     int messageOffset)
+{
+    if (!line.hasTag(TwitchTag::Emotes))
+    {
+        return {};
+    }
+    return parseEmotesValue(line.tag(TwitchTag::Emotes), content,
+                            messageOffset);
+}
+
 }  // namespace chatterino
@@ -10,6 +10,8 @@
 
 namespace chatterino {
 
+class TwitchIrcLine;
+
 struct TwitchEmoteOccurrence {
     int start;
     int end;
@@ -34,6 +36,8 @@ struct TwitchEmoteOccurrence {
 /// @param tags The tags of the IRC message
 /// @returns A map of badge-names to their values
 std::unordered_map<QString, QString> parseBadgeInfoTag(const QVariantMap &tags);
+std::unordered_map<QString, QString> parseBadgeInfoTag(
+    const TwitchIrcLine &line);
 
 /// @brief Parses the `badges` tag of an IRC message
 ///
@@ -47,6 +51,7 @@ std::unordered_map<QString, QString> parseBadgeInfoTag(const QVariantMap &tags);
 /// @param tags The tags of the IRC message
 /// @returns A list of badges (name and version)
 std::vector<Badge> parseBadgeTag(const QVariantMap &tags);
+std::vector<Badge> parseBadgeTag(const TwitchIrcLine &line);
 
 /// @brief Parses Twitch emotes in an IRC message
 ///
@@ -63,5 +68,8 @@ std::vector<Badge> parseBadgeTag(const QVariantMap &tags);
 std::vector<TwitchEmoteOccurrence> parseTwitchEmotes(const QVariantMap &tags,
                                                      const QString &content,
                                                      int messageOffset);
+std::vector<TwitchEmoteOccurrence> parseTwitchEmotes(const TwitchIrcLine &line,
+                                                     const QString &content,
+                                                     int messageOffset);
 
 }  // namespace chatterino
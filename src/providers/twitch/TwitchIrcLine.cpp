@@ -0,0 +1,286 @@
+#include "providers/twitch/TwitchIrcLine.hpp"
+
+#include <algorithm>
+
+namespace {
+
+using namespace chatterino;
+
+/// The keys of the TwitchTags, in the order of the enum (which is sorted)
+constexpr std::array<std::string_view, TWITCH_TAG_COUNT> TAG_KEYS{
+    "badge-info",
+    "badges",
+    "bits",
+    "color",
+    "custom-reward-id",
+    "display-name",
+    "emotes",
+    "first-msg",
+    "historical",
+    "id",
+    "login",
+    "msg-id",
+    "pinned-chat-paid-amount",
+    "reply-parent-msg-id",
+    "reply-thread-parent-msg-id",
+    "rm-deleted",
+    "rm-received-ts",
+    "room-id",
+    "source-room-id",
+    "tmi-sent-ts",
+    "user-id",
+    "user-type",
+};
+
+static_assert(std::ranges::is_sorted(TAG_KEYS));
+
+/// Splits the first word (up to a space) off `rest`
+std::string_view takeWord(std::string_view &rest)
+{
+    auto end = std::min(rest.find(' '), rest.size());
+    auto word = rest.substr(0, end);
+    rest.remove_prefix(end);
+    return word;
+}
+
+void skipSpaces(std::string_view &rest)
+{
+    auto start = std::min(rest.find_first_not_of(' '), rest.size());
+    rest.remove_prefix(start);
+}
+
+}  // namespace
+
+namespace chatterino {
+
+std::optional<TwitchTag> twitchTagFromKey(std::string_view key)
+{
+    auto it = std::ranges::lower_bound(TAG_KEYS, key);
+    if (it == TAG_KEYS.end() || *it != key)
+    {
+        return std::nullopt;
+    }
+    return static_cast<TwitchTag>(it - TAG_KEYS.begin());
+}
+
+QString unescapeTagValue(std::string_view value)
+{
+    if (value.find('\\') == std::string_view::npos)
+    {
+        return QString::fromUtf8(value.data(),
+                                 static_cast<qsizetype>(value.size()));
+    }
+
+    QByteArray unescaped;
+    unescaped.reserve(static_cast<qsizetype>(value.size()));
+    for (size_t i = 0; i < value.size(); i++)
+    {
+        if (value[i] != '\\')
+        {
+            unescaped.append(value[i]);
+            continue;
+        }
+
+        i++;
+        if (i >= value.size())
+        {
+            // a trailing backslash is dropped
+            break;
+        }
+        switch (value[i])
+        {
+            case ':':
+                unescaped.append(';');
+                break;
+            case 's':
+                unescaped.append(' ');
+                break;
+            case 'r':
+                unescaped.append('\r');
+                break;
+            case 'n':
+                unescaped.append('\n');
+                break;
+            default:
+                // this includes "\\"
+                unescaped.append(value[i]);
+        }
+    }
+    return QString::fromUtf8(unescaped);
+}
+
+std::optional<TwitchIrcLine> TwitchIrcLine::parse(std::string_view line)
+{
+    TwitchIrcLine parsed;
+    auto rest = line;
+
+    if (rest.starts_with('@'))
+    {
+        rest.remove_prefix(1);
+        parsed.parseTags(takeWord(rest));
+        skipSpaces(rest);
+    }
+
+    if (rest.starts_with(':'))
+    {
+        rest.remove_prefix(1);
+        parsed.prefix_ = takeWord(rest);
+        skipSpaces(rest);
+    }
+
+    parsed.command_ = takeWord(rest);
+    if (parsed.command_.empty())
+    {
+        return std::nullopt;
+    }
+
+    while (true)
+    {
+        skipSpaces(rest);
+        if (rest.empty())
+        {
+            break;
+        }
+
+        if (rest.starts_with(':') || parsed.paramCount_ == MAX_PARAMS - 1)
+        {
+            if (rest.starts_with(':'))
+            {
+                rest.remove_prefix(1);
+            }
+            parsed.params_[parsed.paramCount_++] = rest;
+            break;
+        }
+
+        parsed.params_[parsed.paramCount_++] = takeWord(rest);
+    }
+
+    return parsed;
+}
+
+std::optional<TwitchIrcLine> TwitchIrcLine::parse(const QByteArray &line)
+{
+    auto view = std::string_view(line.data(), static_cast<size_t>(line.size()));
+    // Communi keeps the line break in the data of a message
+    while (view.ends_with('\n') || view.ends_with('\r'))
+    {
+        view.remove_suffix(1);
+    }
+    return TwitchIrcLine::parse(view);
+}
+
+bool TwitchIrcLine::hasTag(TwitchTag tag) const
+{
+    return this->knownTags_[static_cast<size_t>(tag)].data() != nullptr;
+}
+
+std::string_view TwitchIrcLine::rawTag(TwitchTag tag) const
+{
+    return this->knownTags_[static_cast<size_t>(tag)];
+}
+
+QString TwitchIrcLine::tag(TwitchTag tag) const
+{
+    if (!this->hasTag(tag))
+    {
+        return {};
+    }
+    return unescapeTagValue(this->rawTag(tag));
+}
+
+std::optional<std::string_view> TwitchIrcLine::rawTag(
+    std::string_view key) const
+{
+    if (auto tag = twitchTagFromKey(key))
+    {
+        if (!this->hasTag(*tag))
+        {
+            return std::nullopt;
+        }
+        return this->rawTag(*tag);
+    }
+
+    auto rest = this->tags_;
+    while (!rest.empty())
+    {
+        auto end = std::min(rest.find(';'), rest.size());
+        auto tag = rest.substr(0, end);
+        rest.remove_prefix(std::min(end + 1, rest.size()));
+
+        auto separator = tag.find('=');
+        if (tag.substr(0, separator) == key)
+        {
+            if (separator == std::string_view::npos)
+            {
+                // tags without a value are set but empty
+                return tag.substr(tag.size());
+            }
+            return tag.substr(separator + 1);
+        }
+    }
+    return std::nullopt;
+}
+
+QString TwitchIrcLine::tag(std::string_view key) const
+{
+    auto raw = this->rawTag(key);
+    if (!raw)
+    {
+        return {};
+    }
+    return unescapeTagValue(*raw);
+}
+
+std::string_view TwitchIrcLine::prefix() const
+{
+    return this->prefix_;
+}
+
+std::string_view TwitchIrcLine::nick() const
+{
+    return this->prefix_.substr(
+        0, std::min(this->prefix_.find_first_of("!@"), this->prefix_.size()));
+}
+
+std::string_view TwitchIrcLine::command() const
+{
+    return this->command_;
+}
+
+size_t TwitchIrcLine::paramCount() const
+{
+    return this->paramCount_;
+}
+
+std::string_view TwitchIrcLine::param(size_t index) const
+{
+    if (index >= this->paramCount_)
+    {
+        return {};
+    }
+    return this->params_[index];
+}
+
+void TwitchIrcLine::parseTags(std::string_view tags)
+{
+    this->tags_ = tags;
+
+    while (!tags.empty())
+    {
+        auto end = std::min(tags.find(';'), tags.size());
+        auto tag = tags.substr(0, end);
+        tags.remove_prefix(std::min(end + 1, tags.size()));
+
+        auto separator = std::min(tag.find('='), tag.size());
+        auto known = twitchTagFromKey(tag.substr(0, separator));
+        if (known)
+        {
+            // a tag without a value points to the end of the tag, so it's
+            // set but empty
+            this->knownTags_[static_cast<size_t>(*known)] =
+                tag.substr(std::min(separator + 1, tag.size()));
+        }
+    }
+}
+
+}  // namespace chatterino
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace chatterino {
+
+/// Tags of Twitch IRC messages that can be looked up without searching
+enum class TwitchTag : uint8_t {
+    BadgeInfo,
+    Badges,
+    Bits,
+    Color,
+    CustomRewardId,
+    DisplayName,
+    Emotes,
+    FirstMsg,
+    Historical,
+    Id,
+    Login,
+    MsgId,
+    PinnedChatPaidAmount,
+    ReplyParentMsgId,
+    ReplyThreadParentMsgId,
+    RmDeleted,
+    RmReceivedTs,
+    RoomId,
+    SourceRoomId,
+    TmiSentTs,
+    UserId,
+    UserType,
+};
+
+inline constexpr size_t TWITCH_TAG_COUNT =
+    static_cast<size_t>(TwitchTag::UserType) + 1;
+
+/// Returns the tag with the IRC key `key` (e.g. "user-id"), or nothing if
+/// it's not one of the TwitchTags
+std::optional<TwitchTag> twitchTagFromKey(std::string_view key);
+
+/// Unescapes the value of an IRCv3 tag (e.g. "a\sb" to "a b")
+QString unescapeTagValue(std::string_view value);
+
+/// A parsed IRC line as sent by Twitch.
+///
+/// Parsing doesn't copy or allocate: all parts are views into the parsed
+/// line, which has to outlive this object. Tags are kept escaped and only
+/// unescaped when they're converted to a QString. The TwitchTags are found
+/// in a table, all other tags are found by searching the tags of the line.
+class TwitchIrcLine
+{
+public:
+    /// Parses `line` (without the trailing line break). Returns nothing if
+    /// it doesn't have a command.
+    static std::optional<TwitchIrcLine> parse(std::string_view line);
+    static std::optional<TwitchIrcLine> parse(const QByteArray &line);
+
+    bool hasTag(TwitchTag tag) const;
+    /// The escaped value of `tag`, empty if the tag isn't set
+    std::string_view rawTag(TwitchTag tag) const;
+    /// The unescaped value of `tag`, a null string if the tag isn't set
+    QString tag(TwitchTag tag) const;
+
+    /// The escaped value of the tag `key`, or nothing if it isn't set.
+    /// Prefer the TwitchTag overloads for tags that are looked up often.
+    std::optional<std::string_view> rawTag(std::string_view key) const;
+    /// The unescaped value of the tag `key`, a null string if it isn't set
+    QString tag(std::string_view key) const;
+
+    /// The whole prefix (e.g. "nick!user@host")
+    std::string_view prefix() const;
+    /// The nick of the prefix (or the prefix if it's a server name)
+    std::string_view nick() const;
+    std::string_view command() const;
+
+    size_t paramCount() const;
+    /// The parameter at `index`, empty if there's no such parameter
+    std::string_view param(size_t index) const;
+
+    /// Parameters after this are part of the last one
+    static constexpr size_t MAX_PARAMS = 15;
+
+private:
+    void parseTags(std::string_view tags);
+
+    /// All tags of the line, without the leading '@'
+    std::string_view tags_;
+    /// Values of the TwitchTags, tags that aren't set have no data
+    std::array<std::string_view, TWITCH_TAG_COUNT> knownTags_{};
+
+    std::string_view prefix_;
+    std::string_view command_;
+    std::array<std::string_view, MAX_PARAMS> params_{};
+    size_t paramCount_ = 0;
+};
+
+}  // namespace chatterino
@@ -234,6 +234,13 @@ TwitchIrcServer::TwitchIrcServer()
 
 void TwitchIrcServer::initialize()
 {
+    auto builderThreads = getSettings()->messageBuilderThreads.getValue();
+    if (builderThreads > 0)
+    {
+        this->messageBuildPool_ = std::make_unique<KeyedThreadPool>(
+            static_cast<size_t>(builderThreads), "MessageBuilder");
+    }
+
     getApp()->getAccounts()->twitch.currentUserChanged.connect([this]() {
         postToThread([this] {
             this->connect();
@@ -860,6 +867,13 @@ std::shared_ptr<Channel> TwitchIrcServer::createChannel(
 void TwitchIrcServer::privateMessageReceived(
     Communi::IrcPrivateMessage *message)
 {
+    if (this->messageBuildPool_)
+    {
+        IrcMessageHandler::instance().handlePrivMessage(
+            message, *this, *this->messageBuildPool_);
+        return;
+    }
+
     IrcMessageHandler::instance().handlePrivMessage(message, *this);
 }
 
@@ -872,6 +886,33 @@ void TwitchIrcServer::readConnectionMessageReceived(
         return;
     }
 
+    if (this->messageBuildPool_ && message->parameter(0).startsWith(u'#'))
+    {
+        // PRIVMSGs of the channel might still be built in the pool. Other
+        // messages of the channel (e.g. a CLEARMSG) must not overtake them,
+        // so they go through the pool as well and are handled in the GUI
+        // thread once the earlier messages were added.
+        auto chan = this->getChannelOrEmpty(message->parameter(0).mid(1));
+        if (!chan->isEmpty())
+        {
+            auto *key = chan.get();
+            auto data = message->toData();
+            this->messageBuildPool_->submit(key, [this, data] {
+                postToThread([this, data] {
+                    std::unique_ptr<Communi::IrcMessage> copy(
+                        Communi::IrcMessage::fromData(data, nullptr));
+                    this->handleReadConnectionMessage(copy.get());
+                });
+            });
+            return;
+        }
+    }
+
+    this->handleReadConnectionMessage(message);
+}
+
+void TwitchIrcServer::handleReadConnectionMessage(Communi::IrcMessage *message)
+{
     const QString &command = message->command();
 
     auto &handler = IrcMessageHandler::instance();
@@ -4,6 +4,7 @@
 #include "common/Channel.hpp"
 #include "common/Common.hpp"
 #include "providers/irc/IrcConnection2.hpp"
+#include "util/KeyedThreadPool.hpp"
 #include "util/RatelimitBucket.hpp"
 
 #include <IrcMessage>
@@ -178,6 +179,9 @@ private:
 
     bool prepareToSend(const std::shared_ptr<TwitchChannel> &channel);
 
+    /// Handles a message of the read connection that isn't a PRIVMSG
+    void handleReadConnectionMessage(Communi::IrcMessage *message);
+
     QMap<QString, std::weak_ptr<Channel>> channels;
     std::mutex channelMutex;
 
@@ -198,6 +202,11 @@ private:
     std::mutex lastMessageMutex_;
     std::queue<std::chrono::steady_clock::time_point> lastMessagePleb_;
     std::queue<std::chrono::steady_clock::time_point> lastMessageMod_;
+
+    /// Builds PRIVMSGs outside of the GUI thread if enabled with the
+    /// messageBuilderThreads setting, messages are keyed by their channel.
+    /// The other messages of a channel go through it to keep their order.
+    std::unique_ptr<KeyedThreadPool> messageBuildPool_;
     std::chrono::steady_clock::time_point lastErrorTimeSpeed_;
     std::chrono::steady_clock::time_point lastErrorTimeAmount_;
 };
@@ -6,13 +6,18 @@
 #include "common/network/NetworkRequest.hpp"
 #include "common/network/NetworkResult.hpp"
 #include "common/QLogging.hpp"
+#include "providers/twitch/api/HelixScheduler.hpp"
 #include "util/CancellationToken.hpp"
+#include "util/PostToThread.hpp"
 #include "util/QMagicEnum.hpp"
+#include "util/Twitch.hpp"
 
 #include <magic_enum/magic_enum.hpp>
 #include <QJsonDocument>
 #include <QStringBuilder>
 
+#include <algorithm>
+
 namespace {
 
 using namespace chatterino;
@@ -21,6 +26,21 @@ constexpr auto NUM_MODERATORS_TO_FETCH_PER_REQUEST = 100;
 
 constexpr auto NUM_CHATTERS_TO_FETCH = 1000;
 
+// Twitch rejects a whole batch if one of its IDs or logins is malformed, so
+// these are checked before they're batched
+
+bool isValidUserID(const QString &id)
+{
+    return !id.isEmpty() && std::ranges::all_of(id, [](QChar c) {
+        return c >= u'0' && c <= u'9';
+    });
+}
+
+bool isValidUserLogin(const QString &login)
+{
+    return twitchUserNameRegexp().match(login).hasMatch();
+}
+
 }  // namespace
 
 namespace chatterino {
@@ -29,6 +49,16 @@ using namespace literals;
 
 static IHelix *instance = nullptr;
 
+Helix::Helix()
+    : scheduler(std::make_unique<HelixScheduler>(
+          [this](const auto &url, const auto &urlQuery, auto priority) {
+              return this->makeGet(url, urlQuery, priority);
+          }))
+{
+}
+
+Helix::~Helix() = default;
+
 HelixChatters::HelixChatters(const QJsonObject &jsonObject)
     : total(jsonObject.value("total").toInt())
     , cursor(
@@ -90,19 +120,23 @@ void Helix::getUserByName(QString userName,
                           ResultCallback<HelixUser> successCallback,
                           HelixFailureCallback failureCallback)
 {
-    QStringList userIds;
-    QStringList userLogins{std::move(userName)};
+    if (!isValidUserLogin(userName))
+    {
+        // there's no such user
+        postToThread(std::move(failureCallback));
+        return;
+    }
 
-    this->fetchUsers(
-        userIds, userLogins,
-        [successCallback,
-         failureCallback](const std::vector<HelixUser> &users) {
-            if (users.empty())
+    this->scheduler->batch(
+        {.url = u"users"_s, .parameter = u"login"_s, .field = u"login"_s},
+        userName, HelixPriority::Interactive,
+        [successCallback, failureCallback](const auto &user) {
+            if (!user)
             {
                 failureCallback();
                 return;
             }
-            successCallback(users[0]);
+            successCallback(HelixUser(*user));
         },
         failureCallback);
 }
@@ -111,18 +145,23 @@ void Helix::getUserById(QString userId,
                         ResultCallback<HelixUser> successCallback,
                         HelixFailureCallback failureCallback)
 {
-    QStringList userIds{std::move(userId)};
-    QStringList userLogins;
+    if (!isValidUserID(userId))
+    {
+        // there's no such user
+        postToThread(std::move(failureCallback));
+        return;
+    }
 
-    this->fetchUsers(
-        userIds, userLogins,
-        [successCallback, failureCallback](const auto &users) {
-            if (users.empty())
+    this->scheduler->batch(
+        {.url = u"users"_s, .parameter = u"id"_s, .field = u"id"_s}, userId,
+        HelixPriority::Interactive,
+        [successCallback, failureCallback](const auto &user) {
+            if (!user)
             {
                 failureCallback();
                 return;
             }
-            successCallback(users[0]);
+            successCallback(HelixUser(*user));
         },
         failureCallback);
 }
@@ -181,7 +220,7 @@ void Helix::fetchStreams(
     }
 
     // TODO: set on success and on error
-    this->makeGet("streams", urlQuery)
+    this->makeGet("streams", urlQuery, HelixPriority::Background)
         .onSuccess([successCallback, failureCallback](auto result) {
             auto root = result.parseJson();
             auto data = root.value("data");
@@ -214,20 +253,47 @@ void Helix::getStreamById(QString userId,
                           HelixFailureCallback failureCallback,
                           std::function<void()> finallyCallback)
 {
-    QStringList userIds{std::move(userId)};
-    QStringList userLogins;
+    if (!isValidUserID(userId))
+    {
+        // there's no such user, so it isn't live
+        postToThread([successCallback, finallyCallback] {
+            successCallback(false, HelixStream());
+            if (finallyCallback)
+            {
+                finallyCallback();
+            }
+        });
+        return;
+    }
 
-    this->fetchStreams(
-        userIds, userLogins,
-        [successCallback](const auto &streams) {
-            if (streams.empty())
+    this->scheduler->batch(
+        {
+            .url = u"streams"_s,
+            .parameter = u"user_id"_s,
+            .field = u"user_id"_s,
+        },
+        userId, HelixPriority::Interactive,
+        [successCallback, finallyCallback](const auto &stream) {
+            if (stream)
+            {
+                successCallback(true, HelixStream(*stream));
+            }
+            else
             {
                 successCallback(false, HelixStream());
-                return;
             }
-            successCallback(true, streams[0]);
+            if (finallyCallback)
+            {
+                finallyCallback();
+            }
         },
-        failureCallback, finallyCallback);
+        [failureCallback, finallyCallback] {
+            failureCallback();
+            if (finallyCallback)
+            {
+                finallyCallback();
+            }
+        });
 }
 
 void Helix::getStreamByName(QString userName,
@@ -235,20 +301,47 @@ void Helix::getStreamByName(QString userName,
                             HelixFailureCallback failureCallback,
                             std::function<void()> finallyCallback)
 {
-    QStringList userIds;
-    QStringList userLogins{std::move(userName)};
+    if (!isValidUserLogin(userName))
+    {
+        // there's no such user, so it isn't live
+        postToThread([successCallback, finallyCallback] {
+            successCallback(false, HelixStream());
+            if (finallyCallback)
+            {
+                finallyCallback();
+            }
+        });
+        return;
+    }
 
-    this->fetchStreams(
-        userIds, userLogins,
-        [successCallback, failureCallback](const auto &streams) {
-            if (streams.empty())
+    this->scheduler->batch(
+        {
+            .url = u"streams"_s,
+            .parameter = u"user_login"_s,
+            .field = u"user_login"_s,
+        },
+        userName, HelixPriority::Interactive,
+        [successCallback, finallyCallback](const auto &stream) {
+            if (stream)
+            {
+                successCallback(true, HelixStream(*stream));
+            }
+            else
             {
                 successCallback(false, HelixStream());
-                return;
             }
-            successCallback(true, streams[0]);
+            if (finallyCallback)
+            {
+                finallyCallback();
+            }
         },
-        failureCallback, finallyCallback);
+        [failureCallback, finallyCallback] {
+            failureCallback();
+            if (finallyCallback)
+            {
+                finallyCallback();
+            }
+        });
 }
 
 ///
@@ -445,7 +538,7 @@ void Helix::fetchChannels(
         urlQuery.addQueryItem("broadcaster_id", userID);
     }
 
-    this->makeGet("channels", urlQuery)
+    this->makeGet("channels", urlQuery, HelixPriority::Background)
         .onSuccess([successCallback, failureCallback](auto result) {
             auto root = result.parseJson();
             auto data = root.value("data");
@@ -806,7 +899,7 @@ void Helix::getCheermotes(
 
     urlQuery.addQueryItem("broadcaster_id", broadcasterId);
 
-    this->makeGet("bits/cheermotes", urlQuery)
+    this->makeGet("bits/cheermotes", urlQuery, HelixPriority::Background)
         .onSuccess([successCallback, failureCallback](auto result) {
             auto root = result.parseJson();
             auto data = root.value("data");
@@ -873,7 +966,7 @@ void Helix::getChannelEmotes(
     QUrlQuery urlQuery;
     urlQuery.addQueryItem("broadcaster_id", broadcasterId);
 
-    this->makeGet("chat/emotes", urlQuery)
+    this->makeGet("chat/emotes", urlQuery, HelixPriority::Background)
         .onSuccess([successCallback, failureCallback](NetworkResult result) {
             QJsonObject root = result.parseJson();
             auto data = root.value("data");
@@ -2730,7 +2823,7 @@ void Helix::getGlobalBadges(
 {
     using Error = HelixGetGlobalBadgesError;
 
-    this->makeGet("chat/badges/global", QUrlQuery())
+    this->makeGet("chat/badges/global", QUrlQuery(), HelixPriority::Background)
         .onSuccess([successCallback](auto result) {
             if (result.status() != 200)
             {
@@ -2782,7 +2875,7 @@ void Helix::getChannelBadges(
     QUrlQuery urlQuery;
     urlQuery.addQueryItem("broadcaster_id", broadcasterID);
 
-    this->makeGet("chat/badges", urlQuery)
+    this->makeGet("chat/badges", urlQuery, HelixPriority::Background)
         .onSuccess([successCallback](auto result) {
             if (result.status() != 200)
             {
@@ -3386,7 +3479,8 @@ void Helix::deleteEventSubSubscription(const QString &subscriptionID,
 }
 
 NetworkRequest Helix::makeRequest(const QString &url, const QUrlQuery &urlQuery,
-                                  NetworkRequestType type)
+                                  NetworkRequestType type,
+                                  HelixPriority priority)
 {
     assert(!url.startsWith("/"));
 
@@ -3424,6 +3518,7 @@ NetworkRequest Helix::makeRequest(const QString &url, const QUrlQuery &urlQuery,
         .header("Accept", "application/json")
         .header("Client-ID", this->clientId)
         .header("Authorization", "Bearer " + this->oauthToken)
+        .scheduler(this->scheduler->lane(priority))
 #ifndef NDEBUG
         .ignoreSslErrors(ignoreSslErrors)
 #endif
@@ -3432,27 +3527,38 @@ NetworkRequest Helix::makeRequest(const QString &url, const QUrlQuery &urlQuery,
 
 NetworkRequest Helix::makeGet(const QString &url, const QUrlQuery &urlQuery)
 {
-    return this->makeRequest(url, urlQuery, NetworkRequestType::Get);
+    return this->makeRequest(url, urlQuery, NetworkRequestType::Get,
+                             HelixPriority::Interactive);
+}
+
+NetworkRequest Helix::makeGet(const QString &url, const QUrlQuery &urlQuery,
+                              HelixPriority priority)
+{
+    return this->makeRequest(url, urlQuery, NetworkRequestType::Get, priority);
 }
 
 NetworkRequest Helix::makeDelete(const QString &url, const QUrlQuery &urlQuery)
 {
-    return this->makeRequest(url, urlQuery, NetworkRequestType::Delete);
+    return this->makeRequest(url, urlQuery, NetworkRequestType::Delete,
+                             HelixPriority::Interactive);
 }
 
 NetworkRequest Helix::makePost(const QString &url, const QUrlQuery &urlQuery)
 {
-    return this->makeRequest(url, urlQuery, NetworkRequestType::Post);
+    return this->makeRequest(url, urlQuery, NetworkRequestType::Post,
+                             HelixPriority::Interactive);
 }
 
 NetworkRequest Helix::makePut(const QString &url, const QUrlQuery &urlQuery)
 {
-    return this->makeRequest(url, urlQuery, NetworkRequestType::Put);
+    return this->makeRequest(url, urlQuery, NetworkRequestType::Put,
+                             HelixPriority::Interactive);
 }
 
 NetworkRequest Helix::makePatch(const QString &url, const QUrlQuery &urlQuery)
 {
-    return this->makeRequest(url, urlQuery, NetworkRequestType::Patch);
+    return this->makeRequest(url, urlQuery, NetworkRequestType::Patch,
+                             HelixPriority::Interactive);
 }
 
 void Helix::paginate(
@@ -16,7 +16,9 @@
 #include <QUrl>
 #include <QUrlQuery>
 
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <unordered_set>
 #include <vector>
@@ -1622,8 +1624,11 @@ protected:
 
 private:
     NetworkRequest makeRequest(const QString &url, const QUrlQuery &urlQuery,
-                               NetworkRequestType type);
+                               NetworkRequestType type,
+                               HelixPriority priority);
     NetworkRequest makeGet(const QString &url, const QUrlQuery &urlQuery);
+    NetworkRequest makeGet(const QString &url, const QUrlQuery &urlQuery,
+                           HelixPriority priority);
     NetworkRequest makeDelete(const QString &url, const QUrlQuery &urlQuery);
     NetworkRequest makePost(const QString &url, const QUrlQuery &urlQuery);
     NetworkRequest makePut(const QString &url, const QUrlQuery &urlQuery);
@@ -1640,6 +1645,9 @@ private:
 
     QString clientId;
     QString oauthToken;
+
+    /// Every request is sent through this scheduler
+    std::unique_ptr<HelixScheduler> scheduler;
 };
 
 // initializeHelix sets the helix instance to _instance
@@ -0,0 +1,410 @@
+#include "providers/twitch/api/HelixScheduler.hpp"
+
+#include "common/Literals.hpp"
+#include "common/network/NetworkRequest.hpp"
+#include "common/network/NetworkResult.hpp"
+#include "common/QLogging.hpp"
+#include "util/PostToThread.hpp"
+
+#include <QJsonArray>
+#include <QStringBuilder>
+
+#include <algorithm>
+
+namespace {
+
+using namespace chatterino;
+using namespace std::chrono_literals;
+
+/// How long to wait after a 429 without a Ratelimit-Reset header
+constexpr auto DEFAULT_RESET_DELAY = 1s;
+
+/// Requests that are sent at the same time to the same URL (with the same
+/// token) are identical if they don't send a body
+QString mergeKey(const NetworkData &data)
+{
+    if (data.requestType != NetworkRequestType::Get || !data.payload.isEmpty())
+    {
+        return {};
+    }
+    return data.request.url().toString() % u'\n' %
+           QString::fromUtf8(data.request.rawHeader("Authorization"));
+}
+
+/// Creates a new request with the properties of `data` without its callbacks
+std::shared_ptr<NetworkData> copyRequest(const NetworkData &data)
+{
+    auto copy = std::make_shared<NetworkData>();
+    copy->request = data.request;
+    copy->requestType = data.requestType;
+    copy->payload = data.payload;
+    copy->timeout = data.timeout;
+#ifndef NDEBUG
+    copy->ignoreSslErrors = data.ignoreSslErrors;
+#endif
+    return copy;
+}
+
+}  // namespace
+
+namespace chatterino {
+
+using namespace literals;
+
+HelixScheduler::Lane::Lane(HelixScheduler *owner, HelixPriority priority)
+    : owner(owner)
+    , priority(priority)
+{
+}
+
+void HelixScheduler::Lane::schedule(std::shared_ptr<NetworkData> &&data)
+{
+    runInGuiThread([owner = this->owner, priority = this->priority,
+                    data = std::move(data)]() mutable {
+        owner->enqueue(std::move(data), priority);
+    });
+}
+
+HelixScheduler::HelixScheduler(MakeGet makeGet, size_t maxInFlight,
+                               QObject *parent)
+    : QObject(parent)
+    , makeGet_(std::move(makeGet))
+    , maxInFlight_(maxInFlight)
+    , lanes_{
+          Lane(this, HelixPriority::Interactive),
+          Lane(this, HelixPriority::Background),
+      }
+{
+    this->resetTimer_.setSingleShot(true);
+    QObject::connect(&this->resetTimer_, &QTimer::timeout, this, [this] {
+        this->dispatch();
+    });
+}
+
+NetworkScheduler *HelixScheduler::lane(HelixPriority priority)
+{
+    return &this->lanes_.at(static_cast<size_t>(priority));
+}
+
+std::deque<HelixScheduler::JobPtr> &HelixScheduler::queue(
+    HelixPriority priority)
+{
+    return this->queues_.at(static_cast<size_t>(priority));
+}
+
+std::optional<int> HelixScheduler::ratelimitRemaining() const
+{
+    return this->remaining_;
+}
+
+size_t HelixScheduler::sentRequests() const
+{
+    return this->sentRequests_;
+}
+
+void HelixScheduler::enqueue(std::shared_ptr<NetworkData> &&data,
+                             HelixPriority priority)
+{
+    if (data->cache || data->multiPartPayload)
+    {
+        // these can't be copied, Helix doesn't use them anyway
+        load(std::move(data));
+        return;
+    }
+
+    auto key = mergeKey(*data);
+    if (!key.isEmpty())
+    {
+        auto it = this->mergeable_.find(key);
+        if (it != this->mergeable_.end())
+        {
+            auto job = it->second;
+            job->requests.emplace_back(std::move(data));
+
+            // an interactive request shouldn't wait behind background requests
+            if (!job->sent && priority < job->priority)
+            {
+                std::erase(this->queue(job->priority), job);
+                job->priority = priority;
+                this->queue(priority).push_back(job);
+                this->dispatch();
+            }
+            return;
+        }
+    }
+
+    auto job = std::make_shared<Job>();
+    job->requests.emplace_back(std::move(data));
+    job->key = key;
+    job->priority = priority;
+    if (!key.isEmpty())
+    {
+        this->mergeable_.emplace(key, job);
+    }
+
+    this->queue(priority).push_back(job);
+    this->dispatch();
+}
+
+void HelixScheduler::dispatch()
+{
+    if (this->remaining_ &&
+        std::chrono::system_clock::now() >= this->resetAt_)
+    {
+        // the bucket was refilled, its size is known after the next response
+        this->remaining_.reset();
+    }
+
+    for (auto priority :
+         {HelixPriority::Interactive, HelixPriority::Background})
+    {
+        auto &queue = this->queue(priority);
+        while (!queue.empty())
+        {
+            if (!this->canSend(priority))
+            {
+                if (this->inFlight_ < this->maxInFlight_ &&
+                    !this->resetTimer_.isActive())
+                {
+                    // waiting for the rate limit, not for other requests
+                    auto delay = std::chrono::ceil<std::chrono::milliseconds>(
+                        this->resetAt_ - std::chrono::system_clock::now());
+                    this->resetTimer_.start(std::max(delay, 0ms));
+                }
+                return;
+            }
+
+            auto job = queue.front();
+            queue.pop_front();
+            this->send(job);
+        }
+    }
+}
+
+bool HelixScheduler::canSend(HelixPriority priority) const
+{
+    if (this->inFlight_ >= this->maxInFlight_)
+    {
+        return false;
+    }
+    if (!this->remaining_)
+    {
+        return true;
+    }
+
+    // the points of the requests in flight aren't reflected yet
+    auto available = *this->remaining_ - static_cast<int>(this->inFlight_);
+    if (priority == HelixPriority::Background)
+    {
+        return available > BACKGROUND_RESERVE;
+    }
+    return available > 0;
+}
+
+void HelixScheduler::send(const JobPtr &job)
+{
+    job->sent = true;
+    this->inFlight_++;
+    this->sentRequests_++;
+
+    auto data = copyRequest(*job->requests.front());
+    // don't call back into a destroyed scheduler
+    data->caller = this;
+    data->hasCaller = true;
+    data->onSuccess = [this, job](const NetworkResult &result) {
+        this->finish(job, result, true);
+    };
+    data->onError = [this, job](const NetworkResult &result) {
+        this->finish(job, result, false);
+    };
+    load(std::move(data));
+}
+
+void HelixScheduler::finish(const JobPtr &job, const NetworkResult &result,
+                            bool success)
+{
+    this->inFlight_--;
+    this->updateRatelimit(result);
+
+    if (!success && result.status() == 429 && !job->retried)
+    {
+        qCDebug(chatterinoTwitch)
+            << "Helix request was rate limited, retrying after the reset"
+            << job->requests.front()->request.url().path();
+        job->retried = true;
+        job->sent = false;
+        this->queue(job->priority).push_front(job);
+        this->dispatch();
+        return;
+    }
+
+    if (!job->key.isEmpty())
+    {
+        this->mergeable_.erase(job->key);
+    }
+
+    for (const auto &request : job->requests)
+    {
+        auto copy = result;
+        if (success)
+        {
+            request->emitSuccess(std::move(copy));
+        }
+        else
+        {
+            request->emitError(std::move(copy));
+        }
+        request->emitFinally();
+    }
+
+    this->dispatch();
+}
+
+void HelixScheduler::updateRatelimit(const NetworkResult &result)
+{
+    auto now = std::chrono::system_clock::now();
+
+    bool ok = false;
+    auto remaining = result.header("Ratelimit-Remaining").toInt(&ok);
+    if (!ok)
+    {
+        if (result.status() == 429)
+        {
+            this->remaining_ = 0;
+            this->resetAt_ =
+                std::max(this->resetAt_, now + DEFAULT_RESET_DELAY);
+        }
+        return;
+    }
+
+    // the reset is sent as a unix timestamp
+    std::chrono::system_clock::time_point resetAt = now + DEFAULT_RESET_DELAY;
+    auto reset = result.header("Ratelimit-Reset").toLongLong(&ok);
+    if (ok)
+    {
+        resetAt = std::chrono::system_clock::time_point(
+            std::chrono::seconds(reset));
+    }
+
+    // responses can arrive out of order, so older buckets are ignored
+    if (!this->remaining_ || resetAt > this->resetAt_)
+    {
+        this->remaining_ = remaining;
+        this->resetAt_ = resetAt;
+    }
+    else if (resetAt == this->resetAt_)
+    {
+        this->remaining_ = std::min(*this->remaining_, remaining);
+    }
+}
+
+void HelixScheduler::batch(const BatchEndpoint &endpoint, const QString &id,
+                           HelixPriority priority, BatchCallback onItem,
+                           std::function<void()> onError)
+{
+    QString key = endpoint.url % u'?' % endpoint.parameter % u'#' %
+                  QString::number(static_cast<int>(priority));
+    auto &batch = this->batches_[key];
+    batch.endpoint = endpoint;
+    batch.priority = priority;
+    batch.waiters[id.toLower()].push_back({
+        .onItem = std::move(onItem),
+        .onError = std::move(onError),
+    });
+
+    if (!this->batchFlushQueued_)
+    {
+        this->batchFlushQueued_ = true;
+        QTimer::singleShot(0, this, [this] {
+            this->flushBatches();
+        });
+    }
+}
+
+void HelixScheduler::flushBatches()
+{
+    this->batchFlushQueued_ = false;
+    auto batches = std::exchange(this->batches_, {});
+
+    for (auto &[key, batch] : batches)
+    {
+        BatchWaiters chunk;
+        for (auto &[id, waiters] : batch.waiters)
+        {
+            chunk.emplace(id, std::move(waiters));
+            if (chunk.size() == MAX_BATCH_SIZE)
+            {
+                this->sendBatch(batch.endpoint, batch.priority,
+                                std::exchange(chunk, {}));
+            }
+        }
+        if (!chunk.empty())
+        {
+            this->sendBatch(batch.endpoint, batch.priority, std::move(chunk));
+        }
+    }
+}
+
+void HelixScheduler::sendBatch(const BatchEndpoint &endpoint,
+                               HelixPriority priority, BatchWaiters waiters)
+{
+    QUrlQuery urlQuery;
+    for (const auto &[id, _] : waiters)
+    {
+        urlQuery.addQueryItem(endpoint.parameter, id);
+    }
+
+    auto shared = std::make_shared<BatchWaiters>(std::move(waiters));
+    this->makeGet_(endpoint.url, urlQuery, priority)
+        .onSuccess([shared, field = endpoint.field](const auto &result) {
+            std::unordered_map<QString, QJsonObject> items;
+            const auto data = result.parseJson()["data"_L1].toArray();
+            for (const auto &value : data)
+            {
+                auto item = value.toObject();
+                items.emplace(item[field].toString().toLower(), item);
+            }
+
+            for (const auto &[id, waiters] : *shared)
+            {
+                std::optional<QJsonObject> item;
+                auto it = items.find(id);
+                if (it != items.end())
+                {
+                    item = it->second;
+                }
+                for (const auto &waiter : waiters)
+                {
+                    waiter.onItem(item);
+                }
+            }
+        })
+        .onError([this, shared, endpoint, priority](const auto &result) {
+            if (result.status() == 400 && shared->size() > 1)
+            {
+                // One malformed ID fails the whole batch, so the IDs are
+                // looked up one by one to only fail the malformed ones
+                qCDebug(chatterinoTwitch)
+                    << "Helix batch was rejected, retrying its"
+                    << shared->size() << "IDs individually" << endpoint.url;
+                for (auto &[id, waiters] : *shared)
+                {
+                    BatchWaiters single;
+                    single.emplace(id, std::move(waiters));
+                    this->sendBatch(endpoint, priority, std::move(single));
+                }
+                return;
+            }
+
+            for (const auto &[id, waiters] : *shared)
+            {
+                for (const auto &waiter : waiters)
+                {
+                    waiter.onError();
+                }
+            }
+        })
+        .execute();
+}
+
+}  // namespace chatterino
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "common/network/NetworkPrivate.hpp"
+
+#include <QJsonObject>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QUrlQuery>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace chatterino {
+
+class NetworkRequest;
+class NetworkResult;
+
+enum class HelixPriority : uint8_t {
+    /// Requests made because of something the user did (e.g. running a
+    /// command or opening a user card)
+    Interactive,
+    /// Requests refreshing data in the background (e.g. live statuses or
+    /// badges of newly joined channels)
+    Background,
+};
+
+/// Schedules the requests made to the Helix API.
+///
+/// - Identical GET requests that are queued or in flight are only sent once.
+/// - Interactive requests are sent before any queued background request.
+/// - The rate limit reported in the Ratelimit-* headers of the responses is
+///   shared by all requests. Requests wait for the bucket to reset instead of
+///   running into 429s, and background requests leave BACKGROUND_RESERVE
+///   points for interactive requests. A request that got a 429 anyway is
+///   retried once.
+/// - Lookups of single IDs from batch() are combined into requests of up to
+///   MAX_BATCH_SIZE IDs. If Twitch rejects a batch with a 400, its IDs are
+///   requested one by one.
+///
+/// The scheduler must be used from the GUI thread.
+class HelixScheduler : public QObject
+{
+public:
+    /// The number of requests that are in flight at the same time
+    static constexpr size_t MAX_IN_FLIGHT = 8;
+    /// The points of the rate limit only interactive requests may use
+    static constexpr int BACKGROUND_RESERVE = 80;
+    /// The maximum number of IDs Twitch accepts in one request
+    static constexpr size_t MAX_BATCH_SIZE = 100;
+
+    /// Creates the GET requests for batches, the request must use the lane
+    /// of `priority` of this scheduler
+    using MakeGet = std::function<NetworkRequest(
+        const QString &url, const QUrlQuery &urlQuery, HelixPriority priority)>;
+
+    explicit HelixScheduler(MakeGet makeGet,
+                            size_t maxInFlight = MAX_IN_FLIGHT,
+                            QObject *parent = nullptr);
+
+    /// The scheduler requests of `priority` should be passed to with
+    /// NetworkRequest::scheduler()
+    NetworkScheduler *lane(HelixPriority priority);
+
+    /// An endpoint that takes a list of IDs (e.g. `users?id=1&id=2`)
+    struct BatchEndpoint {
+        QString url;
+        /// The query parameter of the IDs (e.g. "id" or "login")
+        QString parameter;
+        /// The field of the returned items containing the ID (e.g. "id")
+        QString field;
+    };
+
+    /// Called with the returned item of the ID, or std::nullopt if Twitch
+    /// didn't return an item for it
+    using BatchCallback =
+        std::function<void(const std::optional<QJsonObject> &item)>;
+
+    /// Looks up `id` from `endpoint`. The IDs requested in the same event
+    /// loop iteration are requested together. IDs are compared
+    /// case-insensitively, so this can be used for logins too.
+    void batch(const BatchEndpoint &endpoint, const QString &id,
+               HelixPriority priority, BatchCallback onItem,
+               std::function<void()> onError);
+
+    /// The points left in the current rate limit bucket, if a response
+    /// reported them
+    std::optional<int> ratelimitRemaining() const;
+
+    /// The number of requests this scheduler sent
+    size_t sentRequests() const;
+
+private:
+    class Lane final : public NetworkScheduler
+    {
+    public:
+        Lane(HelixScheduler *owner, HelixPriority priority);
+
+        void schedule(std::shared_ptr<NetworkData> &&data) override;
+
+    private:
+        HelixScheduler *owner;
+        HelixPriority priority;
+    };
+
+    struct Job {
+        /// The requests waiting for the response. The first one is sent.
+        std::vector<std::shared_ptr<NetworkData>> requests;
+        /// The key of identical requests, empty if the request can't be
+        /// merged with others
+        QString key;
+        HelixPriority priority = HelixPriority::Interactive;
+        bool sent = false;
+        bool retried = false;
+    };
+    using JobPtr = std::shared_ptr<Job>;
+
+    struct BatchWaiter {
+        BatchCallback onItem;
+        std::function<void()> onError;
+    };
+    /// The waiters of each (lowercase) ID
+    using BatchWaiters = std::map<QString, std::vector<BatchWaiter>>;
+
+    struct Batch {
+        BatchEndpoint endpoint;
+        HelixPriority priority = HelixPriority::Interactive;
+        BatchWaiters waiters;
+    };
+
+    void enqueue(std::shared_ptr<NetworkData> &&data, HelixPriority priority);
+
+    /// Sends queued requests until the rate limit or MAX_IN_FLIGHT is hit
+    void dispatch();
+    bool canSend(HelixPriority priority) const;
+    void send(const JobPtr &job);
+    void finish(const JobPtr &job, const NetworkResult &result, bool success);
+    void updateRatelimit(const NetworkResult &result);
+
+    void flushBatches();
+    void sendBatch(const BatchEndpoint &endpoint, HelixPriority priority,
+                   BatchWaiters waiters);
+
+    std::deque<JobPtr> &queue(HelixPriority priority);
+
+    MakeGet makeGet_;
+    size_t maxInFlight_;
+    std::array<Lane, 2> lanes_;
+
+    /// The queued requests of each priority
+    std::array<std::deque<JobPtr>, 2> queues_;
+    /// Queued and in-flight jobs that can be merged by their key
+    std::unordered_map<QString, JobPtr> mergeable_;
+    size_t inFlight_ = 0;
+    size_t sentRequests_ = 0;
+
+    std::optional<int> remaining_;
+    std::chrono::system_clock::time_point resetAt_;
+    QTimer resetTimer_;
+
+    std::unordered_map<QString, Batch> batches_;
+    bool batchFlushQueued_ = false;
+};
+
+}  // namespace chatterino
@@ -178,6 +178,70 @@ QString fontFamily(FontStyle style)
 
 namespace chatterino {
 
+FontAdvanceCache::FontAdvanceCache(const QFont &font)
+    : metrics_(font)
+{
+}
+
+const QFontMetrics &FontAdvanceCache::metrics() const
+{
+    return this->metrics_;
+}
+
+int FontAdvanceCache::horizontalAdvance(const QString &text)
+{
+    {
+        std::shared_lock lock(this->mutex_);
+        auto it = this->words_.find(text);
+        if (it != this->words_.end())
+        {
+            return it->second;
+        }
+    }
+
+    // QFontMetrics isn't safe to use from multiple threads at once
+    std::unique_lock lock(this->mutex_);
+    if (this->words_.size() >= MAX_WORDS)
+    {
+        this->words_.clear();
+    }
+    auto [it, inserted] = this->words_.try_emplace(text, 0);
+    if (inserted)
+    {
+        it->second = this->metrics_.horizontalAdvance(text);
+    }
+    return it->second;
+}
+
+int FontAdvanceCache::horizontalAdvance(char32_t codePoint)
+{
+    {
+        std::shared_lock lock(this->mutex_);
+        auto it = this->codePoints_.find(codePoint);
+        if (it != this->codePoints_.end())
+        {
+            return it->second;
+        }
+    }
+
+    std::unique_lock lock(this->mutex_);
+    auto [it, inserted] = this->codePoints_.try_emplace(codePoint, 0);
+    if (inserted)
+    {
+        if (QChar::requiresSurrogates(codePoint))
+        {
+            it->second = this->metrics_.horizontalAdvance(
+                QString::fromUcs4(&codePoint, 1));
+        }
+        else
+        {
+            it->second = this->metrics_.horizontalAdvance(
+                QChar(static_cast<char16_t>(codePoint)));
+        }
+    }
+    return it->second;
+}
+
 Fonts::Fonts(Settings &settings)
 {
     this->fontsByType_.resize(size_t(FontStyle::EndType));
@@ -207,6 +271,11 @@ QFontMetrics Fonts::getFontMetrics(FontStyle type, float scale)
     return this->getOrCreateFontData(type, scale).metrics;
 }
 
+FontAdvanceCache &Fonts::getAdvanceCache(FontStyle type, float scale)
+{
+    return *this->getOrCreateFontData(type, scale).advances;
+}
+
 Fonts::FontData &Fonts::getOrCreateFontData(FontStyle type, float scale)
 {
     assertInGuiThread();
@@ -6,6 +6,8 @@
 #include <QFont>
 #include <QFontMetrics>
 
+#include <memory>
+#include <shared_mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -38,6 +40,39 @@ enum class FontStyle : uint8_t {
     ChatEnd = ChatVeryLarge,
 };
 
+/// Caches the horizontal advances of words and characters in one font.
+///
+/// Laying out messages measures the same words over and over again. All
+/// functions are thread-safe.
+class FontAdvanceCache
+{
+public:
+    explicit FontAdvanceCache(const QFont &font);
+
+    const QFontMetrics &metrics() const;
+
+    /// Returns the advance of `text`, see QFontMetrics::horizontalAdvance
+    int horizontalAdvance(const QString &text);
+
+    /// Returns the advance of a single code point
+    int horizontalAdvance(char32_t codePoint);
+
+    int horizontalAdvance(QChar c)
+    {
+        return this->horizontalAdvance(char32_t{c.unicode()});
+    }
+
+private:
+    /// The cached words are dropped once there are more than this
+    static constexpr size_t MAX_WORDS = 1 << 16;
+
+    const QFontMetrics metrics_;
+
+    std::shared_mutex mutex_;
+    std::unordered_map<QString, int> words_;
+    std::unordered_map<char32_t, int> codePoints_;
+};
+
 class Fonts final
 {
 public:
@@ -48,6 +83,10 @@ public:
     QFont getFont(FontStyle type, float scale);
     QFontMetrics getFontMetrics(FontStyle type, float scale);
 
+    /// Returns the advance cache of the font.
+    /// The reference is valid until the font changes (see fontChanged).
+    FontAdvanceCache &getAdvanceCache(FontStyle type, float scale);
+
     pajlada::Signals::NoArgSignal fontChanged;
 
 private:
@@ -55,11 +94,13 @@ private:
         FontData(const QFont &_font)
             : font(_font)
             , metrics(_font)
+            , advances(std::make_shared<FontAdvanceCache>(_font))
         {
         }
 
         const QFont font;
         const QFontMetrics metrics;
+        const std::shared_ptr<FontAdvanceCache> advances;
     };
 
     struct ChatFontData {
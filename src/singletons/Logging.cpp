@@ -2,6 +2,7 @@
 
 #include "messages/Message.hpp"
 #include "singletons/helper/LoggingChannel.hpp"
+#include "singletons/helper/LogWriter.hpp"
 #include "singletons/Settings.hpp"
 
 #include <QDir>
@@ -13,6 +14,7 @@
 namespace chatterino {
 
 Logging::Logging(Settings &settings)
+    : writer_(std::make_unique<LogWriter>())
 {
     // We can safely ignore this signal connection since settings are only-ever destroyed
     // on application exit
@@ -31,6 +33,12 @@ Logging::Logging(Settings &settings)
         });
 }
 
+Logging::~Logging()
+{
+    // Queue the closing lines of all channels before the writer drains
+    this->loggingChannels_.clear();
+}
+
 void Logging::addMessage(const QString &channelName, MessagePtr message,
                          const QString &platformName, const QString &streamID)
 {
@@ -52,7 +60,8 @@ void Logging::addMessage(const QString &channelName, MessagePtr message,
     auto platIt = this->loggingChannels_.find(platformName);
     if (platIt == this->loggingChannels_.end())
     {
-        auto *channel = new LoggingChannel(channelName, platformName);
+        auto *channel =
+            new LoggingChannel(channelName, platformName, *this->writer_);
         channel->addMessage(message, streamID);
         auto map = std::map<QString, std::unique_ptr<LoggingChannel>>();
         this->loggingChannels_[platformName] = std::move(map);
@@ -63,7 +72,8 @@ void Logging::addMessage(const QString &channelName, MessagePtr message,
     auto chanIt = platIt->second.find(channelName);
     if (chanIt == platIt->second.end())
     {
-        auto *channel = new LoggingChannel(channelName, platformName);
+        auto *channel =
+            new LoggingChannel(channelName, platformName, *this->writer_);
         channel->addMessage(message, streamID);
         platIt->second.emplace(channelName, channel);
     }
@@ -81,6 +91,8 @@ void Logging::closeChannel(const QString &channelName,
     {
         return;
     }
+    // The LoggingChannel queues its closing line, the writer closes the files
+    // once everything before it has been written.
     platIt->second.erase(channelName);
 }
 
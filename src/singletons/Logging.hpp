@@ -15,6 +15,7 @@ class Settings;
 struct Message;
 using MessagePtr = std::shared_ptr<const Message>;
 class LoggingChannel;
+class LogWriter;
 
 class ILogging
 {
@@ -33,6 +34,13 @@ class Logging : public ILogging
 {
 public:
     Logging(Settings &settings);
+    /// Closes all log files and waits until everything is written
+    ~Logging() override;
+
+    Logging(const Logging &) = delete;
+    Logging(Logging &&) = delete;
+    Logging &operator=(const Logging &) = delete;
+    Logging &operator=(Logging &&) = delete;
 
     void addMessage(const QString &channelName, MessagePtr message,
                     const QString &platformName,
@@ -42,6 +50,10 @@ public:
                       const QString &platformName) override;
 
 private:
+    // Must outlive loggingChannels_, since they queue their closing lines on
+    // destruction
+    std::unique_ptr<LogWriter> writer_;
+
     using PlatformName = QString;
     using ChannelName = QString;
     std::map<PlatformName,
@@ -642,6 +642,22 @@ public:
                                                true};
     BoolSetting lockNotebookLayout = {"/misc/lockNotebookLayout", false};
     BoolSetting showPronouns = {"/misc/showPronouns", false};
+    /// Number of threads decoding images, 0 picks one based on the number of
+    /// cores. Changes take effect after a restart.
+    IntSetting imageDecoderThreads = {"/misc/imageDecoderThreads", 0};
+    /// Decoded images (in MiB) after which the least recently used images are
+    /// unloaded, 0 to only unload images that weren't used for a while
+    IntSetting imageMemoryBudget = {"/misc/imageMemoryBudget", 1024};
+    /// Size (in MiB) of the disk cache for decoded images, 0 to disable it
+    IntSetting imageFrameCacheSize = {"/misc/imageFrameCacheSize", 512};
+    /// Size (in MiB) of the disk cache for network responses, 0 to disable it
+    IntSetting networkCacheSize = {"/misc/networkCacheSize", 512};
+    /// Number of messages per Twitch channel that are kept on disk after
+    /// they were removed from the scrollback, 0 to disable it
+    IntSetting scrollbackArchiveLimit = {"/misc/scrollbackArchiveLimit", 0};
+    /// Number of threads building chat messages, 0 to build them in the GUI
+    /// thread
+    IntSetting messageBuilderThreads = {"/misc/messageBuilderThreads", 0};
 
     /// UI
 
@@ -0,0 +1,211 @@
+#include "singletons/helper/LogWriter.hpp"
+
+#include "common/QLogging.hpp"
+#include "util/DebugCount.hpp"
+#include "util/RenameThread.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+namespace {
+
+using namespace chatterino;
+
+std::unique_ptr<QFile> openFile(const QString &filePath)
+{
+    if (!QDir().mkpath(QFileInfo(filePath).absolutePath()))
+    {
+        qCWarning(chatterinoHelper)
+            << "Unable to create logging path for" << filePath;
+        return nullptr;
+    }
+
+    auto file = std::make_unique<QFile>(filePath);
+    if (!file->open(QIODevice::Append))
+    {
+        qCWarning(chatterinoHelper)
+            << "Unable to open log file" << filePath << file->errorString();
+        return nullptr;
+    }
+
+    return file;
+}
+
+}  // namespace
+
+namespace chatterino {
+
+LogWriter::LogWriter()
+    : LogWriter(Options{})
+{
+}
+
+LogWriter::LogWriter(Options options)
+    : options_(options)
+{
+    DebugCount::configure("log writer pending bytes",
+                          DebugCount::Flag::DataSize);
+    DebugCount::configure("log writer bytes written",
+                          DebugCount::Flag::DataSize);
+
+    this->thread_ = std::make_unique<std::thread>([this] {
+        this->run();
+    });
+    renameThread(*this->thread_, "LogWriter");
+}
+
+LogWriter::~LogWriter()
+{
+    {
+        std::lock_guard lock(this->mutex_);
+        this->stopping_ = true;
+    }
+    this->wakeCondition_.notify_one();
+
+    this->thread_->join();
+}
+
+void LogWriter::append(const QString &filePath, const QByteArray &data)
+{
+    const auto size = static_cast<size_t>(data.size());
+    bool wakeUp = false;
+    size_t pendingBytes = 0;
+    {
+        std::lock_guard lock(this->mutex_);
+        auto &file = this->pending_[filePath];
+
+        if (this->pendingBytes_ + size > this->options_.maxPendingBytes)
+        {
+            file.droppedLines++;
+            DebugCount::increase("log lines dropped");
+            return;
+        }
+
+        file.data.append(data);
+        this->pendingBytes_ += size;
+        pendingBytes = this->pendingBytes_;
+        wakeUp = this->pendingBytes_ >= this->options_.flushThreshold;
+    }
+
+    DebugCount::set("log writer pending bytes",
+                    static_cast<int64_t>(pendingBytes));
+
+    if (wakeUp)
+    {
+        this->wakeCondition_.notify_one();
+    }
+}
+
+void LogWriter::close(const QString &filePath)
+{
+    std::lock_guard lock(this->mutex_);
+    this->pending_[filePath].closeRequested = true;
+}
+
+void LogWriter::drain()
+{
+    std::unique_lock lock(this->mutex_);
+
+    // Everything queued so far will be part of the next batch
+    auto target = this->batchesTaken_ + 1;
+    this->flushRequested_ = true;
+    this->wakeCondition_.notify_one();
+
+    this->drainCondition_.wait(lock, [&] {
+        return this->batchesWritten_ >= target;
+    });
+}
+
+void LogWriter::run()
+{
+    // Only ever accessed from this thread
+    OpenFiles files;
+
+    std::unique_lock lock(this->mutex_);
+    while (true)
+    {
+        this->wakeCondition_.wait_for(lock, this->options_.flushInterval, [&] {
+            return this->stopping_ || this->flushRequested_ ||
+                   this->pendingBytes_ >= this->options_.flushThreshold;
+        });
+
+        auto batch = std::move(this->pending_);
+        this->pending_.clear();
+        this->pendingBytes_ = 0;
+        this->flushRequested_ = false;
+        const bool stopping = this->stopping_;
+        const auto generation = ++this->batchesTaken_;
+        lock.unlock();
+
+        if (!batch.empty())
+        {
+            DebugCount::set("log writer pending bytes", 0);
+        }
+
+        for (auto &[filePath, pending] : batch)
+        {
+            this->writeFile(files, filePath, pending);
+        }
+
+        lock.lock();
+        this->batchesWritten_ = generation;
+        this->drainCondition_.notify_all();
+
+        if (stopping)
+        {
+            break;
+        }
+    }
+
+    DebugCount::decrease("log writer open files",
+                         static_cast<int64_t>(files.size()));
+    // QFile flushes and closes on destruction
+}
+
+void LogWriter::writeFile(OpenFiles &files, const QString &filePath,
+                          PendingFile &pending)
+{
+    auto it = files.find(filePath);
+
+    if (!pending.data.isEmpty() || pending.droppedLines > 0)
+    {
+        if (it == files.end())
+        {
+            auto file = openFile(filePath);
+            if (!file)
+            {
+                DebugCount::increase("log lines dropped",
+                                     pending.data.count('\n'));
+                return;
+            }
+            it = files.emplace(filePath, std::move(file)).first;
+            DebugCount::increase("log writer open files");
+        }
+
+        auto &file = *it->second;
+        if (pending.droppedLines > 0)
+        {
+            pending.data.append(
+                QStringLiteral(
+                    "# %1 lines were dropped because the log writer "
+                    "couldn't keep up\n")
+                    .arg(pending.droppedLines)
+                    .toUtf8());
+        }
+
+        file.write(pending.data);
+        file.flush();
+
+        DebugCount::increase("log writer bytes written", pending.data.size());
+        DebugCount::increase("log writer flushes");
+    }
+
+    if (pending.closeRequested && it != files.end())
+    {
+        files.erase(it);
+        DebugCount::decrease("log writer open files");
+    }
+}
+
+}  // namespace chatterino
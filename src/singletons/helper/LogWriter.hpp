@@ -0,0 +1,91 @@
+#pragma once
+
+#include "util/QStringHash.hpp"
+
+#include <QByteArray>
+#include <QString>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+class QFile;
+
+namespace chatterino {
+
+/// Writes chat logs on a dedicated thread.
+///
+/// Lines are appended to a buffer per file and written in groups, either when
+/// `flushInterval` has passed or when more than `flushThreshold` bytes are
+/// pending. This keeps disk access (and slow network home directories) away
+/// from the thread that delivers messages.
+///
+/// If the disk can't keep up and more than `maxPendingBytes` are buffered, new
+/// lines are dropped. A note about the dropped lines is written to the file
+/// once it catches up.
+class LogWriter
+{
+public:
+    struct Options {
+        std::chrono::milliseconds flushInterval{250};
+        size_t flushThreshold = 64 * 1024;
+        size_t maxPendingBytes = 8 * 1024 * 1024;
+    };
+
+    LogWriter();
+    explicit LogWriter(Options options);
+
+    /// Writes all pending data and stops the writer thread
+    ~LogWriter();
+
+    LogWriter(const LogWriter &) = delete;
+    LogWriter(LogWriter &&) = delete;
+    LogWriter &operator=(const LogWriter &) = delete;
+    LogWriter &operator=(LogWriter &&) = delete;
+
+    /// Appends `data` to the file at `filePath`.
+    /// The file (and its directory) is created if necessary.
+    void append(const QString &filePath, const QByteArray &data);
+
+    /// Closes the file at `filePath` after all data queued before has been
+    /// written. Data appended afterwards will reopen the file.
+    void close(const QString &filePath);
+
+    /// Blocks until all data queued before this call has been written
+    void drain();
+
+private:
+    struct PendingFile {
+        QByteArray data;
+        size_t droppedLines = 0;
+        bool closeRequested = false;
+    };
+
+    using OpenFiles = std::unordered_map<QString, std::unique_ptr<QFile>>;
+
+    void run();
+    void writeFile(OpenFiles &files, const QString &filePath,
+                   PendingFile &pending);
+
+    const Options options_;
+
+    std::mutex mutex_;
+    std::condition_variable wakeCondition_;
+    std::condition_variable drainCondition_;
+    std::unordered_map<QString, PendingFile> pending_;
+    size_t pendingBytes_ = 0;
+    bool flushRequested_ = false;
+    bool stopping_ = false;
+    /// Number of batches taken from and written by the writer thread,
+    /// used by drain()
+    uint64_t batchesTaken_ = 0;
+    uint64_t batchesWritten_ = 0;
+
+    std::unique_ptr<std::thread> thread_;
+};
+
+}  // namespace chatterino
@@ -4,6 +4,7 @@
 #include "common/QLogging.hpp"
 #include "messages/Message.hpp"
 #include "messages/MessageThread.hpp"
+#include "singletons/helper/LogWriter.hpp"
 #include "singletons/Paths.hpp"
 #include "singletons/Settings.hpp"
 
@@ -14,15 +15,6 @@ namespace {
 
 const QByteArray ENDLINE("\n");
 
-void appendLine(QFile &fileHandle, const QString &line)
-{
-    assert(fileHandle.isOpen());
-    assert(fileHandle.isWritable());
-
-    fileHandle.write(line.toUtf8());
-    fileHandle.flush();
-}
-
 QString generateOpeningString(
     const QDateTime &now = QDateTime::currentDateTime())
 {
@@ -56,9 +48,11 @@ QString generateDateString(const QDateTime &now)
 
 namespace chatterino {
 
-LoggingChannel::LoggingChannel(QString _channelName, QString _platform)
+LoggingChannel::LoggingChannel(QString _channelName, QString _platform,
+                               LogWriter &writer)
     : channelName(std::move(_channelName))
     , platform(std::move(_platform))
+    , writer(writer)
 {
     if (this->channelName.startsWith("/whispers"))
     {
@@ -96,9 +90,15 @@ LoggingChannel::LoggingChannel(QString _channelName, QString _platform)
 
 LoggingChannel::~LoggingChannel()
 {
-    appendLine(this->fileHandle, generateClosingString());
-    this->fileHandle.close();
-    this->currentStreamFileHandle.close();
+    if (!this->fileName.isEmpty())
+    {
+        this->writer.append(this->fileName, generateClosingString().toUtf8());
+        this->writer.close(this->fileName);
+    }
+    if (!this->currentStreamFileName.isEmpty())
+    {
+        this->writer.close(this->currentStreamFileName);
+    }
 }
 
 void LoggingChannel::openLogFile()
@@ -106,10 +106,9 @@ void LoggingChannel::openLogFile()
     QDateTime now = QDateTime::currentDateTime();
     this->dateString = generateDateString(now);
 
-    if (this->fileHandle.isOpen())
+    if (!this->fileName.isEmpty())
     {
-        this->fileHandle.flush();
-        this->fileHandle.close();
+        this->writer.close(this->fileName);
     }
 
     QString baseFileName = this->channelName + "-" + this->dateString + ".log";
@@ -117,20 +116,11 @@ void LoggingChannel::openLogFile()
     QString directory =
         this->baseDirectory + QDir::separator() + this->subDirectory;
 
-    if (!QDir().mkpath(directory))
-    {
-        qCDebug(chatterinoHelper) << "Unable to create logging path";
-        return;
-    }
-
-    // Open file handle to log file of current date
-    QString fileName = directory + QDir::separator() + baseFileName;
-    qCDebug(chatterinoHelper) << "Logging to" << fileName;
-    this->fileHandle.setFileName(fileName);
-
-    this->fileHandle.open(QIODevice::Append);
+    // The directory is created by the writer
+    this->fileName = directory + QDir::separator() + baseFileName;
+    qCDebug(chatterinoHelper) << "Logging to" << this->fileName;
 
-    appendLine(this->fileHandle, generateOpeningString(now));
+    this->writer.append(this->fileName, generateOpeningString(now).toUtf8());
 }
 
 void LoggingChannel::openStreamLogFile(const QString &streamID)
@@ -138,10 +128,9 @@ void LoggingChannel::openStreamLogFile(const QString &streamID)
     QDateTime now = QDateTime::currentDateTime();
     this->currentStreamID = streamID;
 
-    if (this->currentStreamFileHandle.isOpen())
+    if (!this->currentStreamFileName.isEmpty())
     {
-        this->currentStreamFileHandle.flush();
-        this->currentStreamFileHandle.close();
+        this->writer.close(this->currentStreamFileName);
     }
 
     QString baseFileName = this->channelName + "-" + streamID + ".log";
@@ -149,18 +138,12 @@ void LoggingChannel::openStreamLogFile(const QString &streamID)
     QString directory =
         this->baseDirectory + QDir::separator() + this->subDirectory;
 
-    if (!QDir().mkpath(directory))
-    {
-        qCDebug(chatterinoHelper) << "Unable to create logging path";
-        return;
-    }
-
-    QString fileName = directory + QDir::separator() + baseFileName;
-    qCDebug(chatterinoHelper) << "Logging stream to" << fileName;
-    this->currentStreamFileHandle.setFileName(fileName);
+    this->currentStreamFileName = directory + QDir::separator() + baseFileName;
+    qCDebug(chatterinoHelper)
+        << "Logging stream to" << this->currentStreamFileName;
 
-    this->currentStreamFileHandle.open(QIODevice::Append);
-    appendLine(this->currentStreamFileHandle, generateOpeningString(now));
+    this->writer.append(this->currentStreamFileName,
+                        generateOpeningString(now).toUtf8());
 }
 
 void LoggingChannel::addMessage(const MessagePtr &message,
@@ -230,7 +213,8 @@ void LoggingChannel::addMessage(const MessagePtr &message,
     str.append(messageText);
     str.append(ENDLINE);
 
-    appendLine(this->fileHandle, str);
+    auto line = str.toUtf8();
+    this->writer.append(this->fileName, line);
 
     if (!streamID.isEmpty() && getSettings()->separatelyStoreStreamLogs)
     {
@@ -239,7 +223,7 @@ void LoggingChannel::addMessage(const MessagePtr &message,
             this->openStreamLogFile(streamID);
         }
 
-        appendLine(this->currentStreamFileHandle, str);
+        this->writer.append(this->currentStreamFileName, line);
     }
 }
 
@@ -1,6 +1,5 @@
 #pragma once
 
-#include <QFile>
 #include <QString>
 
 #include <memory>
@@ -8,12 +7,14 @@
 namespace chatterino {
 
 class Logging;
+class LogWriter;
 struct Message;
 using MessagePtr = std::shared_ptr<const Message>;
 
 class LoggingChannel
 {
-    explicit LoggingChannel(QString _channelName, QString _platform);
+    explicit LoggingChannel(QString _channelName, QString _platform,
+                            LogWriter &writer);
 
 public:
     ~LoggingChannel();
@@ -35,8 +36,10 @@ private:
     QString baseDirectory;
     QString subDirectory;
 
-    QFile fileHandle;
-    QFile currentStreamFileHandle;
+    LogWriter &writer;
+
+    QString fileName;
+    QString currentStreamFileName;
     QString currentStreamID;
 
     QString dateString;
@@ -0,0 +1,163 @@
+#include "util/AhoCorasick.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <ranges>
+
+namespace chatterino {
+
+AhoCorasick::AhoCorasick(const std::vector<QString> &patterns,
+                         Qt::CaseSensitivity caseSensitivity)
+    : caseInsensitive_(caseSensitivity == Qt::CaseInsensitive)
+{
+    // Build the trie with maps first, the edges are flattened afterwards
+    std::vector<std::map<char16_t, int32_t>> children(1);
+    std::vector<std::vector<size_t>> terminals(1);
+
+    for (size_t i = 0; i < patterns.size(); i++)
+    {
+        const auto &pattern = patterns[i];
+        if (pattern.isEmpty())
+        {
+            continue;
+        }
+
+        int32_t node = 0;
+        for (QChar c : pattern)
+        {
+            auto normalized = this->normalize(c.unicode());
+            auto it = children[node].find(normalized);
+            if (it == children[node].end())
+            {
+                auto created = static_cast<int32_t>(children.size());
+                children[node].emplace(normalized, created);
+                children.emplace_back();
+                terminals.emplace_back();
+                node = created;
+            }
+            else
+            {
+                node = it->second;
+            }
+        }
+        terminals[node].push_back(i);
+    }
+
+    if (children.size() == 1)
+    {
+        // no patterns
+        return;
+    }
+
+    this->nodes_.resize(children.size());
+    for (size_t node = 0; node < children.size(); node++)
+    {
+        this->nodes_[node].firstEdge =
+            static_cast<uint32_t>(this->edges_.size());
+        this->nodes_[node].edgeCount =
+            static_cast<uint32_t>(children[node].size());
+        for (auto [c, target] : children[node])
+        {
+            this->edges_.push_back({c, target});
+        }
+    }
+
+    for (const auto &[c, target] : children[0])
+    {
+        if (c < this->rootAscii_.size())
+        {
+            this->rootAscii_[c] = target;
+        }
+    }
+
+    // Fail links and outputs, in breadth-first order so the fail node of a node
+    // is always done before the node itself
+    std::deque<int32_t> queue{0};
+    while (!queue.empty())
+    {
+        auto node = queue.front();
+        queue.pop_front();
+
+        auto &outputHead = this->nodes_[node].output;
+        if (node != 0)
+        {
+            outputHead = this->nodes_[this->nodes_[node].fail].output;
+        }
+        // Prepend in reverse so the patterns of a node are in ascending order
+        for (auto pattern : std::views::reverse(terminals[node]))
+        {
+            this->outputs_.push_back({pattern, outputHead});
+            outputHead = static_cast<int32_t>(this->outputs_.size() - 1);
+        }
+
+        for (const auto &[c, target] : children[node])
+        {
+            if (node == 0)
+            {
+                this->nodes_[target].fail = 0;
+            }
+            else
+            {
+                this->nodes_[target].fail =
+                    this->next(this->nodes_[node].fail, c);
+            }
+            queue.push_back(target);
+        }
+    }
+}
+
+bool AhoCorasick::empty() const
+{
+    return this->nodes_.empty();
+}
+
+char16_t AhoCorasick::normalize(char16_t c) const
+{
+    if (this->caseInsensitive_)
+    {
+        return static_cast<char16_t>(QChar::toCaseFolded(c));
+    }
+    return c;
+}
+
+int32_t AhoCorasick::next(int32_t node, char16_t c) const
+{
+    while (true)
+    {
+        if (node == 0 && c < this->rootAscii_.size())
+        {
+            return this->rootAscii_[c];
+        }
+
+        auto target = this->child(node, c);
+        if (target != -1)
+        {
+            return target;
+        }
+        if (node == 0)
+        {
+            return 0;
+        }
+        node = this->nodes_[node].fail;
+    }
+}
+
+int32_t AhoCorasick::child(int32_t node, char16_t c) const
+{
+    const auto &info = this->nodes_[node];
+    auto begin = this->edges_.begin() + info.firstEdge;
+    auto end = begin + info.edgeCount;
+
+    auto it = std::lower_bound(begin, end, c,
+                               [](const Edge &edge, char16_t character) {
+                                   return edge.character < character;
+                               });
+    if (it != end && it->character == c)
+    {
+        return it->target;
+    }
+    return -1;
+}
+
+}  // namespace chatterino
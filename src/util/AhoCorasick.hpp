@@ -0,0 +1,91 @@
+#pragma once
+
+#include <QString>
+#include <QStringView>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace chatterino {
+
+/// Finds all occurrences of a set of patterns in a text in a single pass
+/// (Aho-Corasick).
+///
+/// When matching case-insensitively, patterns and text are compared by their
+/// case-folded UTF-16 code units.
+class AhoCorasick
+{
+public:
+    AhoCorasick() = default;
+    AhoCorasick(const std::vector<QString> &patterns,
+                Qt::CaseSensitivity caseSensitivity);
+
+    /// Returns true if there are no (non-empty) patterns
+    bool empty() const;
+
+    /// Calls `callback(pattern, end)` for every occurrence of a pattern in
+    /// `text`, where `pattern` is the index of the pattern and `end` is the
+    /// index after the last character of the occurrence.
+    ///
+    /// Occurrences are reported in the order of their end. Empty patterns never
+    /// match. Stops once the callback returns false.
+    template <typename Callback>
+    void forEachMatch(QStringView text, Callback &&callback) const
+    {
+        if (this->empty())
+        {
+            return;
+        }
+
+        int32_t node = 0;
+        for (qsizetype i = 0; i < text.size(); i++)
+        {
+            node = this->next(node, this->normalize(text[i].unicode()));
+            for (auto out = this->nodes_[node].output; out != -1;
+                 out = this->outputs_[out].next)
+            {
+                if (!callback(this->outputs_[out].pattern, i + 1))
+                {
+                    return;
+                }
+            }
+        }
+    }
+
+private:
+    struct Node {
+        uint32_t firstEdge = 0;
+        uint32_t edgeCount = 0;
+        int32_t fail = 0;
+        /// First entry in outputs_ for the patterns ending at this node
+        /// (including the ones of its fail nodes), or -1
+        int32_t output = -1;
+    };
+
+    struct Edge {
+        char16_t character;
+        int32_t target;
+    };
+
+    struct Output {
+        size_t pattern;
+        int32_t next;
+    };
+
+    char16_t normalize(char16_t c) const;
+    /// Returns the node reached from `node` with `c`, following fail links
+    int32_t next(int32_t node, char16_t c) const;
+    /// Returns the direct child of `node` for `c`, or -1
+    int32_t child(int32_t node, char16_t c) const;
+
+    std::vector<Node> nodes_;
+    /// Edges of each node, sorted by character
+    std::vector<Edge> edges_;
+    std::vector<Output> outputs_;
+    /// Direct transitions from the root for ASCII characters
+    std::array<int32_t, 128> rootAscii_{};
+    bool caseInsensitive_ = false;
+};
+
+}  // namespace chatterino
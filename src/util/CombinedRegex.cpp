@@ -0,0 +1,67 @@
+#include "util/CombinedRegex.hpp"
+
+#include "common/Literals.hpp"
+
+namespace chatterino {
+
+using namespace literals;
+
+bool CombinedRegex::canCombine(const QString &pattern)
+{
+    static const QRegularExpression unsafe(uR"(\(\?|\(\*|\\[QKgk1-9])"_s);
+    return !pattern.contains(unsafe);
+}
+
+CombinedRegex::CombinedRegex(const std::vector<Pattern> &patterns)
+{
+    if (patterns.empty())
+    {
+        return;
+    }
+
+    QString combined;
+    for (const auto &pattern : patterns)
+    {
+        auto name = u"p%1"_s.arg(this->groupNames_.size());
+        if (!combined.isEmpty())
+        {
+            combined += u'|';
+        }
+        combined += u"(?<%1>(?%2:%3))"_s.arg(
+            name,
+            pattern.caseSensitivity == Qt::CaseSensitive ? u"-i"_s : u"i"_s,
+            pattern.pattern);
+        this->groupNames_.push_back(std::move(name));
+    }
+
+    this->regex_ = QRegularExpression(
+        combined, QRegularExpression::UseUnicodePropertiesOption);
+}
+
+bool CombinedRegex::empty() const
+{
+    return this->groupNames_.empty();
+}
+
+bool CombinedRegex::isValid() const
+{
+    return this->regex_.isValid();
+}
+
+QString CombinedRegex::errorString() const
+{
+    return this->regex_.errorString();
+}
+
+QRegularExpressionMatch CombinedRegex::match(const QString &subject) const
+{
+    return this->regex_.match(subject);
+}
+
+bool CombinedRegex::isMatchOf(const QRegularExpressionMatch &match,
+                              size_t index) const
+{
+    return match.capturedStart(this->groupNames_[index]) != -1;
+}
+
+}  // namespace chatterino
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QRegularExpression>
+#include <QString>
+
+#include <vector>
+
+namespace chatterino {
+
+/// Many regular expressions combined into one alternation, so a subject only
+/// has to be searched once to find out if any of them matches.
+///
+/// Every expression is wrapped in a named group, which tells which of the
+/// expressions produced a match.
+class CombinedRegex
+{
+public:
+    struct Pattern {
+        QString pattern;
+        Qt::CaseSensitivity caseSensitivity;
+    };
+
+    /// Returns true if `pattern` means the same when wrapped in a group of a
+    /// larger expression.
+    ///
+    /// Back references depend on the numbering of groups, inline options and
+    /// verbs can change the meaning of the whole expression, and \Q quotes
+    /// until \E or the end. This is intentionally conservative.
+    static bool canCombine(const QString &pattern);
+
+    CombinedRegex() = default;
+    /// All patterns must be valid on their own and pass canCombine
+    explicit CombinedRegex(const std::vector<Pattern> &patterns);
+
+    /// Returns true if there are no patterns
+    bool empty() const;
+
+    /// Returns false if the combined expression couldn't be compiled
+    bool isValid() const;
+    QString errorString() const;
+
+    /// Finds the first match of any pattern in `subject`
+    QRegularExpressionMatch match(const QString &subject) const;
+
+    /// Returns true if the pattern at `index` produced `match`.
+    ///
+    /// Other patterns might still match elsewhere in the subject.
+    bool isMatchOf(const QRegularExpressionMatch &match, size_t index) const;
+
+private:
+    QRegularExpression regex_;
+    std::vector<QString> groupNames_;
+};
+
+}  // namespace chatterino
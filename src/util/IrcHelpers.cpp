@@ -1,11 +1,31 @@
 #include "util/IrcHelpers.hpp"
 
 #include "Application.hpp"
+#include "providers/twitch/TwitchIrcLine.hpp"
 
 namespace {
 
 using namespace chatterino;
 
+QDateTime parseServerTime(const QString &timedate)
+{
+    auto date = QDateTime::fromString(timedate, Qt::ISODate);
+    date.setTimeZone(QTimeZone::utc());
+    return date.toLocalTime();
+}
+
+QDateTime fallbackMessageTime()
+{
+#ifdef CHATTERINO_WITH_TESTS
+    if (getApp()->isTest())
+    {
+        return QDateTime::fromMSecsSinceEpoch(0, QTimeZone::utc());
+    }
+#endif
+
+    return QDateTime::currentDateTime();
+}
+
 QDateTime calculateMessageTimeBase(const Communi::IrcMessage *message)
 {
     // Check if message is from recent-messages API
@@ -33,22 +53,51 @@ QDateTime calculateMessageTimeBase(const Communi::IrcMessage *message)
     // See: https://ircv3.net/irc/#server-time
     if (message->tags().contains("time"))
     {
-        QString timedate = message->tags().value("time").toString();
+        return parseServerTime(message->tags().value("time").toString());
+    }
+
+    return fallbackMessageTime();
+}
+
+QDateTime calculateMessageTimeBase(const TwitchIrcLine &line)
+{
+    if (line.hasTag(TwitchTag::Historical))
+    {
+        bool customReceived = false;
+        auto ts =
+            line.tag(TwitchTag::RmReceivedTs).toLongLong(&customReceived);
+        if (!customReceived)
+        {
+            ts = line.tag(TwitchTag::TmiSentTs).toLongLong();
+        }
+
+        return QDateTime::fromMSecsSinceEpoch(ts);
+    }
+
+    if (line.hasTag(TwitchTag::TmiSentTs))
+    {
+        auto ts = line.tag(TwitchTag::TmiSentTs).toLongLong();
+        return QDateTime::fromMSecsSinceEpoch(ts);
+    }
 
-        auto date = QDateTime::fromString(timedate, Qt::ISODate);
-        date.setTimeZone(QTimeZone::utc());
-        return date.toLocalTime();
+    if (auto time = line.tag("time"); !time.isNull())
+    {
+        return parseServerTime(time);
     }
 
-    // Fallback to current time
+    return fallbackMessageTime();
+}
+
+QDateTime toMessageTime(QDateTime dt)
+{
 #ifdef CHATTERINO_WITH_TESTS
     if (getApp()->isTest())
     {
-        return QDateTime::fromMSecsSinceEpoch(0, QTimeZone::utc());
+        return dt.toUTC();
     }
 #endif
 
-    return QDateTime::currentDateTime();
+    return dt;
 }
 
 }  // namespace
@@ -57,16 +106,12 @@ namespace chatterino {
 
 QDateTime calculateMessageTime(const Communi::IrcMessage *message)
 {
-    auto dt = calculateMessageTimeBase(message);
-
-#ifdef CHATTERINO_WITH_TESTS
-    if (getApp()->isTest())
-    {
-        return dt.toUTC();
-    }
-#endif
+    return toMessageTime(calculateMessageTimeBase(message));
+}
 
-    return dt;
+QDateTime calculateMessageTime(const TwitchIrcLine &line)
+{
+    return toMessageTime(calculateMessageTimeBase(line));
 }
 
 }  // namespace chatterino
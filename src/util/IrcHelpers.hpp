@@ -6,6 +6,8 @@
 
 namespace chatterino {
 
+class TwitchIrcLine;
+
 inline QString parseTagString(const QString &input)
 {
     QString output = input;
@@ -60,6 +62,8 @@ inline QString parseTagString(const QString &input)
 }
 
 QDateTime calculateMessageTime(const Communi::IrcMessage *message);
+/// Like calculateMessageTime, but reads the tags from `line`
+QDateTime calculateMessageTime(const TwitchIrcLine &line);
 
 // "foo/bar/baz,tri/hard" can be a valid badge-info tag
 // In that case, valid map content should be 'split by slash' only once:
@@ -0,0 +1,124 @@
+#include "util/KeyedThreadPool.hpp"
+
+#include "util/RenameThread.hpp"
+
+#include <algorithm>
+
+namespace chatterino {
+
+KeyedThreadPool::KeyedThreadPool(size_t threadCount, const QString &name)
+{
+    threadCount = std::max<size_t>(threadCount, 1);
+    for (size_t i = 0; i < threadCount; i++)
+    {
+        auto &thread = this->threads_.emplace_back([this] {
+            this->run();
+        });
+        renameThread(thread, name);
+    }
+}
+
+KeyedThreadPool::~KeyedThreadPool()
+{
+    {
+        std::lock_guard lock(this->mutex_);
+        this->stopping_ = true;
+        this->queues_.clear();
+        this->ready_.clear();
+    }
+    this->condition_.notify_all();
+
+    for (auto &thread : this->threads_)
+    {
+        thread.join();
+    }
+}
+
+void KeyedThreadPool::submit(const void *key, Job job)
+{
+    {
+        std::lock_guard lock(this->mutex_);
+        this->pending_++;
+
+        auto [it, inserted] = this->queues_.try_emplace(key);
+        it->second.push_back(std::move(job));
+        if (!inserted)
+        {
+            // the key is already queued or its job is running
+            return;
+        }
+        this->ready_.push_back(key);
+    }
+    this->condition_.notify_one();
+}
+
+void KeyedThreadPool::waitForIdle()
+{
+    std::unique_lock lock(this->mutex_);
+    this->idle_.wait(lock, [this] {
+        return this->pending_ == 0;
+    });
+}
+
+size_t KeyedThreadPool::pending() const
+{
+    std::lock_guard lock(this->mutex_);
+    return this->pending_;
+}
+
+size_t KeyedThreadPool::threadCount() const
+{
+    return this->threads_.size();
+}
+
+void KeyedThreadPool::run()
+{
+    std::unique_lock lock(this->mutex_);
+    while (true)
+    {
+        this->condition_.wait(lock, [this] {
+            return this->stopping_ || !this->ready_.empty();
+        });
+        if (this->stopping_)
+        {
+            return;
+        }
+
+        const auto *key = this->ready_.front();
+        this->ready_.pop_front();
+        auto &queue = this->queues_[key];
+        auto job = std::move(queue.front());
+        queue.pop_front();
+
+        lock.unlock();
+        job();
+        // destroy the job (and everything it captured) outside of the lock
+        job = nullptr;
+        lock.lock();
+
+        if (this->stopping_)
+        {
+            return;
+        }
+
+        auto it = this->queues_.find(key);
+        if (it->second.empty())
+        {
+            this->queues_.erase(it);
+        }
+        else
+        {
+            // other keys go first
+            this->ready_.push_back(key);
+            this->condition_.notify_one();
+        }
+
+        this->pending_--;
+        if (this->pending_ == 0)
+        {
+            this->idle_.notify_all();
+        }
+    }
+}
+
+}  // namespace chatterino
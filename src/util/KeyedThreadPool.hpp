@@ -0,0 +1,66 @@
+#pragma once
+
+#include <QString>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace chatterino {
+
+/// Runs jobs on a fixed number of worker threads.
+///
+/// Every job has a key (e.g. the channel a message belongs to). Jobs with the
+/// same key run one after another in the order they were submitted, jobs with
+/// different keys run in parallel. Keys take turns, so a busy key can't starve
+/// the others.
+class KeyedThreadPool
+{
+public:
+    using Job = std::function<void()>;
+
+    /// Starts `threadCount` (at least one) threads called `name`
+    KeyedThreadPool(size_t threadCount, const QString &name);
+
+    /// Drops all pending jobs and waits for the running ones
+    ~KeyedThreadPool();
+
+    KeyedThreadPool(const KeyedThreadPool &) = delete;
+    KeyedThreadPool(KeyedThreadPool &&) = delete;
+    KeyedThreadPool &operator=(const KeyedThreadPool &) = delete;
+    KeyedThreadPool &operator=(KeyedThreadPool &&) = delete;
+
+    /// Queues `job` after all pending jobs of `key`
+    void submit(const void *key, Job job);
+
+    /// Blocks until all submitted jobs have finished
+    void waitForIdle();
+
+    /// Returns the number of jobs that are queued or running
+    size_t pending() const;
+
+    size_t threadCount() const;
+
+private:
+    void run();
+
+    mutable std::mutex mutex_;
+    std::condition_variable condition_;
+    std::condition_variable idle_;
+
+    /// Pending jobs of every key that has queued or running jobs
+    std::unordered_map<const void *, std::deque<Job>> queues_;
+    /// Keys with queued jobs, none of which is running
+    std::deque<const void *> ready_;
+    size_t pending_ = 0;
+    bool stopping_ = false;
+
+    std::vector<std::thread> threads_;
+};
+
+}  // namespace chatterino
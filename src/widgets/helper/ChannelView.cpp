@@ -18,6 +18,7 @@
 #include "messages/MessageBuilder.hpp"
 #include "messages/MessageElement.hpp"
 #include "messages/MessageThread.hpp"
+#include "messages/ScrollbackArchive.hpp"
 #include "providers/colors/ColorProvider.hpp"
 #include "providers/links/LinkInfo.hpp"
 #include "providers/links/LinkResolver.hpp"
@@ -77,6 +78,14 @@ using namespace chatterino;
 
 constexpr int SCROLLBAR_PADDING = 8;
 
+/// Paints within this time after a scroll with the mouse wheel don't create
+/// message buffers
+constexpr qint64 FAST_SCROLL_INTERVAL_MS = 250;
+
+/// Number of archived messages that are loaded when scrolling past the top
+/// (or bottom) of the shown archived messages
+constexpr size_t ARCHIVE_PAGE_SIZE = 200;
+
 void addEmoteContextMenuItems(QMenu *menu, const Emote &emote,
                               MessageElementFlags creatorFlags)
 {
@@ -379,6 +388,10 @@ void ChannelView::initializeLayout()
 
     QObject::connect(
         this->goToBottom_, &EffectLabel::leftClicked, this, [this] {
+            if (this->archivePosition_)
+            {
+                this->messagesUpdated();
+            }
             QTimer::singleShot(180, this, [this] {
                 this->scrollBar_->scrollToBottom(
                     getSettings()->enableSmoothScrollingNewMessages.getValue());
@@ -805,6 +818,10 @@ void ChannelView::clearMessages()
 
     this->lastMessageHasAlternateBackground_ = false;
     this->lastMessageHasAlternateBackgroundReverse_ = true;
+    this->archivePosition_.reset();
+    this->archiveIndices_.clear();
+    this->archiveLoading_ = false;
+    this->archiveGeneration_++;
 }
 
 Scrollbar &ChannelView::getScrollBar()
@@ -1161,6 +1178,31 @@ void ChannelView::messageAppended(MessagePtr &message,
         messageFlags = &*overridingFlags;
     }
 
+    if (!messageFlags->has(MessageFlag::DoNotTriggerNotification))
+    {
+        if ((messageFlags->has(MessageFlag::Highlighted) &&
+             messageFlags->has(MessageFlag::ShowInMentions) &&
+             !messageFlags->has(MessageFlag::Subscription) &&
+             (getSettings()->highlightMentions ||
+              this->channel_->getType() != Channel::Type::TwitchMentions)) ||
+            (this->channel_->getType() == Channel::Type::TwitchAutomod &&
+             getSettings()->enableAutomodHighlight))
+        {
+            this->tabHighlightRequested.invoke(HighlightState::Highlighted);
+        }
+        else
+        {
+            this->tabHighlightRequested.invoke(HighlightState::NewMessage);
+        }
+    }
+
+    if (this->archivePosition_)
+    {
+        // archived messages are shown - the message is shown together with
+        // the latest messages
+        return;
+    }
+
     auto messageRef = std::make_shared<MessageLayout>(message);
 
     if (this->lastMessageHasAlternateBackground_)
@@ -1202,24 +1244,6 @@ void ChannelView::messageAppended(MessagePtr &message,
         }
     }
 
-    if (!messageFlags->has(MessageFlag::DoNotTriggerNotification))
-    {
-        if ((messageFlags->has(MessageFlag::Highlighted) &&
-             messageFlags->has(MessageFlag::ShowInMentions) &&
-             !messageFlags->has(MessageFlag::Subscription) &&
-             (getSettings()->highlightMentions ||
-              this->channel_->getType() != Channel::Type::TwitchMentions)) ||
-            (this->channel_->getType() == Channel::Type::TwitchAutomod &&
-             getSettings()->enableAutomodHighlight))
-        {
-            this->tabHighlightRequested.invoke(HighlightState::Highlighted);
-        }
-        else
-        {
-            this->tabHighlightRequested.invoke(HighlightState::NewMessage);
-        }
-    }
-
     if (this->showScrollbarHighlights())
     {
         this->scrollBar_->addHighlight(message->getScrollBarHighlight());
@@ -1230,6 +1254,11 @@ void ChannelView::messageAppended(MessagePtr &message,
 
 void ChannelView::messageAddedAtStart(std::vector<MessagePtr> &messages)
 {
+    if (this->archivePosition_)
+    {
+        return;
+    }
+
     std::vector<MessageLayoutPtr> messageRefs;
     messageRefs.resize(messages.size());
 
@@ -1317,6 +1346,10 @@ void ChannelView::messagesUpdated()
     this->scrollBar_->setMinimum(0);
     this->lastMessageHasAlternateBackground_ = false;
     this->lastMessageHasAlternateBackgroundReverse_ = true;
+    this->archivePosition_.reset();
+    this->archiveIndices_.clear();
+    this->archiveLoading_ = false;
+    this->archiveGeneration_++;
 
     for (const auto &msg : snapshot)
     {
@@ -1344,6 +1377,329 @@ void ChannelView::messagesUpdated()
     this->queueLayout();
 }
 
+bool ChannelView::showOlderArchivedMessages()
+{
+    auto *channel = this->archivingChannel();
+    if (channel == nullptr)
+    {
+        return false;
+    }
+    if (this->archiveLoading_)
+    {
+        return true;
+    }
+
+    const auto *archive = channel->scrollbackArchive();
+    auto current = this->archivePosition_.value_or(archive->endIndex());
+    if (current <= archive->firstIndex())
+    {
+        return false;
+    }
+
+    if (!this->archivePosition_)
+    {
+        // the view stops following new messages from now on, so the indices
+        // of the shown messages don't change while the page is loaded
+        this->archiveIndices_ = this->latestMessageIndices(*channel);
+        this->archivePosition_ = current;
+    }
+    auto begin =
+        current - std::min(current - archive->firstIndex(), ARCHIVE_PAGE_SIZE);
+
+    this->loadArchivedMessages(
+        *channel, begin, current, {},
+        [this, begin](std::vector<std::pair<size_t, MessagePtr>> messages) {
+            this->prependArchivedMessages(begin, messages);
+        });
+    return true;
+}
+
+bool ChannelView::showNewerArchivedMessages()
+{
+    if (!this->archivePosition_)
+    {
+        return false;
+    }
+    if (this->archiveLoading_)
+    {
+        return true;
+    }
+
+    auto desired = this->scrollBar_->getDesiredValue();
+    auto begin = *this->archivePosition_ + ARCHIVE_PAGE_SIZE;
+    auto *channel = this->archivingChannel();
+    auto archiveEnd =
+        channel == nullptr ? 0 : channel->scrollbackArchive()->endIndex();
+
+    if (begin >= archiveEnd)
+    {
+        // the shown messages move up by the archived messages
+        auto removed = std::lower_bound(this->archiveIndices_.begin(),
+                                        this->archiveIndices_.end(),
+                                        archiveEnd) -
+                       this->archiveIndices_.begin();
+        this->messagesUpdated();
+        this->scrollBar_->setDesiredValue(
+            std::max<qreal>(0, desired - qreal(removed)));
+        return true;
+    }
+
+    // The next page starts after the last shown message. Messages after the
+    // end of the archive are the ones that are still in the channel.
+    auto shownEnd = this->archiveIndices_.empty()
+                        ? begin
+                        : std::max(begin, this->archiveIndices_.back() + 1);
+    auto end = shownEnd + ARCHIVE_PAGE_SIZE;
+
+    std::vector<std::pair<size_t, MessagePtr>> latest;
+    if (end > archiveEnd)
+    {
+        auto snapshot = channel->getMessageSnapshot();
+        for (auto index = std::max(shownEnd, archiveEnd);
+             index < end && index - archiveEnd < snapshot.size(); index++)
+        {
+            latest.emplace_back(index, snapshot[index - archiveEnd]);
+        }
+    }
+
+    this->loadArchivedMessages(
+        *channel, shownEnd, std::min(end, archiveEnd), std::move(latest),
+        [this, begin](std::vector<std::pair<size_t, MessagePtr>> messages) {
+            this->appendArchivedMessages(begin, messages);
+        });
+    return true;
+}
+
+void ChannelView::loadArchivedMessages(
+    TwitchChannel &channel, size_t begin, size_t end,
+    std::vector<std::pair<size_t, MessagePtr>> latest,
+    std::function<void(std::vector<std::pair<size_t, MessagePtr>>)> onLoaded)
+{
+    this->archiveLoading_ = true;
+    channel.loadArchivedMessages(
+        begin, end,
+        [self = QPointer<ChannelView>(this),
+         generation = this->archiveGeneration_, latest = std::move(latest),
+         onLoaded = std::move(onLoaded)](
+            std::vector<std::pair<size_t, MessagePtr>> messages) mutable {
+            // the view might have returned to the latest messages (or changed
+            // its channel) in the meantime
+            if (!self || self->archiveGeneration_ != generation)
+            {
+                return;
+            }
+            self->archiveLoading_ = false;
+
+            for (auto &message : latest)
+            {
+                messages.push_back(std::move(message));
+            }
+            onLoaded(std::move(messages));
+        });
+}
+
+void ChannelView::prependArchivedMessages(
+    size_t begin, const std::vector<std::pair<size_t, MessagePtr>> &messages)
+{
+    auto shown = this->messages_.getSnapshot();
+    auto limit = this->messages_.limit();
+
+    // continue the alternating backgrounds backwards from the first message
+    bool alternate =
+        shown.size() > 0 &&
+        shown[0]->flags.has(MessageLayoutFlag::AlternateBackground);
+    std::vector<std::pair<size_t, MessageLayoutPtr>> loaded;
+    for (const auto &[index, message] : messages)
+    {
+        if (this->shouldIncludeMessage(message))
+        {
+            loaded.emplace_back(index, this->makeArchivedLayout(message));
+        }
+    }
+    for (auto it = loaded.rbegin(); it != loaded.rend(); it++)
+    {
+        alternate = !alternate;
+        if (alternate)
+        {
+            it->second->flags.set(MessageLayoutFlag::AlternateBackground);
+        }
+    }
+
+    // the newest shown messages are dropped if there are too many
+    std::vector<MessageLayoutPtr> layouts;
+    std::vector<size_t> indices;
+    layouts.reserve(std::min(limit, loaded.size() + shown.size()));
+    indices.reserve(layouts.capacity());
+    for (auto &[index, layout] : loaded)
+    {
+        if (layouts.size() < limit)
+        {
+            layouts.push_back(std::move(layout));
+            indices.push_back(index);
+        }
+    }
+    for (size_t i = 0; i < shown.size() && layouts.size() < limit; i++)
+    {
+        layouts.push_back(shown[i]);
+        indices.push_back(this->archiveIndexOf(i));
+    }
+
+    auto desired = this->scrollBar_->getDesiredValue();
+    this->archivePosition_ = begin;
+    this->setArchivedLayouts(std::move(layouts), std::move(indices));
+
+    // the previously shown messages moved down by the loaded messages
+    this->scrollBar_->setDesiredValue(desired + qreal(loaded.size()));
+}
+
+void ChannelView::appendArchivedMessages(
+    size_t begin, const std::vector<std::pair<size_t, MessagePtr>> &messages)
+{
+    auto shown = this->messages_.getSnapshot();
+    auto limit = this->messages_.limit();
+
+    // the messages before `begin` are dropped
+    auto removed = static_cast<size_t>(
+        std::lower_bound(this->archiveIndices_.begin(),
+                         this->archiveIndices_.end(), begin) -
+        this->archiveIndices_.begin());
+
+    std::vector<MessageLayoutPtr> layouts;
+    std::vector<size_t> indices;
+    for (auto i = removed; i < shown.size(); i++)
+    {
+        layouts.push_back(shown[i]);
+        indices.push_back(this->archiveIndexOf(i));
+    }
+
+    // continue the alternating backgrounds from the last message
+    bool alternate =
+        shown.size() > 0 &&
+        shown[shown.size() - 1]->flags.has(
+            MessageLayoutFlag::AlternateBackground);
+    for (const auto &[index, message] : messages)
+    {
+        if (!this->shouldIncludeMessage(message))
+        {
+            continue;
+        }
+
+        auto layout = this->makeArchivedLayout(message);
+        alternate = !alternate;
+        if (alternate)
+        {
+            layout->flags.set(MessageLayoutFlag::AlternateBackground);
+        }
+        layouts.push_back(std::move(layout));
+        indices.push_back(index);
+    }
+
+    if (layouts.size() > limit)
+    {
+        auto excess = layouts.size() - limit;
+        layouts.erase(layouts.begin(),
+                      layouts.begin() + static_cast<std::ptrdiff_t>(excess));
+        indices.erase(indices.begin(),
+                      indices.begin() + static_cast<std::ptrdiff_t>(excess));
+        removed += excess;
+    }
+
+    auto desired = this->scrollBar_->getDesiredValue();
+    this->archivePosition_ =
+        indices.empty() ? begin : std::max(begin, indices.front());
+    this->setArchivedLayouts(std::move(layouts), std::move(indices));
+
+    // the shown messages moved up by the dropped messages
+    this->scrollBar_->setDesiredValue(
+        std::max<qreal>(0, desired - qreal(removed)));
+}
+
+MessageLayoutPtr ChannelView::makeArchivedLayout(const MessagePtr &message)
+{
+    auto layout = std::make_shared<MessageLayout>(message);
+    if (this->underlyingChannel_->shouldIgnoreHighlights())
+    {
+        layout->flags.set(MessageLayoutFlag::IgnoreHighlights);
+    }
+    return layout;
+}
+
+void ChannelView::setArchivedLayouts(std::vector<MessageLayoutPtr> layouts,
+                                     std::vector<size_t> indices)
+{
+    this->messages_.clear();
+    this->scrollBar_->clearHighlights();
+    this->scrollBar_->resetBounds();
+
+    // the layouts that were shown before are reused, so they don't have to
+    // be laid out again
+    for (const auto &layout : layouts)
+    {
+        this->messages_.pushBack(layout);
+        if (this->showScrollbarHighlights())
+        {
+            this->scrollBar_->addHighlight(
+                layout->getMessagePtr()->getScrollBarHighlight());
+        }
+    }
+
+    this->scrollBar_->setMaximum(qreal(layouts.size()));
+    this->scrollBar_->setMinimum(0);
+    this->archiveIndices_ = std::move(indices);
+    this->queueLayout();
+}
+
+size_t ChannelView::archiveIndexOf(size_t i) const
+{
+    if (i < this->archiveIndices_.size())
+    {
+        return this->archiveIndices_[i];
+    }
+    return this->archiveIndices_.empty() ? this->archivePosition_.value_or(0)
+                                         : this->archiveIndices_.back();
+}
+
+std::vector<size_t> ChannelView::latestMessageIndices(
+    TwitchChannel &channel) const
+{
+    // The messages of the channel get the next archive indices once they're
+    // removed from it, so they're indexed as if they were archived already
+    auto archiveEnd = channel.scrollbackArchive()->endIndex();
+    auto snapshot = channel.getMessageSnapshot();
+    auto shown = this->messages_.getSnapshot();
+
+    std::vector<size_t> indices;
+    indices.reserve(shown.size());
+    size_t next = 0;
+    for (size_t i = 0; i < shown.size(); i++)
+    {
+        // the shown messages are a subset of the channel's messages
+        auto found = next;
+        while (found < snapshot.size() &&
+               snapshot[found] != shown[i]->getMessagePtr())
+        {
+            found++;
+        }
+        if (found < snapshot.size())
+        {
+            next = found + 1;
+        }
+        indices.push_back(archiveEnd + (next == 0 ? 0 : next - 1));
+    }
+    return indices;
+}
+
+TwitchChannel *ChannelView::archivingChannel() const
+{
+    auto *channel =
+        dynamic_cast<TwitchChannel *>(this->underlyingChannel_.get());
+    if (channel == nullptr || channel->scrollbackArchive() == nullptr)
+    {
+        return nullptr;
+    }
+    return channel;
+}
+
 void ChannelView::updateLastReadMessage()
 {
     if (auto lastMessage = this->messages_.last())
@@ -1614,6 +1970,12 @@ void ChannelView::drawMessages(QPainter &painter, const QRect &area)
         .messageIndex = start,
         .isLastReadMessage = false,
 
+        // Messages scrolled into view quickly are painted without creating
+        // buffers for them, which would likely be discarded soon
+        .paintDirectly = this->isScrolling_ || this->isPanning_ ||
+                         (this->wheelScrollTimer_.isValid() &&
+                          this->wheelScrollTimer_.elapsed() <
+                              FAST_SCROLL_INTERVAL_MS),
     };
     bool showLastMessageIndicator = getSettings()->showLastMessageIndicator;
 
@@ -1749,8 +2111,28 @@ void ChannelView::wheelEvent(QWheelEvent *event)
 
     if (this->scrollBar_->isVisible())
     {
+        this->wheelScrollTimer_.start();
         float mouseMultiplier = getSettings()->mouseScrollMultiplier;
 
+        // Scrolling past the top (or bottom) of the shown messages pages in
+        // archived messages
+        bool pagedArchive = false;
+        if (event->angleDelta().y() > 0)
+        {
+            pagedArchive = this->scrollBar_->getDesiredValue() <=
+                               this->scrollBar_->getMinimum() &&
+                           this->showOlderArchivedMessages();
+        }
+        else
+        {
+            pagedArchive = this->scrollBar_->isAtBottom() &&
+                           this->showNewerArchivedMessages();
+        }
+        if (pagedArchive)
+        {
+            return;
+        }
+
         // This ensures snapshot won't be indexed out of bounds when scrolling really fast
         qreal desired = std::max<qreal>(0, this->scrollBar_->getDesiredValue());
         qreal delta = event->angleDelta().y() * qreal(1.5) * mouseMultiplier;
@@ -1,8 +1,8 @@
 #pragma once
 
 #include "common/FlagsEnum.hpp"
+#include "messages/ChunkedLimitedQueue.hpp"
 #include "messages/layouts/MessageLayoutContext.hpp"
-#include "messages/LimitedQueue.hpp"
 #include "messages/LimitedQueueSnapshot.hpp"
 #include "messages/MessageFlag.hpp"
 #include "messages/Selection.hpp"
@@ -11,6 +11,7 @@
 #include "widgets/TooltipWidget.hpp"
 
 #include <pajlada/signals/signal.hpp>
+#include <QElapsedTimer>
 #include <QGestureEvent>
 #include <QMenu>
 #include <QPaintEvent>
@@ -21,14 +22,18 @@
 #include <QWheelEvent>
 #include <QWidget>
 
+#include <functional>
+#include <optional>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace chatterino {
 enum class HighlightState;
 
 class Channel;
 using ChannelPtr = std::shared_ptr<Channel>;
+class TwitchChannel;
 
 struct Message;
 using MessagePtr = std::shared_ptr<const Message>;
@@ -280,6 +285,47 @@ private:
                          const MessagePtr &replacement);
     void messagesUpdated();
 
+    /// Loads the page of archived messages before the shown ones and shows
+    /// it in front of them, keeping the scroll position. No new messages are
+    /// shown until messagesUpdated() is called. Returns false if there are no
+    /// older messages.
+    bool showOlderArchivedMessages();
+    /// Loads the page of archived messages after the shown ones (or shows the
+    /// latest messages) and keeps the scroll position. Returns false if the
+    /// latest messages are shown.
+    bool showNewerArchivedMessages();
+    /// Loads the archived messages from `begin` up to `end` of `channel`
+    /// outside of the GUI thread and calls `onLoaded` with them followed by
+    /// `latest`, unless the view returned to the latest messages in the
+    /// meantime.
+    void loadArchivedMessages(
+        TwitchChannel &channel, size_t begin, size_t end,
+        std::vector<std::pair<size_t, MessagePtr>> latest,
+        std::function<void(std::vector<std::pair<size_t, MessagePtr>>)>
+            onLoaded);
+    /// Shows `messages` (starting at the archive index `begin`) in front of
+    /// the shown messages
+    void prependArchivedMessages(
+        size_t begin,
+        const std::vector<std::pair<size_t, MessagePtr>> &messages);
+    /// Shows `messages` after the shown messages and drops the ones before
+    /// the archive index `begin`
+    void appendArchivedMessages(
+        size_t begin,
+        const std::vector<std::pair<size_t, MessagePtr>> &messages);
+    MessageLayoutPtr makeArchivedLayout(const MessagePtr &message);
+    /// Replaces the shown messages with `layouts`, which have the archive
+    /// indices `indices`
+    void setArchivedLayouts(std::vector<MessageLayoutPtr> layouts,
+                            std::vector<size_t> indices);
+    /// The archive index of the `i`th shown message
+    size_t archiveIndexOf(size_t i) const;
+    /// The archive indices of the shown messages while the latest messages
+    /// of `channel` are shown
+    std::vector<size_t> latestMessageIndices(TwitchChannel &channel) const;
+    /// The underlying channel if it archived messages
+    TwitchChannel *archivingChannel() const;
+
     void performLayout(bool causedByScrollbar = false,
                        bool causedByShow = false);
     void layoutVisibleMessages(
@@ -332,6 +378,19 @@ private:
     bool lastMessageHasAlternateBackground_ = false;
     bool lastMessageHasAlternateBackgroundReverse_ = true;
 
+    /// The archive index of the first archived message that's shown. Unset
+    /// while the latest messages are shown.
+    std::optional<size_t> archivePosition_;
+    /// The archive index of every shown message while archived messages are
+    /// shown. Messages that are still in the channel have the index they'll
+    /// get once they're archived.
+    std::vector<size_t> archiveIndices_;
+    /// Whether a page of archived messages is being loaded
+    bool archiveLoading_ = false;
+    /// Incremented when the view returns to the latest messages, so pages
+    /// that were requested before are dropped
+    size_t archiveGeneration_ = 0;
+
     /// Tracks the area of animated elements in the last full repaint.
     /// If this is empty (QRect::isEmpty()), no animated element is shown.
     QRect animationArea_;
@@ -415,6 +474,8 @@ private:
     QPointF lastMiddlePressPosition_;
     QPointF currentMousePosition_;
     QTimer scrollTimer_;
+    /// Started on every scroll with the mouse wheel
+    QElapsedTimer wheelScrollTimer_;
 
     // We're only interested in the pointer, not the contents
     MessageLayout *highlightedMessage_ = nullptr;
@@ -432,7 +493,7 @@ private:
 
     const Context context_;
 
-    LimitedQueue<MessageLayoutPtr> messages_;
+    ChunkedLimitedQueue<MessageLayoutPtr> messages_;
 
     pajlada::Signals::SignalHolder signalHolder_;
 
@@ -190,6 +190,16 @@ void ResizingTextEdit::keyPressEvent(QKeyEvent *event)
             return;
         }
 
+#ifdef CHATTERINO_HAVE_PLUGINS
+        // Slow plugins complete after the first results are shown, their
+        // completions are appended without changing the selected one
+        auto currentRow = this->completer_->currentRow();
+        if (completionModel->applyDeferredCompletions())
+        {
+            this->completer_->setCurrentRow(currentRow);
+        }
+#endif
+
         // scrolling through selections
         if (event->key() == Qt::Key_Tab)
         {
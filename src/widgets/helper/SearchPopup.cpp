@@ -4,65 +4,32 @@
 #include "common/Channel.hpp"
 #include "controllers/filters/FilterSet.hpp"
 #include "controllers/hotkeys/HotkeyController.hpp"
+#include "messages/LimitedQueue.hpp"
+#include "messages/MergedSnapshots.hpp"
 #include "messages/MessageElement.hpp"
 #include "messages/search/AuthorPredicate.hpp"
 #include "messages/search/BadgePredicate.hpp"
 #include "messages/search/ChannelPredicate.hpp"
 #include "messages/search/LinkPredicate.hpp"
 #include "messages/search/MessageFlagsPredicate.hpp"
+#include "messages/search/MessageSearch.hpp"
 #include "messages/search/RegexPredicate.hpp"
 #include "messages/search/SubstringPredicate.hpp"
 #include "messages/search/SubtierPredicate.hpp"
 #include "singletons/Settings.hpp"
 #include "singletons/Theme.hpp"
 #include "singletons/WindowManager.hpp"
+#include "util/PostToThread.hpp"
 #include "widgets/helper/ChannelView.hpp"
 #include "widgets/splits/Split.hpp"
 
 #include <QHBoxLayout>
 #include <QLineEdit>
 #include <QPushButton>
+#include <QThreadPool>
 
 namespace chatterino {
 
-ChannelPtr SearchPopup::filter(const QString &text, const QString &channelName,
-                               const LimitedQueueSnapshot<MessagePtr> &snapshot)
-{
-    ChannelPtr channel(new Channel(channelName, Channel::Type::None));
-
-    // Parse predicates from tags in "text"
-    auto predicates = parsePredicates(text);
-
-    // Check for every message whether it fulfills all predicates that have
-    // been registered
-    for (size_t i = 0; i < snapshot.size(); ++i)
-    {
-        MessagePtr message = snapshot[i];
-
-        bool accept = true;
-        for (const auto &pred : predicates)
-        {
-            // Discard the message as soon as one predicate fails
-            if (!pred->appliesTo(*message))
-            {
-                accept = false;
-                break;
-            }
-        }
-
-        // If all predicates match, add the message to the channel
-        if (accept)
-        {
-            auto overrideFlags = std::optional<MessageFlags>(message->flags);
-            overrideFlags->set(MessageFlag::DoNotLog);
-
-            channel->addMessage(message, MessageContext::Repost, overrideFlags);
-        }
-    }
-
-    return channel;
-}
-
 SearchPopup::SearchPopup(QWidget *parent, Split *split)
     : BasePopup(
           {
@@ -224,13 +191,72 @@ void SearchPopup::themeChangedEvent()
 
 void SearchPopup::search()
 {
-    if (this->snapshot_.size() == 0)
+    if (!this->messageSearch_ || this->messageSearch_->messages().size() == 0)
     {
-        this->snapshot_ = this->buildSnapshot();
+        this->messageSearch_ =
+            std::make_shared<const MessageSearch>(this->buildSnapshot());
+        this->lastResults_.reset();
     }
 
-    this->channelView_->setChannel(filter(this->searchInput_->text(),
-                                          this->channelName_, this->snapshot_));
+    auto query = this->searchInput_->text();
+
+    // Parse predicates from tags in the query
+    auto predicates = std::make_shared<
+        const std::vector<std::unique_ptr<MessagePredicate>>>(
+        parsePredicates(query));
+
+    // If the query was only extended, only the last results have to be checked
+    std::shared_ptr<const std::vector<size_t>> candidates;
+    if (this->lastResults_ && MessageSearch::narrows(this->lastQuery_, query))
+    {
+        candidates = this->lastResults_;
+    }
+
+    // Cancels the previous search
+    CancellationToken token(false);
+    this->searchToken_ = token;
+
+    auto messageSearch = this->messageSearch_;
+    QThreadPool::globalInstance()->start([this, token, query, predicates,
+                                          candidates, messageSearch] {
+        auto results =
+            messageSearch->search(*predicates, candidates.get(), token);
+        if (!results)
+        {
+            return;
+        }
+
+        postToThread([this, token, query,
+                      results = std::make_shared<const std::vector<size_t>>(
+                          std::move(*results))]() mutable {
+            // the popup was closed or another search was started
+            if (token.isCancelled())
+            {
+                return;
+            }
+            this->showResults(query, std::move(results));
+        });
+    });
+}
+
+void SearchPopup::showResults(
+    const QString &query, std::shared_ptr<const std::vector<size_t>> results)
+{
+    ChannelPtr channel(new Channel(this->channelName_, Channel::Type::None));
+
+    const auto &messages = this->messageSearch_->messages();
+    for (auto position : *results)
+    {
+        const auto &message = messages[position];
+        auto overrideFlags = std::optional<MessageFlags>(message->flags);
+        overrideFlags->set(MessageFlag::DoNotLog);
+
+        channel->addMessage(message, MessageContext::Repost, overrideFlags);
+    }
+
+    this->channelView_->setChannel(channel);
+    this->lastQuery_ = query;
+    this->lastResults_ = std::move(results);
 }
 
 LimitedQueueSnapshot<MessagePtr> SearchPopup::buildSnapshot()
@@ -242,46 +268,27 @@ LimitedQueueSnapshot<MessagePtr> SearchPopup::buildSnapshot()
         return channelPtr.get().channel()->getMessageSnapshot();
     }
 
-    auto combinedSnapshot = std::vector<std::shared_ptr<const Message>>{};
+    MergedSnapshots merged;
     for (auto &channel : this->searchChannels_)
     {
         ChannelView &sharedView = channel.get();
 
         const FilterSetPtr filterSet = sharedView.getFilterSet();
-        const LimitedQueueSnapshot<MessagePtr> &snapshot =
-            sharedView.channel()->getMessageSnapshot();
-
-        for (const auto &message : snapshot)
+        MergedSnapshots::Filter filter;
+        if (filterSet)
         {
-            if (filterSet && !filterSet->filter(message, sharedView.channel()))
-            {
-                continue;
-            }
-
-            combinedSnapshot.push_back(message);
+            filter = [filterSet, sharedChannel = sharedView.channel()](
+                         const MessagePtr &message) {
+                return filterSet->filter(message, sharedChannel);
+            };
         }
+        merged.add(sharedView.channel()->getMessageSnapshot(),
+                   std::move(filter));
     }
 
-    // remove any duplicate messages from splits containing the same channel
-    std::sort(combinedSnapshot.begin(), combinedSnapshot.end(),
-              [](MessagePtr &a, MessagePtr &b) {
-                  return a->id > b->id;
-              });
-
-    auto uniqueIterator =
-        std::unique(combinedSnapshot.begin(), combinedSnapshot.end(),
-                    [](MessagePtr &a, MessagePtr &b) {
-                        // nullptr check prevents system messages from being dropped
-                        return (a->id != nullptr) && a->id == b->id;
-                    });
-
-    combinedSnapshot.erase(uniqueIterator, combinedSnapshot.end());
-
-    // resort by time for presentation
-    std::sort(combinedSnapshot.begin(), combinedSnapshot.end(),
-              [](MessagePtr &a, MessagePtr &b) {
-                  return a->serverReceivedTime < b->serverReceivedTime;
-              });
+    // splits containing the same channel have the same messages, these are
+    // only added once
+    auto combinedSnapshot = merged.collect();
 
     auto queue = LimitedQueue<MessagePtr>(combinedSnapshot.size());
     queue.pushFront(combinedSnapshot);
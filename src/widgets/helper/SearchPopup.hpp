@@ -2,9 +2,11 @@
 
 #include "ForwardDecl.hpp"
 #include "messages/LimitedQueueSnapshot.hpp"
+#include "util/CancellationToken.hpp"
 #include "widgets/BasePopup.hpp"
 
 #include <memory>
+#include <vector>
 
 class QLineEdit;
 
@@ -12,6 +14,7 @@ namespace chatterino {
 
 class Split;
 class MessagePredicate;
+class MessageSearch;
 
 class SearchPopup : public BasePopup
 {
@@ -40,20 +43,9 @@ private:
     void addShortcuts() override;
     LimitedQueueSnapshot<MessagePtr> buildSnapshot();
 
-    /**
-     * @brief Only retains those message from a list of messages that satisfy a
-     *        search query.
-     *
-     * @param text          the search query -- will be parsed for MessagePredicates
-     * @param channelName   name of the channel to be returned
-     * @param snapshot      list of messages to filter
-     * @param filterSet     channel filter to apply
-     *
-     * @return a ChannelPtr with "channelName" and the filtered messages from
-     *         "snapshot"
-     */
-    static ChannelPtr filter(const QString &text, const QString &channelName,
-                             const LimitedQueueSnapshot<MessagePtr> &snapshot);
+    /// Shows the messages at `results` in the channel view
+    void showResults(const QString &query,
+                     std::shared_ptr<const std::vector<size_t>> results);
 
     /**
      * @brief Checks the input for tags and registers their corresponding
@@ -65,7 +57,11 @@ private:
     static std::vector<std::unique_ptr<MessagePredicate>> parsePredicates(
         const QString &input);
 
-    LimitedQueueSnapshot<MessagePtr> snapshot_;
+    std::shared_ptr<const MessageSearch> messageSearch_;
+    /// The query and results of the last finished search
+    QString lastQuery_;
+    std::shared_ptr<const std::vector<size_t>> lastResults_;
+    ScopedCancellationToken searchToken_;
     QLineEdit *searchInput_{};
     ChannelView *channelView_{};
     QString channelName_{};
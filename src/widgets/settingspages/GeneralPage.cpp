@@ -1319,6 +1319,21 @@ void GeneralPage::initLayout(GeneralPageView &layout)
                        s.scrollbackSplitLimit, 100, 100000, 100);
     layout.addIntInput("Usercard scrollback limit (requires restart)",
                        s.scrollbackUsercardLimit, 100, 100000, 100);
+    layout.addIntInput(
+        "Image decoder threads, 0 for automatic (requires restart)",
+        s.imageDecoderThreads, 0, 16, 1);
+    layout.addIntInput("Image memory budget in MiB, 0 for unlimited",
+                       s.imageMemoryBudget, 0, 16384, 128);
+    layout.addIntInput("Decoded image disk cache in MiB, 0 to disable",
+                       s.imageFrameCacheSize, 0, 16384, 128);
+    layout.addIntInput("Network response disk cache in MiB, 0 to disable",
+                       s.networkCacheSize, 0, 16384, 128);
+    layout.addIntInput("Messages per channel kept on disk beyond the "
+                       "scrollback limit, 0 to disable",
+                       s.scrollbackArchiveLimit, 0, 10000000, 10000);
+    layout.addIntInput("Message builder threads, 0 to build messages in the "
+                       "GUI thread (experimental, requires restart)",
+                       s.messageBuilderThreads, 0, 16, 1);
 
     SettingWidget::dropdown("Show blocked term automod messages",
                             s.showBlockedTermAutomodMessages)
@@ -3,6 +3,7 @@
 
 #    include "Application.hpp"
 #    include "common/Args.hpp"
+#    include "controllers/plugins/Plugin.hpp"
 #    include "controllers/plugins/PluginController.hpp"
 #    include "singletons/Paths.hpp"
 #    include "singletons/Settings.hpp"
@@ -18,6 +19,27 @@
 #    include <QPushButton>
 #    include <QWidget>
 
+#    include <chrono>
+
+namespace {
+
+using namespace chatterino;
+
+QString formatCallbackStats(const PluginCallbackStats &stats)
+{
+    auto ms = [](std::chrono::nanoseconds duration) {
+        return QString::number(
+            std::chrono::duration<double, std::milli>(duration).count(), 'f',
+            1);
+    };
+    return QString("%1 calls, %2 aborted, %3 ms on average, %4 ms at most")
+        .arg(stats.calls)
+        .arg(stats.aborted)
+        .arg(ms(stats.average()), ms(stats.max));
+}
+
+}  // namespace
+
 namespace chatterino {
 
 PluginsPage::PluginsPage()
@@ -176,6 +198,24 @@ void PluginsPage::rebuildContent()
         }
         pluginEntry->addRow("Commands",
                             new QLabel(commandsTxt, this->dataFrame_));
+
+        // How long the callbacks took since the plugin was loaded
+        auto completionStats = plugin->callbackStats.find(
+            lua::api::EventType::CompletionRequested);
+        if (completionStats != plugin->callbackStats.end())
+        {
+            pluginEntry->addRow(
+                "Completion calls",
+                new QLabel(formatCallbackStats(completionStats->second),
+                           this->dataFrame_));
+        }
+        if (plugin->commandStats.calls > 0)
+        {
+            pluginEntry->addRow(
+                "Command calls",
+                new QLabel(formatCallbackStats(plugin->commandStats),
+                           this->dataFrame_));
+        }
         if (!plugin->meta.permissions.empty())
         {
             QString perms = "<ul>";
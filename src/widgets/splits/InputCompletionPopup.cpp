@@ -66,7 +66,8 @@ std::unique_ptr<completion::Source> InputCompletionPopup::getSource() const
             {
                 return std::make_unique<completion::EmoteSource>(
                     this->currentChannel_.get(),
-                    std::make_unique<completion::SmartEmoteStrategy>(),
+                    std::make_unique<completion::SmartEmoteStrategy>(
+                        MAX_ENTRY_COUNT),
                     this->callback_);
             }
             return std::make_unique<completion::EmoteSource>(
@@ -0,0 +1,93 @@
+#include "util/AhoCorasick.hpp"
+
+#include "Test.hpp"
+
+#include <utility>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+using Matches = std::vector<std::pair<size_t, qsizetype>>;
+
+Matches findAll(const AhoCorasick &automaton, const QString &text)
+{
+    Matches matches;
+    automaton.forEachMatch(text, [&](size_t pattern, qsizetype end) {
+        matches.emplace_back(pattern, end);
+        return true;
+    });
+    return matches;
+}
+
+}  // namespace
+
+TEST(AhoCorasick, Empty)
+{
+    AhoCorasick automaton;
+    EXPECT_TRUE(automaton.empty());
+    EXPECT_TRUE(findAll(automaton, "foo").empty());
+
+    automaton = AhoCorasick({"", ""}, Qt::CaseSensitive);
+    EXPECT_TRUE(automaton.empty());
+    EXPECT_TRUE(findAll(automaton, "foo").empty());
+}
+
+TEST(AhoCorasick, Overlapping)
+{
+    AhoCorasick automaton({"he", "she", "his", "hers", ""}, Qt::CaseSensitive);
+    EXPECT_FALSE(automaton.empty());
+
+    EXPECT_EQ(findAll(automaton, "ushers"), (Matches{
+                                                {1, 4},
+                                                {0, 4},
+                                                {3, 6},
+                                            }));
+    EXPECT_EQ(findAll(automaton, "ahishers"), (Matches{
+                                                  {2, 4},
+                                                  {1, 6},
+                                                  {0, 6},
+                                                  {3, 8},
+                                              }));
+    EXPECT_TRUE(findAll(automaton, "HERS").empty());
+    EXPECT_TRUE(findAll(automaton, "").empty());
+}
+
+TEST(AhoCorasick, Duplicates)
+{
+    AhoCorasick automaton({"a", "aa", "a"}, Qt::CaseSensitive);
+
+    EXPECT_EQ(findAll(automaton, "aa"), (Matches{
+                                            {0, 1},
+                                            {2, 1},
+                                            {1, 2},
+                                            {0, 2},
+                                            {2, 2},
+                                        }));
+}
+
+TEST(AhoCorasick, CaseInsensitive)
+{
+    AhoCorasick automaton({"Kappa", "ÖL"}, Qt::CaseInsensitive);
+
+    EXPECT_EQ(findAll(automaton, "kappa KAPPA"), (Matches{
+                                                     {0, 5},
+                                                     {0, 11},
+                                                 }));
+    EXPECT_EQ(findAll(automaton, "öl"), (Matches{{1, 2}}));
+    // The Kelvin sign folds to 'k'
+    EXPECT_EQ(findAll(automaton, "\u212Aappa"), (Matches{{0, 5}}));
+}
+
+TEST(AhoCorasick, Stop)
+{
+    AhoCorasick automaton({"a"}, Qt::CaseSensitive);
+
+    size_t calls = 0;
+    automaton.forEachMatch(u"aaaa", [&](size_t /*pattern*/, qsizetype end) {
+        calls++;
+        return end < 2;
+    });
+    EXPECT_EQ(calls, 2);
+}
@@ -4,6 +4,10 @@
 
 #include <QStringList>
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 using namespace chatterino;
 
 TEST(ChatterSet, insert)
@@ -85,3 +89,62 @@ TEST(ChatterSet, MaxSizeLastUsed)
     EXPECT_TRUE(set.contains("pajlada"));
     EXPECT_TRUE(set.contains("Pajlada"));
 }
+
+TEST(ChatterSet, FilterByPrefix)
+{
+    ChatterSet set;
+    set.addRecentChatter("pajlada");
+    set.addRecentChatter("Forsen");
+    set.addRecentChatter("pajbot");
+    set.addRecentChatter("nymn");
+    set.addRecentChatter("Pajlada");
+
+    using Chatters = std::vector<std::pair<QString, QString>>;
+
+    // the most recent chatters come first
+    EXPECT_EQ(set.filterByPrefix("PAJ"), (Chatters{
+                                             {"pajlada", "Pajlada"},
+                                             {"pajbot", "pajbot"},
+                                         }));
+    EXPECT_EQ(set.filterByPrefix("f"), (Chatters{{"forsen", "Forsen"}}));
+    EXPECT_EQ(set.filterByPrefix("").size(), 4);
+    EXPECT_TRUE(set.filterByPrefix("pajladas").empty());
+    EXPECT_TRUE(set.filterByPrefix("z").empty());
+}
+
+TEST(ChatterSet, FilterByPrefixEvicted)
+{
+    ChatterSet set(3);
+    set.addRecentChatter("a1");
+    set.addRecentChatter("a2");
+    set.addRecentChatter("a3");
+    set.addRecentChatter("a1");
+    set.addRecentChatter("b1");
+
+    // a2 was the least recent chatter
+    EXPECT_FALSE(set.contains("a2"));
+    EXPECT_EQ(set.filterByPrefix("a"),
+              (std::vector<std::pair<QString, QString>>{
+                  {"a1", "a1"},
+                  {"a3", "a3"},
+              }));
+}
+
+TEST(ChatterSet, FilterByPrefixOnline)
+{
+    ChatterSet set;
+    set.addRecentChatter("Pajlada");
+    set.addRecentChatter("pajbot");
+
+    set.updateOnlineChatters({"pajlada", "paj"});
+
+    EXPECT_FALSE(set.contains("pajbot"));
+    using Chatter = std::pair<QString, QString>;
+    auto chatters = set.filterByPrefix("paj");
+    ASSERT_EQ(chatters.size(), 2);
+    // the original case is kept
+    EXPECT_NE(std::ranges::find(chatters, Chatter{"pajlada", "Pajlada"}),
+              chatters.end());
+    EXPECT_NE(std::ranges::find(chatters, Chatter{"paj", "paj"}),
+              chatters.end());
+}
@@ -92,6 +92,9 @@ TEST(Emojis, Parse)
     auto coupleKissTone1Tone2 =
         getEmoji("1F9D1-1F3FB-200D-2764-FE0F-200D-1F48B-200D-1F9D1-1F3FC");
     auto hearHands = getEmoji("1FAF6");
+    auto keycapHash = getEmoji("0023-FE0F-20E3");
+    auto keycapOne = getEmoji("0031-FE0F-20E3");
+    auto tradeMark = getEmoji("2122-FE0F");
 
     const std::vector<TestCase> tests{
         {
@@ -156,6 +159,20 @@ TEST(Emojis, Parse)
             "\U0001FAF6",
             {coupleKissTone1Tone2, coupleKissTone1Tone2, hearHands},
         },
+        {
+            // keycaps start with ASCII characters
+            u"# 1 #1 abc#\uFE0F\u20E3 1\u20E3abcdefgh"_s,
+            {"# 1 #1 abc", keycapHash, " ", keycapOne, "abcdefgh"},
+        },
+        {
+            // trade mark, qualified and non-qualified
+            u"abcdefgh\u2122\uFE0Fabc\u2122"_s,
+            {"abcdefgh", tradeMark, "abc", tradeMark},
+        },
+        {
+            "a longer message without any emojis 1234567890",
+            {"a longer message without any emojis 1234567890"},
+        },
     };
 
     for (const auto &test : tests)
@@ -0,0 +1,124 @@
+#include "controllers/completion/sources/EmoteCompletionIndex.hpp"
+
+#include "common/Literals.hpp"
+#include "messages/Emote.hpp"
+#include "providers/emoji/Emojis.hpp"
+#include "Test.hpp"
+
+#include <memory>
+#include <vector>
+
+using namespace chatterino;
+using namespace chatterino::completion;
+using namespace literals;
+
+namespace {
+
+std::shared_ptr<const EmoteMap> makeEmotes(const std::vector<QString> &names)
+{
+    auto map = std::make_shared<EmoteMap>();
+    for (const auto &name : names)
+    {
+        EmoteName emoteName{.string = name};
+        map->emplace(emoteName, std::make_shared<const Emote>(Emote{
+                                    .name = emoteName,
+                                }));
+    }
+    return map;
+}
+
+std::vector<EmojiPtr> makeEmojis()
+{
+    auto emoji = std::make_shared<EmojiData>();
+    emoji->shortCodes = {u"thinking"_s, u"thinking_face"_s};
+    return {emoji};
+}
+
+std::vector<QString> tabNames(const EmoteCompletionIndex &index)
+{
+    std::vector<QString> names;
+    for (const auto &item : index.items())
+    {
+        names.push_back(item.tabCompletionName);
+    }
+    return names;
+}
+
+}  // namespace
+
+TEST(EmoteCompletionIndex, Items)
+{
+    auto emojis = makeEmojis();
+    EmoteCompletionIndex index(
+        {
+            {makeEmotes({u"Kappa"_s}), u"Twitch Emote"_s},
+            {nullptr, u"Channel 7TV"_s},
+            {makeEmotes({u"PAJAW"_s}), u"Global 7TV"_s},
+        },
+        emojis);
+
+    ASSERT_EQ(tabNames(index),
+              (std::vector<QString>{u"Kappa"_s, u"PAJAW"_s, u":thinking:"_s,
+                                    u":thinking_face:"_s}));
+
+    const auto &items = index.items();
+    ASSERT_EQ(items[0].providerName, u"Twitch Emote"_s);
+    ASSERT_EQ(items[0].searchKey, u"kappa"_s);
+    ASSERT_EQ(items[1].providerName, u"Global 7TV"_s);
+    ASSERT_EQ(items[1].searchKey, u"pajaw"_s);
+    ASSERT_TRUE(items[2].isEmoji);
+    ASSERT_EQ(items[2].searchName, u"thinking"_s);
+}
+
+TEST(EmoteCompletionIndex, Cache)
+{
+    auto emojis = makeEmojis();
+    auto twitch = makeEmotes({u"Kappa"_s});
+    auto seventv = makeEmotes({u"Clap"_s});
+
+    EmoteCompletionIndexCache cache;
+    auto index = cache.get(
+        {
+            {twitch, u"Twitch Emote"_s},
+            {seventv, u"Channel 7TV"_s},
+        },
+        emojis);
+    ASSERT_EQ(tabNames(*index),
+              (std::vector<QString>{u"Kappa"_s, u"Clap"_s, u":thinking:"_s,
+                                    u":thinking_face:"_s}));
+
+    // nothing changed
+    ASSERT_EQ(cache.get(
+                  {
+                      {twitch, u"Twitch Emote"_s},
+                      {seventv, u"Channel 7TV"_s},
+                  },
+                  emojis),
+              index);
+
+    // a live update replaced the 7TV emotes
+    auto updated = cache.get(
+        {
+            {twitch, u"Twitch Emote"_s},
+            {makeEmotes({u"Clap2"_s}), u"Channel 7TV"_s},
+        },
+        emojis);
+    ASSERT_NE(updated, index);
+    ASSERT_EQ(tabNames(*updated),
+              (std::vector<QString>{u"Kappa"_s, u"Clap2"_s, u":thinking:"_s,
+                                    u":thinking_face:"_s}));
+    ASSERT_EQ(updated->items()[0].emote, index->items()[0].emote);
+
+    // more emojis were loaded
+    auto emoji = std::make_shared<EmojiData>();
+    emoji->shortCodes = {u"salt"_s};
+    emojis.push_back(emoji);
+    updated = cache.get(
+        {
+            {twitch, u"Twitch Emote"_s},
+        },
+        emojis);
+    ASSERT_EQ(tabNames(*updated),
+              (std::vector<QString>{u"Kappa"_s, u":thinking:"_s,
+                                    u":thinking_face:"_s, u":salt:"_s}));
+}
@@ -1,6 +1,7 @@
 #include "controllers/accounts/AccountController.hpp"
 #include "controllers/filters/lang/expressions/UnaryOperation.hpp"
 #include "controllers/filters/lang/Filter.hpp"
+#include "controllers/filters/lang/FilterContext.hpp"
 #include "controllers/filters/lang/Types.hpp"
 #include "controllers/highlights/HighlightController.hpp"
 #include "messages/MessageBuilder.hpp"
@@ -15,6 +16,7 @@
 #include "providers/ffz/FfzBadges.hpp"
 #include "providers/seventv/SeventvBadges.hpp"
 #include "providers/twitch/TwitchBadge.hpp"
+#include "providers/twitch/TwitchIrcLine.hpp"
 #include "Test.hpp"
 
 #include <QColor>
@@ -285,8 +287,11 @@ TEST_F(FiltersF, TypingContextChecks)
 
     QString originalMessage = privmsg->content();
 
+    auto line = TwitchIrcLine::parse(message);
+    ASSERT_TRUE(line.has_value());
+
     auto [msg, alert] = MessageBuilder::makeIrcMessage(
-        &channel, privmsg, MessageParseArgs{}, originalMessage, 0);
+        &channel, *line, MessageParseArgs{}, originalMessage, 0);
 
     EXPECT_NE(msg.get(), nullptr);
 
@@ -297,6 +302,87 @@ TEST_F(FiltersF, TypingContextChecks)
     delete privmsg;
 }
 
+TEST_F(FiltersF, CompiledEvaluation)
+{
+    MockChannel channel("pajlada");
+
+    QByteArray message =
+        R"(@badge-info=subscriber/80;badges=broadcaster/1,subscriber/3072,partner/1;color=#CC44FF;display-name=pajlada;emote-only=1;emotes=25:0-4;first-msg=0;flags=;id=90ef1e46-8baa-4bf2-9c54-272f39d6fa11;mod=0;returning-chatter=0;room-id=11148817;subscriber=1;tmi-sent-ts=1662206235860;turbo=0;user-id=11148817;user-type= :pajlada!pajlada@pajlada.tmi.twitch.tv PRIVMSG #pajlada :ACTION Kappa 2038-01-19)";
+
+    auto *privmsg = dynamic_cast<Communi::IrcPrivateMessage *>(
+        Communi::IrcPrivateMessage::fromData(message, nullptr));
+    ASSERT_NE(privmsg, nullptr);
+
+    QString originalMessage = privmsg->content();
+
+    auto line = TwitchIrcLine::parse(message);
+    ASSERT_TRUE(line.has_value());
+
+    auto [msg, alert] = MessageBuilder::makeIrcMessage(
+        &channel, *line, MessageParseArgs{}, originalMessage, 0);
+    ASSERT_NE(msg.get(), nullptr);
+
+    // clang-format off
+    std::vector<QString> tests{
+        R".(1 + 1).",
+        R".(8 / 3 + 7 % 3 - 2 * 4).",
+        R".(!(1 == 1)).",
+        R".(1 > 2 || 3 >= 3).",
+        R".(1 > 2 && 3 > 1).",
+        R".("abc" + 123).",
+        R".("abc" + "456").",
+        R".("abc" + author.subbed).",
+        R".(5 == "5").",
+        R".(5 != "abc").",
+        R".(author.name == "PAJLADA").",
+        R".(author.name != "forsen").",
+        R".(author.color == "#cc44ff").",
+        R".(author.no_color).",
+        R".(author.subbed && author.sub_length > 12).",
+        R".(author.sub_length).",
+        R".(author.user_id startswith "111").",
+        R".(author.badges contains "BROADCASTER").",
+        R".(author.badges startswith "broadcaster").",
+        R".(author.badges endswith "subscriber").",
+        R".(author.badges contains 5).",
+        R".(channel.name endswith "lada" && !channel.watching).",
+        R".(channel.live || flags.highlighted).",
+        R".(flags.action && !flags.reply).",
+        R".(message.content contains "kappa").",
+        R".(message.content match r"(\d\d\d\d)\-(\d\d)").",
+        R".(message.content match {r"(\d\d\d\d)\-(\d\d)\-(\d\d)", 3}).",
+        R".(message.content match ri"KAPPA").",
+        R".(message.length + 1).",
+        R".({"abc", "def"} contains "ABC").",
+        R".({123, "def"} contains "DEF").",
+        R".({} startswith "A123").",
+        R".({author.name, channel.name} contains "pajlada").",
+        R".(reward.cost == -1 && reward.title == "").",
+    };
+    // clang-format on
+
+    auto contextMap = buildContextMap(msg, &channel);
+
+    for (const auto &input : tests)
+    {
+        auto filterResult = Filter::fromString(input);
+        const auto *filter = std::get_if<Filter>(&filterResult);
+        ASSERT_NE(filter, nullptr)
+            << "Filter::fromString( " << input << " ) is invalid";
+
+        FilterContext context(msg, &channel);
+        auto expected = filter->execute(contextMap);
+        auto actual = valueToVariant(filter->execute(context));
+
+        EXPECT_EQ(actual, expected)
+            << "Filter{ " << input << " } compiled to " << actual.toString()
+            << " instead of " << expected.toString()
+            << ".\nDebug: " << filter->debugString(MESSAGE_TYPING_CONTEXT);
+    }
+
+    delete privmsg;
+}
+
 TEST_F(FiltersF, ExpressionDebug)
 {
     struct TestCase {
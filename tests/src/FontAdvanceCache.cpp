@@ -0,0 +1,37 @@
+#include "singletons/Fonts.hpp"
+
+#include "common/Literals.hpp"
+#include "Test.hpp"
+
+#include <QFont>
+#include <QFontMetrics>
+#include <QString>
+
+using namespace chatterino;
+using namespace literals;
+
+TEST(FontAdvanceCache, MatchesFontMetrics)
+{
+    QFont font(u"Monospace"_s, 12);
+    QFontMetrics metrics(font);
+    FontAdvanceCache cache(font);
+
+    for (const auto &word : {u"forsen"_s, u"W"_s, u""_s, u"ÄÖÜ 🙂"_s})
+    {
+        auto expected = metrics.horizontalAdvance(word);
+        // the second lookup is cached
+        ASSERT_EQ(cache.horizontalAdvance(word), expected);
+        ASSERT_EQ(cache.horizontalAdvance(word), expected);
+    }
+
+    for (auto c : u"abc Ä"_s)
+    {
+        ASSERT_EQ(cache.horizontalAdvance(c), metrics.horizontalAdvance(c));
+        ASSERT_EQ(cache.horizontalAdvance(c), metrics.horizontalAdvance(c));
+    }
+
+    auto emoji = u"🙂"_s;
+    ASSERT_EQ(cache.horizontalAdvance(
+                  QChar::surrogateToUcs4(emoji.at(0), emoji.at(1))),
+              metrics.horizontalAdvance(emoji));
+}
@@ -0,0 +1,435 @@
+#include "providers/twitch/api/HelixScheduler.hpp"
+
+#include "common/Literals.hpp"
+#include "common/network/NetworkRequest.hpp"
+#include "common/network/NetworkResult.hpp"
+#include "NetworkHelpers.hpp"
+#include "Test.hpp"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QStringList>
+#include <QUrl>
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <thread>
+
+using namespace chatterino;
+using namespace literals;
+using namespace std::chrono_literals;
+
+namespace {
+
+QString url(const QString &path)
+{
+    return QString(HTTPBIN_BASE_URL) + path;
+}
+
+/// Asks httpbox to respond with the rate limit headers Twitch sends
+QString ratelimitURL(int remaining, std::chrono::seconds resetIn)
+{
+    auto reset = QDateTime::currentSecsSinceEpoch() + resetIn.count();
+    return url(u"/response-headers?Ratelimit-Remaining=%1&Ratelimit-Reset=%2"_s
+                   .arg(remaining)
+                   .arg(reset));
+}
+
+HelixScheduler::MakeGet makeGet(HelixScheduler *&scheduler,
+                                std::vector<QUrlQuery> &queries)
+{
+    return [&scheduler, &queries](const QString &endpoint,
+                                  const QUrlQuery &urlQuery,
+                                  HelixPriority priority) {
+        queries.push_back(urlQuery);
+        auto query = urlQuery;
+        query.addQueryItem(u"endpoint"_s, endpoint);
+        QUrl full(url(u"/get"_s));
+        full.setQuery(query);
+        return NetworkRequest(full).scheduler(scheduler->lane(priority));
+    };
+}
+
+/// Answers batches with the items `respond` returns for their query in a
+/// `data` array, like Helix does
+HelixScheduler::MakeGet makeBatchGet(
+    HelixScheduler *&scheduler, std::vector<QUrlQuery> &queries,
+    std::function<QJsonArray(const QUrlQuery &)> respond)
+{
+    return [&scheduler, &queries, respond](const QString & /*endpoint*/,
+                                           const QUrlQuery &urlQuery,
+                                           HelixPriority priority) {
+        queries.push_back(urlQuery);
+        // httpbox responds with the body of POST requests
+        return NetworkRequest(url(u"/post"_s), NetworkRequestType::Post)
+            .json(QJsonObject{{u"data"_s, respond(urlQuery)}})
+            .scheduler(scheduler->lane(priority));
+    };
+}
+
+/// Processes events until `done` returns true
+bool waitUntil(const std::function<bool()> &done)
+{
+    auto start = std::chrono::steady_clock::now();
+    while (!done())
+    {
+        if (std::chrono::steady_clock::now() - start > 30s)
+        {
+            return false;
+        }
+        QCoreApplication::processEvents(QEventLoop::AllEvents);
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+void get(HelixScheduler &scheduler, const QString &requestURL,
+         HelixPriority priority, std::function<void(int)> onDone)
+{
+    NetworkRequest(requestURL)
+        .scheduler(scheduler.lane(priority))
+        .onSuccess([onDone](const NetworkResult &result) {
+            onDone(result.status().value_or(0));
+        })
+        .onError([onDone](const NetworkResult &result) {
+            onDone(result.status().value_or(0));
+        })
+        .execute();
+}
+
+}  // namespace
+
+TEST(HelixScheduler, MergeIdenticalRequests)
+{
+    std::vector<QUrlQuery> queries;
+    HelixScheduler *self = nullptr;
+    HelixScheduler scheduler(makeGet(self, queries));
+    self = &scheduler;
+
+    std::vector<int> statuses;
+    auto onDone = [&](int status) {
+        statuses.push_back(status);
+    };
+    get(scheduler, url(u"/get?a=1"_s), HelixPriority::Background, onDone);
+    get(scheduler, url(u"/get?a=1"_s), HelixPriority::Interactive, onDone);
+    get(scheduler, url(u"/get?a=2"_s), HelixPriority::Interactive, onDone);
+
+    ASSERT_TRUE(waitUntil([&] {
+        return statuses.size() == 3;
+    }));
+    ASSERT_EQ(statuses, std::vector<int>({200, 200, 200}));
+    ASSERT_EQ(scheduler.sentRequests(), 2U);
+
+    // requests that finished aren't merged anymore
+    get(scheduler, url(u"/get?a=1"_s), HelixPriority::Interactive, onDone);
+    ASSERT_TRUE(waitUntil([&] {
+        return statuses.size() == 4;
+    }));
+    ASSERT_EQ(scheduler.sentRequests(), 3U);
+}
+
+TEST(HelixScheduler, InteractiveFirst)
+{
+    std::vector<QUrlQuery> queries;
+    HelixScheduler *self = nullptr;
+    HelixScheduler scheduler(makeGet(self, queries), 1);
+    self = &scheduler;
+
+    std::vector<QString> order;
+    auto track = [&](const QString &name) {
+        return [&order, name](int /*status*/) {
+            order.push_back(name);
+        };
+    };
+    get(scheduler, url(u"/get?r=a"_s), HelixPriority::Background,
+        track(u"a"_s));
+    get(scheduler, url(u"/get?r=b"_s), HelixPriority::Background,
+        track(u"b"_s));
+    get(scheduler, url(u"/get?r=c"_s), HelixPriority::Interactive,
+        track(u"c"_s));
+    ASSERT_EQ(scheduler.sentRequests(), 1U);
+
+    ASSERT_TRUE(waitUntil([&] {
+        return order.size() == 3;
+    }));
+    ASSERT_EQ(order, std::vector<QString>({u"a"_s, u"c"_s, u"b"_s}));
+}
+
+TEST(HelixScheduler, WaitForRatelimitReset)
+{
+    std::vector<QUrlQuery> queries;
+    HelixScheduler *self = nullptr;
+    HelixScheduler scheduler(makeGet(self, queries));
+    self = &scheduler;
+
+    int done = 0;
+    auto onDone = [&](int status) {
+        ASSERT_EQ(status, 200);
+        done++;
+    };
+    get(scheduler, ratelimitURL(0, 2s), HelixPriority::Interactive, onDone);
+    ASSERT_TRUE(waitUntil([&] {
+        return done == 1;
+    }));
+    ASSERT_EQ(scheduler.ratelimitRemaining(), 0);
+
+    // the bucket is empty, so this waits for the reset
+    get(scheduler, url(u"/get?after=reset"_s), HelixPriority::Interactive,
+        onDone);
+    ASSERT_EQ(scheduler.sentRequests(), 1U);
+
+    ASSERT_TRUE(waitUntil([&] {
+        return done == 2;
+    }));
+    ASSERT_EQ(scheduler.sentRequests(), 2U);
+}
+
+TEST(HelixScheduler, BackgroundReserve)
+{
+    std::vector<QUrlQuery> queries;
+    HelixScheduler *self = nullptr;
+    HelixScheduler scheduler(makeGet(self, queries));
+    self = &scheduler;
+
+    int done = 0;
+    auto onDone = [&](int /*status*/) {
+        done++;
+    };
+    get(scheduler, ratelimitURL(HelixScheduler::BACKGROUND_RESERVE, 60s),
+        HelixPriority::Interactive, onDone);
+    ASSERT_TRUE(waitUntil([&] {
+        return done == 1;
+    }));
+    ASSERT_EQ(scheduler.ratelimitRemaining(),
+              HelixScheduler::BACKGROUND_RESERVE);
+
+    // the remaining points are reserved for interactive requests
+    get(scheduler, url(u"/get?r=background"_s), HelixPriority::Background,
+        onDone);
+    ASSERT_EQ(scheduler.sentRequests(), 1U);
+
+    get(scheduler, url(u"/get?r=interactive"_s), HelixPriority::Interactive,
+        onDone);
+    ASSERT_EQ(scheduler.sentRequests(), 2U);
+    ASSERT_TRUE(waitUntil([&] {
+        return done == 2;
+    }));
+}
+
+TEST(HelixScheduler, Batch)
+{
+    std::vector<QUrlQuery> queries;
+    HelixScheduler *self = nullptr;
+    // only users with an even ID exist
+    HelixScheduler scheduler(
+        makeBatchGet(self, queries, [](const QUrlQuery &query) {
+            QJsonArray data;
+            for (const auto &id : query.allQueryItemValues(u"id"_s))
+            {
+                if (id.toInt() % 2 == 0)
+                {
+                    data.append(QJsonObject{{u"id"_s, id}});
+                }
+            }
+            return data;
+        }));
+    self = &scheduler;
+
+    const HelixScheduler::BatchEndpoint users{
+        .url = u"users"_s,
+        .parameter = u"id"_s,
+        .field = u"id"_s,
+    };
+
+    int found = 0;
+    int missing = 0;
+    auto onItem = [&](const QString &id) {
+        return [&, id](const auto &item) {
+            if (item)
+            {
+                ASSERT_EQ((*item)[u"id"_s].toString(), id);
+                found++;
+            }
+            else
+            {
+                ASSERT_NE(id.toInt() % 2, 0);
+                missing++;
+            }
+        };
+    };
+    auto onError = [] {
+        FAIL() << "the batch should succeed";
+    };
+
+    for (int i = 0; i < 150; i++)
+    {
+        auto id = QString::number(i);
+        scheduler.batch(users, id, HelixPriority::Background, onItem(id),
+                        onError);
+    }
+    // requested twice, but only sent once
+    scheduler.batch(users, u"42"_s, HelixPriority::Background,
+                    onItem(u"42"_s), onError);
+    ASSERT_TRUE(queries.empty());
+
+    ASSERT_TRUE(waitUntil([&] {
+        return found + missing == 151;
+    }));
+    ASSERT_EQ(found, 76);
+    ASSERT_EQ(missing, 75);
+
+    ASSERT_EQ(queries.size(), 2U);
+    ASSERT_EQ(queries[0].allQueryItemValues(u"id"_s).size(),
+              static_cast<qsizetype>(HelixScheduler::MAX_BATCH_SIZE));
+    ASSERT_EQ(queries[1].allQueryItemValues(u"id"_s).size(), 50);
+    ASSERT_EQ(scheduler.sentRequests(), 2U);
+}
+
+TEST(HelixScheduler, BatchLogins)
+{
+    std::vector<QUrlQuery> queries;
+    HelixScheduler *self = nullptr;
+    // Twitch doesn't necessarily return the logins in the requested case
+    HelixScheduler scheduler(
+        makeBatchGet(self, queries, [](const QUrlQuery & /*query*/) {
+            return QJsonArray{
+                QJsonObject{{u"id"_s, u"1"_s}, {u"login"_s, u"alice"_s}},
+                QJsonObject{{u"id"_s, u"2"_s}, {u"login"_s, u"BoB"_s}},
+            };
+        }));
+    self = &scheduler;
+
+    const HelixScheduler::BatchEndpoint users{
+        .url = u"users"_s,
+        .parameter = u"login"_s,
+        .field = u"login"_s,
+    };
+
+    // the ID of the user each waiter got, empty if it got none
+    std::map<QString, QString> got;
+    auto onError = [] {
+        FAIL() << "the batch should succeed";
+    };
+    for (const auto &login : {u"Alice"_s, u"alice"_s, u"bob"_s, u"carol"_s})
+    {
+        scheduler.batch(
+            users, login, HelixPriority::Interactive,
+            [&got, login](const auto &item) {
+                got[login] = item ? (*item)[u"id"_s].toString() : QString();
+            },
+            onError);
+    }
+
+    ASSERT_TRUE(waitUntil([&] {
+        return got.size() == 4;
+    }));
+    ASSERT_EQ(got, (std::map<QString, QString>{
+                       {u"Alice"_s, u"1"_s},
+                       {u"alice"_s, u"1"_s},
+                       {u"bob"_s, u"2"_s},
+                       {u"carol"_s, QString()},
+                   }));
+
+    // logins are only requested once, in lowercase
+    ASSERT_EQ(queries.size(), 1U);
+    ASSERT_EQ(queries[0].allQueryItemValues(u"login"_s),
+              QStringList({u"alice"_s, u"bob"_s, u"carol"_s}));
+}
+
+TEST(HelixScheduler, RetryRatelimitedBatch)
+{
+    std::vector<QUrlQuery> queries;
+    HelixScheduler *self = nullptr;
+    HelixScheduler scheduler([&](const QString & /*endpoint*/,
+                                 const QUrlQuery &urlQuery,
+                                 HelixPriority priority) {
+        queries.push_back(urlQuery);
+        return NetworkRequest(url(u"/status/429"_s))
+            .scheduler(self->lane(priority));
+    });
+    self = &scheduler;
+
+    const HelixScheduler::BatchEndpoint users{
+        .url = u"users"_s,
+        .parameter = u"id"_s,
+        .field = u"id"_s,
+    };
+
+    int errors = 0;
+    auto onItem = [](const auto & /*item*/) {
+        FAIL() << "the batch should fail";
+    };
+    auto onError = [&] {
+        errors++;
+    };
+    scheduler.batch(users, u"1"_s, HelixPriority::Interactive, onItem,
+                    onError);
+    scheduler.batch(users, u"2"_s, HelixPriority::Interactive, onItem,
+                    onError);
+
+    ASSERT_TRUE(waitUntil([&] {
+        return errors == 2;
+    }));
+    ASSERT_EQ(scheduler.ratelimitRemaining(), 0);
+
+    // the batch was sent once and retried once after the reset
+    ASSERT_EQ(queries.size(), 1U);
+    ASSERT_EQ(scheduler.sentRequests(), 2U);
+}
+
+TEST(HelixScheduler, RetryRejectedBatch)
+{
+    std::vector<QUrlQuery> queries;
+    HelixScheduler *self = nullptr;
+    auto get = makeGet(self, queries);
+    // Twitch rejects the whole batch if one of its IDs is malformed
+    HelixScheduler scheduler([&self, get](const QString &endpoint,
+                                          const QUrlQuery &urlQuery,
+                                          HelixPriority priority) {
+        if (urlQuery.allQueryItemValues(u"id"_s).size() > 1)
+        {
+            return NetworkRequest(url(u"/status/400"_s))
+                .scheduler(self->lane(priority));
+        }
+        return get(endpoint, urlQuery, priority);
+    });
+    self = &scheduler;
+
+    const HelixScheduler::BatchEndpoint users{
+        .url = u"users"_s,
+        .parameter = u"id"_s,
+        .field = u"id"_s,
+    };
+
+    int missing = 0;
+    int errors = 0;
+    auto onItem = [&](const auto &item) {
+        ASSERT_FALSE(item.has_value());
+        missing++;
+    };
+    auto onError = [&] {
+        errors++;
+    };
+
+    for (const auto &id : {u"1"_s, u"2"_s, u"3"_s})
+    {
+        scheduler.batch(users, id, HelixPriority::Interactive, onItem,
+                        onError);
+    }
+
+    ASSERT_TRUE(waitUntil([&] {
+        return missing + errors == 3;
+    }));
+    ASSERT_EQ(errors, 0);
+
+    // the rejected batch and one request for each ID
+    ASSERT_EQ(scheduler.sentRequests(), 4U);
+    ASSERT_EQ(queries.size(), 3U);
+    for (const auto &query : queries)
+    {
+        ASSERT_EQ(query.allQueryItemValues(u"id"_s).size(), 1);
+    }
+}
@@ -1,5 +1,6 @@
 #include "controllers/highlights/HighlightPhrase.hpp"
 
+#include "controllers/highlights/HighlightPhraseMatcher.hpp"
 #include "Test.hpp"
 
 using namespace chatterino;
@@ -159,3 +160,93 @@ TEST(HighlightPhrase, Regex)
     EXPECT_FALSE(p.isMatch("!foo bar"));
     EXPECT_FALSE(p.isMatch("!"));
 }
+
+TEST(HighlightPhraseMatcher, Empty)
+{
+    HighlightPhraseMatcher matcher;
+    EXPECT_TRUE(matcher.findMatches("foo").empty());
+
+    matcher = HighlightPhraseMatcher({});
+    EXPECT_TRUE(matcher.findMatches("foo").empty());
+}
+
+TEST(HighlightPhraseMatcher, Order)
+{
+    HighlightPhraseMatcher matcher({
+        buildHighlightPhrase("bar", false, false),
+        buildHighlightPhrase("ba[rz]", true, false),
+        buildHighlightPhrase("foo", false, false),
+        buildHighlightPhrase("(?i)FOO", true, true),
+        buildHighlightPhrase("baz", false, true),
+    });
+
+    EXPECT_EQ(matcher.findMatches("foo bar"),
+              (std::vector<size_t>{0, 1, 2, 3}));
+    EXPECT_EQ(matcher.findMatches("baz"), (std::vector<size_t>{1, 4}));
+    EXPECT_EQ(matcher.findMatches("BAZ"), (std::vector<size_t>{1}));
+    EXPECT_EQ(matcher.findMatches("foobar"), (std::vector<size_t>{1, 3}));
+    EXPECT_TRUE(matcher.findMatches("qux").empty());
+}
+
+TEST(HighlightPhraseMatcher, SameAsPhrases)
+{
+    std::vector<HighlightPhrase> phrases{
+        // plain
+        buildHighlightPhrase("foo", false, false),
+        buildHighlightPhrase("Foo", false, true),
+        buildHighlightPhrase("foo bar", false, false),
+        buildHighlightPhrase("a.b", false, false),
+        buildHighlightPhrase("@pajlada", false, false),
+        buildHighlightPhrase("!", false, false),
+        buildHighlightPhrase("ö", false, false),
+        buildHighlightPhrase("Kappa", false, true),
+        // combinable regex
+        buildHighlightPhrase("[a-z]+ [a-z]+", true, true),
+        buildHighlightPhrase("^foo", true, false),
+        buildHighlightPhrase("bar$", true, false),
+        buildHighlightPhrase(R"(\bba(r|z)\b)", true, false),
+        buildHighlightPhrase("Ö+", true, false),
+        buildHighlightPhrase(R"(\p{Lu}{3})", true, true),
+        // not combinable
+        buildHighlightPhrase("(?i)KAPPA", true, true),
+        buildHighlightPhrase(R"((a)\1)", true, false),
+        buildHighlightPhrase(R"(\Q.*\E)", true, false),
+        // invalid
+        buildHighlightPhrase("(", true, false),
+        buildHighlightPhrase("", false, false),
+    };
+
+    HighlightPhraseMatcher matcher(phrases);
+
+    const std::vector<QString> subjects{
+        "",
+        "foo",
+        "FOO",
+        "foobar",
+        "foo bar",
+        "Foo Bar",
+        "some foo bar baz",
+        "axb a.b",
+        "hi @pajlada!",
+        "hi @PAJLADA",
+        "\u00f6\u00d6 K\u212Appa kappa",
+        "aa .* Kappa",
+        "\u212A",
+        "ABC",
+        "bar",
+        "xbaz baz",
+    };
+
+    for (const auto &subject : subjects)
+    {
+        std::vector<size_t> expected;
+        for (size_t i = 0; i < phrases.size(); i++)
+        {
+            if (phrases[i].isMatch(subject))
+            {
+                expected.push_back(i);
+            }
+        }
+        EXPECT_EQ(matcher.findMatches(subject), expected) << subject;
+    }
+}
@@ -1,6 +1,7 @@
 #include "controllers/ignores/IgnoreController.hpp"
 
 #include "controllers/accounts/AccountController.hpp"
+#include "controllers/ignores/IgnorePhrase.hpp"
 #include "mocks/BaseApplication.hpp"
 #include "mocks/Emotes.hpp"
 #include "providers/twitch/TwitchIrc.hpp"
@@ -182,5 +183,81 @@ TEST_F(TestIgnoreController, processIgnorePhrases)
         EXPECT_EQ(emotes, test.expectedTwitchEmotes)
             << "Twitch emotes not equal for input '" << test.input
             << "' and output '" << message << "'";
+
+        message = test.input;
+        emotes = test.twitchEmotes;
+        IgnorePhraseReplacer replacer(
+            std::make_shared<const std::vector<IgnorePhrase>>(test.phrases));
+        replacer.process(message, emotes);
+
+        EXPECT_EQ(message, test.expectedMessage)
+            << "Replacer message not equal for input '" << test.input << "'";
+        EXPECT_EQ(emotes, test.expectedTwitchEmotes)
+            << "Replacer Twitch emotes not equal for input '" << test.input
+            << "'";
+    }
+}
+
+TEST_F(TestIgnoreController, IgnorePhraseReplacer)
+{
+    auto *twitchEmotes = this->mockApplication->getEmotes()->getTwitchEmotes();
+
+    auto emoteAt = [&](int at, const QString &name) {
+        return TwitchEmoteOccurrence{
+            .start = at,
+            .end = static_cast<int>(at + name.size() - 1),
+            .ptr =
+                twitchEmotes->getOrCreateEmote(EmoteId{name}, EmoteName{name}),
+            .name = EmoteName{name},
+        };
+    };
+
+    auto phrases = std::make_shared<const std::vector<IgnorePhrase>>(
+        std::vector<IgnorePhrase>{
+            IgnorePhrase("foo", false, false, "bar", true),
+            IgnorePhrase("BAR", false, false, "baz", false),
+            IgnorePhrase("blocked", false, true, "", true),
+            IgnorePhrase("", false, false, "empty", true),
+            IgnorePhrase("ö", false, false, "oe", false),
+            IgnorePhrase("\U0001F600", false, false, ":)", false),
+            IgnorePhrase("a+b", false, false, "plain", true),
+            IgnorePhrase("x(\\d+)", true, false, "[\\1]", false),
+            IgnorePhrase("(?i)QUX", true, false, "quux", true),
+            IgnorePhrase("(a)\\1", true, false, "double-a", true),
+            IgnorePhrase("(", true, false, "invalid", true),
+            IgnorePhrase("^start", true, false, "begin", false),
+            IgnorePhrase("Kappa", false, false, "Keepo", true),
+        });
+
+    const std::vector<std::pair<QString, std::vector<TwitchEmoteOccurrence>>>
+        inputs{
+            {"", {}},
+            {"nothing to see here", {}},
+            {"foo", {}},
+            {"foofoo FOO", {}},
+            {"fOo bar", {}},
+            {"blocked empty", {}},
+            {"\u00d6l \U0001F600 a+b aab", {}},
+            {"x1 X23 x", {}},
+            {"qux QUX quux", {}},
+            {"aa baa", {}},
+            {"start START restart", {}},
+            {"foo Kappa bar", {emoteAt(4, "Kappa")}},
+            {"Kappa foo Kappa", {emoteAt(0, "Kappa"), emoteAt(10, "Kappa")}},
+        };
+
+    IgnorePhraseReplacer replacer(phrases);
+    for (const auto &[input, inputEmotes] : inputs)
+    {
+        auto expectedMessage = input;
+        auto expectedEmotes = inputEmotes;
+        processIgnorePhrases(*phrases, expectedMessage, expectedEmotes);
+
+        auto message = input;
+        auto emotes = inputEmotes;
+        replacer.process(message, emotes);
+
+        EXPECT_EQ(message, expectedMessage) << input;
+        EXPECT_EQ(emotes, expectedEmotes) << input;
     }
 }
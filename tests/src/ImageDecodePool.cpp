@@ -0,0 +1,133 @@
+#include "messages/ImageDecodePool.hpp"
+
+#include "Test.hpp"
+
+#include <array>
+#include <atomic>
+#include <future>
+#include <vector>
+
+using namespace chatterino;
+
+using Priority = ImageDecodePool::Priority;
+
+namespace {
+
+/// Blocks the only worker of a pool until release() is called
+class Blocker
+{
+public:
+    explicit Blocker(ImageDecodePool &pool)
+    {
+        auto released = this->released_.get_future().share();
+        pool.submit(
+            this,
+            [this, released] {
+                this->started_.set_value();
+                released.wait();
+            },
+            Priority::Visible);
+        this->started_.get_future().wait();
+    }
+
+    void release()
+    {
+        this->released_.set_value();
+    }
+
+private:
+    std::promise<void> started_;
+    std::promise<void> released_;
+};
+
+}  // namespace
+
+TEST(ImageDecodePool, Order)
+{
+    ImageDecodePool pool(1);
+    Blocker blocker(pool);
+
+    std::array<int, 5> owners{};
+    std::vector<int> order;
+    std::promise<void> done;
+    auto record = [&](int id) {
+        return [&, id] {
+            order.push_back(id);
+            if (order.size() == 4)
+            {
+                done.set_value();
+            }
+        };
+    };
+
+    pool.submit(&owners[0], record(0), Priority::Normal);
+    pool.submit(&owners[1], record(1), Priority::Normal);
+    pool.submit(&owners[2], record(2), Priority::Visible);
+    pool.submit(&owners[3], record(3), Priority::Normal);
+    pool.submit(&owners[4], record(4), Priority::Normal);
+
+    // visible jobs run first
+    pool.prioritize(&owners[3]);
+    pool.prioritize(&owners[2]);
+    // replaces the pending job
+    pool.submit(&owners[0], record(5), Priority::Normal);
+    pool.cancel(&owners[4]);
+    pool.cancel(&owners[4]);
+
+    ASSERT_EQ(pool.pending(), 4);
+
+    blocker.release();
+    done.get_future().wait();
+
+    ASSERT_EQ(order, (std::vector<int>{2, 3, 1, 5}));
+    ASSERT_EQ(pool.pending(), 0);
+}
+
+TEST(ImageDecodePool, ReplaceKeepsPriority)
+{
+    ImageDecodePool pool(1);
+    Blocker blocker(pool);
+
+    std::array<int, 2> owners{};
+    std::vector<int> order;
+    std::promise<void> done;
+    auto record = [&](int id) {
+        return [&, id] {
+            order.push_back(id);
+            if (order.size() == 2)
+            {
+                done.set_value();
+            }
+        };
+    };
+
+    pool.submit(&owners[0], record(0), Priority::Normal);
+    pool.submit(&owners[1], record(1), Priority::Visible);
+    pool.submit(&owners[1], record(2), Priority::Normal);
+
+    blocker.release();
+    done.get_future().wait();
+
+    // the replacement of a visible job is still visible
+    ASSERT_EQ(order, (std::vector<int>{2, 0}));
+}
+
+TEST(ImageDecodePool, DestroyWithPendingJobs)
+{
+    // pending jobs are dropped, running ones are waited for
+    std::atomic<int> ran = 0;
+    {
+        ImageDecodePool pool(2);
+        std::array<int, 64> owners{};
+        for (auto &owner : owners)
+        {
+            pool.submit(
+                &owner,
+                [&] {
+                    ran++;
+                },
+                Priority::Normal);
+        }
+    }
+    ASSERT_LE(ran.load(), 64);
+}
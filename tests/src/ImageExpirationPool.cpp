@@ -0,0 +1,106 @@
+#include "messages/Image.hpp"
+
+#include "Test.hpp"
+
+#include <chrono>
+#include <vector>
+
+using namespace chatterino;
+using namespace std::chrono_literals;
+
+namespace {
+
+using Pool = ImageExpirationPool;
+
+const auto NOW = Pool::Clock::now();
+constexpr int64_t MIB = 1024 * 1024;
+
+const Pool::ExpiryPolicy POLICY{
+    .lifetime = 10min,
+    .memoryBudget = 100 * MIB,
+    .minimumAge = 10s,
+};
+
+Pool::ExpiryCandidate usedAgo(Pool::Clock::duration ago, int64_t bytes)
+{
+    return {
+        .lastUsed = NOW - ago,
+        .bytes = bytes,
+    };
+}
+
+}  // namespace
+
+TEST(ImageExpirationPool, Lifetime)
+{
+    std::vector<Pool::ExpiryCandidate> candidates{
+        usedAgo(1min, MIB),
+        usedAgo(11min, MIB),
+        usedAgo(0s, MIB),
+        usedAgo(20min, MIB),
+        usedAgo(10min, MIB),
+    };
+
+    ASSERT_EQ(Pool::selectExpired(candidates, NOW, POLICY),
+              (std::vector<size_t>{3, 1}));
+    ASSERT_TRUE(Pool::selectExpired({}, NOW, POLICY).empty());
+}
+
+TEST(ImageExpirationPool, BudgetEvictsLeastRecentlyUsed)
+{
+    std::vector<Pool::ExpiryCandidate> candidates{
+        usedAgo(2min, 30 * MIB),
+        usedAgo(1min, 20 * MIB),
+        usedAgo(5min, 30 * MIB),
+        usedAgo(30s, 25 * MIB),
+        usedAgo(3min, 10 * MIB),
+    };
+
+    // 115 MiB are loaded, images are expired until at most 90 MiB are left
+    ASSERT_EQ(Pool::selectExpired(candidates, NOW, POLICY),
+              (std::vector<size_t>{2}));
+
+    candidates.push_back(usedAgo(4min, 20 * MIB));
+    // 135 MiB
+    ASSERT_EQ(Pool::selectExpired(candidates, NOW, POLICY),
+              (std::vector<size_t>{2, 5}));
+
+    candidates.push_back(usedAgo(1s, 40 * MIB));
+    // 175 MiB
+    ASSERT_EQ(Pool::selectExpired(candidates, NOW, POLICY),
+              (std::vector<size_t>{2, 5, 4, 0}));
+}
+
+TEST(ImageExpirationPool, BudgetKeepsRecentlyUsed)
+{
+    std::vector<Pool::ExpiryCandidate> candidates{
+        usedAgo(5s, 80 * MIB),
+        usedAgo(1min, 10 * MIB),
+        usedAgo(0s, 80 * MIB),
+    };
+
+    // images used in the last 10s are likely visible
+    ASSERT_EQ(Pool::selectExpired(candidates, NOW, POLICY),
+              (std::vector<size_t>{1}));
+}
+
+TEST(ImageExpirationPool, WithinBudget)
+{
+    std::vector<Pool::ExpiryCandidate> candidates{
+        usedAgo(5min, 50 * MIB),
+        usedAgo(9min, 50 * MIB),
+        usedAgo(11min, 10 * MIB),
+    };
+
+    // exactly at the budget once the expired image is gone
+    ASSERT_EQ(Pool::selectExpired(candidates, NOW, POLICY),
+              (std::vector<size_t>{2}));
+
+    candidates.pop_back();
+    ASSERT_TRUE(Pool::selectExpired(candidates, NOW, POLICY).empty());
+
+    auto noBudget = POLICY;
+    noBudget.memoryBudget = 0;
+    candidates.push_back(usedAgo(1min, 1000 * MIB));
+    ASSERT_TRUE(Pool::selectExpired(candidates, NOW, noBudget).empty());
+}
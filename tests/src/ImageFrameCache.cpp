@@ -0,0 +1,155 @@
+#include "messages/ImageFrameCache.hpp"
+
+#include "Test.hpp"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+using namespace chatterino;
+
+namespace {
+
+constexpr int64_t MIB = 1024 * 1024;
+
+detail::DecodedFrame makeFrame(int width, int height, QRgb color,
+                               int duration)
+{
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    image.fill(color);
+    image.setPixel(0, 0, qRgba(1, 2, 3, 255));
+    return {
+        .image = std::move(image),
+        .duration = duration,
+    };
+}
+
+void setLastUsed(const QString &path, const QDateTime &time)
+{
+    QFile file(path);
+    ASSERT_TRUE(file.open(QFile::ReadWrite));
+    ASSERT_TRUE(file.setFileTime(time, QFileDevice::FileModificationTime));
+}
+
+}  // namespace
+
+TEST(ImageFrameCache, RoundTrip)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    ImageFrameCache cache(dir.filePath("Frames"), 64 * MIB);
+
+    QList<detail::DecodedFrame> frames{
+        makeFrame(28, 28, qRgba(255, 0, 0, 255), 100),
+        makeFrame(13, 7, qRgba(0, 64, 0, 128), 40),
+    };
+    cache.write("https://example.com/emote/1x", 1, frames);
+
+    auto read = cache.read("https://example.com/emote/1x", 1);
+    ASSERT_TRUE(read.has_value());
+    ASSERT_EQ(read->size(), 2);
+    for (qsizetype i = 0; i < frames.size(); i++)
+    {
+        ASSERT_EQ((*read)[i].duration, frames[i].duration);
+        ASSERT_EQ((*read)[i].image.format(),
+                  QImage::Format_ARGB32_Premultiplied);
+        ASSERT_EQ((*read)[i].image, frames[i].image);
+    }
+
+    // the scale is part of the key
+    ASSERT_FALSE(cache.read("https://example.com/emote/1x", 2).has_value());
+    ASSERT_FALSE(cache.read("https://example.com/emote/2x", 1).has_value());
+}
+
+TEST(ImageFrameCache, Replace)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    ImageFrameCache cache(dir.path(), 64 * MIB);
+
+    cache.write("a", 1, {makeFrame(4, 4, qRgba(0, 0, 0, 255), 20)});
+    cache.write("a", 1, {makeFrame(8, 2, qRgba(0, 0, 0, 255), 30)});
+
+    auto read = cache.read("a", 1);
+    ASSERT_TRUE(read.has_value());
+    ASSERT_EQ(read->size(), 1);
+    ASSERT_EQ(read->front().image.size(), QSize(8, 2));
+    ASSERT_EQ(read->front().duration, 30);
+}
+
+TEST(ImageFrameCache, BrokenFiles)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    ImageFrameCache cache(dir.path(), 64 * MIB);
+
+    cache.write("a", 1, {makeFrame(16, 16, qRgba(0, 0, 255, 255), 20)});
+    auto path = cache.filePath("a", 1);
+    ASSERT_TRUE(cache.read("a", 1).has_value());
+
+    {
+        // cut off in the middle of the pixels
+        QFile file(path);
+        ASSERT_TRUE(file.open(QFile::ReadWrite));
+        ASSERT_TRUE(file.resize(file.size() - 1));
+    }
+    ASSERT_FALSE(cache.read("a", 1).has_value());
+
+    {
+        QFile file(path);
+        ASSERT_TRUE(file.open(QFile::WriteOnly | QFile::Truncate));
+        file.write("GIF89a definitely not a frame cache file");
+    }
+    ASSERT_FALSE(cache.read("a", 1).has_value());
+
+    {
+        QFile file(path);
+        ASSERT_TRUE(file.open(QFile::WriteOnly | QFile::Truncate));
+    }
+    ASSERT_FALSE(cache.read("a", 1).has_value());
+}
+
+TEST(ImageFrameCache, Evict)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    ImageFrameCache writer(dir.path(), 64 * MIB);
+
+    // every file uses 304 bytes (48 bytes of headers and 256 of pixels)
+    auto frame = makeFrame(8, 8, qRgba(0, 0, 0, 255), 20);
+    auto now = QDateTime::currentDateTime();
+    std::vector<std::pair<QString, QDateTime>> files{
+        {"a", now.addSecs(-60)},
+        {"b", now.addSecs(-120)},
+        {"c", now.addSecs(-180)},
+        {"d", now.addDays(-15)},
+    };
+    for (const auto &[url, lastUsed] : files)
+    {
+        writer.write(url, 1, {frame});
+        setLastUsed(writer.filePath(url, 1), lastUsed);
+        ASSERT_EQ(QFile(writer.filePath(url, 1)).size(), 304);
+    }
+
+    // only removes old files
+    ASSERT_EQ(writer.evict(), 1);
+    ASSERT_FALSE(QFile::exists(writer.filePath("d", 1)));
+
+    // the least recently used file doesn't fit
+    ImageFrameCache small(dir.path(), 700);
+    ASSERT_EQ(small.evict(), 1);
+    ASSERT_TRUE(QFile::exists(small.filePath("a", 1)));
+    ASSERT_TRUE(QFile::exists(small.filePath("b", 1)));
+    ASSERT_FALSE(QFile::exists(small.filePath("c", 1)));
+
+    // reading marks the file as used
+    setLastUsed(small.filePath("a", 1), now.addSecs(-300));
+    ASSERT_TRUE(small.read("a", 1).has_value());
+    ASSERT_GE(QFileInfo(small.filePath("a", 1)).lastModified(),
+              now.addSecs(-1));
+    ImageFrameCache tiny(dir.path(), 400);
+    ASSERT_EQ(tiny.evict(), 1);
+    ASSERT_TRUE(QFile::exists(tiny.filePath("a", 1)));
+    ASSERT_FALSE(QFile::exists(tiny.filePath("b", 1)));
+}
@@ -247,6 +247,16 @@ protected:
         return queryEmoteCompletion<SmartEmoteStrategy>(fullQuery);
     }
 
+    auto querySmartEmoteCompletion(const QString &fullQuery, size_t limit)
+    {
+        EmoteSource source(this->channelPtr.get(),
+                           std::make_unique<SmartEmoteStrategy>(limit));
+        source.update(fullQuery);
+
+        std::vector<EmoteItem> out(source.output());
+        return out;
+    }
+
     auto querySmartTabCompletion(const QString &fullQuery, bool isFirstWord)
     {
         return queryTabCompletion<SmartTabEmoteStrategy>(fullQuery,
@@ -467,6 +477,23 @@ TEST_F(InputCompletionTest, SmartEmoteExactNameMatching)
     ASSERT_EQ(completion[1].displayName, "SaltyCorn");
 }
 
+TEST_F(InputCompletionTest, SmartEmoteLimit)
+{
+    auto all = querySmartEmoteCompletion(":sal");
+    ASSERT_TRUE(all.size() >= 4);
+
+    // the best emotes are the same as without a limit
+    auto completion = querySmartEmoteCompletion(":sal", 3);
+    ASSERT_EQ(completion.size(), 3);
+    for (size_t i = 0; i < completion.size(); i++)
+    {
+        ASSERT_EQ(completion[i].displayName, all[i].displayName);
+    }
+
+    completion = querySmartEmoteCompletion(":sal", all.size() + 10);
+    ASSERT_EQ(completion.size(), all.size());
+}
+
 TEST_F(InputCompletionTest, SmartEmoteProviderOrdering)
 {
     auto completion = querySmartEmoteCompletion(":clap");
@@ -0,0 +1,104 @@
+#include "util/KeyedThreadPool.hpp"
+
+#include "Test.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <vector>
+
+using namespace chatterino;
+using namespace std::chrono_literals;
+
+TEST(KeyedThreadPool, OrderPerKey)
+{
+    KeyedThreadPool pool(4, "Test");
+    ASSERT_EQ(pool.threadCount(), 4);
+
+    std::array<std::vector<int>, 8> results;
+    for (int i = 0; i < 1000; i++)
+    {
+        for (auto &result : results)
+        {
+            pool.submit(&result, [&result, i] {
+                result.push_back(i);
+            });
+        }
+    }
+    pool.waitForIdle();
+    ASSERT_EQ(pool.pending(), 0);
+
+    std::vector<int> expected;
+    for (int i = 0; i < 1000; i++)
+    {
+        expected.push_back(i);
+    }
+    for (const auto &result : results)
+    {
+        ASSERT_EQ(result, expected);
+    }
+}
+
+TEST(KeyedThreadPool, SameKeyRunsSequentially)
+{
+    KeyedThreadPool pool(4, "Test");
+
+    int key = 0;
+    std::atomic<int> running = 0;
+    std::atomic<int> maxRunning = 0;
+    for (int i = 0; i < 200; i++)
+    {
+        pool.submit(&key, [&] {
+            auto now = ++running;
+            auto max = maxRunning.load();
+            while (now > max && !maxRunning.compare_exchange_weak(max, now))
+            {
+            }
+            std::this_thread::yield();
+            running--;
+        });
+    }
+    pool.waitForIdle();
+
+    ASSERT_EQ(maxRunning.load(), 1);
+}
+
+TEST(KeyedThreadPool, KeysRunInParallel)
+{
+    KeyedThreadPool pool(2, "Test");
+
+    std::array<int, 2> keys{};
+    std::promise<void> secondRan;
+    auto secondRanFuture = secondRan.get_future();
+    std::atomic<bool> firstSawSecond = false;
+
+    pool.submit(&keys[0], [&] {
+        // only finishes once the job of the other key ran
+        firstSawSecond = secondRanFuture.wait_for(5s) ==
+                         std::future_status::ready;
+    });
+    pool.submit(&keys[1], [&] {
+        secondRan.set_value();
+    });
+    pool.waitForIdle();
+
+    ASSERT_TRUE(firstSawSecond);
+}
+
+TEST(KeyedThreadPool, DestroyWithPendingJobs)
+{
+    // pending jobs are dropped, running ones are waited for
+    std::atomic<int> ran = 0;
+    {
+        KeyedThreadPool pool(2, "Test");
+        std::array<int, 16> keys{};
+        for (int i = 0; i < 64; i++)
+        {
+            pool.submit(&keys[static_cast<size_t>(i) % keys.size()], [&] {
+                ran++;
+            });
+        }
+    }
+    ASSERT_LE(ran.load(), 64);
+}
@@ -1,7 +1,10 @@
 #include "messages/LimitedQueue.hpp"
 
+#include "messages/ChunkedLimitedQueue.hpp"
 #include "Test.hpp"
 
+#include <atomic>
+#include <thread>
 #include <vector>
 
 using namespace chatterino;
@@ -57,9 +60,18 @@ inline void SNAPSHOT_EQUALS(const LimitedQueueSnapshot<T> &snapshot,
     }
 }
 
-TEST(LimitedQueue, PushBack)
+template <typename Queue>
+class LimitedQueueT : public ::testing::Test
 {
-    LimitedQueue<int> queue(5);
+};
+
+using QueueTypes =
+    ::testing::Types<LimitedQueue<int>, ChunkedLimitedQueue<int>>;
+TYPED_TEST_SUITE(LimitedQueueT, QueueTypes);
+
+TYPED_TEST(LimitedQueueT, PushBack)
+{
+    TypeParam queue(5);
     int d = 0;
     bool flag;
 
@@ -95,9 +107,9 @@ TEST(LimitedQueue, PushBack)
     SNAPSHOT_EQUALS(snapshot1, {1, 2}, "first snapshot same 3");
 }
 
-TEST(LimitedQueue, PushFront)
+TYPED_TEST(LimitedQueueT, PushFront)
 {
-    LimitedQueue<int> queue(5);
+    TypeParam queue(5);
     queue.pushBack(1);
     queue.pushBack(2);
     queue.pushBack(3);
@@ -112,9 +124,9 @@ TEST(LimitedQueue, PushFront)
     EXPECT_EQ(pushed2.size(), 0);
 }
 
-TEST(LimitedQueue, ReplaceItem)
+TYPED_TEST(LimitedQueueT, ReplaceItem)
 {
-    LimitedQueue<int> queue(10);
+    TypeParam queue(10);
     queue.pushBack(1);
     queue.pushBack(2);
     queue.pushBack(3);
@@ -148,9 +160,9 @@ TEST(LimitedQueue, ReplaceItem)
                     "first snapshot");
 }
 
-TEST(LimitedQueue, Find)
+TYPED_TEST(LimitedQueueT, Find)
 {
-    LimitedQueue<int> queue(10);
+    TypeParam queue(10);
     queue.pushBack(1);
     queue.pushBack(2);
     queue.pushBack(3);
@@ -264,3 +276,120 @@ TEST(LimitedQueue, Find)
                            })
                      .has_value());
 }
+
+TYPED_TEST(LimitedQueueT, Insert)
+{
+    TypeParam queue(5);
+    queue.pushBack(1);
+    queue.pushBack(3);
+
+    EXPECT_TRUE(queue.insertBefore(3, 2));
+    EXPECT_TRUE(queue.insertAfter(3, 4));
+    EXPECT_FALSE(queue.insertAfter(42, 5));
+    SNAPSHOT_EQUALS(queue.getSnapshot(), {1, 2, 3, 4}, "inserted");
+
+    queue.pushBack(5);
+    // the queue is full, so the first item is dropped
+    EXPECT_TRUE(queue.insertAfter(1, 6));
+    SNAPSHOT_EQUALS(queue.getSnapshot(), {6, 2, 3, 4, 5}, "full");
+}
+
+TEST(ChunkedLimitedQueue, SnapshotsAreStable)
+{
+    // 16 items per chunk
+    ChunkedLimitedQueue<int> queue(20);
+    for (int i = 0; i < 20; ++i)
+    {
+        queue.pushBack(i);
+    }
+
+    auto before = queue.getSnapshot();
+    std::vector<int> expected(before.begin(), before.end());
+
+    // evict more than a chunk and replace an item in every chunk
+    for (int i = 20; i < 50; ++i)
+    {
+        int deleted = -1;
+        EXPECT_TRUE(queue.pushBack(i, deleted));
+        EXPECT_EQ(deleted, i - 20);
+    }
+    EXPECT_EQ(queue.replaceItem(35, -35), 5);
+    EXPECT_EQ(queue.replaceItem(48, -48), 18);
+    queue.clear();
+    queue.pushBack(100);
+
+    SNAPSHOT_EQUALS(before, expected, "before");
+    EXPECT_EQ(queue.first().value_or(-1), 100);
+    EXPECT_EQ(queue.last().value_or(-1), 100);
+}
+
+TEST(ChunkedLimitedQueue, SnapshotIteration)
+{
+    ChunkedLimitedQueue<int> queue(40);
+    for (int i = 0; i < 100; ++i)
+    {
+        queue.pushBack(i);
+    }
+
+    auto snapshot = queue.getSnapshot();
+    ASSERT_EQ(snapshot.size(), 40);
+
+    int expected = 60;
+    for (int item : snapshot)
+    {
+        EXPECT_EQ(item, expected++);
+    }
+    EXPECT_EQ(*snapshot.rbegin(), 99);
+    EXPECT_EQ(snapshot.end() - snapshot.begin(), 40);
+    EXPECT_EQ(snapshot.begin()[39], 99);
+    auto lastSeventh = queue.rfind([](int i) {
+        return i % 7 == 0;
+    });
+    EXPECT_EQ(lastSeventh.value_or(-1), 98);
+}
+
+TEST(ChunkedLimitedQueue, ConcurrentReaders)
+{
+    ChunkedLimitedQueue<std::shared_ptr<int>> queue(100);
+    std::atomic<bool> done = false;
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r)
+    {
+        readers.emplace_back([&] {
+            while (!done)
+            {
+                auto snapshot = queue.getSnapshot();
+                int previous = -1;
+                for (const auto &item : snapshot)
+                {
+                    ASSERT_NE(item, nullptr);
+                    ASSERT_GT(*item, previous);
+                    previous = *item;
+                }
+                auto last = queue.last();
+                if (last)
+                {
+                    ASSERT_NE(*last, nullptr);
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        queue.pushBack(std::make_shared<int>(i));
+        if (auto item = queue.get(50); item && i % 100 == 0)
+        {
+            queue.replaceItem(size_t{50}, std::make_shared<int>(**item));
+        }
+    }
+    done = true;
+
+    for (auto &reader : readers)
+    {
+        reader.join();
+    }
+
+    EXPECT_EQ(*queue.last().value(), 19999);
+}
@@ -0,0 +1,93 @@
+#include "singletons/helper/LogWriter.hpp"
+
+#include "Test.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <limits>
+
+using namespace chatterino;
+
+namespace {
+
+QByteArray readFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly))
+    {
+        return {};
+    }
+    return file.readAll();
+}
+
+LogWriter::Options neverFlush()
+{
+    return {
+        .flushInterval = std::chrono::hours{1},
+        .flushThreshold = std::numeric_limits<size_t>::max(),
+        .maxPendingBytes = 16,
+    };
+}
+
+}  // namespace
+
+TEST(LogWriter, WritesInOrder)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    auto path = dir.filePath("Twitch/Channels/forsen/forsen.log");
+
+    LogWriter writer;
+    writer.append(path, "first\n");
+    writer.append(path, "second\n");
+    writer.drain();
+
+    ASSERT_EQ(readFile(path), "first\nsecond\n");
+
+    writer.close(path);
+    writer.append(path, "third\n");
+    writer.drain();
+
+    ASSERT_EQ(readFile(path), "first\nsecond\nthird\n");
+}
+
+TEST(LogWriter, DrainsOnDestruction)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    auto a = dir.filePath("a.log");
+    auto b = dir.filePath("b.log");
+
+    {
+        LogWriter writer(neverFlush());
+        writer.append(a, "a\n");
+        writer.append(b, "b\n");
+    }
+
+    ASSERT_EQ(readFile(a), "a\n");
+    ASSERT_EQ(readFile(b), "b\n");
+}
+
+TEST(LogWriter, DropsWhenOverBudget)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    auto path = dir.filePath("dropped.log");
+
+    LogWriter writer(neverFlush());
+    writer.append(path, "0123456789\n");
+    writer.append(path, "this is dropped\n");
+    writer.append(path, "this too\n");
+    writer.drain();
+
+    ASSERT_EQ(readFile(path),
+              "0123456789\n# 2 lines were dropped because the log writer "
+              "couldn't keep up\n");
+
+    // there's room again
+    writer.append(path, "ok\n");
+    writer.drain();
+    ASSERT_TRUE(readFile(path).endsWith("keep up\nok\n"));
+}
@@ -0,0 +1,115 @@
+#include "messages/MergedEmoteMap.hpp"
+
+#include "common/Literals.hpp"
+#include "messages/Emote.hpp"
+#include "messages/MessageElement.hpp"
+#include "Test.hpp"
+
+#include <memory>
+#include <vector>
+
+using namespace chatterino;
+using namespace literals;
+
+namespace {
+
+std::shared_ptr<const EmoteMap> makeEmotes(
+    std::initializer_list<std::pair<QString, bool>> emotes)
+{
+    auto map = std::make_shared<EmoteMap>();
+    for (const auto &[name, zeroWidth] : emotes)
+    {
+        map->emplace(EmoteName{name}, std::make_shared<const Emote>(Emote{
+                                          .name = EmoteName{name},
+                                          .zeroWidth = zeroWidth,
+                                      }));
+    }
+    return map;
+}
+
+}  // namespace
+
+TEST(MergedEmoteMap, Precedence)
+{
+    auto ffz = makeEmotes({{u"Kappa"_s, false}, {u"ffzOnly"_s, false}});
+    auto bttv = makeEmotes({{u"Kappa"_s, false}, {u"bttvOnly"_s, false}});
+    auto seventv = makeEmotes({{u"Kappa"_s, true}, {u"RainTime"_s, true}});
+
+    MergedEmoteMap map({
+        {ffz, MessageElementFlag::FfzEmote},
+        {bttv, MessageElementFlag::BttvEmote},
+        {seventv, MessageElementFlag::SevenTVEmote,
+         MergedEmoteMap::ZeroWidth::FromEmote},
+    });
+    ASSERT_EQ(map.size(), 4);
+
+    const auto *kappa = map.find(u"Kappa"_s);
+    ASSERT_NE(kappa, nullptr);
+    ASSERT_EQ(kappa->emote, ffz->at(EmoteName{u"Kappa"_s}));
+    ASSERT_EQ(kappa->flag, MessageElementFlag::FfzEmote);
+    ASSERT_FALSE(kappa->zeroWidth);
+
+    const auto *bttvOnly = map.find(u"bttvOnly"_s);
+    ASSERT_NE(bttvOnly, nullptr);
+    ASSERT_EQ(bttvOnly->flag, MessageElementFlag::BttvEmote);
+
+    const auto *rainTime = map.find(u"RainTime"_s);
+    ASSERT_NE(rainTime, nullptr);
+    ASSERT_EQ(rainTime->flag, MessageElementFlag::SevenTVEmote);
+    ASSERT_TRUE(rainTime->zeroWidth);
+
+    // case sensitive
+    ASSERT_EQ(map.find(u"kappa"_s), nullptr);
+    ASSERT_EQ(map.find(u"Kappa2"_s), nullptr);
+    ASSERT_EQ(map.find(u"K"_s), nullptr);
+    ASSERT_EQ(map.find(u"a very long word that is no emote"_s), nullptr);
+    ASSERT_EQ(map.find(u"äKappa"_s), nullptr);
+}
+
+TEST(MergedEmoteMap, BttvZeroWidth)
+{
+    MergedEmoteMap map({
+        {makeEmotes({{u"SoSnowy"_s, false}, {u"OMEGALUL"_s, false}}),
+         MessageElementFlag::BttvEmote, MergedEmoteMap::ZeroWidth::BttvGlobal},
+    });
+
+    ASSERT_TRUE(map.find(u"SoSnowy"_s)->zeroWidth);
+    ASSERT_FALSE(map.find(u"OMEGALUL"_s)->zeroWidth);
+}
+
+TEST(MergedEmoteMap, Empty)
+{
+    MergedEmoteMap map({
+        {nullptr, MessageElementFlag::FfzEmote},
+        {std::make_shared<const EmoteMap>(), MessageElementFlag::BttvEmote},
+    });
+    ASSERT_EQ(map.size(), 0);
+    ASSERT_EQ(map.find(u"Kappa"_s), nullptr);
+    ASSERT_EQ(map.find(u""_s), nullptr);
+}
+
+TEST(MergedEmoteMap, Cache)
+{
+    auto ffz = makeEmotes({{u"Kappa"_s, false}});
+    auto bttv = makeEmotes({{u"OMEGALUL"_s, false}});
+
+    MergedEmoteMapCache cache;
+    auto first = cache.get({
+        {ffz, MessageElementFlag::FfzEmote},
+        {bttv, MessageElementFlag::BttvEmote},
+    });
+    auto second = cache.get({
+        {ffz, MessageElementFlag::FfzEmote},
+        {bttv, MessageElementFlag::BttvEmote},
+    });
+    ASSERT_EQ(first, second);
+
+    // a new emote map replaced the old one
+    auto third = cache.get({
+        {ffz, MessageElementFlag::FfzEmote},
+        {makeEmotes({{u"LULW"_s, false}}), MessageElementFlag::BttvEmote},
+    });
+    ASSERT_NE(first, third);
+    ASSERT_EQ(third->find(u"OMEGALUL"_s), nullptr);
+    ASSERT_NE(third->find(u"LULW"_s), nullptr);
+}
@@ -0,0 +1,136 @@
+#include "messages/MergedSnapshots.hpp"
+
+#include "common/Literals.hpp"
+#include "messages/LimitedQueue.hpp"
+#include "messages/Message.hpp"
+#include "Test.hpp"
+
+#include <QDateTime>
+
+#include <memory>
+#include <vector>
+
+using namespace chatterino;
+using namespace literals;
+
+namespace {
+
+MessagePtr makeMessage(const QString &id, qint64 time)
+{
+    auto message = std::make_shared<Message>();
+    message->id = id;
+    message->serverReceivedTime = QDateTime::fromMSecsSinceEpoch(time);
+    return message;
+}
+
+LimitedQueueSnapshot<MessagePtr> makeSnapshot(
+    const std::vector<MessagePtr> &messages)
+{
+    LimitedQueue<MessagePtr> queue(16);
+    for (const auto &message : messages)
+    {
+        queue.pushBack(message);
+    }
+    return queue.getSnapshot();
+}
+
+std::vector<QString> ids(const std::vector<MessagePtr> &messages)
+{
+    std::vector<QString> result;
+    for (const auto &message : messages)
+    {
+        result.push_back(message->id);
+    }
+    return result;
+}
+
+}  // namespace
+
+TEST(MergedSnapshots, OrdersByTime)
+{
+    MergedSnapshots merged;
+    merged.add(makeSnapshot({
+        makeMessage(u"a1"_s, 1),
+        makeMessage(u"a4"_s, 4),
+        makeMessage(u"a5"_s, 5),
+    }));
+    merged.add(makeSnapshot({}));
+    merged.add(makeSnapshot({
+        makeMessage(u"b2"_s, 2),
+        makeMessage(u"b3"_s, 3),
+        makeMessage(u"b5"_s, 5),
+        makeMessage(u"b6"_s, 6),
+    }));
+
+    // messages with the same time keep the order of their snapshots
+    ASSERT_EQ(ids(merged.collect()),
+              (std::vector<QString>{u"a1"_s, u"b2"_s, u"b3"_s, u"a4"_s,
+                                    u"a5"_s, u"b5"_s, u"b6"_s}));
+}
+
+TEST(MergedSnapshots, RemovesDuplicates)
+{
+    auto shared = makeSnapshot({
+        makeMessage(u"a"_s, 1),
+        makeMessage({}, 2),
+        makeMessage(u"b"_s, 3),
+    });
+
+    MergedSnapshots merged;
+    merged.add(shared);
+    merged.add(shared);
+    merged.add(makeSnapshot({makeMessage(u"b"_s, 3)}));
+
+    // messages without an ID are kept
+    ASSERT_EQ(ids(merged.collect()),
+              (std::vector<QString>{u"a"_s, {}, {}, u"b"_s}));
+}
+
+TEST(MergedSnapshots, Filter)
+{
+    MergedSnapshots merged;
+    merged.add(
+        makeSnapshot({
+            makeMessage(u"a1"_s, 1),
+            makeMessage(u"a2"_s, 2),
+            makeMessage(u"a3"_s, 3),
+        }),
+        [](const MessagePtr &message) {
+            return message->id != u"a2";
+        });
+    merged.add(makeSnapshot({makeMessage(u"b2"_s, 2)}),
+               [](const MessagePtr &) {
+                   return false;
+               });
+
+    ASSERT_EQ(ids(merged.collect()),
+              (std::vector<QString>{u"a1"_s, u"a3"_s}));
+}
+
+TEST(MergedSnapshots, StopEarly)
+{
+    MergedSnapshots merged;
+    for (qint64 i = 0; i < 4; i++)
+    {
+        merged.add(makeSnapshot({
+            makeMessage(QString::number(i), i),
+            makeMessage(QString::number(i + 4), i + 4),
+        }));
+    }
+
+    std::vector<MessagePtr> first;
+    for (const auto &message : merged)
+    {
+        first.push_back(message);
+        if (first.size() == 3)
+        {
+            break;
+        }
+    }
+    ASSERT_EQ(ids(first), (std::vector<QString>{u"0"_s, u"1"_s, u"2"_s}));
+
+    // the iteration continues at the message it stopped at
+    ASSERT_EQ(ids(merged.collect()),
+              (std::vector<QString>{u"2"_s, u"3"_s, u"4"_s, u"5"_s, u"6"_s,
+                                    u"7"_s}));
+}
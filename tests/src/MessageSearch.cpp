@@ -0,0 +1,152 @@
+#include "messages/search/MessageSearch.hpp"
+
+#include "common/Literals.hpp"
+#include "messages/LimitedQueue.hpp"
+#include "messages/Message.hpp"
+#include "messages/search/AuthorPredicate.hpp"
+#include "messages/search/SubstringPredicate.hpp"
+#include "Test.hpp"
+#include "util/CancellationToken.hpp"
+
+#include <memory>
+#include <vector>
+
+using namespace chatterino;
+using namespace literals;
+
+namespace {
+
+MessagePtr makeMessage(const QString &login, const QString &text)
+{
+    auto message = std::make_shared<Message>();
+    message->loginName = login;
+    message->displayName = login.toUpper();
+    message->searchText = login + u": "_s + text;
+    return message;
+}
+
+MessageSearch makeSearch()
+{
+    LimitedQueue<MessagePtr> queue(16);
+    queue.pushBack(makeMessage(u"forsen"_s, u"hello chat"_s));
+    queue.pushBack(makeMessage(u"nymn"_s, u"hello forsen"_s));
+    queue.pushBack(makeMessage(u"forsen"_s, u"bye chat"_s));
+    queue.pushBack(makeMessage(u"pajlada"_s, u"hello"_s));
+    return MessageSearch(queue.getSnapshot());
+}
+
+template <typename... Predicates>
+std::vector<std::unique_ptr<MessagePredicate>> predicates(Predicates... preds)
+{
+    std::vector<std::unique_ptr<MessagePredicate>> result;
+    (result.emplace_back(std::move(preds)), ...);
+    return result;
+}
+
+}  // namespace
+
+TEST(MessageSearch, Substring)
+{
+    auto search = makeSearch();
+    auto results = search.search(
+        predicates(std::make_unique<SubstringPredicate>(u"HELLO"_s)), nullptr,
+        CancellationToken(false));
+    ASSERT_TRUE(results.has_value());
+    ASSERT_EQ(*results, (std::vector<size_t>{0, 1, 3}));
+}
+
+TEST(MessageSearch, Authors)
+{
+    auto search = makeSearch();
+    CancellationToken token(false);
+
+    auto results = search.search(
+        predicates(std::make_unique<AuthorPredicate>(u"Forsen"_s, false)),
+        nullptr, token);
+    ASSERT_EQ(*results, (std::vector<size_t>{0, 2}));
+
+    // display names are indexed too
+    results = search.search(predicates(std::make_unique<AuthorPredicate>(
+                                u"PAJLADA,nymn,unknown"_s, false)),
+                            nullptr, token);
+    ASSERT_EQ(*results, (std::vector<size_t>{1, 3}));
+
+    results = search.search(
+        predicates(std::make_unique<AuthorPredicate>(u"forsen"_s, true)),
+        nullptr, token);
+    ASSERT_EQ(*results, (std::vector<size_t>{1, 3}));
+
+    results = search.search(
+        predicates(std::make_unique<AuthorPredicate>(u"forsen"_s, false),
+                   std::make_unique<SubstringPredicate>(u"bye"_s)),
+        nullptr, token);
+    ASSERT_EQ(*results, (std::vector<size_t>{2}));
+
+    results = search.search(
+        predicates(std::make_unique<AuthorPredicate>(u"unknown"_s, false)),
+        nullptr, token);
+    ASSERT_TRUE(results->empty());
+}
+
+TEST(MessageSearch, Candidates)
+{
+    auto search = makeSearch();
+    CancellationToken token(false);
+
+    std::vector<size_t> candidates{1, 2, 3};
+    auto results = search.search(
+        predicates(std::make_unique<SubstringPredicate>(u"hello"_s)),
+        &candidates, token);
+    ASSERT_EQ(*results, (std::vector<size_t>{1, 3}));
+
+    results = search.search(
+        predicates(std::make_unique<AuthorPredicate>(u"forsen"_s, false)),
+        &candidates, token);
+    ASSERT_EQ(*results, (std::vector<size_t>{2}));
+}
+
+TEST(MessageSearch, Cancelled)
+{
+    auto search = makeSearch();
+    CancellationToken token(false);
+    token.cancel();
+
+    auto results = search.search(
+        predicates(std::make_unique<SubstringPredicate>(u"hello"_s)), nullptr,
+        token);
+    ASSERT_FALSE(results.has_value());
+}
+
+TEST(MessageSearch, Narrows)
+{
+    struct Case {
+        QString previous;
+        QString query;
+        bool narrows;
+    };
+
+    std::vector<Case> cases{
+        {u""_s, u"foo"_s, true},
+        {u"foo"_s, u"foo"_s, true},
+        {u"fo"_s, u"foo"_s, true},
+        {u"foo"_s, u"foo bar"_s, true},
+        {u"foo "_s, u"foo bar"_s, true},
+        {u"foo"_s, u"foobar baz"_s, true},
+        {u"from:forsen"_s, u"from:forsen hello"_s, true},
+        {u"-foo"_s, u"-foob"_s, true},
+
+        {u"foo"_s, u"fo"_s, false},
+        {u"foo"_s, u"bar"_s, false},
+        {u"from:fo"_s, u"from:forsen"_s, false},
+        {u"from"_s, u"from:forsen"_s, false},
+        {u"regex:a"_s, u"regex:a|b"_s, false},
+        {u"!in:a"_s, u"!in:ab"_s, false},
+        {u"regex:\"a"_s, u"regex:\"a b\""_s, false},
+    };
+
+    for (const auto &c : cases)
+    {
+        EXPECT_EQ(MessageSearch::narrows(c.previous, c.query), c.narrows)
+            << c.previous << " -> " << c.query;
+    }
+}
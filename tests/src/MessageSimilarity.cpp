@@ -0,0 +1,114 @@
+#include "messages/MessageSimilarity.hpp"
+
+#include "Test.hpp"
+
+#include <QString>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+/// The previous implementation: longest common substring with a full matrix
+float referenceSimilarity(const QString &str1, const QString &str2)
+{
+    std::vector<std::vector<int>> tree(str1.size(),
+                                       std::vector<int>(str2.size(), 0));
+    int z = 0;
+
+    for (qsizetype i = 0; i < str1.size(); ++i)
+    {
+        for (qsizetype j = 0; j < str2.size(); ++j)
+        {
+            if (str1[i] == str2[j])
+            {
+                if (i == 0 || j == 0)
+                {
+                    tree[i][j] = 1;
+                }
+                else
+                {
+                    tree[i][j] = tree[i - 1][j - 1] + 1;
+                }
+                z = std::max(tree[i][j], z);
+            }
+        }
+    }
+
+    if (z == 0)
+    {
+        return 0.F;
+    }
+
+    auto div = std::max<>({qsizetype{1}, str1.size(), str2.size()});
+
+    return float(z) / float(div);
+}
+
+}  // namespace
+
+TEST(MessageSimilarity, Examples)
+{
+    SubstringMatcher matcher(u"forsen LULW forsen");
+
+    EXPECT_EQ(matcher.relativeSimilarity(u"forsen LULW forsen"), 1.F);
+    EXPECT_EQ(matcher.relativeSimilarity(u""), 0.F);
+    EXPECT_EQ(matcher.relativeSimilarity(u"xyz"), 0.F);
+    // "LULW forsen"
+    EXPECT_EQ(matcher.relativeSimilarity(u"LULW forsen"), 11.F / 18.F);
+    // " LULW " in a longer message
+    EXPECT_EQ(matcher.relativeSimilarity(u"a LULW b c d e f g h i"),
+              6.F / 22.F);
+
+    EXPECT_TRUE(matcher.isMoreSimilarThan(u"forsen LULW forsen", 0.9F));
+    EXPECT_FALSE(matcher.isMoreSimilarThan(u"forsen LULW forsen", 1.F));
+    EXPECT_TRUE(matcher.isMoreSimilarThan(u"LULW forsen", 0.6F));
+    EXPECT_FALSE(matcher.isMoreSimilarThan(u"LULW forsen", 0.62F));
+    EXPECT_FALSE(matcher.isMoreSimilarThan(u"xyz", 0.F));
+
+    SubstringMatcher empty(u"");
+    EXPECT_EQ(empty.relativeSimilarity(u""), 0.F);
+    EXPECT_EQ(empty.relativeSimilarity(u"forsen"), 0.F);
+    EXPECT_FALSE(empty.isMoreSimilarThan(u"", 0.F));
+}
+
+TEST(MessageSimilarity, MatchesReference)
+{
+    std::mt19937 rng(1337);
+    auto randomString = [&](int alphabet) {
+        QString str;
+        auto length = rng() % 40;
+        for (size_t i = 0; i < length; i++)
+        {
+            auto c = static_cast<char16_t>(u'a' + rng() % alphabet);
+            if (rng() % 50 == 0)
+            {
+                // some characters outside of the first histogram buckets
+                c = static_cast<char16_t>(c + 0x3000);
+            }
+            str.append(QChar(c));
+        }
+        return str;
+    };
+
+    for (int i = 0; i < 5000; i++)
+    {
+        auto alphabet = 1 + static_cast<int>(rng() % 6);
+        auto a = randomString(alphabet);
+        auto b = randomString(alphabet);
+        SubstringMatcher matcher(a);
+
+        auto expected = referenceSimilarity(a, b);
+        ASSERT_EQ(matcher.relativeSimilarity(b), expected)
+            << a.toStdString() << " / " << b.toStdString();
+
+        auto threshold = static_cast<float>(rng() % 101) / 100.F;
+        ASSERT_EQ(matcher.isMoreSimilarThan(b, threshold),
+                  expected > threshold)
+            << a.toStdString() << " / " << b.toStdString() << " @ "
+            << threshold;
+    }
+}
@@ -1,11 +1,15 @@
 #include "common/network/NetworkRequest.hpp"
 
+#include "common/network/NetworkCache.hpp"
 #include "common/network/NetworkManager.hpp"
 #include "common/network/NetworkResult.hpp"
 #include "NetworkHelpers.hpp"
 #include "Test.hpp"
 
 #include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
 
 using namespace chatterino;
 
@@ -21,6 +25,55 @@ QString getDelayURL(int delay)
     return QString("%1/delay/%2").arg(HTTPBIN_BASE_URL).arg(delay);
 }
 
+QString getCacheURL()
+{
+    return QString("%1/cache").arg(HTTPBIN_BASE_URL);
+}
+
+NetworkCacheEntry makeEntry(const QByteArray &data)
+{
+    return {
+        .data = data,
+        .etag = {},
+        .lastModified = {},
+        .freshUntil = QDateTime::currentDateTimeUtc().addDays(1),
+    };
+}
+
+/// The key of the only response in the cache stored in `directory`
+QString onlyCacheKey(const QString &directory)
+{
+    auto files = QDir(directory).entryList({}, QDir::Files);
+    files.removeAll("index");
+    if (files.size() != 1)
+    {
+        return {};
+    }
+    return files.front();
+}
+
+/// Requests `url` through `cache` and returns the received body
+QByteArray requestCached(const QString &url, NetworkCache &cache)
+{
+    RequestWaiter waiter;
+    QByteArray body;
+    NetworkRequest(url)
+        .cache(&cache)
+        .onSuccess([&](const NetworkResult &result) {
+            EXPECT_EQ(result.status(), 200);
+            body = result.getData();
+        })
+        .onError([&](const NetworkResult & /*result*/) {
+            EXPECT_TRUE(false);
+        })
+        .finally([&] {
+            waiter.requestDone();
+        })
+        .execute();
+    waiter.waitForRequest();
+    return body;
+}
+
 }  // namespace
 
 TEST(NetworkRequest, Success)
@@ -277,3 +330,172 @@ TEST(NetworkRequest, BatchedTimeouts)
     }
 #endif
 }
+
+TEST(NetworkCache, RoundTrip)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    auto path = dir.filePath("Http");
+
+    {
+        NetworkCache cache(path, 1024 * 1024);
+        ASSERT_FALSE(cache.read("a").has_value());
+
+        auto entry = makeEntry("hello");
+        entry.etag = "\"abc\"";
+        entry.lastModified = "Wed, 21 Oct 2015 07:28:00 GMT";
+        cache.write("a", entry);
+        cache.write("b", makeEntry("world"));
+        ASSERT_EQ(cache.size(), 2);
+        ASSERT_EQ(cache.totalBytes(), 10);
+
+        // writes are batched, pending responses are read from memory
+        ASSERT_FALSE(QFile::exists(path + "/a"));
+        auto read = cache.read("a");
+        ASSERT_TRUE(read.has_value());
+        ASSERT_EQ(read->data, "hello");
+        ASSERT_TRUE(read->isFresh());
+        ASSERT_TRUE(read->canRevalidate());
+
+        cache.flush();
+        ASSERT_TRUE(QFile::exists(path + "/a"));
+        ASSERT_TRUE(QFile::exists(path + "/index"));
+    }
+
+    // the index is loaded again
+    NetworkCache cache(path, 1024 * 1024);
+    ASSERT_EQ(cache.size(), 2);
+    ASSERT_EQ(cache.totalBytes(), 10);
+    auto read = cache.read("a");
+    ASSERT_TRUE(read.has_value());
+    ASSERT_EQ(read->data, "hello");
+    ASSERT_EQ(read->etag, "\"abc\"");
+    ASSERT_EQ(read->lastModified, "Wed, 21 Oct 2015 07:28:00 GMT");
+    ASSERT_EQ(cache.read("b")->data, "world");
+
+    // a file removed behind the cache's back is a miss
+    ASSERT_TRUE(QFile::remove(path + "/b"));
+    ASSERT_FALSE(cache.read("b").has_value());
+    ASSERT_EQ(cache.size(), 1);
+}
+
+TEST(NetworkCache, LeastRecentlyUsedEviction)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    NetworkCache cache(dir.path(), 30);
+
+    cache.write("a", makeEntry(QByteArray(10, 'a')));
+    cache.write("b", makeEntry(QByteArray(10, 'b')));
+    cache.write("c", makeEntry(QByteArray(10, 'c')));
+    ASSERT_EQ(cache.totalBytes(), 30);
+    cache.flush();
+
+    // "a" is now used more recently than "b"
+    ASSERT_TRUE(cache.read("a").has_value());
+    cache.write("d", makeEntry(QByteArray(10, 'd')));
+    ASSERT_EQ(cache.size(), 3);
+    ASSERT_FALSE(cache.read("b").has_value());
+    ASSERT_TRUE(cache.read("a").has_value());
+    ASSERT_TRUE(cache.read("c").has_value());
+    ASSERT_TRUE(cache.read("d").has_value());
+
+    cache.flush();
+    ASSERT_FALSE(QFile::exists(dir.filePath("b")));
+
+    // responses larger than the cache aren't stored
+    cache.write("e", makeEntry(QByteArray(31, 'e')));
+    ASSERT_FALSE(cache.read("e").has_value());
+    ASSERT_EQ(cache.size(), 3);
+
+    // ...and don't leave the outdated response behind
+    cache.write("c", makeEntry(QByteArray(31, 'c')));
+    ASSERT_FALSE(cache.read("c").has_value());
+    ASSERT_EQ(cache.size(), 2);
+    cache.flush();
+    ASSERT_FALSE(QFile::exists(dir.filePath("c")));
+
+    cache.setMaxBytes(10);
+    ASSERT_EQ(cache.size(), 1);
+    ASSERT_TRUE(cache.read("d").has_value());
+}
+
+TEST(NetworkCache, EvictRemovesUnknownFiles)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    NetworkCache cache(dir.path(), 1024);
+
+    cache.write("a", makeEntry("a"));
+    cache.flush();
+
+    QFile stray(dir.filePath("stray"));
+    ASSERT_TRUE(stray.open(QFile::WriteOnly));
+    stray.close();
+
+    ASSERT_EQ(cache.evict(), 1);
+    ASSERT_FALSE(QFile::exists(dir.filePath("stray")));
+    ASSERT_TRUE(cache.read("a").has_value());
+}
+
+TEST(NetworkCache, Freshness)
+{
+    auto now = QDateTime::currentDateTimeUtc();
+
+    ASSERT_EQ(NetworkCache::freshUntil({}, now),
+              now.addSecs(NetworkCache::DEFAULT_FRESHNESS.count()));
+    ASSERT_EQ(NetworkCache::freshUntil("public, max-age=60", now),
+              now.addSecs(60));
+    ASSERT_EQ(NetworkCache::freshUntil("Max-Age=0", now), now);
+    ASSERT_EQ(NetworkCache::freshUntil("no-cache", now), now);
+    ASSERT_FALSE(
+        NetworkCache::freshUntil("private, no-store", now).has_value());
+}
+
+TEST(NetworkRequest, CachedResponse)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    NetworkCache cache(dir.path(), 1024 * 1024);
+
+    auto url = getStatusURL(200);
+    requestCached(url, cache);
+    ASSERT_EQ(cache.size(), 1);
+
+    // replace the stored response, so we know it's used
+    cache.flush();
+    auto key = onlyCacheKey(dir.path());
+    ASSERT_FALSE(key.isEmpty());
+    auto entry = cache.read(key);
+    ASSERT_TRUE(entry.has_value());
+    entry->data = "from the cache";
+    cache.write(key, *entry);
+
+    ASSERT_EQ(requestCached(url, cache), "from the cache");
+}
+
+TEST(NetworkRequest, RevalidatedResponse)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    NetworkCache cache(dir.path(), 1024 * 1024);
+
+    // /cache responds with an ETag and Last-Modified and with 304 to
+    // conditional requests
+    auto url = getCacheURL();
+    requestCached(url, cache);
+    cache.flush();
+    auto key = onlyCacheKey(dir.path());
+    ASSERT_FALSE(key.isEmpty());
+    auto entry = cache.read(key);
+    ASSERT_TRUE(entry.has_value());
+    ASSERT_TRUE(entry->canRevalidate());
+
+    // make the stored response stale
+    entry->data = "from the cache";
+    entry->freshUntil = QDateTime::currentDateTimeUtc().addSecs(-1);
+    cache.write(key, *entry);
+
+    ASSERT_EQ(requestCached(url, cache), "from the cache");
+    ASSERT_TRUE(cache.read(key)->isFresh());
+}
@@ -4,6 +4,7 @@
 #    include "common/network/NetworkCommon.hpp"
 #    include "controllers/commands/Command.hpp"  // IWYU pragma: keep
 #    include "controllers/commands/CommandController.hpp"
+#    include "controllers/completion/TabCompletionModel.hpp"
 #    include "controllers/plugins/api/ChannelRef.hpp"
 #    include "controllers/plugins/api/WebSocket.hpp"
 #    include "controllers/plugins/Plugin.hpp"
@@ -20,6 +21,7 @@
 #    include "Test.hpp"
 
 #    include <lauxlib.h>
+#    include <QCoreApplication>
 #    include <sol/state_view.hpp>
 #    include <sol/table.hpp>
 
@@ -228,6 +230,27 @@ TEST_F(PluginTest, testCommands)
     EXPECT_EQ(ref.get_name(), channel->getName());
 }
 
+TEST_F(PluginTest, testSlowCommand)
+{
+    configure();
+
+    lua->script(R"lua(
+        c2.register_command("/slow", function(ctx)
+            while true do end
+        end)
+    )lua");
+
+    // the endless loop is aborted once it exceeds the budget
+    app->commands.execCommand("/slow", channel, false);
+    const auto &stats = rawpl->commandStats;
+    ASSERT_EQ(stats.calls, 1U);
+    ASSERT_EQ(stats.aborted, 1U);
+    ASSERT_GE(stats.last, PluginController::COMMAND_BUDGET);
+
+    // the Lua state is still usable after the abort
+    ASSERT_EQ(lua->script("return 1 + 1").get<int>(0), 2);
+}
+
 TEST_F(PluginTest, testCompletion)
 {
     configure();
@@ -284,6 +307,114 @@ TEST_F(PluginTest, testCompletion)
     ASSERT_EQ((*lua).get<bool>("is_first_word"), false);
 }
 
+TEST_F(PluginTest, testSlowCompletion)
+{
+    configure();
+
+    lua->script(R"lua(
+        c2.register_callback(
+            c2.EventType.CompletionRequested,
+            function(ev)
+                if ev.query == "slow" then
+                    while true do end
+                end
+                return {
+                    hide_others = false,
+                    values = {"Completion"},
+                }
+            end
+        )
+    )lua");
+    using Pass = PluginController::CompletionPass;
+    const auto &stats =
+        rawpl->callbackStats[lua::api::EventType::CompletionRequested];
+
+    ASSERT_FALSE(app->plugins.hasDeferredCompletions());
+
+    // the endless loop is aborted once it exceeds the budget
+    bool done{};
+    QStringList results;
+    std::tie(done, results) =
+        app->plugins.updateCustomCompletions("slow", "slow", 4, true);
+    ASSERT_EQ(done, false);
+    ASSERT_TRUE(results.isEmpty());
+    ASSERT_EQ(stats.calls, 1U);
+    ASSERT_EQ(stats.aborted, 1U);
+    ASSERT_TRUE(stats.lastAborted);
+    ASSERT_GE(stats.last, PluginController::COMPLETION_BUDGET);
+
+    // the plugin is only asked in the deferred pass now
+    ASSERT_TRUE(app->plugins.hasDeferredCompletions());
+    std::tie(done, results) =
+        app->plugins.updateCustomCompletions("foo", "foo", 3, true);
+    ASSERT_TRUE(results.isEmpty());
+    ASSERT_EQ(stats.calls, 1U);
+
+    std::tie(done, results) = app->plugins.updateCustomCompletions(
+        "foo", "foo", 3, true, Pass::Deferred);
+    ASSERT_EQ(results, QStringList{"Completion"});
+    ASSERT_EQ(stats.calls, 2U);
+    ASSERT_FALSE(stats.lastAborted);
+
+    // it was fast again, so it's back in the immediate pass
+    ASSERT_FALSE(app->plugins.hasDeferredCompletions());
+    std::tie(done, results) =
+        app->plugins.updateCustomCompletions("foo", "foo", 3, true);
+    ASSERT_EQ(results, QStringList{"Completion"});
+    ASSERT_EQ(stats.calls, 3U);
+
+    // the Lua state is still usable after the abort
+    ASSERT_EQ(lua->script("return 1 + 1").get<int>(0), 2);
+}
+
+TEST_F(PluginTest, testDeferredCompletionModel)
+{
+    configure();
+
+    lua->script(R"lua(
+        _G.slow = true
+        c2.register_callback(
+            c2.EventType.CompletionRequested,
+            function(ev)
+                if _G.slow then
+                    _G.slow = false
+                    while true do end
+                end
+                return {
+                    hide_others = true,
+                    values = {"/ban ", "/banana ", "/banana "},
+                }
+            end
+        )
+    )lua");
+
+    TabCompletionModel model(*channel, nullptr);
+
+    // the plugin is aborted, so only the built-in commands are shown
+    model.updateResults("/ba", "/ba", 3, true);
+    auto builtIn = model.stringList();
+    ASSERT_TRUE(builtIn.contains("/ban "));
+    ASSERT_FALSE(builtIn.contains("/banana "));
+    ASSERT_TRUE(app->plugins.hasDeferredCompletions());
+
+    // the deferred pass doesn't change the shown completions on its own
+    QCoreApplication::processEvents();
+    ASSERT_FALSE((*lua).get<bool>("slow"));
+    ASSERT_EQ(model.stringList(), builtIn);
+
+    // new completions are appended once, hide_others is ignored
+    ASSERT_TRUE(model.applyDeferredCompletions());
+    ASSERT_EQ(model.stringList(), builtIn + QStringList{"/banana "});
+    ASSERT_FALSE(model.applyDeferredCompletions());
+
+    // deferred completions are dropped when another query is started
+    lua->script("_G.slow = true");
+    model.updateResults("/ba", "/ba", 3, true);
+    QCoreApplication::processEvents();
+    model.updateResults("/ba", "/ba", 3, true);
+    ASSERT_FALSE(model.applyDeferredCompletions());
+}
+
 TEST_F(PluginTest, testChannel)
 {
     configure();
@@ -0,0 +1,300 @@
+#include "common/Literals.hpp"
+#include "controllers/accounts/AccountController.hpp"
+#include "controllers/highlights/HighlightController.hpp"
+#include "controllers/sound/NullBackend.hpp"
+#include "messages/Message.hpp"
+#include "mocks/BaseApplication.hpp"
+#include "mocks/ChatterinoBadges.hpp"
+#include "mocks/Emotes.hpp"
+#include "mocks/LinkResolver.hpp"
+#include "mocks/Logging.hpp"
+#include "mocks/TwitchIrcServer.hpp"
+#include "mocks/UserData.hpp"
+#include "providers/bttv/BttvEmotes.hpp"
+#include "providers/ffz/FfzBadges.hpp"
+#include "providers/ffz/FfzEmotes.hpp"
+#include "providers/recentmessages/Impl.hpp"
+#include "providers/seventv/SeventvBadges.hpp"
+#include "providers/seventv/SeventvEmotes.hpp"
+#include "providers/twitch/TwitchBadges.hpp"
+#include "providers/twitch/TwitchChannel.hpp"
+#include "Test.hpp"
+#include "util/VectorMessageSink.hpp"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QLocale>
+#include <QString>
+#include <QStringList>
+#include <QtConcurrent>
+
+#include <memory>
+#include <vector>
+
+using namespace chatterino;
+using namespace literals;
+
+namespace {
+
+class MockApplication : public mock::BaseApplication
+{
+public:
+    MockApplication()
+        : highlights(this->settings, &this->accounts)
+    {
+    }
+
+    IEmotes *getEmotes() override
+    {
+        return &this->emotes;
+    }
+
+    IUserDataController *getUserData() override
+    {
+        return &this->userData;
+    }
+
+    AccountController *getAccounts() override
+    {
+        return &this->accounts;
+    }
+
+    ITwitchIrcServer *getTwitch() override
+    {
+        return &this->twitch;
+    }
+
+    IChatterinoBadges *getChatterinoBadges() override
+    {
+        return &this->chatterinoBadges;
+    }
+
+    FfzBadges *getFfzBadges() override
+    {
+        return &this->ffzBadges;
+    }
+
+    SeventvBadges *getSeventvBadges() override
+    {
+        return &this->seventvBadges;
+    }
+
+    HighlightController *getHighlights() override
+    {
+        return &this->highlights;
+    }
+
+    BttvEmotes *getBttvEmotes() override
+    {
+        return &this->bttvEmotes;
+    }
+
+    FfzEmotes *getFfzEmotes() override
+    {
+        return &this->ffzEmotes;
+    }
+
+    SeventvEmotes *getSeventvEmotes() override
+    {
+        return &this->seventvEmotes;
+    }
+
+    ILogging *getChatLogger() override
+    {
+        return &this->logging;
+    }
+
+    TwitchBadges *getTwitchBadges() override
+    {
+        return &this->twitchBadges;
+    }
+
+    ILinkResolver *getLinkResolver() override
+    {
+        return &this->linkResolver;
+    }
+
+    ISoundController *getSound() override
+    {
+        return &this->sound;
+    }
+
+    mock::EmptyLogging logging;
+    AccountController accounts;
+    mock::Emotes emotes;
+    mock::UserDataController userData;
+    mock::MockTwitchIrcServer twitch;
+    mock::ChatterinoBadges chatterinoBadges;
+    FfzBadges ffzBadges;
+    SeventvBadges seventvBadges;
+    HighlightController highlights;
+    BttvEmotes bttvEmotes;
+    FfzEmotes ffzEmotes;
+    SeventvEmotes seventvEmotes;
+    TwitchBadges twitchBadges;
+    mock::EmptyLinkResolver linkResolver;
+    NullBackend sound;
+};
+
+constexpr qint64 DAY = 24LL * 60 * 60 * 1000;
+constexpr qint64 FIRST_DAY = 1700000000000;
+
+/// A PRIVMSG by `user` received `offset` ms after the start of the fixture
+QString privmsg(qint64 offset, const QString &id, const QString &user,
+                const QString &text, const QString &extraTags = {})
+{
+    auto ts = QString::number(FIRST_DAY + offset);
+    return u"@badge-info=;badges=;color=#FF0000;display-name=%1;emotes=;"
+           u"flags=;id=%2;mod=0;room-id=11148817;subscriber=0;"
+           u"tmi-sent-ts=%3;rm-received-ts=%3;turbo=0;user-id=1;"
+           u"user-type=%4 :%5!%5@%5.tmi.twitch.tv PRIVMSG #pajlada :%6"_s
+        .arg(user, id, ts, extraTags, user.toLower(), text);
+}
+
+/// Recent messages spanning three days, where the second day begins at the
+/// start of a chunk and the third day in the middle of one (with a chunk size
+/// of two). Also contains a reply, which can't be built in advance, and a
+/// timeout.
+QJsonObject fixture()
+{
+    QStringList lines{
+        privmsg(0, u"id-0"_s, u"Alice"_s, u"first"_s),
+        privmsg(1000, u"id-1"_s, u"Bob"_s, u"second"_s),
+        privmsg(DAY, u"id-2"_s, u"Carol"_s, u"next day"_s),
+        privmsg(DAY + 1000, u"id-3"_s, u"Alice"_s, u"@Carol reply"_s,
+                u";reply-parent-display-name=Carol;reply-parent-msg-body="
+                u"next\\sday;reply-parent-msg-id=id-2;"
+                u"reply-parent-user-id=1;reply-parent-user-login=carol;"
+                u"reply-thread-parent-display-name=Carol;"
+                u"reply-thread-parent-msg-id=id-2;"
+                u"reply-thread-parent-user-id=1;"
+                u"reply-thread-parent-user-login=carol"_s),
+        u"@ban-duration=600;room-id=11148817;target-user-id=2;"
+        u"tmi-sent-ts=%1;rm-received-ts=%1 :tmi.twitch.tv CLEARCHAT "
+        u"#pajlada :bob"_s.arg(FIRST_DAY + DAY + 2000),
+        privmsg(2 * DAY, u"id-5"_s, u"Bob"_s, u"third day"_s),
+        privmsg(2 * DAY + 1000, u"id-6"_s, u"Carol"_s, u"last"_s),
+    };
+
+    return {{u"messages"_s, QJsonArray::fromStringList(lines)}};
+}
+
+QJsonArray toJson(const std::vector<MessagePtr> &messages)
+{
+    QJsonArray array;
+    for (const auto &message : messages)
+    {
+        array.append(message->toJson());
+    }
+    return array;
+}
+
+class RecentMessagesTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        this->mockApplication = std::make_unique<MockApplication>();
+    }
+
+    void TearDown() override
+    {
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+        this->mockApplication.reset();
+    }
+
+    /// Builds the fixture on one thread with buildRecentMessages
+    std::vector<MessagePtr> buildSerially()
+    {
+        TwitchChannel channel(u"pajlada"_s);
+        auto parsed = recentmessages::detail::parseRecentMessages(fixture());
+        return recentmessages::detail::buildRecentMessages(parsed, &channel);
+    }
+
+    /// Builds the fixture in chunks of two messages like Backfill. With
+    /// `build`, the chunks are prepared in the global thread pool.
+    std::vector<MessagePtr> buildInChunks(bool build)
+    {
+        TwitchChannel channel(u"pajlada"_s);
+        auto chunks = recentmessages::detail::splitRecentMessages(fixture(), 2);
+        EXPECT_EQ(chunks.size(), 4);
+
+        std::vector<recentmessages::detail::PreparedRecentMessages> prepared;
+        if (build)
+        {
+            prepared = QtConcurrent::blockingMapped<
+                std::vector<recentmessages::detail::PreparedRecentMessages>>(
+                chunks, [&](const std::vector<QByteArray> &lines) {
+                    return recentmessages::detail::prepareRecentMessages(
+                        lines, &channel);
+                });
+        }
+        else
+        {
+            for (const auto &chunk : chunks)
+            {
+                prepared.emplace_back(
+                    recentmessages::detail::prepareRecentMessages(
+                        chunk, &channel, false));
+            }
+        }
+
+        VectorMessageSink sink({}, MessageFlag::RecentMessage);
+        for (auto &chunk : prepared)
+        {
+            recentmessages::detail::finishRecentMessages(chunk, sink, &channel);
+        }
+        return std::move(sink).takeMessages();
+    }
+
+    std::unique_ptr<MockApplication> mockApplication;
+};
+
+/// The messages announcing the days of the fixture in `messages`
+QStringList dateChanges(const std::vector<MessagePtr> &messages)
+{
+    QStringList days;
+    for (qint64 day = 0; day < 3; day++)
+    {
+        days.append(QLocale().toString(
+            QDateTime::fromMSecsSinceEpoch(FIRST_DAY + day * DAY).date(),
+            QLocale::LongFormat));
+    }
+
+    QStringList found;
+    for (const auto &message : messages)
+    {
+        if (days.contains(message->messageText))
+        {
+            found.append(message->messageText);
+        }
+    }
+    return found;
+}
+
+}  // namespace
+
+TEST_F(RecentMessagesTest, ChunksMatchSerialBuild)
+{
+    auto expected = this->buildSerially();
+    ASSERT_FALSE(expected.empty());
+    ASSERT_EQ(dateChanges(expected).size(), 3);
+
+    auto built = this->buildInChunks(true);
+    ASSERT_EQ(built.size(), expected.size());
+    ASSERT_EQ(dateChanges(built), dateChanges(expected));
+    ASSERT_EQ(toJson(built), toJson(expected));
+}
+
+TEST_F(RecentMessagesTest, ChunksMatchSerialBuildWithoutBuilding)
+{
+    auto expected = this->buildSerially();
+    ASSERT_FALSE(expected.empty());
+
+    auto built = this->buildInChunks(false);
+    ASSERT_EQ(built.size(), expected.size());
+    ASSERT_EQ(dateChanges(built), dateChanges(expected));
+    ASSERT_EQ(toJson(built), toJson(expected));
+}
@@ -0,0 +1,156 @@
+#include "messages/ScrollbackArchive.hpp"
+
+#include "common/Literals.hpp"
+#include "Test.hpp"
+
+#include <QDir>
+#include <QLockFile>
+#include <QTemporaryDir>
+
+#include <chrono>
+#include <filesystem>
+
+using namespace chatterino;
+using namespace literals;
+
+namespace {
+
+QByteArray record(size_t i)
+{
+    // records have different sizes, some are empty
+    return QByteArray::number(i).repeated(static_cast<qsizetype>(i % 5));
+}
+
+void appendRecords(ScrollbackArchive &archive, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        archive.append(record(archive.endIndex()));
+    }
+}
+
+}  // namespace
+
+TEST(ScrollbackArchive, ReadAcrossSegments)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    ScrollbackArchive archive(dir.path(), u"#forsen"_s, 10000);
+    ASSERT_TRUE(archive.isValid());
+    ASSERT_EQ(archive.endIndex(), 0);
+    ASSERT_TRUE(archive.read(0, 10).empty());
+
+    appendRecords(archive, 3000);
+    ASSERT_EQ(archive.firstIndex(), 0);
+    ASSERT_EQ(archive.endIndex(), 3000);
+
+    // from written segments and the current one
+    auto records = archive.read(1000, 2100);
+    ASSERT_EQ(records.size(), 1100);
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        ASSERT_EQ(records[i], record(1000 + i)) << i;
+    }
+
+    // the range is clamped
+    records = archive.read(2990, 5000);
+    ASSERT_EQ(records.size(), 10);
+    ASSERT_EQ(records.front(), record(2990));
+    ASSERT_EQ(records.back(), record(2999));
+    ASSERT_TRUE(archive.read(3000, 4000).empty());
+}
+
+TEST(ScrollbackArchive, RemovesOldSegments)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    ScrollbackArchive archive(dir.path(), u"#forsen"_s, 2000);
+    appendRecords(archive, ScrollbackArchive::SEGMENT_RECORDS * 5 + 10);
+
+    // two segments are kept on disk, one is in memory
+    ASSERT_EQ(archive.firstIndex(), ScrollbackArchive::SEGMENT_RECORDS * 3);
+    ASSERT_EQ(archive.endIndex(), ScrollbackArchive::SEGMENT_RECORDS * 5 + 10);
+
+    auto records = archive.read(0, archive.endIndex());
+    ASSERT_EQ(records.size(), ScrollbackArchive::SEGMENT_RECORDS * 2 + 10);
+    ASSERT_EQ(records.front(), record(archive.firstIndex()));
+    ASSERT_EQ(records.back(), record(archive.endIndex() - 1));
+
+    // segments are written in the background, afterwards they're read from
+    // the disk
+    archive.waitForWrites();
+    records = archive.read(0, archive.endIndex());
+    ASSERT_EQ(records.size(), ScrollbackArchive::SEGMENT_RECORDS * 2 + 10);
+    ASSERT_EQ(records.front(), record(archive.firstIndex()));
+    ASSERT_EQ(records.back(), record(archive.endIndex() - 1));
+}
+
+TEST(ScrollbackArchive, RemovesDirectory)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    {
+        ScrollbackArchive archive(dir.path(), u"#forsen"_s, 10000);
+        appendRecords(archive, 2000);
+        auto entries = QDir(dir.path()).entryList(QDir::Dirs |
+                                                  QDir::NoDotAndDotDot);
+        ASSERT_EQ(entries.size(), 1);
+        ASSERT_TRUE(entries.front().startsWith(u"_forsen-"));
+    }
+
+    ASSERT_TRUE(
+        QDir(dir.path()).entryList(QDir::Dirs | QDir::NoDotAndDotDot).empty());
+}
+
+TEST(ScrollbackArchive, RemoveStale)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    // left behind by a crash
+    QDir(dir.path()).mkpath(u"crashed-abcdef"_s);
+
+    ScrollbackArchive archive(dir.path(), u"#forsen"_s, 10000);
+    appendRecords(archive, 10);
+    auto live = QDir(dir.path())
+                    .entryList({u"_forsen-*"_s},
+                               QDir::Dirs | QDir::NoDotAndDotDot);
+    ASSERT_EQ(live.size(), 1);
+
+    // archives of running instances are kept, even if they weren't changed
+    // in a long time
+    std::filesystem::last_write_time(
+        dir.filePath(live.front()).toStdString(),
+        std::filesystem::file_time_type::clock::now() - std::chrono::days(30));
+
+    ASSERT_EQ(ScrollbackArchive::removeStale(dir.path()), 1);
+    ASSERT_EQ(QDir(dir.path()).entryList(QDir::Dirs | QDir::NoDotAndDotDot),
+              live);
+    ASSERT_EQ(archive.read(0, 10).size(), 10);
+}
+
+TEST(ScrollbackArchive, InvalidWithoutLock)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    // another instance is creating an archive or removing stale ones
+    QLockFile parentLock(dir.filePath(u"creation.lock"_s));
+    ASSERT_TRUE(parentLock.tryLock());
+
+    ScrollbackArchive archive(dir.path(), u"#forsen"_s, 10000);
+    ASSERT_FALSE(archive.isValid());
+    ASSERT_TRUE(
+        QDir(dir.path()).entryList(QDir::Dirs | QDir::NoDotAndDotDot).empty());
+
+    // the full segment couldn't be written, the current one is in memory
+    appendRecords(archive, ScrollbackArchive::SEGMENT_RECORDS + 10);
+    archive.waitForWrites();
+    auto records = archive.read(0, archive.endIndex());
+    ASSERT_EQ(records.size(), ScrollbackArchive::SEGMENT_RECORDS + 10);
+    ASSERT_TRUE(records[1].isEmpty());
+    ASSERT_EQ(records.back(), record(archive.endIndex() - 1));
+}
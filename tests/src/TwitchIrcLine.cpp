@@ -0,0 +1,116 @@
+#include "providers/twitch/TwitchIrcLine.hpp"
+
+#include "common/Literals.hpp"
+#include "Test.hpp"
+
+#include <IrcMessage>
+
+#include <memory>
+
+using namespace chatterino;
+using namespace literals;
+using namespace std::literals;
+
+TEST(TwitchIrcLine, Privmsg)
+{
+    std::string_view data =
+        "@badge-info=subscriber/22;badges=moderator/1,subscriber/18;color=#"
+        "FF0000;display-name=Mm2PL;emotes=;id=1234;room-id=11148817;"
+        "tmi-sent-ts=1700000000000;user-id=117691339;custom-tag=abc "
+        ":mm2pl!mm2pl@mm2pl.tmi.twitch.tv PRIVMSG #pajlada :hello  world";
+
+    auto line = TwitchIrcLine::parse(data);
+    ASSERT_TRUE(line.has_value());
+
+    ASSERT_EQ(line->command(), "PRIVMSG");
+    ASSERT_EQ(line->prefix(), "mm2pl!mm2pl@mm2pl.tmi.twitch.tv");
+    ASSERT_EQ(line->nick(), "mm2pl");
+    ASSERT_EQ(line->paramCount(), 2);
+    ASSERT_EQ(line->param(0), "#pajlada");
+    ASSERT_EQ(line->param(1), "hello  world");
+    ASSERT_EQ(line->param(2), "");
+
+    ASSERT_TRUE(line->hasTag(TwitchTag::UserId));
+    ASSERT_EQ(line->rawTag(TwitchTag::UserId), "117691339");
+    ASSERT_EQ(line->tag(TwitchTag::DisplayName), u"Mm2PL"_s);
+    ASSERT_EQ(line->tag(TwitchTag::Color), u"#FF0000"_s);
+
+    // set, but empty
+    ASSERT_TRUE(line->hasTag(TwitchTag::Emotes));
+    ASSERT_TRUE(line->tag(TwitchTag::Emotes).isEmpty());
+    ASSERT_FALSE(line->tag(TwitchTag::Emotes).isNull());
+
+    ASSERT_FALSE(line->hasTag(TwitchTag::Bits));
+    ASSERT_TRUE(line->tag(TwitchTag::Bits).isNull());
+
+    ASSERT_EQ(line->rawTag("custom-tag"), "abc");
+    ASSERT_EQ(line->rawTag("room-id"), "11148817");
+    ASSERT_FALSE(line->rawTag("missing").has_value());
+}
+
+TEST(TwitchIrcLine, EscapedTags)
+{
+    auto line = TwitchIrcLine::parse(
+        "@system-msg=5\\sraiders\\sfrom\\:\\\\;login=a\\b;msg-id "
+        ":tmi.twitch.tv USERNOTICE #pajlada"sv);
+    ASSERT_TRUE(line.has_value());
+
+    ASSERT_EQ(line->command(), "USERNOTICE");
+    ASSERT_EQ(line->nick(), "tmi.twitch.tv");
+    ASSERT_EQ(line->paramCount(), 1);
+    ASSERT_EQ(unescapeTagValue(*line->rawTag("system-msg")),
+              u"5 raiders from;\\"_s);
+    ASSERT_EQ(line->tag("system-msg"), u"5 raiders from;\\"_s);
+    ASSERT_TRUE(line->tag("missing").isNull());
+    // unknown escapes drop the backslash
+    ASSERT_EQ(line->tag(TwitchTag::Login), u"ab"_s);
+    ASSERT_TRUE(line->hasTag(TwitchTag::MsgId));
+    ASSERT_EQ(line->rawTag(TwitchTag::MsgId), "");
+}
+
+TEST(TwitchIrcLine, Malformed)
+{
+    ASSERT_FALSE(TwitchIrcLine::parse(""sv).has_value());
+    ASSERT_FALSE(TwitchIrcLine::parse("@a=b"sv).has_value());
+    ASSERT_FALSE(TwitchIrcLine::parse(":prefix"sv).has_value());
+
+    auto line = TwitchIrcLine::parse("PING"sv);
+    ASSERT_TRUE(line.has_value());
+    ASSERT_EQ(line->command(), "PING");
+    ASSERT_EQ(line->prefix(), "");
+    ASSERT_EQ(line->paramCount(), 0);
+
+    line = TwitchIrcLine::parse("PRIVMSG #a :"sv);
+    ASSERT_TRUE(line.has_value());
+    ASSERT_EQ(line->paramCount(), 2);
+    ASSERT_EQ(line->param(1), "");
+}
+
+TEST(TwitchIrcLine, MatchesCommuni)
+{
+    auto data =
+        "@badge-info=;badges=premium/1;color=#1E90FF;display-name=Foo\\sBar;"
+        "emotes=25:0-4;first-msg=0;id=abc;reply-parent-msg-id=def;"
+        "room-id=1;tmi-sent-ts=2;user-id=3 :foo!foo@foo.tmi.twitch.tv "
+        "PRIVMSG #forsen :Kappa 123\r\n"_ba;
+    std::unique_ptr<Communi::IrcMessage> message(
+        Communi::IrcMessage::fromData(data, nullptr));
+    auto line = TwitchIrcLine::parse(data);
+    ASSERT_TRUE(line.has_value());
+
+    auto toQString = [](std::string_view view) {
+        return QString::fromUtf8(view.data(),
+                                 static_cast<qsizetype>(view.size()));
+    };
+    ASSERT_EQ(toQString(line->command()), message->command());
+    ASSERT_EQ(toQString(line->nick()), message->nick());
+    ASSERT_EQ(toQString(line->param(1)), message->parameter(1));
+
+    const auto tags = message->tags();
+    for (auto it = tags.begin(); it != tags.end(); it++)
+    {
+        auto value = line->rawTag(it.key().toStdString());
+        ASSERT_TRUE(value.has_value()) << it.key();
+        ASSERT_EQ(unescapeTagValue(*value), it.value().toString()) << it.key();
+    }
+}